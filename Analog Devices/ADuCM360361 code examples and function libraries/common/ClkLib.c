@@ -7,15 +7,17 @@
    - Example:
    - ClkCfg(CLK_CD3,CLK_HF,CLK_HFO,CLK_OFF);
    - ClkSel(CLK_OFF,CLK_OFF,CLK_CD0,CLK_OFF);
+   - lUartHz = ClkFreq(CLK_FREQ_UART);
 
-   @version		V0.4
+   @version		V0.5
    @author     ADI
-   @date		Febrauary 2013
+   @date		October 2026
    @par Revision History:
    - V0.1, December 2010: initial version. 
    - V0.2, January 2012: Changed Clkcfg() - removed write to XOSCCON.
    - V0.3, January 2013: corrected comments.
    - v0.4, February 2013: corrected parameters in ClkDis()
+   - V0.5, October 2026: Added ClkFreq().
 
 All files for ADuCM360/361 provided by ADI, including this file, are
 provided  as is without warranty of any kind, either expressed or implied.
@@ -176,4 +178,68 @@ int XOSCCfg(int iXosc)
 	pADI_CLKCTL->XOSCCON = i1;
 	return pADI_CLKCTL->XOSCCON;
 }
+/**
+	@brief long ClkFreq(int iClk)
+			==========Calculates a clock frequency from the current clock settings.
+	@param iClk :{CLK_FREQ_UCLK,CLK_FREQ_CORE,CLK_FREQ_SPI0,CLK_FREQ_SPI1,CLK_FREQ_I2C,CLK_FREQ_UART,CLK_FREQ_PWM}
+		- 0 or CLK_FREQ_UCLK for the undivided clock, UCLK.
+		- 1 or CLK_FREQ_CORE for the core clock, UCLK divided by the CLKCON0 divider.
+		- 2 or CLK_FREQ_SPI0 for the SPI0 clock.
+		- 3 or CLK_FREQ_SPI1 for the SPI1 clock.
+		- 4 or CLK_FREQ_I2C for the I2C clock.
+		- 5 or CLK_FREQ_UART for the UART clock.
+		- 6 or CLK_FREQ_PWM for the PWM clock.
+	@return	Frequency in Hz.
+	@note
+		- Reads CLKCON0, CLKCON1, CLKSYSDIV and XOSCCON, so the result follows ClkCfg(),
+		  ClkSel() and XOSCCfg().
+		- The 16MHz and 32kHz oscillators are assumed to be at their nominal frequency.
+		- With CLK_P4 the clock input frequency is taken from CLK_EXT_HZ.
+**/
+long ClkFreq(int iClk)
+{
+	long lUclk;
+	int	iCon1;
+
+	switch ((pADI_CLKCTL->CLKCON0>>3)&3)
+	{
+		case CLK_HF:
+			lUclk = 16000000;
+			if ((pADI_CLKCTL->CLKSYSDIV&1) == 1)
+				lUclk = 8000000;
+			break;
+
+		case CLK_LFX:
+			lUclk = 32768;
+			if ((pADI_CLKCTL->XOSCCON&4) == 4)
+				lUclk = 16384;
+			break;
+
+		case CLK_LF:
+			lUclk = 32768;
+			break;
+
+		default:
+			lUclk = CLK_EXT_HZ;
+			break;
+	}
+	iCon1 = pADI_CLKCTL->CLKCON1;
+	switch (iClk)
+	{
+		case CLK_FREQ_CORE:
+			return lUclk>>(pADI_CLKCTL->CLKCON0&7);
+		case CLK_FREQ_SPI0:
+			return lUclk>>(iCon1&7);
+		case CLK_FREQ_SPI1:
+			return lUclk>>((iCon1>>3)&7);
+		case CLK_FREQ_I2C:
+			return lUclk>>((iCon1>>6)&7);
+		case CLK_FREQ_UART:
+			return lUclk>>((iCon1>>9)&7);
+		case CLK_FREQ_PWM:
+			return lUclk>>((iCon1>>12)&7);
+		default:
+			return lUclk;
+	}
+}
 /**@}*/
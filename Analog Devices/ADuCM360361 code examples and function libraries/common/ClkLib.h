@@ -5,15 +5,17 @@
    - Example:
    - ClkCfg(CLK_CD3,CLK_HF,CLK_HFO,CLK_OFF);
    - ClkSel(CLK_OFF,CLK_OFF,CLK_CD0,CLK_OFF);
+   - lUartHz = ClkFreq(CLK_FREQ_UART);
 
-   @version		V0.4
+   @version		V0.5
    @author     ADI
-   @date		January 2013
+   @date		October 2026
    @par Revision History:
    - V0.1, December 2010: initial version. 
    - V0.2, January 2012: Changed Clkcfg() - removed write to XOSCCON.
    - V0.3, January 2013: corrected comments.
    - V0.4, February 2013: corrected parameters in ClkDis()
+   - V0.5, October 2026: Added ClkFreq().
    
 All files for ADuCM360/361 provided by ADI, including this file, are
 provided  as is without warranty of any kind, either expressed or implied.
@@ -27,6 +29,7 @@ extern int ClkCfg(int iCd, int iClkSrc, int iSysClockDiv, int iClkOut);
 extern int ClkSel(int iSpiCd, int iI2cCd, int iUrtCd, int iPwmCd);
 extern int ClkDis(int iClkDis);
 extern int XOSCCfg(int iXosc);
+extern long ClkFreq(int iClk);
 
 #define	CLK_OFF		-1
 #define	CLK_CD0		0
@@ -53,3 +56,16 @@ extern int XOSCCfg(int iXosc);
 #define	CLK_XOFF	0
 #define	CLK_XON		1
 #define	CLK_XON2	5
+
+#define	CLK_FREQ_UCLK	0
+#define	CLK_FREQ_CORE	1
+#define	CLK_FREQ_SPI0	2
+#define	CLK_FREQ_SPI1	3
+#define	CLK_FREQ_I2C	4
+#define	CLK_FREQ_UART	5
+#define	CLK_FREQ_PWM	6
+
+// Frequency in Hz of the external clock input, used by ClkFreq() when CLK_P4 is selected
+#ifndef CLK_EXT_HZ
+#define	CLK_EXT_HZ	16000000
+#endif
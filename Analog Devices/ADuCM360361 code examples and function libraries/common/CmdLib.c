@@ -0,0 +1,266 @@
+/**
+ *****************************************************************************
+   @addtogroup cmd
+   @{
+   @file     CmdLib.c
+   @brief    Text command interpreter on the UART.
+   - Give the commands with CmdCfg().
+   - Call CmdRxIsr() from UART_Int_Handler for each received byte. It collects a line.
+   - Call CmdPoll() from the main loop. It runs the received line and answers with
+     UrtWrite():
+         "NAME value"  sets the variable, answers "OK" or "ERR" when out of range
+         "NAME"        answers "NAME=value", or "OK" for an action
+         "?"           answers "NAME=value min..max" for each command
+   Names are not case sensitive. Values are decimal, or hexadecimal with 0x.
+   CmdPoll() only writes the variables, so the application decides when the new
+   values are used, for example between two measurements.
+
+   @version  V0.1
+   @date     October 2026
+
+All files for ADuCM360 provided by ADI, including this file, are
+provided  as is without warranty of any kind, either expressed or implied.
+The user assumes any and all risk from the use of this code.
+It is the responsibility of the person integrating this code into an application
+to ensure that the resulting application performs as required and is safe.
+
+**/
+
+#include "CmdLib.h"
+#include <ADuCM360.h>
+#include "UrtLib.h"
+#include "FmtLib.h"
+
+static ADI_UART_TypeDef *pCmdPort = 0;
+static const CmdMap *pCmdMap = 0;
+static int iCmdNum = 0;
+// CmdRxIsr() fills szCmdLine and sets iCmdReady; CmdPoll() clears it once the line is run.
+static char szCmdLine[CMD_LINE_MAX+1];
+static int iCmdLen = 0;
+static volatile int iCmdReady = 0;
+
+/**
+	@brief int CmdCfg(ADI_UART_TypeDef *pPort, const CmdMap *pMap, int iNum)
+			==========Set up the commands.
+	@param pPort :{pADI_UART,}	\n
+		Set to pADI_UART. The UART must already be set up with UrtCfg() and its receive
+		interrupt enabled.
+	@param pMap :{}	\n
+		Commands, kept by reference.
+	@param iNum :{}	\n
+		Number of commands.
+	@return 1.
+**/
+
+int CmdCfg(ADI_UART_TypeDef *pPort, const CmdMap *pMap, int iNum)
+	{
+	pCmdPort = pPort;
+	pCmdMap = pMap;
+	iCmdNum = iNum;
+	iCmdLen = 0;
+	iCmdReady = 0;
+	return 1;
+	}
+
+/**
+	@brief int CmdRxIsr(int iByte)
+			==========Add a received byte to the command line.
+	@param iByte :{0-255}	\n
+		Byte read with UrtRx().
+	@return 1 when the byte ends a line, 0 otherwise.
+	@note
+		- Call from UART_Int_Handler.
+		- A line ends with CR or LF. Backspace removes the last character.
+		- Bytes received while the previous line waits for CmdPoll() are ignored, and so
+		  are lines longer than CMD_LINE_MAX.
+**/
+
+int CmdRxIsr(int iByte)
+	{
+	if (iCmdReady)
+		return 0;
+	if ((iByte == '\r') || (iByte == '\n'))
+		{
+		if ((iCmdLen == 0) || (iCmdLen > CMD_LINE_MAX))
+			{
+			iCmdLen = 0;
+			return 0;
+			}
+		szCmdLine[iCmdLen] = 0;
+		iCmdLen = 0;
+		iCmdReady = 1;
+		return 1;
+		}
+	if ((iByte == 8) || (iByte == 0x7F))
+		{
+		if ((iCmdLen > 0) && (iCmdLen <= CMD_LINE_MAX))
+			iCmdLen--;
+		return 0;
+		}
+	if (iCmdLen < CMD_LINE_MAX)
+		szCmdLine[iCmdLen] = (char)iByte;
+	if (iCmdLen <= CMD_LINE_MAX)
+		iCmdLen++;							// one past CMD_LINE_MAX marks a line too long
+	return 0;
+	}
+
+// Compare a name with the start of the line up to a space or its end, ignoring the case
+static int CmdName(const char *szName, const char *szLine)
+	{
+	while (*szName)
+		{
+		char c = *szLine++;
+
+		if ((c >= 'a') && (c <= 'z'))
+			c -= 'a' - 'A';
+		if (c != *szName++)
+			return 0;
+		}
+	return (*szLine == 0) || (*szLine == ' ');
+	}
+
+// Read a decimal or 0x hexadecimal number that ends the line. Returns 0 for a format error.
+static int CmdValue(const char *szLine, long *plVal)
+	{
+	unsigned long ulVal = 0;
+	int iNeg = 0;
+	int iBase = 10;
+	int iDig = 0;
+
+	while (*szLine == ' ')
+		szLine++;
+	if (*szLine == '-')
+		{
+		iNeg = 1;
+		szLine++;
+		}
+	if ((szLine[0] == '0') && ((szLine[1] == 'x') || (szLine[1] == 'X')))
+		{
+		iBase = 16;
+		szLine += 2;
+		}
+	for (; *szLine && (*szLine != ' '); szLine++)
+		{
+		char c = *szLine;
+		int iDigit;
+
+		if ((c >= '0') && (c <= '9'))
+			iDigit = c - '0';
+		else if ((iBase == 16) && (c >= 'a') && (c <= 'f'))
+			iDigit = c - 'a' + 10;
+		else if ((iBase == 16) && (c >= 'A') && (c <= 'F'))
+			iDigit = c - 'A' + 10;
+		else
+			return 0;
+		if (ulVal > (0x7FFFFFFFUL - iDigit)/iBase)
+			return 0;
+		ulVal = ulVal*iBase + iDigit;
+		iDig++;
+		}
+	while (*szLine == ' ')
+		szLine++;
+	if ((iDig == 0) || *szLine)
+		return 0;
+	*plVal = iNeg ? -(long)ulVal : (long)ulVal;
+	return 1;
+	}
+
+// Answer "NAME=value", with " min..max" if iRange
+static void CmdShow(const CmdMap *pCmd, int iRange)
+	{
+	char szOut[CMD_LINE_MAX+40];
+	int iLen;
+
+	iLen = FmtStr(szOut, pCmd->szName);
+	if (pCmd->plVal)
+		{
+		iLen += FmtStr(szOut+iLen, "=");
+		iLen += FmtFix(szOut+iLen, *pCmd->plVal, 0);
+		if (iRange)
+			{
+			iLen += FmtStr(szOut+iLen, " ");
+			iLen += FmtFix(szOut+iLen, pCmd->lMin, 0);
+			iLen += FmtStr(szOut+iLen, "..");
+			iLen += FmtFix(szOut+iLen, pCmd->lMax, 0);
+			}
+		}
+	iLen += FmtStr(szOut+iLen, "\r\n");
+	UrtWrite(pCmdPort, (unsigned char *)szOut, iLen);
+	}
+
+static void CmdReply(const char *szReply)
+	{
+	char szOut[8];
+	int iLen;
+
+	iLen = FmtStr(szOut, szReply);
+	iLen += FmtStr(szOut+iLen, "\r\n");
+	UrtWrite(pCmdPort, (unsigned char *)szOut, iLen);
+	}
+
+/**
+	@brief int CmdPoll(void)
+			==========Run the received command line, if any.
+	@return Index in the command table plus 1 of the variable set or of the action
+		requested, 0 when no line was received or the line only read values or was wrong.
+	@note
+		- Call from the main loop. Setting a variable to its current value also returns it.
+		- Each answer is queued whole with UrtWrite(). The UrtWrite() queue should have
+		  room for the list of commands when "?" is used.
+**/
+
+int CmdPoll(void)
+	{
+	const char *szArg;
+	long lVal;
+	int i;
+
+	if (!iCmdReady)
+		return 0;
+	for (szArg = szCmdLine; *szArg == ' '; szArg++)
+		;
+	if ((szArg[0] == '?') && (szArg[1] == 0))
+		{
+		for (i = 0; i < iCmdNum; i++)
+			CmdShow(&pCmdMap[i], 1);
+		iCmdReady = 0;
+		return 0;
+		}
+	for (i = 0; i < iCmdNum; i++)
+		if (CmdName(pCmdMap[i].szName, szArg))
+			break;
+	if (i == iCmdNum)
+		{
+		CmdReply("ERR");
+		iCmdReady = 0;
+		return 0;
+		}
+	while (*szArg && (*szArg != ' '))
+		szArg++;
+	while (*szArg == ' ')
+		szArg++;
+	if ((*szArg == 0) && pCmdMap[i].plVal)		// read
+		{
+		CmdShow(&pCmdMap[i], 0);
+		iCmdReady = 0;
+		return 0;
+		}
+	if (*szArg == 0)							// action
+		{
+		CmdReply("OK");
+		iCmdReady = 0;
+		return i + 1;
+		}
+	if ((pCmdMap[i].plVal == 0) || !CmdValue(szArg, &lVal) || (lVal < pCmdMap[i].lMin) || (lVal > pCmdMap[i].lMax))
+		{
+		CmdReply("ERR");
+		iCmdReady = 0;
+		return 0;
+		}
+	*pCmdMap[i].plVal = lVal;
+	CmdReply("OK");
+	iCmdReady = 0;
+	return i + 1;
+	}
+
+   /**@}*/
@@ -0,0 +1,41 @@
+/**
+ *****************************************************************************
+   @file     CmdLib.h
+   @brief    Text command interpreter on the UART.
+   - Give the commands with CmdCfg(): each one sets and reads a variable, or is an
+     action handled by the application.
+   - Call CmdRxIsr() from UART_Int_Handler for each received byte and CmdPoll()
+     from the main loop.
+   Commands are lines of text: "NAME value" sets a variable, "NAME" reads it or
+   runs an action and "?" lists the commands.
+
+   @version  V0.1
+   @date     October 2026
+
+All files for ADuCM360 provided by ADI, including this file, are
+provided  as is without warranty of any kind, either expressed or implied.
+The user assumes any and all risk from the use of this code.
+It is the responsibility of the person integrating this code into an application
+to ensure that the resulting application performs as required and is safe.
+
+**/
+
+#include <ADuCM360.h>
+
+// One command
+typedef struct
+{
+	const char *szName;				// command name, upper case
+	long *plVal;					// variable of the command, 0 for an action
+	long lMin;						// smallest value accepted
+	long lMax;						// largest value accepted
+} CmdMap;
+
+extern int CmdCfg(ADI_UART_TypeDef *pPort, const CmdMap *pMap, int iNum);
+extern int CmdRxIsr(int iByte);
+extern int CmdPoll(void);
+
+// Longest command line, terminator excluded
+#ifndef CMD_LINE_MAX
+#define CMD_LINE_MAX	32
+#endif
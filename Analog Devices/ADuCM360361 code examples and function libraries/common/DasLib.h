@@ -56,18 +56,24 @@ Functions and examples still work in progress. Check for updates regularly.
    @{
       @defgroup adc ADC
       @defgroup clk Clock
+      @defgroup cmd Command Interpreter
       @defgroup dac DAC
       @defgroup dio Digital IO
       @defgroup dma DMA
       @defgroup fee Flash
+      @defgroup fmt Number Formatting
       @defgroup gpt General Purpose Timer
       @defgroup i2c I2C
       @defgroup iexc Excitation Current Source
       @defgroup int Interrupts
+      @defgroup mbs Modbus Slave
       @defgroup pwm PWM
       @defgroup pwr Power
       @defgroup rst Reset
       @defgroup spi SPI
+      @defgroup tlm Telemetry Batching
+      @defgroup tmp Temperature Conversion
+      @defgroup trc Trace
       @defgroup urt UART
       @defgroup wdt Watchdong Timer
       @defgroup wut Wake Up Timer
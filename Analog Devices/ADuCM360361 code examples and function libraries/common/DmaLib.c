@@ -6,10 +6,19 @@
    @brief   Set of DMA peripheral functions.
    - DmaBase(), DmaSet(), DmaClr(), DmaSta() and DmaErr() apply to all DMA channels together.
    - DmaOn() apply for each channel separately. 
+   - Receive from the UART into a ring with UrtDmaRxCfg(), get complete frames in
+     place with UrtDmaRxSpan() and release them with UrtDmaRxDone().
+   - Receive as SPI1 slave into a ring with SpiDmaRxCfg(), in the same way with
+     SpiDmaRxSpan() and SpiDmaRxDone().
    
-   @version    V0.1
+   @version    V0.3
    @author     ADI
-   @date       October 2012
+   @date       October 2026
+
+   @par Revision History:
+   - V0.1, October 2012: initial version. 
+   - V0.2, October 2026: Added circular UART reception with idle line detection, UrtDmaRxCfg().
+   - V0.3, October 2026: Added continuous SPI1 slave reception, SpiDmaRxCfg().
 
 
 All files for ADuCM360/361 provided by ADI, including this file, are
@@ -21,6 +30,7 @@ to ensure that the resulting application performs as required and is safe.
 #include <stdio.h>
 #include <string.h>
 #include "DmaLib.h"
+#include "ClkLib.h"
 
 // Define dmaChanDesc as an array of descriptors aligned to the required 
 // boundary for all supported compilers. It was not possible to do something
@@ -38,6 +48,34 @@ DmaDesc dmaChanDesc     [CCD_SIZE * 2] __attribute__ ((aligned (DMACHAN_DSC_ALIG
 DmaDesc dmaChanDesc     [CCD_SIZE * 2];
 #endif
 
+// Circular UART reception, see UrtDmaRxCfg(). Byte counts are kept from the start of
+// reception and wrap with the ring. Only UrtDmaRxIsr() moves ulUrtDmaRxHalves, only
+// UrtDmaRxTmrIsr() moves uiUrtDmaRxHead and only the application moves ulUrtDmaRxOut
+// and uiUrtDmaRxTail.
+static unsigned char ucUrtDmaRxBuf[URT_DMA_RX_SIZE];
+static unsigned long ulUrtDmaRxFrm[URT_DMA_RX_FRAMES];     // end count of each waiting frame
+static ADI_TIMER_TypeDef *pUrtDmaTmr = 0;
+static volatile unsigned long ulUrtDmaRxHalves = 0;       // halves filled
+static unsigned long ulUrtDmaRxLast = 0;                  // count at the previous timer period
+static unsigned long ulUrtDmaRxEnd = 0;                   // end of the last frame
+static volatile unsigned int uiUrtDmaRxHead = 0;
+static volatile unsigned int uiUrtDmaRxTail = 0;
+static unsigned long ulUrtDmaRxOut = 0;                   // bytes released by UrtDmaRxDone()
+static unsigned long ulUrtDmaRxOvr = 0;
+
+// Continuous SPI1 slave reception, see SpiDmaRxCfg(). Same scheme as the UART: only
+// SpiDmaRxIsr() moves ulSpiDmaRxHalves, only SpiDmaRxCsIsr() moves uiSpiDmaRxHead.
+static unsigned char ucSpiDmaRxBuf[SPI_DMA_RX_SIZE];
+static unsigned long ulSpiDmaRxFrm[SPI_DMA_RX_FRAMES];     // end count of each waiting frame
+static int iSpiDmaRxFrame = 0;                            // fixed frame length, 0 frames ended by CS
+static volatile unsigned long ulSpiDmaRxHalves = 0;
+static unsigned long ulSpiDmaRxEnd = 0;
+static volatile unsigned int uiSpiDmaRxHead = 0;
+static volatile unsigned int uiSpiDmaRxTail = 0;
+static unsigned long ulSpiDmaRxOut = 0;
+static unsigned long ulSpiDmaRxOvr = 0;
+static int iSpiDmaRxSkip = 0;                            // drop the next CS frame, its start was overwritten
+
 
 
 /**
@@ -925,6 +963,417 @@ int DacDmaWriteSetup(int iType, int iCfg, int iNumVals, int *pucTX_DMA)
 return 1;	
 }
 
-/**@}*/
+/**
+   @brief int UrtDmaRxCfg(ADI_UART_TypeDef *pPort, ADI_TIMER_TypeDef *pTmr, int iIdle)
+         ==========Starts circular UART reception with DMA and idle line detection.
+   @param pPort :{pADI_UART}
+    - Set to pADI_UART. The UART must already be set up with UrtCfg().
+   @param pTmr :{pADI_TM0,pADI_TM1}
+    - Timer used for the idle line detection. Its interrupt handler must call
+      UrtDmaRxTmrIsr() and its interrupt must be enabled in the NVIC.
+   @param iIdle :{1-1000000}
+    - Idle time in us. A frame ends when no byte has been received for iIdle to 2*iIdle.
+      A few character times is usual, 1000000*30/baud for 3 characters.
+   @return 1 if successful, 0 if the timer is busy.
+   @note
+    - DmaBase() must have been called. DMA_UART_RX_Int_Handler must call UrtDmaRxIsr()
+      and DMA_UART_RX_IRQn must be enabled in the NVIC.
+    - The UARTRX_C primary and alternate structures run in ping-pong mode, each into one
+      half of a URT_DMA_RX_SIZE byte ring. The CPU is interrupted once per half and once
+      per timer period, instead of once per byte.
+    - The timer is clocked by PCLK/16, or PCLK/256 if the period does not fit in 16 bits.
+**/
+int UrtDmaRxCfg(ADI_UART_TypeDef *pPort, ADI_TIMER_TypeDef *pTmr, int iIdle)
+{
+   unsigned long ulLd, ulTick;
+   int iScale = TCON_PRE_DIV16;
+
+   if (pTmr->STA & TSTA_CON)
+      return 0;
+   // PCLK/16 counts for iIdle us, in whole ms and the rest in us: no product
+   // exceeds 32 bits over the whole iIdle range
+   ulTick = (unsigned long)ClkFreq(CLK_FREQ_CORE)/16;
+   ulLd = ulTick*((unsigned long)iIdle/1000)/1000 + ulTick*((unsigned long)iIdle%1000)/1000000;
+   if (ulLd > 0xFFFF)
+   {
+      iScale = TCON_PRE_DIV256;
+      ulLd /= 16;
+   }
+   if (ulLd > 0xFFFF)
+      ulLd = 0xFFFF;
+   if (ulLd == 0)
+      ulLd = 1;
+   pUrtDmaTmr = pTmr;
+   ulUrtDmaRxHalves = 0;
+   ulUrtDmaRxLast = 0;
+   ulUrtDmaRxEnd = 0;
+   ulUrtDmaRxOut = 0;
+   uiUrtDmaRxHead = 0;
+   uiUrtDmaRxTail = 0;
+
+   // Both halves armed in ping-pong mode, primary first
+   DmaPeripheralStructSetup(UARTRX_C,DMA_DSTINC_BYTE|DMA_SRCINC_NO|DMA_SIZE_BYTE);
+   DmaPeripheralStructSetup(UARTRX_C+ALTERNATE,DMA_DSTINC_BYTE|DMA_SRCINC_NO|DMA_SIZE_BYTE);
+   DmaStructPtrInSetup(UARTRX_C,URT_DMA_RX_SIZE/2,ucUrtDmaRxBuf);
+   DmaStructPtrInSetup(UARTRX_C+ALTERNATE,URT_DMA_RX_SIZE/2,ucUrtDmaRxBuf+URT_DMA_RX_SIZE/2);
+   DmaCycleCntCtrl(UARTRX_C,URT_DMA_RX_SIZE/2,DMA_PING);
+   DmaCycleCntCtrl(UARTRX_C+ALTERNATE,URT_DMA_RX_SIZE/2,DMA_PING);
+   DmaClr(DMARMSKCLR_UARTRX,0,DMAALTCLR_UARTRX,0);
+   DmaSet(0,DMAENSET_UARTRX,0,0);
+   pPort->COMIEN |= COMIEN_EDMAR;                        // UART requests DMA for each received byte
+
+   // Periodic count down, polls the DMA progress each period
+   pTmr->LD = ulLd;
+   pTmr->CON = TCON_CLK_PCLK|iScale|TCON_MOD_PERIODIC|TCON_ENABLE;
+   return 1;
+}
+
+// Number of bytes received since UrtDmaRxCfg(), from the progress of the active structure
+static unsigned long UrtDmaRxCount(void)
+{
+   unsigned long ulHalves = ulUrtDmaRxHalves;
+   int iAlt = (pADI_DMA->DMAALTSET & DMAALTSET_UARTRX) ? 1 : 0;
+   DmaDesc *pDesc = Dma_GetDescriptor(UARTRX_C-1,iAlt);
+   unsigned long ulDone;
+
+   if (iAlt != (int)(ulHalves & 1))                     // a half is complete, UrtDmaRxIsr() not run yet
+      ulHalves++;
+   if (pDesc->ctrlCfg.Bits.cycle_ctrl == DMA_STOP)       // both halves full, reception stopped
+      ulDone = URT_DMA_RX_SIZE/2;
+   else
+      ulDone = URT_DMA_RX_SIZE/2 - 1 - pDesc->ctrlCfg.Bits.n_minus_1;
+   return ulHalves*(URT_DMA_RX_SIZE/2) + ulDone;
+}
+
+/**
+   @brief int UrtDmaRxIsr(void)
+         ==========Re-arms the half of the ring the DMA has just filled.
+   @return 1.
+   @note
+    - Call from DMA_UART_RX_Int_Handler.
+    - The half is re-armed before the DMA has filled the other half, so reception only
+      stops if this interrupt is held off for URT_DMA_RX_SIZE/2 character times. Bytes not
+      read by then are overwritten, which UrtDmaRxSpan() and UrtDmaRxDone() report.
+**/
+int UrtDmaRxIsr(void)
+{
+   if (ulUrtDmaRxHalves & 1)
+      DmaCycleCntCtrl(UARTRX_C+ALTERNATE,URT_DMA_RX_SIZE/2,DMA_PING);
+   else
+      DmaCycleCntCtrl(UARTRX_C,URT_DMA_RX_SIZE/2,DMA_PING);
+   ulUrtDmaRxHalves++;
+   return 1;
+}
+
+/**
+   @brief int UrtDmaRxTmrIsr(void)
+         ==========Ends the current frame if no byte was received during the last period.
+   @return 1 if a frame was ended, 0 otherwise.
+   @note
+    - Call from the interrupt handler of the timer given to UrtDmaRxCfg().
+    - If URT_DMA_RX_FRAMES frames are waiting, the frame is not ended yet and is
+      joined to the following bytes.
+**/
+int UrtDmaRxTmrIsr(void)
+{
+   unsigned long ulIn = UrtDmaRxCount();
+   int iEnd = 0;
+
+   pUrtDmaTmr->CLRI = TSTA_TMOUT;
+   if ((ulIn == ulUrtDmaRxLast) && (ulIn != ulUrtDmaRxEnd)
+      && (uiUrtDmaRxHead - uiUrtDmaRxTail < URT_DMA_RX_FRAMES))
+   {
+      ulUrtDmaRxFrm[uiUrtDmaRxHead & (URT_DMA_RX_FRAMES-1)] = ulIn;
+      uiUrtDmaRxHead++;
+      ulUrtDmaRxEnd = ulIn;
+      iEnd = 1;
+   }
+   ulUrtDmaRxLast = ulIn;
+   return iEnd;
+}
+
+/**
+   @brief int UrtDmaRxSpan(unsigned char **ppBuf, int *piEnd)
+         ==========Gets the next received bytes in place, without copying.
+   @param ppBuf :{}
+    - Set to the first byte of the span, inside the ring.
+   @param piEnd :{}
+    - Set to 1 if the span ends a frame, 0 if the frame wraps around the end of the ring
+      and continues in the next span.
+   @return Number of bytes in the span, 0 if no complete frame is waiting.
+   @note
+    - Call UrtDmaRxDone() when the span has been used. The same span is returned until then.
+    - If the DMA has overwritten unread bytes, the waiting frames are dropped and
+      counted by UrtDmaRxOvr().
+**/
+int UrtDmaRxSpan(unsigned char **ppBuf, int *piEnd)
+{
+   unsigned int uiHead = uiUrtDmaRxHead;
+   unsigned long ulEnd;
+   int iIdx;
+   int iLen;
+
+   if (uiHead == uiUrtDmaRxTail)
+      return 0;
+   if (UrtDmaRxCount() - ulUrtDmaRxOut > URT_DMA_RX_SIZE)
+   {
+      ulUrtDmaRxOut = ulUrtDmaRxFrm[(uiHead-1) & (URT_DMA_RX_FRAMES-1)];
+      uiUrtDmaRxTail = uiHead;
+      ulUrtDmaRxOvr++;
+      return 0;
+   }
+   ulEnd = ulUrtDmaRxFrm[uiUrtDmaRxTail & (URT_DMA_RX_FRAMES-1)];
+   iIdx = (int)(ulUrtDmaRxOut & (URT_DMA_RX_SIZE-1));
+   iLen = (int)(ulEnd - ulUrtDmaRxOut);
+   *piEnd = 1;
+   if (iIdx + iLen > URT_DMA_RX_SIZE)
+   {
+      iLen = URT_DMA_RX_SIZE - iIdx;
+      *piEnd = 0;
+   }
+   *ppBuf = ucUrtDmaRxBuf + iIdx;
+   return iLen;
+}
+
+/**
+   @brief int UrtDmaRxDone(int iLen)
+         ==========Releases bytes returned by UrtDmaRxSpan().
+   @param iLen :{}
+    - Number of bytes used, normally the length returned by UrtDmaRxSpan().
+   @return 1 if the bytes were still intact, 0 if the DMA overwrote them while they were used.
+**/
+int UrtDmaRxDone(int iLen)
+{
+   unsigned long ulOut = ulUrtDmaRxOut;
+
+   ulUrtDmaRxOut += iLen;
+   if ((uiUrtDmaRxTail != uiUrtDmaRxHead)
+      && (ulUrtDmaRxOut == ulUrtDmaRxFrm[uiUrtDmaRxTail & (URT_DMA_RX_FRAMES-1)]))
+      uiUrtDmaRxTail++;
+   if (UrtDmaRxCount() - ulOut > URT_DMA_RX_SIZE)
+   {
+      ulUrtDmaRxOvr++;
+      return 0;
+   }
+   return 1;
+}
+
+/**
+   @brief int UrtDmaRxOvr(void)
+         ==========Reads the number of ring overruns.
+   @return Number of times unread bytes were overwritten by the DMA.
+**/
+int UrtDmaRxOvr(void)
+{
+   return (int)ulUrtDmaRxOvr;
+}
+
+/**
+   @brief int SpiDmaRxCfg(ADI_SPI_TypeDef *pSPI, int iFrame)
+         ==========Starts continuous SPI1 slave reception with DMA into a ring.
+   @param pSPI :{pADI_SPI1}
+    - Set to pADI_SPI1. Only SPI1 has DMA. It must already be set up with SpiCfg() in
+      Slave mode.
+   @param iFrame :{0,1-SPI_DMA_RX_SIZE/2}
+    - Length of every frame in bytes, or 0 for frames of any length ended by
+      SpiDmaRxCsIsr() when the master releases CS.
+   @return 1.
+   @note
+    - DmaBase() must have been called. DMA_SPI1_RX_Int_Handler must call SpiDmaRxIsr()
+      and DMA_SPI1_RX_IRQn must be enabled in the NVIC.
+    - The SPI1RX_C primary and alternate structures run in ping-pong mode, each into one
+      half of a SPI_DMA_RX_SIZE byte ring, so the DMA never waits for the application
+      to re-arm it between frames.
+**/
+int SpiDmaRxCfg(ADI_SPI_TypeDef *pSPI, int iFrame)
+{
+   iSpiDmaRxFrame = iFrame;
+   ulSpiDmaRxHalves = 0;
+   ulSpiDmaRxEnd = 0;
+   ulSpiDmaRxOut = 0;
+   uiSpiDmaRxHead = 0;
+   uiSpiDmaRxTail = 0;
+   iSpiDmaRxSkip = 0;
 
+   // Both halves armed in ping-pong mode, primary first
+   DmaPeripheralStructSetup(SPI1RX_C,DMA_DSTINC_BYTE|DMA_SRCINC_NO|DMA_SIZE_BYTE);
+   DmaPeripheralStructSetup(SPI1RX_C+ALTERNATE,DMA_DSTINC_BYTE|DMA_SRCINC_NO|DMA_SIZE_BYTE);
+   DmaStructPtrInSetup(SPI1RX_C,SPI_DMA_RX_SIZE/2,ucSpiDmaRxBuf);
+   DmaStructPtrInSetup(SPI1RX_C+ALTERNATE,SPI_DMA_RX_SIZE/2,ucSpiDmaRxBuf+SPI_DMA_RX_SIZE/2);
+   DmaCycleCntCtrl(SPI1RX_C,SPI_DMA_RX_SIZE/2,DMA_PING);
+   DmaCycleCntCtrl(SPI1RX_C+ALTERNATE,SPI_DMA_RX_SIZE/2,DMA_PING);
+   DmaClr(DMARMSKCLR_SPI1RX,0,DMAALTCLR_SPI1RX,0);
+   DmaSet(0,DMAENSET_SPI1RX,0,0);
+   pSPI->SPIDMA = SPIDMA_IENRXDMA_EN|SPIDMA_ENABLE_EN;   // SPI1 requests DMA for each received byte
+   return 1;
+}
+
+// Number of bytes received since SpiDmaRxCfg(), from the progress of the active structure
+static unsigned long SpiDmaRxCount(void)
+{
+   unsigned long ulHalves = ulSpiDmaRxHalves;
+   int iAlt = (pADI_DMA->DMAALTSET & DMAALTSET_SPI1RX) ? 1 : 0;
+   DmaDesc *pDesc = Dma_GetDescriptor(SPI1RX_C-1,iAlt);
+   unsigned long ulDone;
+
+   if (iAlt != (int)(ulHalves & 1))                     // a half is complete, SpiDmaRxIsr() not run yet
+      ulHalves++;
+   if (pDesc->ctrlCfg.Bits.cycle_ctrl == DMA_STOP)       // both halves full, reception stopped
+      ulDone = SPI_DMA_RX_SIZE/2;
+   else
+      ulDone = SPI_DMA_RX_SIZE/2 - 1 - pDesc->ctrlCfg.Bits.n_minus_1;
+   return ulHalves*(SPI_DMA_RX_SIZE/2) + ulDone;
+}
+
+/**
+   @brief int SpiDmaRxIsr(void)
+         ==========Re-arms the half of the ring the DMA has just filled.
+   @return 1.
+   @note
+    - Call from DMA_SPI1_RX_Int_Handler.
+    - Reception only stops if this interrupt is held off while the master sends
+      SPI_DMA_RX_SIZE/2 bytes. Bytes not read by then are overwritten, which
+      SpiDmaRxSpan() and SpiDmaRxDone() count in SpiDmaRxOvr().
+**/
+int SpiDmaRxIsr(void)
+{
+   if (ulSpiDmaRxHalves & 1)
+      DmaCycleCntCtrl(SPI1RX_C+ALTERNATE,SPI_DMA_RX_SIZE/2,DMA_PING);
+   else
+      DmaCycleCntCtrl(SPI1RX_C,SPI_DMA_RX_SIZE/2,DMA_PING);
+   ulSpiDmaRxHalves++;
+   return 1;
+}
+
+/**
+   @brief int SpiDmaRxCsIsr(void)
+         ==========Ends the current frame. Call when CS goes high, for frames of any length.
+   @return 1 if a frame was ended, 0 if no byte was received since the last one.
+   @note
+    - Call from the external interrupt handler on the rising edge of CS, with
+      SpiDmaRxCfg() iFrame = 0.
+    - If SPI_DMA_RX_FRAMES frames are waiting, the frame is not ended yet and is
+      joined to the following bytes.
+**/
+int SpiDmaRxCsIsr(void)
+{
+   unsigned long ulIn = SpiDmaRxCount();
 
+   if ((ulIn == ulSpiDmaRxEnd) || (uiSpiDmaRxHead - uiSpiDmaRxTail >= SPI_DMA_RX_FRAMES))
+      return 0;
+   ulSpiDmaRxFrm[uiSpiDmaRxHead & (SPI_DMA_RX_FRAMES-1)] = ulIn;
+   uiSpiDmaRxHead++;
+   ulSpiDmaRxEnd = ulIn;
+   return 1;
+}
+
+/**
+   @brief int SpiDmaRxSpan(unsigned char **ppBuf, int *piEnd)
+         ==========Gets the next complete frame in place, without copying.
+   @param ppBuf :{}
+    - Set to the first byte of the span, inside the ring.
+   @param piEnd :{}
+    - Set to 1 if the span ends a frame, 0 if the frame wraps around the end of the ring
+      and continues in the next span.
+   @return Number of bytes in the span, 0 if no complete frame is waiting.
+   @note
+    - Call SpiDmaRxDone() when the span has been used. The same span is returned until then.
+    - If the DMA has overwritten unread bytes, the waiting frames are dropped and
+      counted by SpiDmaRxOvr().
+**/
+int SpiDmaRxSpan(unsigned char **ppBuf, int *piEnd)
+{
+   unsigned long ulIn = SpiDmaRxCount();
+   unsigned long ulEnd;
+   int iIdx;
+   int iLen;
+
+   if (ulIn - ulSpiDmaRxOut > SPI_DMA_RX_SIZE)
+   {
+      if (iSpiDmaRxFrame)
+         ulSpiDmaRxOut = ulIn - ulIn % iSpiDmaRxFrame;
+      else
+      {
+         unsigned int uiHead = uiSpiDmaRxHead;
+         unsigned long ulLast = ulSpiDmaRxFrm[(uiHead-1) & (SPI_DMA_RX_FRAMES-1)];
+
+         // Drop the waiting frames. If the frame being received has lost its start
+         // too, or none has ended yet, drop it as well when its CS edge comes.
+         uiSpiDmaRxTail = uiHead;
+         if ((uiHead != 0) && (ulIn - ulLast <= SPI_DMA_RX_SIZE))
+            ulSpiDmaRxOut = ulLast;
+         else
+         {
+            ulSpiDmaRxOut = ulIn;
+            iSpiDmaRxSkip = 1;
+         }
+      }
+      ulSpiDmaRxOvr++;
+      return 0;
+   }
+   if (iSpiDmaRxFrame)
+   {
+      // frames are counted from the start of reception
+      ulEnd = ulSpiDmaRxOut - ulSpiDmaRxOut % iSpiDmaRxFrame + iSpiDmaRxFrame;
+      if (ulEnd > ulIn)
+         return 0;
+   }
+   else
+   {
+      if (uiSpiDmaRxHead == uiSpiDmaRxTail)
+         return 0;
+      ulEnd = ulSpiDmaRxFrm[uiSpiDmaRxTail & (SPI_DMA_RX_FRAMES-1)];
+      if (iSpiDmaRxSkip)                                 // tail of a frame cut by an overrun
+      {
+         iSpiDmaRxSkip = 0;
+         ulSpiDmaRxOut = ulEnd;
+         uiSpiDmaRxTail++;
+         return 0;
+      }
+   }
+   iIdx = (int)(ulSpiDmaRxOut & (SPI_DMA_RX_SIZE-1));
+   iLen = (int)(ulEnd - ulSpiDmaRxOut);
+   *piEnd = 1;
+   if (iIdx + iLen > SPI_DMA_RX_SIZE)
+   {
+      iLen = SPI_DMA_RX_SIZE - iIdx;
+      *piEnd = 0;
+   }
+   *ppBuf = ucSpiDmaRxBuf + iIdx;
+   return iLen;
+}
+
+/**
+   @brief int SpiDmaRxDone(int iLen)
+         ==========Releases bytes returned by SpiDmaRxSpan().
+   @param iLen :{}
+    - Number of bytes used, normally the length returned by SpiDmaRxSpan().
+   @return 1 if the bytes were still intact, 0 if the DMA overwrote them while they were used.
+**/
+int SpiDmaRxDone(int iLen)
+{
+   unsigned long ulOut = ulSpiDmaRxOut;
+
+   ulSpiDmaRxOut += iLen;
+   if (!iSpiDmaRxFrame && (uiSpiDmaRxTail != uiSpiDmaRxHead)
+      && (ulSpiDmaRxOut == ulSpiDmaRxFrm[uiSpiDmaRxTail & (SPI_DMA_RX_FRAMES-1)]))
+      uiSpiDmaRxTail++;
+   if (SpiDmaRxCount() - ulOut > SPI_DMA_RX_SIZE)
+   {
+      ulSpiDmaRxOvr++;
+      return 0;
+   }
+   return 1;
+}
+
+/**
+   @brief int SpiDmaRxOvr(void)
+         ==========Reads the number of ring overruns.
+   @return Number of times unread bytes were overwritten by the DMA.
+**/
+int SpiDmaRxOvr(void)
+{
+   return (int)ulSpiDmaRxOvr;
+}
+
+/**@}*/
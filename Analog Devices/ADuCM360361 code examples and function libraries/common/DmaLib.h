@@ -4,10 +4,21 @@
    @brief   Set of DMA peripheral functions.
    - DmaBase(), DmaSet(), DmaClr(), DmaSta() and DmaErr() apply to all DMA channels together.
    - DmaOn() apply for each channel separately. 
+   - UrtDmaRxCfg() receives from the UART into a ring, frames are read in place with
+     UrtDmaRxSpan() and UrtDmaRxDone().
+   - SpiDmaRxCfg() receives as SPI1 slave into a ring, frames are read in place with
+     SpiDmaRxSpan() and SpiDmaRxDone().
    
-   @version    V0.1
+   @version    V0.3
    @author     ADI
-   @date       October 2012
+   @date       October 2026
+
+   @par Revision History:
+   - V0.1, October 2012: initial version. 
+   - V0.2, October 2026: Added UrtDmaRxCfg(), UrtDmaRxIsr(), UrtDmaRxTmrIsr(), UrtDmaRxSpan(),
+     UrtDmaRxDone() and UrtDmaRxOvr().
+   - V0.3, October 2026: Added SpiDmaRxCfg(), SpiDmaRxIsr(), SpiDmaRxCsIsr(), SpiDmaRxSpan(),
+     SpiDmaRxDone() and SpiDmaRxOvr().
 
 
 All files for ADuCM360/361 provided by ADI, including this file, are
@@ -65,6 +76,41 @@ extern int DmaPeripheralStructSetup(int iChan, int iCfg);
 extern int DmaStructPtrOutSetup(int iChan, int iNumVals, unsigned char *pucTX_DMA);
 extern int DmaStructPtrInSetup(int iChan, int iNumVals, unsigned char *pucRX_DMA);
 extern int DmaCycleCntCtrl(unsigned int iChan, int iNumx, int iCfg);
+
+extern int UrtDmaRxCfg(ADI_UART_TypeDef *pPort, ADI_TIMER_TypeDef *pTmr, int iIdle);
+extern int UrtDmaRxIsr(void);
+extern int UrtDmaRxTmrIsr(void);
+extern int UrtDmaRxSpan(unsigned char **ppBuf, int *piEnd);
+extern int UrtDmaRxDone(int iLen);
+extern int UrtDmaRxOvr(void);
+
+extern int SpiDmaRxCfg(ADI_SPI_TypeDef *pSPI, int iFrame);
+extern int SpiDmaRxIsr(void);
+extern int SpiDmaRxCsIsr(void);
+extern int SpiDmaRxSpan(unsigned char **ppBuf, int *piEnd);
+extern int SpiDmaRxDone(int iLen);
+extern int SpiDmaRxOvr(void);
+
+// UrtDmaRxCfg() ring size in bytes, a power of 2 up to 2048. Each DMA structure fills one half.
+#ifndef URT_DMA_RX_SIZE
+#define URT_DMA_RX_SIZE    256
+#endif
+
+// Complete frames UrtDmaRxTmrIsr() can queue, a power of 2
+#ifndef URT_DMA_RX_FRAMES
+#define URT_DMA_RX_FRAMES  8
+#endif
+
+// SpiDmaRxCfg() ring size in bytes, a power of 2 up to 2048. Each DMA structure fills one half.
+#ifndef SPI_DMA_RX_SIZE
+#define SPI_DMA_RX_SIZE    256
+#endif
+
+// Frames ended by SpiDmaRxCsIsr() that can wait, a power of 2
+#ifndef SPI_DMA_RX_FRAMES
+#define SPI_DMA_RX_FRAMES  8
+#endif
+
 //DMA channel numbers.
 #define	SPI1TX_C	1
 #define	SPI1RX_C	2
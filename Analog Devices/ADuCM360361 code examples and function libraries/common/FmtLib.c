@@ -0,0 +1,154 @@
+/**
+ *****************************************************************************
+   @addtogroup fmt
+   @{
+   @file     FmtLib.c
+   @brief    Set of number formatting functions, a small replacement for sprintf().
+   - Copy text with FmtStr().
+   - Format integers and fixed point values with FmtFix().
+   - Format floats with a fixed number of decimals with FmtFlt().
+   Each function writes at the given position in a buffer and returns the number of
+   characters written, so a line is built with successive calls and its length is
+   known without strlen(). The line can then be queued with UrtWrite().
+   The functions do not depend on the C library, so printf and the floating point
+   conversion code are not linked in.
+
+   @version  V0.1
+   @date     October 2026
+
+All files for ADuCM360 provided by ADI, including this file, are
+provided  as is without warranty of any kind, either expressed or implied.
+The user assumes any and all risk from the use of this code.
+It is the responsibility of the person integrating this code into an application
+to ensure that the resulting application performs as required and is safe.
+
+**/
+
+#include "FmtLib.h"
+
+static const unsigned long ulFmtScale[7] = {1, 10, 100, 1000, 10000, 100000, 1000000};
+
+/**
+	@brief int FmtStr(char *szBuf, const char *szStr)
+			==========Copy a string.
+	@param szBuf :{}	\n
+		Destination, terminated with 0.
+	@param szStr :{}	\n
+		String to copy.
+	@return Number of characters written, not counting the terminating 0.
+**/
+
+int FmtStr(char *szBuf, const char *szStr)
+	{
+	int iLen = 0;
+
+	while (szStr[iLen])
+		{
+		szBuf[iLen] = szStr[iLen];
+		iLen++;
+		}
+	szBuf[iLen] = 0;
+	return iLen;
+	}
+
+/**
+	@brief int FmtFix(char *szBuf, long lVal, int iDec)
+			==========Format a fixed point value.
+	@param szBuf :{}	\n
+		Destination, terminated with 0. Up to 13 characters for a 32 bit long.
+	@param lVal :{}	\n
+		Value in units of 10^-iDec, for example millivolts with iDec = 3 to print volts.
+	@param iDec :{0-9}	\n
+		Number of decimals. 0 to print lVal as an integer.
+	@return Number of characters written, not counting the terminating 0.
+	@note
+		- A '-' is written for negative values, no sign for positive values.
+		- At least one digit is written before the decimal point, so 5 with iDec = 3 gives 0.005.
+**/
+
+int FmtFix(char *szBuf, long lVal, int iDec)
+	{
+	char szDig[20];
+	unsigned long ulVal;
+	int iLen = 0;
+	int iDig = 0;
+
+	if (lVal < 0)
+		{
+		szBuf[iLen++] = '-';
+		ulVal = 0UL - (unsigned long)lVal;
+		}
+	else
+		ulVal = (unsigned long)lVal;
+	do									// digits in reverse order
+		{
+		szDig[iDig++] = (char)('0' + ulVal%10);
+		ulVal /= 10;
+		}
+	while ((ulVal != 0) || (iDig <= iDec));
+	while (iDig)
+		{
+		if (iDig == iDec)
+			szBuf[iLen++] = '.';
+		szBuf[iLen++] = szDig[--iDig];
+		}
+	szBuf[iLen] = 0;
+	return iLen;
+	}
+
+/**
+	@brief int FmtFlt(char *szBuf, float fVal, int iDec)
+			==========Format a float with a fixed number of decimals.
+	@param szBuf :{}	\n
+		Destination, terminated with 0. Up to 13 characters.
+	@param fVal :{}	\n
+		Value to format. Rounded to the nearest, halves away from zero.
+	@param iDec :{0-6}	\n
+		Number of decimals, as %.*f.
+	@return Number of characters written, not counting the terminating 0.
+	@note
+		- fVal*10^iDec is limited to +/-2147483647, larger values are saturated.
+		- The integer part is split off before scaling, so the decimals are rounded
+		  from the exact fraction and match sprintf() except for values within a few
+		  float ulps of a rounding tie.
+		- NaN is written as "nan". Values that round to 0 are written without a sign.
+**/
+
+int FmtFlt(char *szBuf, float fVal, int iDec)
+	{
+	unsigned long ulInt;
+	unsigned long ulFrac;
+	unsigned long ulVal;
+	float fFrac;
+	int iLen = 0;
+
+	if (fVal != fVal)
+		return FmtStr(szBuf, "nan");
+	if (iDec < 0)
+		iDec = 0;
+	if (iDec > 6)
+		iDec = 6;
+	if (fVal < 0.0f)
+		{
+		fVal = -fVal;
+		szBuf[iLen++] = '-';
+		}
+	if (fVal >= 2147483647.0f/(float)ulFmtScale[iDec])
+		ulVal = 2147483647UL;
+	else
+		{
+		ulInt = (unsigned long)fVal;
+		fFrac = (fVal - (float)ulInt)*(float)ulFmtScale[iDec];	// the subtraction is exact
+		ulFrac = (unsigned long)fFrac;
+		if (fFrac - (float)ulFrac >= 0.5f)
+			ulFrac++;
+		ulVal = ulInt*ulFmtScale[iDec] + ulFrac;
+		if (ulVal > 2147483647UL)
+			ulVal = 2147483647UL;
+		}
+	if (ulVal == 0)
+		iLen = 0;						// no sign for -0
+	return iLen + FmtFix(szBuf + iLen, (long)ulVal, iDec);
+	}
+
+   /**@}*/
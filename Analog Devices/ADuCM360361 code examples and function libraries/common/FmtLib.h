@@ -0,0 +1,22 @@
+/**
+ *****************************************************************************
+   @file     FmtLib.h
+   @brief    Set of number formatting functions, a small replacement for sprintf().
+   - Copy text with FmtStr().
+   - Format integers and fixed point values with FmtFix().
+   - Format floats with a fixed number of decimals with FmtFlt().
+
+   @version  V0.1
+   @date     October 2026
+
+All files for ADuCM360 provided by ADI, including this file, are
+provided  as is without warranty of any kind, either expressed or implied.
+The user assumes any and all risk from the use of this code.
+It is the responsibility of the person integrating this code into an application
+to ensure that the resulting application performs as required and is safe.
+
+**/
+
+extern int FmtStr(char *szBuf, const char *szStr);
+extern int FmtFix(char *szBuf, long lVal, int iDec);
+extern int FmtFlt(char *szBuf, float fVal, int iDec);
@@ -0,0 +1,424 @@
+/**
+ *****************************************************************************
+   @addtogroup mbs
+   @{
+   @file     MbsLib.c
+   @brief    Modbus RTU slave on the UART.
+   - Configure the UART with UrtCfg() and the slave with MbsCfg(). MbsCfg() sets a
+     general purpose timer to the 3.5 character time that ends a frame.
+   - Give the holding and input register maps with MbsMapCfg(). The maps point at
+     the application variables, a read encodes them straight into the response.
+   - Call MbsRxIsr() from UART_Int_Handler for each received byte. Each byte
+     restarts the frame timer.
+   - Call MbsTmrIsr() from the timer interrupt handler. The frame is checked and
+     answered from the interrupt so the turnaround does not depend on the main loop.
+   Supported functions: 03 read holding registers, 04 read input registers,
+   06 write single register and 16 write multiple registers. Other functions are
+   answered with exception 01, bad addresses with 02 and bad counts with 03.
+   Responses are queued with UrtWrite(), so UrtWriteIsr() must also be called
+   from UART_Int_Handler.
+
+   @version  V0.1
+   @date     October 2026
+
+All files for ADuCM360 provided by ADI, including this file, are
+provided  as is without warranty of any kind, either expressed or implied.
+The user assumes any and all risk from the use of this code.
+It is the responsibility of the person integrating this code into an application
+to ensure that the resulting application performs as required and is safe.
+
+**/
+
+#include "MbsLib.h"
+#include <ADuCM360.h>
+#include "UrtLib.h"
+#include "GptLib.h"
+#include "ClkLib.h"
+
+// CRC-16/MODBUS, reflected polynomial 0xA001, one byte at a time
+static const unsigned short usMbsCrcTbl[256] = {
+	0x0000, 0xC0C1, 0xC181, 0x0140, 0xC301, 0x03C0, 0x0280, 0xC241,
+	0xC601, 0x06C0, 0x0780, 0xC741, 0x0500, 0xC5C1, 0xC481, 0x0440,
+	0xCC01, 0x0CC0, 0x0D80, 0xCD41, 0x0F00, 0xCFC1, 0xCE81, 0x0E40,
+	0x0A00, 0xCAC1, 0xCB81, 0x0B40, 0xC901, 0x09C0, 0x0880, 0xC841,
+	0xD801, 0x18C0, 0x1980, 0xD941, 0x1B00, 0xDBC1, 0xDA81, 0x1A40,
+	0x1E00, 0xDEC1, 0xDF81, 0x1F40, 0xDD01, 0x1DC0, 0x1C80, 0xDC41,
+	0x1400, 0xD4C1, 0xD581, 0x1540, 0xD701, 0x17C0, 0x1680, 0xD641,
+	0xD201, 0x12C0, 0x1380, 0xD341, 0x1100, 0xD1C1, 0xD081, 0x1040,
+	0xF001, 0x30C0, 0x3180, 0xF141, 0x3300, 0xF3C1, 0xF281, 0x3240,
+	0x3600, 0xF6C1, 0xF781, 0x3740, 0xF501, 0x35C0, 0x3480, 0xF441,
+	0x3C00, 0xFCC1, 0xFD81, 0x3D40, 0xFF01, 0x3FC0, 0x3E80, 0xFE41,
+	0xFA01, 0x3AC0, 0x3B80, 0xFB41, 0x3900, 0xF9C1, 0xF881, 0x3840,
+	0x2800, 0xE8C1, 0xE981, 0x2940, 0xEB01, 0x2BC0, 0x2A80, 0xEA41,
+	0xEE01, 0x2EC0, 0x2F80, 0xEF41, 0x2D00, 0xEDC1, 0xEC81, 0x2C40,
+	0xE401, 0x24C0, 0x2580, 0xE541, 0x2700, 0xE7C1, 0xE681, 0x2640,
+	0x2200, 0xE2C1, 0xE381, 0x2340, 0xE101, 0x21C0, 0x2080, 0xE041,
+	0xA001, 0x60C0, 0x6180, 0xA141, 0x6300, 0xA3C1, 0xA281, 0x6240,
+	0x6600, 0xA6C1, 0xA781, 0x6740, 0xA501, 0x65C0, 0x6480, 0xA441,
+	0x6C00, 0xACC1, 0xAD81, 0x6D40, 0xAF01, 0x6FC0, 0x6E80, 0xAE41,
+	0xAA01, 0x6AC0, 0x6B80, 0xAB41, 0x6900, 0xA9C1, 0xA881, 0x6840,
+	0x7800, 0xB8C1, 0xB981, 0x7940, 0xBB01, 0x7BC0, 0x7A80, 0xBA41,
+	0xBE01, 0x7EC0, 0x7F80, 0xBF41, 0x7D00, 0xBDC1, 0xBC81, 0x7C40,
+	0xB401, 0x74C0, 0x7580, 0xB541, 0x7700, 0xB7C1, 0xB681, 0x7640,
+	0x7200, 0xB2C1, 0xB381, 0x7340, 0xB101, 0x71C0, 0x7080, 0xB041,
+	0x5000, 0x90C1, 0x9181, 0x5140, 0x9301, 0x53C0, 0x5280, 0x9241,
+	0x9601, 0x56C0, 0x5780, 0x9741, 0x5500, 0x95C1, 0x9481, 0x5440,
+	0x9C01, 0x5CC0, 0x5D80, 0x9D41, 0x5F00, 0x9FC1, 0x9E81, 0x5E40,
+	0x5A00, 0x9AC1, 0x9B81, 0x5B40, 0x9901, 0x59C0, 0x5880, 0x9841,
+	0x8801, 0x48C0, 0x4980, 0x8941, 0x4B00, 0x8BC1, 0x8A81, 0x4A40,
+	0x4E00, 0x8EC1, 0x8F81, 0x4F40, 0x8D01, 0x4DC0, 0x4C80, 0x8C41,
+	0x4400, 0x84C1, 0x8581, 0x4540, 0x8701, 0x47C0, 0x4680, 0x8641,
+	0x8201, 0x42C0, 0x4380, 0x8341, 0x4100, 0x81C1, 0x8081, 0x4040};
+
+static ADI_UART_TypeDef *pMbsPort = 0;
+static ADI_TIMER_TypeDef *pMbsTmr = 0;
+static unsigned char ucMbsAddr = 1;
+static const MbsMap *pMbsHold = 0;
+static const MbsMap *pMbsInput = 0;
+static int iMbsHold = 0;
+static int iMbsInput = 0;
+static unsigned char ucMbsRx[MBS_FRAME_MAX];
+static volatile int iMbsRxLen = 0;
+static volatile unsigned char ucMbsOvr = 0;
+static unsigned char ucMbsTx[MBS_FRAME_MAX];
+static unsigned long ulMbsSta[4] = {0, 0, 0, 0};
+
+/**
+	@brief int MbsCfg(ADI_UART_TypeDef *pPort, ADI_TIMER_TypeDef *pTmr, int iAddr, long lBaud)
+			==========Configure the Modbus slave and its frame timer.
+	@param pPort :{pADI_UART,}	\n
+		Set to pADI_UART. The UART must already be set up with UrtCfg() at lBaud.
+	@param pTmr :{pADI_TM0,pADI_TM1}	\n
+		Timer used for the 3.5 character end of frame time. Its interrupt handler
+		must call MbsTmrIsr() and its interrupt must be enabled in the NVIC.
+	@param iAddr :{1-247}	\n
+		Slave address. Broadcast frames to address 0 are also accepted, but not answered.
+	@param lBaud :{}	\n
+		Baud rate of the UART, used for the frame timing.
+	@return 1 if successful, 0 if the timer is busy or the arguments are out of range.
+	@note
+		- 3.5 characters of 11 bits, or 1.75ms above 19200 baud as the standard specifies.
+		- The timer is clocked by PCLK/16, or PCLK/256 if the time does not fit in 16 bits.
+		  Below 37 baud with a 16MHz core clock it does not fit either, and MbsCfg() returns 0.
+		- The 1.5 character gap inside a frame is not checked, a late byte only delays the end of frame.
+**/
+
+int MbsCfg(ADI_UART_TypeDef *pPort, ADI_TIMER_TypeDef *pTmr, int iAddr, long lBaud)
+	{
+	unsigned long ulUs;
+	unsigned long ulLd, ulTick;
+	int iScale = TCON_PRE_DIV16;
+
+	if ((iAddr < 1) || (iAddr > 247) || (lBaud <= 0))
+		return 0;
+	if (lBaud > 19200)
+		ulUs = 1750;
+	else
+		ulUs = 38500000UL/(unsigned long)lBaud;			// 3.5*11 bits
+	// PCLK/16 counts, in whole ms and the rest in us: ulUs reaches 38500000 at 1 baud
+	ulTick = (unsigned long)ClkFreq(CLK_FREQ_CORE)/16;
+	ulLd = ulTick/1000*(ulUs/1000) + ulTick%1000*(ulUs/1000)/1000 + ulTick*(ulUs%1000)/1000000;
+	if (ulLd > 0xFFFF)
+		{
+		iScale = TCON_PRE_DIV256;
+		ulLd /= 16;
+		}
+	if (ulLd > 0xFFFF)
+		return 0;
+	if (ulLd == 0)
+		ulLd = 1;
+	pMbsPort = pPort;
+	pMbsTmr = pTmr;
+	ucMbsAddr = (unsigned char)iAddr;
+	iMbsRxLen = 0;
+	ucMbsOvr = 0;
+	// Periodic count down, writing CLRI reloads the count, enabled by the first byte of a frame
+	if (GptCfg(pTmr, TCON_CLK_PCLK, iScale, TCON_MOD_PERIODIC|TCON_RLD) == 0)
+		return 0;
+	GptLd(pTmr, (int)ulLd);
+	return 1;
+	}
+
+/**
+	@brief int MbsMapCfg(const MbsMap *pHold, int iHold, const MbsMap *pInput, int iInput)
+			==========Set the register maps.
+	@param pHold :{}	\n
+		Holding register blocks, read by function 03 and written by 06/16 if ucWr is set. 0 if none.
+	@param iHold :{}	\n
+		Number of blocks in pHold.
+	@param pInput :{}	\n
+		Input register blocks, read by function 04. 0 if none.
+	@param iInput :{}	\n
+		Number of blocks in pInput.
+	@return 1.
+	@note
+		- The maps are used in place, keep them in flash or in static variables.
+		- A read may span several blocks if their addresses are contiguous.
+		- A 32 bit value is loaded once for both of its registers, so the two halves
+		  always come from the same value. Writes to it must cover both registers.
+**/
+
+int MbsMapCfg(const MbsMap *pHold, int iHold, const MbsMap *pInput, int iInput)
+	{
+	pMbsHold = pHold;
+	iMbsHold = pHold ? iHold : 0;
+	pMbsInput = pInput;
+	iMbsInput = pInput ? iInput : 0;
+	return 1;
+	}
+
+/**
+	@brief int MbsCrc16(const unsigned char *pBuf, int iLen)
+			==========Calculate the Modbus CRC.
+	@param pBuf :{}	\n
+		Data.
+	@param iLen :{}	\n
+		Number of bytes.
+	@return CRC-16/MODBUS of the data. It is sent low byte first. The CRC of a
+		frame including its CRC is 0.
+**/
+
+int MbsCrc16(const unsigned char *pBuf, int iLen)
+	{
+	unsigned int uiCrc = 0xFFFF;
+
+	while (iLen-- > 0)
+		uiCrc = (uiCrc >> 8) ^ usMbsCrcTbl[(uiCrc ^ *pBuf++) & 0xFF];
+	return (int)uiCrc;
+	}
+
+/**
+	@brief int MbsRxIsr(int iByte)
+			==========Store a received byte.
+	@param iByte :{0-255}	\n
+		Byte read with UrtRx() in UART_Int_Handler.
+	@return 1 if stored, 0 if the frame is too long and will be dropped.
+**/
+
+int MbsRxIsr(int iByte)
+	{
+	if (iMbsRxLen == 0)
+		pMbsTmr->CON |= TCON_ENABLE;
+	GptClrInt(pMbsTmr, TSTA_TMOUT);		// restart the 3.5 character time
+	if (iMbsRxLen >= MBS_FRAME_MAX)
+		{
+		ucMbsOvr = 1;
+		return 0;
+		}
+	ucMbsRx[iMbsRxLen++] = (unsigned char)iByte;
+	return 1;
+	}
+
+// Block of the map holding register iAddr, 0 if none
+static const MbsMap *MbsFind(const MbsMap *pMap, int iMap, int iAddr)
+	{
+	while (iMap-- > 0)
+		{
+		if ((iAddr >= pMap->usAddr) && (iAddr < pMap->usAddr + pMap->usNum))
+			return pMap;
+		pMap++;
+		}
+	return 0;
+	}
+
+// Encode iNum registers from iAddr on, big endian. Returns 0 if one is not mapped.
+static int MbsRead(const MbsMap *pMap, int iMap, int iAddr, int iNum, unsigned char *pOut)
+	{
+	const MbsMap *pBlk;
+	unsigned long ulVal;
+	int iOff;
+
+	while (iNum > 0)
+		{
+		pBlk = MbsFind(pMap, iMap, iAddr);
+		if (pBlk == 0)
+			return 0;
+		iOff = iAddr - pBlk->usAddr;
+		if (pBlk->ucType == MBS_U16)
+			{
+			ulVal = ((volatile unsigned short *)pBlk->pData)[iOff];
+			*pOut++ = (unsigned char)(ulVal >> 8);
+			*pOut++ = (unsigned char)ulVal;
+			iAddr++;
+			iNum--;
+			continue;
+			}
+		ulVal = ((volatile unsigned long *)pBlk->pData)[iOff >> 1];	// one load for both halves
+		if ((iOff & 1) == 0)
+			{
+			*pOut++ = (unsigned char)(ulVal >> 24);
+			*pOut++ = (unsigned char)(ulVal >> 16);
+			iAddr++;
+			if (--iNum == 0)
+				break;
+			}
+		*pOut++ = (unsigned char)(ulVal >> 8);
+		*pOut++ = (unsigned char)ulVal;
+		iAddr++;
+		iNum--;
+		}
+	return 1;
+	}
+
+// Write iNum big endian registers from iAddr on. Nothing is written unless all of
+// them are writable and 32 bit values are written whole. Returns 0 if not.
+static int MbsWrite(int iAddr, int iNum, const unsigned char *pIn)
+	{
+	const MbsMap *pBlk;
+	unsigned long ulVal;
+	int iPass, iOff, i;
+
+	for (iPass = 0; iPass < 2; iPass++)
+		{
+		for (i = 0; i < iNum; )
+			{
+			pBlk = MbsFind(pMbsHold, iMbsHold, iAddr + i);
+			if ((pBlk == 0) || (pBlk->ucWr == 0))
+				return 0;
+			iOff = iAddr + i - pBlk->usAddr;
+			if (pBlk->ucType == MBS_U16)
+				{
+				if (iPass)
+					((volatile unsigned short *)pBlk->pData)[iOff] = (unsigned short)((pIn[2*i] << 8) | pIn[2*i+1]);
+				i++;
+				continue;
+				}
+			if ((iOff & 1) || (i + 1 >= iNum))
+				return 0;
+			if (iPass)
+				{
+				ulVal = ((unsigned long)pIn[2*i] << 24) | ((unsigned long)pIn[2*i+1] << 16)
+						| ((unsigned long)pIn[2*i+2] << 8) | pIn[2*i+3];
+				((volatile unsigned long *)pBlk->pData)[iOff >> 1] = ulVal;
+				}
+			i += 2;
+			}
+		}
+	return 1;
+	}
+
+// Handle a checked request of iLen bytes without CRC. Returns the response length without CRC.
+static int MbsProcess(const unsigned char *pReq, int iLen, unsigned char *pRsp)
+	{
+	int iFunc = pReq[1];
+	int iAddr = (pReq[2] << 8) | pReq[3];
+	int iNum = (pReq[4] << 8) | pReq[5];
+	int iExc = 0;
+
+	pRsp[0] = pReq[0];
+	pRsp[1] = (unsigned char)iFunc;
+	switch (iFunc)
+		{
+		case 3:									// read holding registers
+		case 4:									// read input registers
+			if ((iLen != 6) || (iNum < 1) || (iNum > 125))
+				iExc = 3;
+			else if (iFunc == 3 ? !MbsRead(pMbsHold, iMbsHold, iAddr, iNum, pRsp + 3)
+								: !MbsRead(pMbsInput, iMbsInput, iAddr, iNum, pRsp + 3))
+				iExc = 2;
+			else
+				{
+				pRsp[2] = (unsigned char)(2*iNum);
+				return 3 + 2*iNum;
+				}
+			break;
+		case 6:									// write single register
+			if (iLen != 6)
+				iExc = 3;
+			else if (!MbsWrite(iAddr, 1, pReq + 4))
+				iExc = 2;
+			else
+				{
+				for (iLen = 2; iLen < 6; iLen++)
+					pRsp[iLen] = pReq[iLen];	// echo of the request
+				return 6;
+				}
+			break;
+		case 16:								// write multiple registers
+			if ((iLen < 7) || (iNum < 1) || (iNum > 123) || (pReq[6] != 2*iNum) || (iLen != 7 + 2*iNum))
+				iExc = 3;
+			else if (!MbsWrite(iAddr, iNum, pReq + 7))
+				iExc = 2;
+			else
+				{
+				for (iLen = 2; iLen < 6; iLen++)
+					pRsp[iLen] = pReq[iLen];	// address and count
+				return 6;
+				}
+			break;
+		default:
+			iExc = 1;
+			break;
+		}
+	pRsp[1] = (unsigned char)(iFunc | 0x80);
+	pRsp[2] = (unsigned char)iExc;
+	ulMbsSta[MBS_STA_EXC]++;
+	return 3;
+	}
+
+/**
+	@brief int MbsTmrIsr(void)
+			==========End of frame: check and answer the received frame.
+	@return 1 if a response was queued, 0 otherwise.
+	@note
+		- Call from the interrupt handler of the timer given to MbsCfg().
+		- Frames with a bad CRC, too short or too long are dropped silently, as are
+		  frames for another slave. Broadcast frames are executed but not answered.
+		- The response is dropped if the UrtWrite() queue does not have room for it.
+		- The master must wait for the response before the next request, bytes
+		  received while a frame is processed would overwrite it.
+**/
+
+int MbsTmrIsr(void)
+	{
+	int iLen = iMbsRxLen;
+	int iRsp;
+	int iCrc;
+
+	pMbsTmr->CON &= ~TCON_ENABLE;
+	GptClrInt(pMbsTmr, TSTA_TMOUT);
+	iMbsRxLen = 0;
+	if (ucMbsOvr || (iLen < 8) || (MbsCrc16(ucMbsRx, iLen) != 0))
+		{
+		ucMbsOvr = 0;
+		if (iLen)
+			ulMbsSta[MBS_STA_CRC]++;
+		return 0;
+		}
+	if ((ucMbsRx[0] != ucMbsAddr) && (ucMbsRx[0] != 0))
+		return 0;
+	iRsp = MbsProcess(ucMbsRx, iLen - 2, ucMbsTx);
+	if (ucMbsRx[0] == 0)
+		return 0;
+	iCrc = MbsCrc16(ucMbsTx, iRsp);
+	ucMbsTx[iRsp++] = (unsigned char)iCrc;
+	ucMbsTx[iRsp++] = (unsigned char)(iCrc >> 8);
+	if (UrtWriteFree(pMbsPort) < iRsp)
+		{
+		ulMbsSta[MBS_STA_TXFULL]++;
+		return 0;
+		}
+	UrtWrite(pMbsPort, ucMbsTx, iRsp);
+	ulMbsSta[MBS_STA_FRAMES]++;
+	return 1;
+	}
+
+/**
+	@brief int MbsSta(int iSta)
+			==========Read a slave counter.
+	@param iSta :{MBS_STA_FRAMES,MBS_STA_CRC,MBS_STA_EXC,MBS_STA_TXFULL}	\n
+		- MBS_STA_FRAMES: responses queued.
+		- MBS_STA_CRC: frames dropped for a CRC error, an overrun or a short length.
+		- MBS_STA_EXC: exception responses.
+		- MBS_STA_TXFULL: responses dropped because the UrtWrite() queue was full.
+	@return Counter value, 0 for an unknown counter.
+**/
+
+int MbsSta(int iSta)
+	{
+	if ((iSta < 0) || (iSta > MBS_STA_TXFULL))
+		return 0;
+	return (int)ulMbsSta[iSta];
+	}
+
+   /**@}*/
@@ -0,0 +1,52 @@
+/**
+ *****************************************************************************
+   @file     MbsLib.h
+   @brief    Modbus RTU slave on the UART.
+   - Configure the UART with UrtCfg() and the slave with MbsCfg().
+   - Give the register maps with MbsMapCfg().
+   - Call MbsRxIsr() from UART_Int_Handler for each received byte and
+     MbsTmrIsr() from the GP_Tmr0/1_Int_Handler of the frame timer.
+
+   @version  V0.1
+   @date     October 2026
+
+All files for ADuCM360 provided by ADI, including this file, are
+provided  as is without warranty of any kind, either expressed or implied.
+The user assumes any and all risk from the use of this code.
+It is the responsibility of the person integrating this code into an application
+to ensure that the resulting application performs as required and is safe.
+
+**/
+
+#include <ADuCM360.h>
+
+// One block of consecutive registers mapped onto application variables
+typedef struct
+{
+	unsigned short usAddr;			// first register address
+	unsigned short usNum;			// number of registers, 2 per MBS_U32/MBS_F32 value
+	volatile void *pData;			// first variable of the block
+	unsigned char ucType;			// MBS_U16, MBS_U32 or MBS_F32
+	unsigned char ucWr;				// 1 if the master may write the block (holding registers)
+} MbsMap;
+
+extern int MbsCfg(ADI_UART_TypeDef *pPort, ADI_TIMER_TypeDef *pTmr, int iAddr, long lBaud);
+extern int MbsMapCfg(const MbsMap *pHold, int iHold, const MbsMap *pInput, int iInput);
+extern int MbsRxIsr(int iByte);
+extern int MbsTmrIsr(void);
+extern int MbsSta(int iSta);
+extern int MbsCrc16(const unsigned char *pBuf, int iLen);
+
+// MbsMap value types. 32 bit values take two registers, high word first.
+#define MBS_U16		0
+#define MBS_U32		1
+#define MBS_F32		2
+
+// MbsSta() counters
+#define MBS_STA_FRAMES	0				// frames addressed to the slave and answered
+#define MBS_STA_CRC		1				// frames dropped for a CRC error, overrun or short length
+#define MBS_STA_EXC		2				// exception responses sent
+#define MBS_STA_TXFULL	3				// responses dropped because the UrtWrite() queue was full
+
+// Largest RTU frame, address to CRC
+#define MBS_FRAME_MAX	256
@@ -4,13 +4,23 @@
    @{
    @file     SpiLib.c
    @brief    Set of SPI peripheral functions.
-   @version  V0.3
+   - Interrupt driven transfers of whole buffers with SpiXfer(), call SpiXferIsr()
+     from SPI0_Int_Handler or SPI1_Int_Handler.
+   - Set the Master mode clock in Hz with SpiBaudHz(), read it back with SpiFreq().
+   - Build with SPI_PROF defined to time SpiXfer() transfers and CPU waits per device,
+     set up with SpiProfCfg() and read with SpiProfRd(). Drivers that fill the FIFO
+     themselves add their frames with SpiProfXferAdd().
+   @version  V0.6
    @author   ADI
-   @date     November 2012
+   @date     October 2026
    @par Revision History:
    - V0.1, May 2012: initial version. 
    - V0.2, October 2012: Added SPI DMA support
    - V0.3, November 2012: Moved SPI DMA functionality to DmaLib
+   - V0.4, October 2026: Added SpiXfer(), SpiXferIsr() and SpiXferSta().
+   - V0.5, October 2026: Added SpiBaudHz() and SpiFreq().
+   - V0.6, October 2026: Added SPI_PROF profiling, SpiProfCfg(), SpiProfDev(), SpiProfRd(),
+     SpiProfWait(), SpiProfXferAdd(), SPI_PROF_WAIT() and SpiXferWait().
 
 All files for ADuCM360/361 provided by ADI, including this file, are
 provided  as is without warranty of any kind, either expressed or implied.
@@ -23,6 +33,37 @@ to ensure that the resulting application performs as required and is safe.
 #include	"SpiLib.h"
 #include <ADuCM360.h>
 #include "DmaLib.h"
+#include "ClkLib.h"
+#include <string.h>
+
+// SpiXfer() state of SPI0 and SPI1. SpiXfer() only writes it while no transfer is
+// running, with iRx >= iLen until the rest is set, then SpiXferIsr() owns it until
+// iRx reaches iLen.
+typedef struct
+{
+  const unsigned char *pTx;
+  unsigned char *pRx;
+  volatile int iLen;
+  int iTx;                              // bytes written to SPITX
+  volatile int iRx;                     // bytes read from SPIRX
+  int iCnt;                             // SPICNT at the last SpiXferIsr()
+  unsigned long ulSta[3];               // SpiXferSta() counters
+  unsigned short usStart;               // SpiProfTime() when SpiXfer() started
+  int iDev;                             // SpiProfDev() when SpiXfer() started
+} SPI_XFER;
+
+static SPI_XFER SpiXferS[2];
+
+// SPI_PROF profiles. SpiXferIsr() adds the transfers, the main loop the waits.
+static SPI_PROF_DEV SpiProfS[SPI_PROF_DEVS];
+static int iSpiProfDev[2] = {0,1};      // device of SPI0 and SPI1 transfers
+static ADI_TIMER_TypeDef *pSpiProfTmr = 0;
+static int iSpiProfUp = 0;
+static const int iSpiMod[SPI_FIFO] = {SPICON_MOD_TX1RX1,SPICON_MOD_TX2RX2,SPICON_MOD_TX3RX3,SPICON_MOD_TX4RX4};
+
+static void SpiXferFill(ADI_SPI_TypeDef *pSPI, SPI_XFER *pX);
+static unsigned short SpiProfTicks(unsigned short usFrom, unsigned short usTo);
+static void SpiProfAdd(int iDev, unsigned short usStart, int iBytes);
 
 /**
       @brief int SpiCfg(ADI_SPI_TypeDef *pSPI, int iFifoSize, int iMasterEn, int iConfig);
@@ -90,6 +131,61 @@ int SpiBaud(ADI_SPI_TypeDef *pSPI, int iClkDiv, int iCserr)
   return 1;
 }
 
+/**
+	@brief long SpiBaudHz(ADI_SPI_TypeDef *pSPI, long lHz, int iCserr)
+			========== Set the SPI clock rate in Master mode from a frequency.
+	@param pSPI :{pADI_SPI0 , pADI_SPI1}
+		- pADI_SPI0 for SPI0.
+		- pADI_SPI1 for SPI1.
+	@param lHz :{}
+		- Highest SCLK frequency in Hz the slave accepts.
+	@param iCserr :{SPIDIV_BCRST_DIS,SPIDIV_BCRST_EN}
+		- SPIDIV_BCRST_DIS to disable CS error detection.
+		- SPIDIV_BCRST_EN to Enable CS error detection.
+	@return Frequency set in Hz, 0 if lHz is below 1.
+	@note
+		- The SPI clock is read with ClkFreq(CLK_FREQ_SPI0) or ClkFreq(CLK_FREQ_SPI1),
+		  so it follows ClkCfg(), ClkSel() and XOSCCfg(). Call SpiBaudHz() again
+		  after changing them.
+		- The fastest rate not above lHz is set. Below SPI clock/128, the slowest
+		  divider, SPI clock/128 is set and returned.
+**/
+long SpiBaudHz(ADI_SPI_TypeDef *pSPI, long lHz, int iCserr)
+{
+  long lClk;
+  long lDiv;
+
+  if (lHz < 1)
+    return 0;
+  lClk = ClkFreq((pSPI == pADI_SPI0) ? CLK_FREQ_SPI0 : CLK_FREQ_SPI1);
+  // SCLK = lClk/(2*(iClkDiv+1)), round the divider up. Test 2*lHz >= lClk without
+  // the product, which overflows for large lHz.
+  if (lHz >= (lClk + 1)/2)
+    lDiv = 0;
+  else
+    lDiv = (lClk + 2*lHz - 1)/(2*lHz) - 1;
+  if (lDiv > 63)
+    lDiv = 63;
+  SpiBaud(pSPI,(int)lDiv,iCserr);
+  return lClk/(2*(lDiv+1));
+}
+
+/**
+	@brief long SpiFreq(ADI_SPI_TypeDef *pSPI)
+			========== Read the SPI clock rate in Master mode.
+	@param pSPI :{pADI_SPI0 , pADI_SPI1}
+		- pADI_SPI0 for SPI0.
+		- pADI_SPI1 for SPI1.
+	@return SCLK frequency in Hz, from SPIDIV and ClkFreq().
+**/
+long SpiFreq(ADI_SPI_TypeDef *pSPI)
+{
+  long lClk;
+
+  lClk = ClkFreq((pSPI == pADI_SPI0) ? CLK_FREQ_SPI0 : CLK_FREQ_SPI1);
+  return lClk/(2*((pSPI->SPIDIV & 0x3F)+1));
+}
+
 /**
 	@brief int SpiRx(ADI_SPI_TypeDef *pSPI)
 			========== Write 8 bits of iRx to SPIxRX.
@@ -270,4 +366,300 @@ int SpiCountRd(ADI_SPI_TypeDef *pSPI)
   return	pSPI->SPICNT;
 }
 
+/**
+	@brief int SpiXfer(ADI_SPI_TypeDef *pSPI, const unsigned char *pTx, unsigned char *pRx, int iLen);
+			========== Start an interrupt driven transfer of iLen bytes in Master mode.
+	@param pSPI :{pADI_SPI0 , pADI_SPI1}
+		- pADI_SPI0 for SPI0.
+		- pADI_SPI1 for SPI1.
+	@param pTx :{}
+		- Bytes to send, 0 to send 0xFF. Must stay valid until the transfer is over.
+	@param pRx :{}
+		- Buffer for the bytes received, 0 to discard them. May be pTx.
+	@param iLen :{1-}
+		- Number of bytes.
+	@return 1 if started, 0 if a transfer is still running on this SPI.
+	@note
+		- The SPI must be set up with SpiCfg() in Master mode with SPICON_TIM_TXWR,
+		  and SPICON_CON_EN to keep CS low between FIFO refills.
+		- Up to SPI_FIFO bytes are written at a time and the IRQ threshold
+		  (SPICON_MOD) is set to the size of each block, so there is one interrupt
+		  per block instead of one per byte. SPIx_Int_Handler must call SpiXferIsr()
+		  and the SPI interrupt must be enabled in the NVIC.
+		- Check the end with SpiXferSta(pSPI,SPI_XFER_LEFT) == 0.
+**/
+int SpiXfer(ADI_SPI_TypeDef *pSPI, const unsigned char *pTx, unsigned char *pRx, int iLen)
+{
+  SPI_XFER *pX = &SpiXferS[pSPI == pADI_SPI1];
+
+  if (pX->iRx < pX->iLen)
+    return 0;
+  if (pX->iRx < iLen)                   // SpiXferIsr() stays idle for the new length too
+    pX->iRx = iLen;
+  SpiFifoFlush(pSPI,SPICON_TFLUSH_EN,SPICON_RFLUSH_EN);
+  pX->pTx = pTx;
+  pX->pRx = pRx;
+  pX->iTx = 0;
+  pX->iCnt = SpiCountRd(pSPI);
+#ifdef SPI_PROF
+  pX->usStart = SpiProfTime();
+  pX->iDev = iSpiProfDev[pSPI == pADI_SPI1];
+#endif
+  pX->iLen = iLen;
+  pX->iRx = 0;                          // SpiXferIsr() owns the transfer from here
+  SpiXferFill(pSPI,pX);
+  return 1;
+}
+
+// Next block: as many bytes as the FIFO takes, IRQ once they are all out
+static void SpiXferFill(ADI_SPI_TypeDef *pSPI, SPI_XFER *pX)
+{
+  int iNum = pX->iLen - pX->iTx;
+
+  if (iNum > SPI_FIFO)
+    iNum = SPI_FIFO;
+  if (iNum <= 0)
+    return;
+  pSPI->SPICON = (pSPI->SPICON & ~SPICON_MOD_TX4RX4) | iSpiMod[iNum-1];
+  while (iNum--)
+  {
+    pSPI->SPITX = pX->pTx ? pX->pTx[pX->iTx] : 0xFF;
+    pX->iTx++;
+  }
+}
+
+/**
+	@brief int SpiXferIsr(ADI_SPI_TypeDef *pSPI);
+			========== Read the block received and send the next one. Call from SPIx_Int_Handler.
+	@param pSPI :{pADI_SPI0 , pADI_SPI1}
+		- pADI_SPI0 for SPI0.
+		- pADI_SPI1 for SPI1.
+	@return Bytes left to receive, 0 when the transfer is over or none is running.
+	@note
+		- The bytes are counted with SpiCountRd(). Bytes counted but not found in the
+		  Rx FIFO were lost and are added to SpiXferSta(pSPI,SPI_XFER_LOST).
+**/
+int SpiXferIsr(ADI_SPI_TypeDef *pSPI)
+{
+  SPI_XFER *pX = &SpiXferS[pSPI == pADI_SPI1];
+  int i1, iCnt, iNew, iFifo;
+
+  if (pX->iRx >= pX->iLen)
+    return 0;
+  iCnt = SpiCountRd(pSPI);
+  iNew = (iCnt - pX->iCnt) & 0xFF;              // bytes received since the last call
+  pX->iCnt = iCnt;
+  iFifo = (SpiSta(pSPI) >> 8) & 7;              // SPISTA_RXFSTA: bytes in the Rx FIFO
+  if (iNew > iFifo)                             // the rest were lost, keep the count in step
+    pX->ulSta[SPI_XFER_LOST] += iNew - iFifo;
+  else
+    iNew = iFifo;
+  for (i1 = 0; i1 < iNew; i1++)
+  {
+    int iRx = i1 < iFifo ? SpiRx(pSPI) : 0;
+    if (pX->pRx && pX->iRx < pX->iLen)
+      pX->pRx[pX->iRx] = iRx;
+    pX->iRx++;
+  }
+  pX->ulSta[SPI_XFER_IRQ]++;
+  if (pX->iRx >= pX->iLen)
+  {
+    pX->iRx = pX->iLen;
+    pX->ulSta[SPI_XFER_BYTES] += pX->iLen;
+#ifdef SPI_PROF
+    SpiProfAdd(pX->iDev,pX->usStart,pX->iLen);
+#endif
+    return 0;
+  }
+  if (pX->iRx >= pX->iTx)                       // block read back, Rx FIFO empty
+    SpiXferFill(pSPI,pX);
+  return pX->iLen - pX->iRx;
+}
+
+/**
+	@brief unsigned long SpiXferSta(ADI_SPI_TypeDef *pSPI, int iSta);
+			========== SpiXfer() state and counters.
+	@param pSPI :{pADI_SPI0 , pADI_SPI1}
+		- pADI_SPI0 for SPI0.
+		- pADI_SPI1 for SPI1.
+	@param iSta :{SPI_XFER_LEFT,SPI_XFER_BYTES,SPI_XFER_IRQ,SPI_XFER_LOST}
+		- SPI_XFER_LEFT, bytes left to receive in the current transfer, 0 when over.
+		- SPI_XFER_BYTES, bytes of all finished transfers.
+		- SPI_XFER_IRQ, calls to SpiXferIsr() during transfers.
+		- SPI_XFER_LOST, bytes counted by SPICNT that did not reach the Rx FIFO.
+	@return Value asked for.
+**/
+unsigned long SpiXferSta(ADI_SPI_TypeDef *pSPI, int iSta)
+{
+  SPI_XFER *pX = &SpiXferS[pSPI == pADI_SPI1];
+
+  if (iSta == SPI_XFER_LEFT)
+    return pX->iLen - pX->iRx;
+  return pX->ulSta[iSta];
+}
+
+/**
+	@brief int SpiXferWait(ADI_SPI_TypeDef *pSPI);
+			========== Wait for the end of the SpiXfer() transfer.
+	@param pSPI :{pADI_SPI0 , pADI_SPI1}
+		- pADI_SPI0 for SPI0.
+		- pADI_SPI1 for SPI1.
+	@return 1.
+	@note
+		- With SPI_PROF defined the time waited is added to the device profile.
+**/
+int SpiXferWait(ADI_SPI_TypeDef *pSPI)
+{
+  SPI_XFER *pX = &SpiXferS[pSPI == pADI_SPI1];
+
+  SPI_PROF_WAIT(pSPI,pX->iRx < pX->iLen);
+  return 1;
+}
+
+/**
+	@brief int SpiProfCfg(ADI_TIMER_TypeDef *pTmr);
+			========== Select the timer that times transfers and waits, and clear the profiles.
+	@param pTmr :{0,pADI_TM0,pADI_TM1}
+		- Free running timer set up and enabled by the application, counting up or down.
+		  0 for no timing, only transfers and bytes are counted.
+	@return 1.
+	@note
+		- Only used when SpiLib is built with SPI_PROF defined.
+		- Times are 16 bit timer differences: choose a prescaler so that the longest
+		  transfer or wait is below 65536 ticks.
+**/
+int SpiProfCfg(ADI_TIMER_TypeDef *pTmr)
+{
+  int i1;
+
+  pSpiProfTmr = pTmr;
+  iSpiProfUp = pTmr ? (pTmr->CON & TCON_UP) : 0;
+  for (i1 = 0; i1 < SPI_PROF_DEVS; i1++)
+    SpiProfRd(i1,0,1);
+  return 1;
+}
+
+/**
+	@brief int SpiProfDev(ADI_SPI_TypeDef *pSPI, int iDev);
+			========== Select the device profile the next transfers on pSPI are added to.
+	@param pSPI :{pADI_SPI0 , pADI_SPI1}
+		- pADI_SPI0 for SPI0.
+		- pADI_SPI1 for SPI1.
+	@param iDev :{0 - SPI_PROF_DEVS-1}
+		- Device number, by default 0 for SPI0 and 1 for SPI1.
+	@return 1, or 0 if iDev is out of range.
+	@note
+		- Call it where the application selects the slave, for example next to the
+		  GPIO chip select, so several slaves on one SPI get their own profile.
+		- A transfer is added to the device selected when SpiXfer() started it.
+**/
+int SpiProfDev(ADI_SPI_TypeDef *pSPI, int iDev)
+{
+  if ((iDev < 0) || (iDev >= SPI_PROF_DEVS))
+    return 0;
+  iSpiProfDev[pSPI == pADI_SPI1] = iDev;
+  return 1;
+}
+
+/**
+	@brief int SpiProfRd(int iDev, SPI_PROF_DEV *pProf, int iClr);
+			========== Read the profile of a device.
+	@param iDev :{0 - SPI_PROF_DEVS-1}
+		- Device number.
+	@param pProf :{}
+		- Copy of the profile, 0 to only clear it.
+	@param iClr :{0,1}
+		- 1 to clear the profile once read.
+	@return 1, or 0 if iDev is out of range.
+	@note
+		- Interrupts are off while the profile is copied, so it is consistent.
+**/
+int SpiProfRd(int iDev, SPI_PROF_DEV *pProf, int iClr)
+{
+  unsigned long ulPm;
+
+  if ((iDev < 0) || (iDev >= SPI_PROF_DEVS))
+    return 0;
+  ulPm = __get_PRIMASK();
+  __disable_irq();
+  if (pProf)
+    *pProf = SpiProfS[iDev];
+  if (iClr)
+    memset(&SpiProfS[iDev],0,sizeof(SPI_PROF_DEV));
+  __set_PRIMASK(ulPm);
+  return 1;
+}
+
+/**
+	@brief unsigned short SpiProfTime(void);
+			========== Read the profiling timer.
+	@return Timer value, 0 if no timer was given to SpiProfCfg().
+**/
+unsigned short SpiProfTime(void)
+{
+  return pSpiProfTmr ? pSpiProfTmr->VAL : 0;
+}
+
+/**
+	@brief int SpiProfWait(ADI_SPI_TypeDef *pSPI, unsigned short usStart);
+			========== Add a CPU wait that started at usStart to the device of pSPI.
+	@param pSPI :{pADI_SPI0 , pADI_SPI1}
+		- pADI_SPI0 for SPI0.
+		- pADI_SPI1 for SPI1.
+	@param usStart :{}
+		- SpiProfTime() when the wait started.
+	@return 1.
+	@note
+		- Normally used through SPI_PROF_WAIT(), for example
+		  SPI_PROF_WAIT(pADI_SPI1,(SpiSta(pADI_SPI1) & SPISTA_TX) == 0).
+**/
+int SpiProfWait(ADI_SPI_TypeDef *pSPI, unsigned short usStart)
+{
+  SpiProfS[iSpiProfDev[pSPI == pADI_SPI1]].ulWait += SpiProfTicks(usStart,SpiProfTime());
+  return 1;
+}
+
+/**
+	@brief int SpiProfXferAdd(ADI_SPI_TypeDef *pSPI, unsigned short usStart, int iBytes);
+			========== Add a transfer that did not go through SpiXfer() to the device of pSPI.
+	@param pSPI :{pADI_SPI0 , pADI_SPI1}
+		- pADI_SPI0 for SPI0.
+		- pADI_SPI1 for SPI1.
+	@param usStart :{}
+		- SpiProfTime() when the transfer started.
+	@param iBytes :{1-}
+		- Bytes of the transfer.
+	@return 1.
+	@note
+		- For drivers that write the FIFO themselves, for example one SPI frame per
+		  interrupt. Call it from the interrupt that sees the end of the frame.
+**/
+int SpiProfXferAdd(ADI_SPI_TypeDef *pSPI, unsigned short usStart, int iBytes)
+{
+  SpiProfAdd(iSpiProfDev[pSPI == pADI_SPI1],usStart,iBytes);
+  return 1;
+}
+
+// Ticks between two timer values, whichever way the timer counts
+static unsigned short SpiProfTicks(unsigned short usFrom, unsigned short usTo)
+{
+  return iSpiProfUp ? (unsigned short)(usTo - usFrom) : (unsigned short)(usFrom - usTo);
+}
+
+// Add a transfer that ends now to the device profile, from an interrupt
+static void SpiProfAdd(int iDev, unsigned short usStart, int iBytes)
+{
+  SPI_PROF_DEV *pP = &SpiProfS[iDev];
+  unsigned short usEnd = SpiProfTime();
+  unsigned long ulTicks = SpiProfTicks(usStart,usEnd);
+
+  pP->ulXfers++;
+  pP->ulBytes += iBytes;
+  pP->ulBusy += ulTicks;
+  if (ulTicks > pP->ulMax)
+    pP->ulMax = ulTicks;
+  pP->usStart = usStart;
+  pP->usEnd = usEnd;
+}
+
 /**@}*/
@@ -2,13 +2,23 @@
  *****************************************************************************
    @file     SpiLib.h
    @brief    Set of SPI peripheral functions.
-   @version  V0.3
+   - Interrupt driven transfers of whole buffers with SpiXfer(), call SpiXferIsr()
+     from SPI0_Int_Handler or SPI1_Int_Handler.
+   - Set the Master mode clock in Hz with SpiBaudHz(), read it back with SpiFreq().
+   - Build with SPI_PROF defined to time SpiXfer() transfers and CPU waits per device,
+     set up with SpiProfCfg() and read with SpiProfRd(). Drivers that fill the FIFO
+     themselves add their frames with SpiProfXferAdd().
+   @version  V0.6
    @author   ADI
-   @date     November 2012 
+   @date     October 2026
    @par Revision History:
    - V0.1, May 2012: initial version. 
    - V0.2, October 2012: Added SPI DMA support
    - V0.3, November 2012: Moved SPI DMA functionality to DmaLib
+   - V0.4, October 2026: Added SpiXfer(), SpiXferIsr() and SpiXferSta().
+   - V0.5, October 2026: Added SpiBaudHz() and SpiFreq().
+   - V0.6, October 2026: Added SPI_PROF profiling, SpiProfCfg(), SpiProfDev(), SpiProfRd(),
+     SpiProfWait(), SpiProfXferAdd(), SPI_PROF_WAIT() and SpiXferWait().
 
 All files for ADuCM360/361 provided by ADI, including this file, are
 provided  as is without warranty of any kind, either expressed or implied.
@@ -25,9 +35,55 @@ extern int SpiRx(ADI_SPI_TypeDef *pSPI);
 extern int SpiTx(ADI_SPI_TypeDef *pSPI, int iTx);
 extern int SpiSta(ADI_SPI_TypeDef *pSPI);
 extern int SpiBaud(ADI_SPI_TypeDef *pSPI, int iClkDiv, int iCserr);
+extern long SpiBaudHz(ADI_SPI_TypeDef *pSPI, long lHz, int iCserr);
+extern long SpiFreq(ADI_SPI_TypeDef *pSPI);
 extern int SpiFifoFlush(ADI_SPI_TypeDef *pSPI, int iTxFlush, int iRxFlush);
 extern int SpiTxFifoFlush(ADI_SPI_TypeDef *pSPI, int iTxFlush);
 extern int SpiRxFifoFlush(ADI_SPI_TypeDef *pSPI, int iRxFlush);
 extern int SpiDma(ADI_SPI_TypeDef *pSPI, int iDmaRxSel, int iDmaTxSel, int iDmaEn);
 extern int SpiCountRd(ADI_SPI_TypeDef *pSPI);
+extern int SpiXfer(ADI_SPI_TypeDef *pSPI, const unsigned char *pTx, unsigned char *pRx, int iLen);
+extern int SpiXferIsr(ADI_SPI_TypeDef *pSPI);
+extern unsigned long SpiXferSta(ADI_SPI_TypeDef *pSPI, int iSta);
+extern int SpiXferWait(ADI_SPI_TypeDef *pSPI);
+
+// Profile of one device, timer ticks are those of the SpiProfCfg() timer
+typedef struct
+{
+  unsigned long ulXfers;                // finished SpiXfer() and SpiProfXferAdd() transfers
+  unsigned long ulBytes;                // bytes of those transfers
+  unsigned long ulBusy;                 // ticks from SpiXfer() to the end of each transfer, summed
+  unsigned long ulMax;                  // ticks of the longest transfer
+  unsigned long ulWait;                 // ticks the CPU waited in SpiXferWait() and SPI_PROF_WAIT()
+  unsigned short usStart;               // timer value when the last transfer started
+  unsigned short usEnd;                 // and when it ended
+} SPI_PROF_DEV;
+
+extern int SpiProfCfg(ADI_TIMER_TypeDef *pTmr);
+extern int SpiProfDev(ADI_SPI_TypeDef *pSPI, int iDev);
+extern int SpiProfRd(int iDev, SPI_PROF_DEV *pProf, int iClr);
+extern unsigned short SpiProfTime(void);
+extern int SpiProfWait(ADI_SPI_TypeDef *pSPI, unsigned short usStart);
+extern int SpiProfXferAdd(ADI_SPI_TypeDef *pSPI, unsigned short usStart, int iBytes);
+
+// Tx and Rx FIFO depth in bytes, the largest SpiXfer() block
+#define SPI_FIFO	4
+
+// SpiXferSta() values
+#define SPI_XFER_LEFT	3				// bytes left in the current transfer
+#define SPI_XFER_BYTES	0				// bytes of all finished transfers
+#define SPI_XFER_IRQ	1				// SpiXferIsr() calls
+#define SPI_XFER_LOST	2				// bytes lost from the Rx FIFO
+
+// Devices profiled, see SpiProfDev()
+#ifndef SPI_PROF_DEVS
+#define SPI_PROF_DEVS	4
+#endif
+
+// Wait while cond is true. With SPI_PROF defined the time is added to the device of pSPI.
+#ifdef SPI_PROF
+#define SPI_PROF_WAIT(pSPI, cond)	do { unsigned short usT = SpiProfTime(); while (cond); SpiProfWait((pSPI), usT); } while (0)
+#else
+#define SPI_PROF_WAIT(pSPI, cond)	do { while (cond); } while (0)
+#endif
 
@@ -0,0 +1,360 @@
+/**
+ *****************************************************************************
+   @addtogroup tmp
+   @{
+   @file     TempLib.h
+   @brief    Set of temperature conversion functions for RTD and thermocouple measurements.
+   - Select the sensors used by defining TEMPLIB_RTD and/or TEMPLIB_TC before including this file.
+   - Convert an RTD resistance to temperature with CalculateRTDTemp().
+   - Convert a thermocouple voltage to temperature with CalculateThermoCoupleTemp().
+   - Convert the cold junction temperature to a thermocouple voltage with CalculateColdJVoltage().
+   - Convert a thermocouple voltage with cold junction compensation in one call with CalculateCjcTemp().
+   - For non-uniform tables, CalculateRTDTempHint() and CalculateCjcTempHint() keep a
+     per-channel segment hint so slowly varying inputs skip the table search.
+   The functions are static inline and the tables static const, so an image only
+   contains the tables of the sensors it selects and the lookup is inlined into
+   the caller. Include this file from one source file per project.
+   The default tables are a PT100 RTD from -40degC to 125degC (TempTblPt100.h) and a
+   Type T thermocouple from -200degC to 350degC (TempTblTypeT.h). Other ranges are
+   selected by defining TEMPLIB_RTD_TABLES or TEMPLIB_TC_TABLES to a header generated
+   by tools/LutGen. Non-uniform LutGen tables (-n) are supported.
+
+   @version  V0.3
+   @date     October 2026
+   @par Revision History:
+   - V0.1, October 2026: initial version.
+   - V0.2, October 2026: One cold junction table over -40degC to 125degC, added CalculateCjcTemp().
+   - V0.3, October 2026: Segment hints for non-uniform tables.
+
+All files for ADuCM360 provided by ADI, including this file, are
+provided  as is without warranty of any kind, either expressed or implied.
+The user assumes any and all risk from the use of this code.
+It is the responsibility of the person integrating this code into an application
+to ensure that the resulting application performs as required and is safe.
+
+**/
+
+#ifndef TEMPLIB_H
+#define TEMPLIB_H
+
+#ifndef __INLINE
+#define __INLINE __inline							// normally provided by core_cm3.h
+#endif
+
+#ifdef TEMPLIB_RTD
+#ifndef TEMPLIB_RTD_TABLES
+#define TEMPLIB_RTD_TABLES "TempTblPt100.h"
+#endif
+#include TEMPLIB_RTD_TABLES
+#endif
+
+#ifdef TEMPLIB_TC
+#ifndef TEMPLIB_TC_TABLES
+#define TEMPLIB_TC_TABLES "TempTblTypeT.h"
+#endif
+#include TEMPLIB_TC_TABLES
+#endif
+
+/**
+	@brief float TempLut(float fX, float fX0, float fRcpSeg, int iNSeg, const float *pfTbl)
+			==========Piecewise linear lookup in a table with equal input segments.
+	@param fX :{}	\n
+		Input value.
+	@param fX0 :{}	\n
+		Input value of the first table entry.
+	@param fRcpSeg :{}	\n
+		Reciprocal of the input width of one segment. Passed as a constant so no division is done at run time.
+	@param iNSeg :{}	\n
+		Number of segments, the table holds iNSeg+1 entries.
+	@param pfTbl :{}	\n
+		Output values at each segment boundary.
+	@return Interpolated output. Inputs outside the table extrapolate the first or last segment.
+**/
+
+static __INLINE float TempLut(float fX, float fX0, float fRcpSeg, int iNSeg, const float *pfTbl)
+	{
+	float fPos = (fX - fX0)*fRcpSeg;				// position in segments
+	int j = (int)fPos;								// determine which coefficients to use
+
+	if (j < 0)										// if input is under-range..
+		j = 0;										// ..then use lowest coefficients
+	else if (j > iNSeg-1)							// if input is over-range..
+		j = iNSeg-1;								// ..then use highest coefficients
+	return pfTbl[j] + (fPos - j)*(pfTbl[j+1] - pfTbl[j]);
+	}
+
+/**
+	@brief int TempSegNu(float fX, const float *pfX, int iLo, int iHi, int iAsc)
+			==========Binary search for the breakpoint segment holding fX.
+	@param fX :{}	\n
+		Input value.
+	@param pfX :{}	\n
+		Input value of each table entry.
+	@param iLo :{}	\n
+		First segment to search.
+	@param iHi :{}	\n
+		Last segment to search.
+	@param iAsc :{0,1}	\n
+		1 if pfX[] is ascending, 0 if descending.
+	@return Last segment in iLo..iHi whose start is not past fX, iLo if there is none.
+**/
+
+static __INLINE int TempSegNu(float fX, const float *pfX, int iLo, int iHi, int iAsc)
+	{
+	int j;
+
+	while (iLo < iHi)
+		{
+		j = (iLo + iHi + 1) >> 1;
+		if ((fX >= pfX[j]) == iAsc)
+			iLo = j;
+		else
+			iHi = j-1;
+		}
+	return iLo;
+	}
+
+/**
+	@brief float TempLutNu(float fX, const float *pfX, int iNSeg, const float *pfTbl)
+			==========Piecewise linear lookup in a table with breakpoints (LutGen -n).
+	@param fX :{}	\n
+		Input value.
+	@param pfX :{}	\n
+		Input value of each table entry, ascending or descending.
+	@param iNSeg :{}	\n
+		Number of segments, both tables hold iNSeg+1 entries.
+	@param pfTbl :{}	\n
+		Output values at each breakpoint.
+	@return Interpolated output. Inputs outside the table extrapolate the first or last segment.
+**/
+
+static __INLINE float TempLutNu(float fX, const float *pfX, int iNSeg, const float *pfTbl)
+	{
+	int j = TempSegNu(fX, pfX, 0, iNSeg-1, pfX[iNSeg] > pfX[0]);
+
+	return pfTbl[j] + (fX - pfX[j])*(pfTbl[j+1] - pfTbl[j])/(pfX[j+1] - pfX[j]);
+	}
+
+/**
+	@brief float TempLutNuHint(float fX, const float *pfX, int iNSeg, const float *pfTbl, int *piHint)
+			==========As TempLutNu(), starting from the segment used by the previous call.
+	@param fX :{}	\n
+		Input value.
+	@param pfX :{}	\n
+		Input value of each table entry, ascending or descending.
+	@param iNSeg :{}	\n
+		Number of segments, both tables hold iNSeg+1 entries.
+	@param pfTbl :{}	\n
+		Output values at each breakpoint.
+	@param piHint :{}	\n
+		Segment used by the previous call, updated on return. Keep one per input channel
+		and initialise it to 0 (any value is safe).
+	@return Interpolated output, identical to TempLutNu().
+	@note
+		- Slowly varying inputs stay in the hinted segment or move to a neighbour,
+		  which costs two compares. Larger jumps fall back to a binary search on the
+		  side of the table the input moved to.
+**/
+
+static __INLINE float TempLutNuHint(float fX, const float *pfX, int iNSeg, const float *pfTbl, int *piHint)
+	{
+	int iAsc = pfX[iNSeg] > pfX[0];
+	int j = *piHint;
+
+	if (j < 0 || j > iNSeg-1)						// no usable hint
+		j = TempSegNu(fX, pfX, 0, iNSeg-1, iAsc);
+	else if ((fX >= pfX[j]) != iAsc)				// before the hinted segment..
+		{
+		if (j > 0 && (fX >= pfX[j-1]) == iAsc)		// ..in the previous one
+			j--;
+		else
+			j = TempSegNu(fX, pfX, 0, (j > 1) ? j-2 : 0, iAsc);
+		}
+	else if (j < iNSeg-1 && (fX >= pfX[j+1]) == iAsc)	// after the hinted segment..
+		{
+		if (j+1 == iNSeg-1 || (fX >= pfX[j+2]) != iAsc)	// ..in the next one
+			j++;
+		else
+			j = TempSegNu(fX, pfX, j+2, iNSeg-1, iAsc);
+		}
+	*piHint = j;
+	return pfTbl[j] + (fX - pfX[j])*(pfTbl[j+1] - pfTbl[j])/(pfX[j+1] - pfX[j]);
+	}
+
+#ifdef TEMPLIB_RTD
+/**
+	@brief float CalculateRTDTemp(float r)
+			==========Convert RTD resistance to temperature.
+	@param r :{}	\n
+		RTD resistance in ohms.
+	@return Temperature in degC.
+**/
+
+static __INLINE float CalculateRTDTemp(float r)
+	{
+#ifdef RTD_NU
+	return TempLutNu(r, C_rtd_x, NSEG, C_rtd);
+#else
+	return TempLut(r, (float)RMIN, (float)(1.0/RSEG), NSEG, C_rtd);
+#endif
+	}
+
+/**
+	@brief float CalculateRTDTempHint(float r, int *piHint)
+			==========As CalculateRTDTemp(), keeping the last table segment used for this channel.
+	@param r :{}	\n
+		RTD resistance in ohms.
+	@param piHint :{}	\n
+		Segment hint of the channel, see TempLutNuHint(). Unused with a uniform table,
+		where the segment is found directly.
+	@return Temperature in degC.
+**/
+
+static __INLINE float CalculateRTDTempHint(float r, int *piHint)
+	{
+#ifdef RTD_NU
+	return TempLutNuHint(r, C_rtd_x, NSEG, C_rtd, piHint);
+#else
+	(void)piHint;
+	return TempLut(r, (float)RMIN, (float)(1.0/RSEG), NSEG, C_rtd);
+#endif
+	}
+#endif
+
+#ifdef TEMPLIB_TC
+/**
+	@brief float TempTcMv(float fMv)
+			==========Convert thermocouple voltage in mV to temperature.
+	@param fMv :{}	\n
+		Thermocouple voltage in mV, including the cold junction voltage.
+	@return Temperature in degC.
+**/
+
+static __INLINE float TempTcMv(float fMv)
+	{
+	if (fMv >= 0)
+#ifdef THER_NU_P
+		return TempLutNu(fMv, C_themocoupleP_x, THER_N_SEG_P, C_themocoupleP);
+#else
+		return TempLut(fMv, (float)THER_V_MIN_P, (float)(1.0/THER_V_SEG_P), THER_N_SEG_P, C_themocoupleP);
+#endif
+	else
+#ifdef THER_NU_N
+		return TempLutNu(fMv, C_themocoupleN_x, THER_N_SEG_N, C_themocoupleN);
+#else
+		return TempLut(fMv, (float)THER_V_MIN_N, (float)(1.0/THER_V_SEG_N), THER_N_SEG_N, C_themocoupleN);
+#endif
+	}
+
+/**
+	@brief float TempTcMvHint(float fMv, int *piHint)
+			==========As TempTcMv(), keeping the last table segment used for this channel.
+	@param fMv :{}	\n
+		Thermocouple voltage in mV, including the cold junction voltage.
+	@param piHint :{}	\n
+		Segment hint of the channel, see TempLutNuHint(). Both halves of the table start
+		at 0mV, so one hint serves both.
+	@return Temperature in degC.
+**/
+
+static __INLINE float TempTcMvHint(float fMv, int *piHint)
+	{
+#if !defined(THER_NU_P) && !defined(THER_NU_N)
+	(void)piHint;
+#endif
+	if (fMv >= 0)
+#ifdef THER_NU_P
+		return TempLutNuHint(fMv, C_themocoupleP_x, THER_N_SEG_P, C_themocoupleP, piHint);
+#else
+		return TempLut(fMv, (float)THER_V_MIN_P, (float)(1.0/THER_V_SEG_P), THER_N_SEG_P, C_themocoupleP);
+#endif
+	else
+#ifdef THER_NU_N
+		return TempLutNuHint(fMv, C_themocoupleN_x, THER_N_SEG_N, C_themocoupleN, piHint);
+#else
+		return TempLut(fMv, (float)THER_V_MIN_N, (float)(1.0/THER_V_SEG_N), THER_N_SEG_N, C_themocoupleN);
+#endif
+	}
+
+/**
+	@brief float TempCjMv(float t)
+			==========Convert cold junction temperature to its thermocouple equivalent voltage in mV.
+	@param t :{}	\n
+		Cold junction temperature in degC.
+	@return Thermocouple voltage in mV. One table covers the whole cold junction range.
+**/
+
+static __INLINE float TempCjMv(float t)
+	{
+#ifdef COLDJ_NU
+	return TempLutNu(t, C_cold_junction_x, COLDJ_N_SEG, C_cold_junction);
+#else
+	return TempLut(t, (float)COLDJ_T_MIN, (float)(1.0/COLDJ_T_SEG), COLDJ_N_SEG, C_cold_junction);
+#endif
+	}
+
+/**
+	@brief float CalculateThermoCoupleTemp(float v)
+			==========Convert thermocouple voltage to temperature.
+	@param v :{}	\n
+		Thermocouple voltage in V, including the cold junction voltage.
+	@return Temperature in degC.
+**/
+
+static __INLINE float CalculateThermoCoupleTemp(float v)
+	{
+	return TempTcMv(v*1000.0f);
+	}
+
+/**
+	@brief float CalculateColdJVoltage(float t)
+			==========Convert cold junction temperature to its thermocouple equivalent voltage.
+	@param t :{}	\n
+		Cold junction temperature in degC, usually from CalculateRTDTemp().
+	@return Thermocouple voltage in V.
+**/
+
+static __INLINE float CalculateColdJVoltage(float t)
+	{
+	return TempCjMv(t)*0.001f;
+	}
+
+/**
+	@brief float CalculateCjcTemp(float v, float t)
+			==========Convert a thermocouple voltage to temperature with cold junction compensation.
+	@param v :{}	\n
+		Measured thermocouple voltage in V.
+	@param t :{}	\n
+		Cold junction temperature in degC, usually from CalculateRTDTemp().
+	@return Temperature in degC.
+	@note
+		- Same result as CalculateThermoCoupleTemp(v + CalculateColdJVoltage(t)),
+		  with one cold junction lookup and one inverse lookup, all in mV.
+**/
+
+static __INLINE float CalculateCjcTemp(float v, float t)
+	{
+	return TempTcMv(v*1000.0f + TempCjMv(t));
+	}
+
+/**
+	@brief float CalculateCjcTempHint(float v, float t, int *piHint)
+			==========As CalculateCjcTemp(), keeping the last thermocouple table segment used for this channel.
+	@param v :{}	\n
+		Measured thermocouple voltage in V.
+	@param t :{}	\n
+		Cold junction temperature in degC, usually from CalculateRTDTempHint().
+	@param piHint :{}	\n
+		Segment hint of the channel, see TempLutNuHint().
+	@return Temperature in degC.
+**/
+
+static __INLINE float CalculateCjcTempHint(float v, float t, int *piHint)
+	{
+	return TempTcMvHint(v*1000.0f + TempCjMv(t), piHint);
+	}
+#endif
+
+#endif
+
+   /**@}*/
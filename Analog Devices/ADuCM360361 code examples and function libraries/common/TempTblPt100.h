@@ -0,0 +1,25 @@
+/**
+ *****************************************************************************
+   @file     TempTblPt100.h
+   @brief    PT100 RTD table for TempLib.h, -40degC to 125degC.
+   - RTD resistance in ohms to temperature in degC.
+   Only included by TempLib.h when TEMPLIB_RTD is defined. A table for another range
+   can be generated with tools/LutGen and selected with TEMPLIB_RTD_TABLES.
+
+   @version  V0.1
+   @date     October 2026
+
+**/
+
+//RTD constants
+#define TMIN (-40)  		// = minimum temperature in degC
+#define TMAX (125)  		// = maximum temperature in degC
+#define RMIN (84.2707)  // = input resistance in ohms at -40 degC
+#define RMAX (147.951)  // = input resistance in ohms at 125 degC
+#define NSEG 30  			// = number of sections in table
+#define RSEG 2.12269  	// = (RMAX-RMIN)/NSEG = resistance  in ohms of each segment
+
+//RTD lookup table
+static const float C_rtd[NSEG+1] = {-40.0006,-34.6322,-29.2542,-23.8669,-18.4704,-13.0649,-7.65042,-2.22714,3.20489,8.64565,14.0952,
+						19.5536,25.0208,30.497,35.9821,41.4762,46.9794,52.4917,58.0131,63.5436,69.0834,74.6325,80.1909,
+						85.7587,91.3359,96.9225,102.519,108.124,113.74,119.365,124.999};
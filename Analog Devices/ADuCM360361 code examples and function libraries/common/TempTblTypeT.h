@@ -0,0 +1,56 @@
+/**
+ *****************************************************************************
+   @file     TempTblTypeT.h
+   @brief    Type T thermocouple tables for TempLib.h, -200degC to 350degC.
+   - Thermocouple voltage in mV to temperature in degC, positive and negative halves.
+   - Cold junction temperature in degC to thermocouple voltage in mV, -40degC to 125degC.
+   Only included by TempLib.h when TEMPLIB_TC is defined. A table for another range
+   can be generated with tools/LutGen and selected with TEMPLIB_TC_TABLES.
+
+   @version  V0.1
+   @date     October 2026
+
+**/
+
+// Thermocouple temperature constants
+#define THER_T_MIN_P (0)  			// = minimum positive temperature in degC
+#define THER_T_MAX_P (350) 	 	// = maximum positive temperature in degC
+#define THER_V_MIN_P (0)  			// = input voltage in mV at 0 degC
+#define THER_V_MAX_P (17.819)  	// = input voltage in mV at 350 degC
+#define THER_N_SEG_P (30)  		// = number of sections in table
+#define THER_V_SEG_P (0.59397) 	// = (THER_V_MAX-THER_V_MIN)/THER_N_SEG = Voltage in mV of each segment
+#define THER_T_MIN_N (0)  			// = minimum negative temperature in degC
+#define THER_T_MAX_N (-200)	  	// = maximum negative temperature in degC
+#define THER_V_MIN_N (0)  			// = input voltage in mV at 0 degC
+#define THER_V_MAX_N (-5.603)  	// = input voltage in mV at -200 degC
+#define THER_N_SEG_N (20)  		// = number of sections in table
+#define THER_V_SEG_N (-0.28015) 	// = (THER_V_MAX-THER_V_MIN)/THER_N_SEG = Voltage in mV of each segment
+
+// Thermocouple lookup tables....
+static const float C_themocoupleP[THER_N_SEG_P+1] = {0.0, 	15.1417, 	29.8016, 	44.0289, 	57.8675, 	71.3563,
+									84.5295, 	97.4175, 	110.047, 	122.441, 	134.62,		146.602,
+									158.402, 	170.034, 	181.51, 	192.841, 	204.035, 	215.101,
+									226.046, 	236.877, 	247.6,		258.221, 	268.745, 	279.177,
+									289.522, 	299.784, 	309.969, 	320.079, 	330.119, 	340.092,
+									350.001};
+static const float C_themocoupleN[THER_N_SEG_N+1] = {0.0,		-7.30137,	-14.7101,	-22.2655,
+									-29.9855, 	-37.8791, 	-45.9548, 	-54.2258,
+									-62.7115, 	-71.4378, 	-80.4368,	-89.7453,
+									-99.4048, 	-109.463, 	-119.978, 	-131.025,
+									-142.707, 	-155.173, 	-168.641, 	-183.422,
+									-199.964};
+
+// Cold Junction constants, one table over the whole cold junction range (LutGen -t coldj -e 0.0005)
+#define COLDJ_T_MIN (-40)  		// = minimum temperature in degC
+#define COLDJ_T_MAX (125)		// = maximum temperature in degC
+#define COLDJ_V_MIN (-1.474992)	// = input voltage in mV at -40 degC
+#define COLDJ_V_MAX (5.470261)	// = input voltage in mV at 125 degC
+#define COLDJ_N_SEG (27) 		// = number of sections in table
+#define COLDJ_T_SEG (6.111111)	// = (COLDJ_T_MAX-COLDJ_T_MIN)/COLDJ_N_SEG = Temperature in degC of each segment
+
+//Cold junction lookup table. Used for converting cold junction temperature to thermocouple voltage
+static const float C_cold_junction[COLDJ_N_SEG+1] = {-1.474992,	-1.25977,	-1.040829,	-0.8181942,	-0.591895,	-0.3620065,
+												-0.1286715,	0.1078948,	0.3471899,	0.5893055,	0.834402,	1.082591,
+												1.333942,	1.588493,	1.846252,	2.107207,	2.371329,	2.638576,
+												2.908896,	3.182234,	3.458527,	3.737714,	4.019732,	4.304522,
+												4.592023,	4.882181,	5.174943,	5.470261};
@@ -0,0 +1,273 @@
+/**
+ *****************************************************************************
+   @addtogroup tlm
+   @{
+   @file     TlmLib.c
+   @brief    Batched binary telemetry.
+   - Set up the batches with TlmCfg().
+   - Add samples with TlmAdd(). A batch is closed when a channel holds the batch size
+     or when the time window from its first sample is over.
+   - A closed batch is sent as one packet by DMA, from TlmPoll() or TlmAdd() as soon as
+     the UART is idle. Call TlmTxIsr() from DMA_UART_TX_Int_Handler.
+   Each packet carries one timestamp base. The samples of each channel follow as
+   differences from the previous sample: time difference, then value difference, in
+   variable length bytes. Slowly changing values at a steady rate take 2 or 3 bytes
+   per sample instead of a text line each, and one header for the whole batch.
+
+   @version  V0.1
+   @date     October 2026
+
+All files for ADuCM360 provided by ADI, including this file, are
+provided  as is without warranty of any kind, either expressed or implied.
+The user assumes any and all risk from the use of this code.
+It is the responsibility of the person integrating this code into an application
+to ensure that the resulting application performs as required and is safe.
+
+**/
+
+#include "TlmLib.h"
+#include <ADuCM360.h>
+#include "DmaLib.h"
+#include "UrtLib.h"
+
+// Batch being filled. TlmAdd() and TlmPoll() run in the same context, so only
+// iTlmTx is shared with the DMA interrupt.
+static long lTlmVal[TLM_CHANS][TLM_BATCH];
+static unsigned long ulTlmTime[TLM_CHANS][TLM_BATCH];
+static int iTlmNum[TLM_CHANS];
+static int iTlmHeld = 0;						// samples in the batch
+static int iTlmClosed = 0;					// batch waiting for the packet buffer
+static unsigned long ulTlmBase = 0;			// time of the first sample of the batch
+static unsigned char ucTlmRaw[TLM_RAW_MAX];
+static unsigned char ucTlmPkt[URT_COBS_LEN(TLM_RAW_MAX)];
+static int iTlmPktLen = 0;
+static volatile int iTlmTx = 0;				// 0 free, 1 packet waiting for the UART, 2 sending
+static ADI_UART_TypeDef *pTlmPort = 0;
+static int iTlmBatch = TLM_BATCH;
+static unsigned long ulTlmWindow = 0;
+static int iTlmDec = 0;
+static unsigned long ulTlmSta[4];
+
+/**
+	@brief int TlmCfg(ADI_UART_TypeDef *pPort, int iBatch, unsigned long ulWindow, int iDec)
+			==========Set up the batches.
+	@param pPort :{pADI_UART,}	\n
+		Set to pADI_UART. The UART must already be set up with UrtCfg().
+	@param iBatch :{1-TLM_BATCH}	\n
+		Samples per channel that close a batch.
+	@param ulWindow :{0,}	\n
+		Time from the first sample of a batch that closes it, in the units of the
+		timestamps given to TlmAdd(). 0 to close batches on their size only.
+	@param iDec :{0-15}	\n
+		Number of decimals of the values, 0 for raw codes. The host scales the values with it.
+	@return 1, or 0 for an invalid iBatch.
+	@note
+		- DmaBase() must have been called and DMA_UART_TX_IRQn enabled in the NVIC.
+		- Uses the UARTTX_C DMA channel. A packet only starts when the UrtWrite() queue
+		  is empty and the UART is idle, so text and packets can share the line as long as
+		  UrtWrite() is not called while TlmBusy() returns 1.
+		- Samples held from a previous configuration are discarded.
+**/
+
+int TlmCfg(ADI_UART_TypeDef *pPort, int iBatch, unsigned long ulWindow, int iDec)
+	{
+	int i;
+
+	if ((iBatch < 1) || (iBatch > TLM_BATCH))
+		return 0;
+	pTlmPort = pPort;
+	iTlmBatch = iBatch;
+	ulTlmWindow = ulWindow;
+	iTlmDec = iDec & 0xF;
+	for (i = 0; i < TLM_CHANS; i++)
+		iTlmNum[i] = 0;
+	iTlmHeld = 0;
+	iTlmClosed = 0;
+	DmaPeripheralStructSetup(UARTTX_C,DMA_DSTINC_NO|DMA_SRCINC_BYTE|DMA_SIZE_BYTE);
+	pPort->COMIEN |= COMIEN_EDMAT;
+	return 1;
+	}
+
+/**
+	@brief int TlmAdd(int iChan, unsigned long ulTime, long lVal)
+			==========Add a sample to the batch.
+	@param iChan :{0-TLM_CHANS-1}	\n
+		Channel id.
+	@param ulTime :{}	\n
+		Timestamp of the sample, from a counter that only counts up (wrapping at 2^32 is fine).
+	@param lVal :{}	\n
+		Value, raw code or fixed point value with the decimals given to TlmCfg().
+	@return 1 if added, 0 if dropped because the channel is full and the previous packet
+		still waits for the UART, -1 for an invalid iChan.
+	@note
+		- Call from the main loop, in the same context as TlmPoll(), not from interrupts.
+		- Sends the batch at once when it is closed and the UART is idle.
+**/
+
+int TlmAdd(int iChan, unsigned long ulTime, long lVal)
+	{
+	int iNum;
+
+	if ((iChan < 0) || (iChan >= TLM_CHANS))
+		return -1;
+	iNum = iTlmNum[iChan];
+	if (iNum >= iTlmBatch)
+		{
+		TlmPoll(ulTime);						// room again if the previous packet has gone
+		iNum = iTlmNum[iChan];
+		if (iNum >= iTlmBatch)
+			{
+			ulTlmSta[TLM_STA_DROP]++;
+			return 0;
+			}
+		}
+	if (iTlmHeld == 0)
+		ulTlmBase = ulTime;
+	ulTlmTime[iChan][iNum] = ulTime;
+	lTlmVal[iChan][iNum] = lVal;
+	iTlmNum[iChan] = iNum + 1;
+	iTlmHeld++;
+	if (iNum + 1 == iTlmBatch)
+		iTlmClosed = 1;
+	TlmPoll(ulTime);
+	return 1;
+	}
+
+// Variable length unsigned value, 7 bits per byte, least significant first, bit 7 set
+// when more bytes follow
+static int TlmVarint(unsigned char *pOut, unsigned long ulVal)
+	{
+	int iLen = 0;
+
+	ulVal &= 0xFFFFFFFF;
+	while (ulVal >= 0x80)
+		{
+		pOut[iLen++] = (unsigned char)(ulVal | 0x80);
+		ulVal >>= 7;
+		}
+	pOut[iLen++] = (unsigned char)ulVal;
+	return iLen;
+	}
+
+// Encode the batch into ucTlmPkt and empty it
+static void TlmEncode(void)
+	{
+	int iLen = 6;
+	int iBlocks = 0;
+	int i, j;
+
+	ucTlmRaw[1] = (unsigned char)(URT_TLM_BATCH | iTlmDec);
+	for (j = 0; j < 4; j++)
+		ucTlmRaw[2 + j] = (unsigned char)(ulTlmBase >> (8*j));
+	for (i = 0; i < TLM_CHANS; i++)
+		{
+		unsigned long ulPrevTime = ulTlmBase;
+		long lPrevVal = 0;
+
+		if (iTlmNum[i] == 0)
+			continue;
+		iBlocks++;
+		ucTlmRaw[iLen++] = (unsigned char)i;
+		ucTlmRaw[iLen++] = (unsigned char)iTlmNum[i];
+		for (j = 0; j < iTlmNum[i]; j++)
+			{
+			long lDiff = (long)((unsigned long)lTlmVal[i][j] - (unsigned long)lPrevVal);
+
+			iLen += TlmVarint(ucTlmRaw + iLen, ulTlmTime[i][j] - ulPrevTime);
+			// Zigzag: small negative differences become small odd numbers
+			iLen += TlmVarint(ucTlmRaw + iLen, ((unsigned long)lDiff << 1) ^ (unsigned long)(lDiff >> 31));
+			ulPrevTime = ulTlmTime[i][j];
+			lPrevVal = lTlmVal[i][j];
+			}
+		ulTlmSta[TLM_STA_VALS] += iTlmNum[i];
+		iTlmNum[i] = 0;
+		}
+	ucTlmRaw[0] = (unsigned char)iBlocks;
+	i = UrtCrc16(ucTlmRaw, iLen, 0xFFFF);
+	ucTlmRaw[iLen++] = (unsigned char)(i >> 8);
+	ucTlmRaw[iLen++] = (unsigned char)i;
+	iTlmPktLen = UrtCobs(ucTlmRaw, iLen, ucTlmPkt);
+	iTlmHeld = 0;
+	iTlmClosed = 0;
+	}
+
+/**
+	@brief int TlmPoll(unsigned long ulNow)
+			==========Close the batch when its window is over and send the closed batch.
+	@param ulNow :{}	\n
+		Current time, in the units of the timestamps given to TlmAdd().
+	@return 1 if a packet was started, 0 otherwise.
+	@note
+		- Call from the main loop as often as possible, so a batch is not held longer
+		  than the window when the samples stop.
+		- The batch is encoded as soon as the packet buffer is free, so new samples go to
+		  the next batch while the packet waits for the UART.
+**/
+
+int TlmPoll(unsigned long ulNow)
+	{
+	if (iTlmHeld && ulTlmWindow && (ulNow - ulTlmBase >= ulTlmWindow))
+		iTlmClosed = 1;
+	if (iTlmClosed && (iTlmTx == 0))
+		{
+		TlmEncode();
+		iTlmTx = 1;
+		}
+	if ((iTlmTx != 1) || (UrtWriteFree(pTlmPort) < URT_TX_SIZE-1) || !(pTlmPort->COMLSR & COMLSR_TEMT))
+		return 0;
+	iTlmTx = 2;
+	// The first byte is written by the core and starts the transfer of the others
+	DmaStructPtrOutSetup(UARTTX_C,iTlmPktLen-1,ucTlmPkt+1);
+	DmaCycleCntCtrl(UARTTX_C,iTlmPktLen-1,DMA_BASIC);
+	pTlmPort->COMTX = ucTlmPkt[0];
+	DmaClr(DMARMSKCLR_UARTTX,0,DMAALTCLR_UARTTX,0);
+	DmaSet(0,DMAENSET_UARTTX,0,0);
+	return 1;
+	}
+
+/**
+	@brief int TlmTxIsr(void)
+			==========Handle the end of a packet.
+	@return 1 when a packet has been sent, 0 otherwise.
+	@note
+		- Call from DMA_UART_TX_Int_Handler.
+**/
+
+int TlmTxIsr(void)
+	{
+	if (iTlmTx != 2)
+		return 0;
+	DmaSet(DMARMSKSET_UARTTX,0,0,0);
+	ulTlmSta[TLM_STA_PKTS]++;
+	ulTlmSta[TLM_STA_BYTES] += iTlmPktLen;
+	iTlmTx = 0;
+	return 1;
+	}
+
+/**
+	@brief int TlmBusy(void)
+			==========Check whether a packet is being sent.
+	@return 1 while a packet is being sent, UrtWrite() must not be called then. 0 otherwise.
+**/
+
+int TlmBusy(void)
+	{
+	return (iTlmTx == 2) ? 1 : 0;
+	}
+
+/**
+	@brief unsigned long TlmSta(int iSta)
+			==========Read a counter.
+	@param iSta :{TLM_STA_PKTS,TLM_STA_VALS,TLM_STA_BYTES,TLM_STA_DROP}	\n
+		Counter to read.
+	@return Value of the counter since reset, 0 for an invalid iSta.
+**/
+
+unsigned long TlmSta(int iSta)
+	{
+	if ((iSta < 0) || (iSta > TLM_STA_DROP))
+		return 0;
+	return ulTlmSta[iSta];
+	}
+
+   /**@}*/
@@ -0,0 +1,53 @@
+/**
+ *****************************************************************************
+   @file     TlmLib.h
+   @brief    Batched binary telemetry.
+   - Set up the batches with TlmCfg().
+   - Add samples with TlmAdd(). Samples of several channels are sent together as one
+     packet when a channel holds the batch size or when the time window is over.
+   - Call TlmPoll() from the main loop and TlmTxIsr() from DMA_UART_TX_Int_Handler.
+   - Decode the packets on the host with tools/TlmDump.
+
+   @version  V0.1
+   @date     October 2026
+
+All files for ADuCM360 provided by ADI, including this file, are
+provided  as is without warranty of any kind, either expressed or implied.
+The user assumes any and all risk from the use of this code.
+It is the responsibility of the person integrating this code into an application
+to ensure that the resulting application performs as required and is safe.
+
+**/
+
+#include <ADuCM360.h>
+
+extern int TlmCfg(ADI_UART_TypeDef *pPort, int iBatch, unsigned long ulWindow, int iDec);
+extern int TlmAdd(int iChan, unsigned long ulTime, long lVal);
+extern int TlmPoll(unsigned long ulNow);
+extern int TlmTxIsr(void);
+extern int TlmBusy(void);
+extern unsigned long TlmSta(int iSta);
+
+// Number of channels, ids 0 to TLM_CHANS-1
+#ifndef TLM_CHANS
+#define TLM_CHANS	2
+#endif
+
+// Largest batch size in samples per channel
+#ifndef TLM_BATCH
+#define TLM_BATCH	16
+#endif
+
+// TlmSta() counters
+#define TLM_STA_PKTS	0				// packets sent
+#define TLM_STA_VALS	1				// samples packed into packets
+#define TLM_STA_BYTES	2				// bytes sent, framing included
+#define TLM_STA_DROP	3				// samples dropped because their channel was full
+
+// Largest packet before framing: header, per channel its id, count and 5+5 bytes per
+// sample at most, then the CRC
+#define TLM_RAW_MAX	(6 + TLM_CHANS*(2 + 10*TLM_BATCH) + 2)
+
+#if (TLM_BATCH > 255) || (TLM_RAW_MAX > 1000)
+#error "TLM_BATCH or TLM_CHANS too large for one packet"
+#endif
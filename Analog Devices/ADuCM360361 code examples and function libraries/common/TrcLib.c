@@ -0,0 +1,225 @@
+/**
+ *****************************************************************************
+   @addtogroup trc
+   @{
+   @file     TrcLib.c
+   @brief    Deferred binary trace.
+   - Set up the trace with TrcCfg().
+   - Record events with TRC(id, arg0, arg1) or TrcLog(). An event is an id and two 32 bit
+     arguments, stamped with the value of a timer. Recording only claims a slot of a RAM
+     ring and writes 3 words, it can be done from any interrupt.
+   - Call TrcFlush() from the main loop. When the UART is idle it sends the events recorded
+     so far by DMA, straight from the ring, after an 8 byte burst header.
+   - Call TrcTxIsr() from DMA_UART_TX_Int_Handler, it releases the sent events.
+   - Decode the stream on the host with tools/TrcDump.
+   Slots are claimed with an exclusive load/store, so nothing is locked and interrupts
+   stay enabled. Events recorded while the ring is full are dropped and counted.
+
+   @version  V0.1
+   @date     October 2026
+
+All files for ADuCM360 provided by ADI, including this file, are
+provided  as is without warranty of any kind, either expressed or implied.
+The user assumes any and all risk from the use of this code.
+It is the responsibility of the person integrating this code into an application
+to ensure that the resulting application performs as required and is safe.
+
+**/
+
+#include "TrcLib.h"
+#include <ADuCM360.h>
+#include "DmaLib.h"
+#include "UrtLib.h"
+
+// Only TrcLog() moves uiTrcHead and only the flush moves uiTrcTail. An entry is sent
+// once its ulHdr is set, and cleared back to 0 once sent.
+static volatile TrcEntry TrcRing[TRC_SIZE];
+static volatile unsigned int uiTrcHead = 0;
+static volatile unsigned int uiTrcTail = 0;
+static volatile unsigned int uiTrcDrop = 0;
+static ADI_UART_TypeDef *pTrcPort = 0;
+static ADI_TIMER_TypeDef *pTrcTmr = 0;
+static unsigned char ucTrcHdr[TRC_HDR_LEN];
+static volatile int iTrcTx = 0;				// 0 idle, 1 sending the header, 2 sending the events
+static int iTrcTxNum = 0;
+
+/**
+	@brief int TrcCfg(ADI_UART_TypeDef *pPort, ADI_TIMER_TypeDef *pTmr)
+			==========Set up the trace.
+	@param pPort :{pADI_UART,}	\n
+		Set to pADI_UART. The UART must already be set up with UrtCfg().
+	@param pTmr :{0,pADI_TM0,pADI_TM1}	\n
+		Timer whose value stamps each event, set up by the application, or 0 for no timestamps.
+	@return 1.
+	@note
+		- DmaBase() must have been called and DMA_UART_TX_IRQn enabled in the NVIC.
+		- The trace uses the UARTTX_C DMA channel. A burst only starts when the UrtWrite()
+		  queue is empty and the UART is idle, so text and trace bursts can share the line
+		  as long as UrtWrite() is not called while a burst is sent.
+**/
+
+int TrcCfg(ADI_UART_TypeDef *pPort, ADI_TIMER_TypeDef *pTmr)
+	{
+	pTrcPort = pPort;
+	pTrcTmr = pTmr;
+	ucTrcHdr[0] = TRC_MAGIC0;
+	ucTrcHdr[1] = TRC_MAGIC1;
+	ucTrcHdr[2] = TRC_VERSION;
+	ucTrcHdr[3] = 0;
+	DmaPeripheralStructSetup(UARTTX_C,DMA_DSTINC_NO|DMA_SRCINC_BYTE|DMA_SIZE_BYTE);
+	DmaPeripheralStructSetup(UARTTX_C+ALTERNATE,DMA_DSTINC_NO|DMA_SRCINC_BYTE|DMA_SIZE_BYTE);
+	pPort->COMIEN |= COMIEN_EDMAT;
+	return 1;
+	}
+
+/**
+	@brief int TrcLog(int iId, unsigned long ulArg0, unsigned long ulArg1)
+			==========Record an event.
+	@param iId :{1-65535}	\n
+		Event id, decoded by the host with its table of event formats. 0 is not allowed.
+	@param ulArg0 :{}	\n
+		First argument.
+	@param ulArg1 :{}	\n
+		Second argument.
+	@return 1 if recorded, 0 if dropped because the ring is full or iId is out of range.
+**/
+
+int TrcLog(int iId, unsigned long ulArg0, unsigned long ulArg1)
+	{
+	unsigned long ulTime = 0;
+	unsigned int uiIdx;
+	volatile TrcEntry *pEntry;
+
+	if ((iId <= 0) || (iId > 0xFFFF))
+		return 0;
+	if (pTrcTmr)
+		ulTime = pTrcTmr->VAL;
+	// Claim a slot. An interrupt that claims one in between makes the store fail and the claim is retried.
+#ifdef __GNUC__
+	do
+		{
+		uiIdx = uiTrcHead;
+		if (uiIdx - uiTrcTail >= TRC_SIZE)
+			{
+			__sync_fetch_and_add(&uiTrcDrop, 1);
+			return 0;
+			}
+		}
+	while (!__sync_bool_compare_and_swap(&uiTrcHead, uiIdx, uiIdx + 1));
+#else
+	do
+		{
+		uiIdx = __LDREXW((uint32_t *)&uiTrcHead);
+		if (uiIdx - uiTrcTail >= TRC_SIZE)
+			{
+			__CLREX();
+			do
+				uiIdx = __LDREXW((uint32_t *)&uiTrcDrop);
+			while (__STREXW(uiIdx + 1, (uint32_t *)&uiTrcDrop));
+			return 0;
+			}
+		}
+	while (__STREXW(uiIdx + 1, (uint32_t *)&uiTrcHead));
+#endif
+	pEntry = &TrcRing[uiIdx & (TRC_SIZE-1)];
+	pEntry->ulArg0 = ulArg0;
+	pEntry->ulArg1 = ulArg1;
+	pEntry->ulHdr = (unsigned long)iId | (ulTime << 16);	// written last, marks the entry complete
+	return 1;
+	}
+
+/**
+	@brief int TrcFlush(void)
+			==========Start sending the recorded events.
+	@return Number of events being sent, 0 if a burst is already being sent, the UART
+		is busy or no event is complete.
+	@note
+		- Call from the main loop or a low priority interrupt, as often as possible.
+		- A burst sends the complete events from the oldest on, up to the end of the ring
+		  or TRC_BURST events. An event still being written ends the burst.
+		- The header carries the count of events dropped since TrcCfg(), modulo 65536.
+**/
+
+int TrcFlush(void)
+	{
+	unsigned int uiIdx = uiTrcTail & (TRC_SIZE-1);
+	unsigned int uiDrop;
+	int iNum = 0;
+	int iLen;
+
+	if (iTrcTx || (UrtWriteFree(pTrcPort) < URT_TX_SIZE-1) || !(pTrcPort->COMLSR & COMLSR_TEMT))
+		return 0;
+	while ((iNum < TRC_SIZE - (int)uiIdx) && (iNum < (int)TRC_BURST) && TrcRing[uiIdx + iNum].ulHdr)
+		iNum++;
+	if (iNum == 0)
+		return 0;
+	uiDrop = uiTrcDrop;
+	ucTrcHdr[4] = (unsigned char)iNum;
+	ucTrcHdr[5] = (unsigned char)(iNum >> 8);
+	ucTrcHdr[6] = (unsigned char)uiDrop;
+	ucTrcHdr[7] = (unsigned char)(uiDrop >> 8);
+	iTrcTxNum = iNum;
+	iTrcTx = 1;
+	// Header on the primary structure, events on the alternate one, so the DMA goes on
+	// from one to the other without stopping. The first byte starts the transfer.
+	iLen = iNum*sizeof(TrcEntry);
+	DmaStructPtrOutSetup(UARTTX_C,TRC_HDR_LEN-1,ucTrcHdr+1);
+	DmaCycleCntCtrl(UARTTX_C,TRC_HDR_LEN-1,DMA_PING);
+	DmaStructPtrOutSetup(UARTTX_C+ALTERNATE,iLen,(unsigned char *)&TrcRing[uiIdx]);
+	DmaCycleCntCtrl(UARTTX_C+ALTERNATE,iLen,DMA_PING);
+	pTrcPort->COMTX = ucTrcHdr[0];
+	DmaClr(DMARMSKCLR_UARTTX,0,DMAALTCLR_UARTTX,0);
+	DmaSet(0,DMAENSET_UARTTX,0,0);
+	return iNum;
+	}
+
+/**
+	@brief int TrcTxIsr(void)
+			==========Handle the end of a DMA cycle of a burst.
+	@return 1 when the events of the burst have been sent and released, 0 otherwise.
+	@note
+		- Call from DMA_UART_TX_Int_Handler.
+**/
+
+int TrcTxIsr(void)
+	{
+	int i;
+
+	if (iTrcTx == 1)							// header sent, the events follow
+		{
+		iTrcTx = 2;
+		return 0;
+		}
+	if (iTrcTx != 2)
+		return 0;
+	DmaSet(DMARMSKSET_UARTTX,0,0,0);
+	for (i = 0; i < iTrcTxNum; i++)
+		TrcRing[(uiTrcTail + i) & (TRC_SIZE-1)].ulHdr = 0;
+	uiTrcTail += iTrcTxNum;
+	iTrcTx = 0;
+	return 1;
+	}
+
+/**
+	@brief int TrcBusy(void)
+			==========Check whether a burst is being sent.
+	@return 1 while a burst is being sent, UrtWrite() must not be called then. 0 otherwise.
+**/
+
+int TrcBusy(void)
+	{
+	return iTrcTx ? 1 : 0;
+	}
+
+/**
+	@brief int TrcDropped(void)
+			==========Read the number of dropped events.
+	@return Events dropped since TrcCfg() because the ring was full.
+**/
+
+int TrcDropped(void)
+	{
+	return (int)uiTrcDrop;
+	}
+
+   /**@}*/
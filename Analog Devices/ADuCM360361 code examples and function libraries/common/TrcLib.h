@@ -0,0 +1,58 @@
+/**
+ *****************************************************************************
+   @file     TrcLib.h
+   @brief    Deferred binary trace.
+   - Set up the trace with TrcCfg().
+   - Record events with TRC(id, arg0, arg1) or TrcLog() from interrupts or the main loop.
+   - Call TrcFlush() from the main loop to send recorded events over the UART with DMA,
+     and TrcTxIsr() from DMA_UART_TX_Int_Handler.
+   - Decode the stream on the host with tools/TrcDump.
+
+   @version  V0.1
+   @date     October 2026
+
+All files for ADuCM360 provided by ADI, including this file, are
+provided  as is without warranty of any kind, either expressed or implied.
+The user assumes any and all risk from the use of this code.
+It is the responsibility of the person integrating this code into an application
+to ensure that the resulting application performs as required and is safe.
+
+**/
+
+#include <ADuCM360.h>
+
+// One recorded event, sent as is: 3 words, 12 bytes, little endian
+typedef struct
+{
+	uint32_t ulHdr;						// event id in bits 0-15, timestamp in bits 16-31, 0 while being written
+	uint32_t ulArg0;
+	uint32_t ulArg1;
+} TrcEntry;
+
+extern int TrcCfg(ADI_UART_TypeDef *pPort, ADI_TIMER_TypeDef *pTmr);
+extern int TrcLog(int iId, unsigned long ulArg0, unsigned long ulArg1);
+extern int TrcFlush(void);
+extern int TrcTxIsr(void);
+extern int TrcBusy(void);
+extern int TrcDropped(void);
+
+// Ring size in events, a power of 2
+#ifndef TRC_SIZE
+#define TRC_SIZE	64
+#endif
+
+// Events per burst, limited by the 1024 transfers of a DMA cycle
+#define TRC_BURST	(1024/sizeof(TrcEntry))
+
+// Burst header: TRC_MAGIC0/1, version, 0, event count and dropped count (16 bits each, little endian)
+#define TRC_MAGIC0	0xA5
+#define TRC_MAGIC1	0x54
+#define TRC_VERSION	1
+#define TRC_HDR_LEN	8
+
+// Define TRC_OFF to compile the TRC() calls out
+#ifdef TRC_OFF
+#define TRC(iId, ulArg0, ulArg1)
+#else
+#define TRC(iId, ulArg0, ulArg1)	TrcLog((iId), (unsigned long)(ulArg0), (unsigned long)(ulArg1))
+#endif
@@ -5,19 +5,26 @@
    @file     UrtLib.c
    @brief    Set of UART peripheral functions.
    - Configure the UART pins by setting the mux options in GPCON
-   - Configure UART with UrtCfg().
+   - Configure UART with UrtCfg(), change the baud rate with UrtBaud().
    - Set modem control with UrtMod() if desired.
    - Check space in Tx buffer with UrtLinSta().
    - Output character with UrtTx().
    - Read characters with UrtRx().
+   - Queue data for interrupt driven transmission with UrtWrite(), call UrtWriteIsr()
+     from UART_Int_Handler when the transmit buffer is empty.
+   - Queue binary telemetry packets with UrtTlmSend(), frame packets with UrtCobs().
    
-   @version  V0.3
+   @version  V0.7
    @author   ADI
-   @date     April 2013
+   @date     October 2026
    @par Revision History:
    - V0.1, March 2012: initial version. 
    - V0.2, October 2012: Fixed Baud rate generation function
    - V0.3, April 2013: Fixed doxygen comments
+   - V0.4, October 2026: Added UrtWrite(), UrtWriteFree() and UrtWriteIsr().
+   - V0.5, October 2026: Added UrtTlmSend() and UrtCrc16().
+   - V0.6, October 2026: Added UrtBaud(), UrtCfg() uses the actual UART clock.
+   - V0.7, October 2026: Added UrtCobs(), packets longer than 254 bytes.
 
      
 
@@ -32,16 +39,27 @@ to ensure that the resulting application performs as required and is safe.
 #include "UrtLib.h"
 #include <ADuCM360.h>
 #include "DmaLib.h"
+#include "ClkLib.h"
+
+// Transmit queue for UrtWrite(). UrtWrite() only moves uiUrtTxHead and UrtWriteIsr()
+// only moves uiUrtTxTail, so neither needs to disable interrupts.
+static volatile unsigned char ucUrtTxBuf[URT_TX_SIZE];
+static volatile unsigned int uiUrtTxHead = 0;
+static volatile unsigned int uiUrtTxTail = 0;
+
+// CRC-16/CCITT-FALSE, one nibble at a time
+static const unsigned short usUrtCrcTbl[16] = {0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+											  0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF};
 
 /**
 	@brief int UrtCfg(ADI_UART_TypeDef *pPort, int iBaud, int iBits, int iFormat)
 			==========Configure the UART.
 	@param pPort :{pADI_UART,}	\n
 		Set to pADI_UART. Only one channel available.
-	@param iBaud :{B1200,B2200,B2400,B4800,B9600,B19200,B38400,B57600,B115200,B230400,B430800}	\n
+	@param iBaud :{B1200,B2200,B2400,B4800,B9600,B19200,B38400,B57600,B115200,B230400,B460800,B921600}	\n
 		Set iBaud to the baudrate required:
 		Values usually: 1200, 2200 (for HART), 2400, 4800, 9600, 
-		        19200, 38400, 57600, 115200, 230400, 430800, or type in baud-rate directly 
+		        19200, 38400, 57600, 115200, 230400, 460800, or type in baud-rate directly 
 	@param iBits :{COMLCR_WLS_5BITS,COMLCR_WLS_6BITS,COMLCR_WLS_7BITS,COMLCR_WLS_8BITS}	\n
 			- 0 = COMLCR_WLS_5BITS for data length 5bits.
 			- 1 = COMLCR_WLS_6BITS for data length 6bits.
@@ -57,64 +75,79 @@ to ensure that the resulting application performs as required and is safe.
 	@return Value of COMLSR: See UrtLinSta() function for bit details.
 	@note
 		- Powers up UART if not powered up.
-		- Standard baudrates are accurate to better than 0.1% plus clock error.\n
-		- Non standard baudrates are accurate to better than 1% plus clock error.
+		- The baud rate is set with UrtBaud(), from the UART clock selected when UrtCfg()
+		  is called. Call UrtBaud() directly to know the baud rate error.
 **/
 
 int UrtCfg(ADI_UART_TypeDef *pPort, int iBaud, int iBits, int iFormat)
 	{
-	int i1;
-	int iDiv;
-			
-	iDiv = (pADI_CLKCTL->CLKCON1& 0x0E00);// Read UART clock as set by CLKCON1
-	iDiv = iDiv>>9;
-	
-	switch (iDiv)
-		{
-			case 0:
-				iDiv = 1;
-			  break;
-			
-			case 1:
-				iDiv = 2;
-			  break;
-			
-			case 2:
-				iDiv = 4;
-			  break;
-		
-	    case 3:
-				iDiv = 8;
-			  break;
-		
-			case 4:
-				iDiv = 16;
-			  break;
-			
-			case 5:
-				iDiv = 32;
-			  break;
-			
-			case 6:
-				iDiv = 64;
-			  break;	
-			
-			case 7:
-				iDiv = 128;
-			  break;
-			default:	 
-		     break;
-			}
-			if ((pADI_CLKCTL->CLKSYSDIV& 0x1)==1)
-				 iDiv = iDiv*2;
-	i1 = (16000000/(32*iDiv))/iBaud;	  // UART baud rate clock source is UARTCLK divided by 32
-	pPort->COMDIV = i1;
-	pPort->COMFBR = 0x8800|(((((2048/(32*iDiv))*16000000)/i1)/iBaud)-2048);
+	UrtBaud(pPort, iBaud);
 	pPort->COMIEN = 0;
 	pPort->COMLCR = (iFormat&0x3c)|(iBits&3);	
 	return	pPort->COMLSR;
 	}
 
+/**
+	@brief int UrtBaud(ADI_UART_TypeDef *pPort, long lBaud)
+			==========Set the baud rate from the actual UART clock.
+	@param pPort :{pADI_UART,}	\n
+		Set to pADI_UART. Only one channel available.
+	@param lBaud :{B1200,B2200,B2400,B4800,B9600,B19200,B38400,B57600,B115200,B230400,B460800,B921600}	\n
+		Baud rate required.
+	@return Error of the baud rate set, in ppm: (actual-lBaud)*1000000/lBaud.
+	@note
+		- The UART clock is read with ClkFreq(CLK_FREQ_UART), so it follows ClkCfg(),
+		  ClkSel() and XOSCCfg(). Call UrtBaud() again after changing them.
+		- Baud rate = UART clock/(32*COMDIV*(M+N/2048)) with M 1 to 3 and N 0 to 2047.
+		  UrtBaud() tries every COMDIV and keeps the pair with the smallest error.
+		- The highest baud rate is the UART clock/32, 500000 with a 16MHz UART clock.
+		  Above it the highest rate is set and the error returned is negative.
+		- An error within +/-20000ppm (2%) is usually tolerated by receivers.
+**/
+
+int UrtBaud(ADI_UART_TypeDef *pPort, long lBaud)
+	{
+	unsigned long ulK;
+	unsigned long ulDiv;
+	unsigned long ulDivMax;
+	unsigned long ulQ;
+	unsigned long ulErr;
+	unsigned long ulBestDiv = 1;
+	unsigned long ulBestQ = 2048;
+	unsigned long ulBestErr = 0xFFFFFFFF;
+
+	if (lBaud < 1)
+		return 0;
+	// COMDIV*(2048*M+N) must be 2048*UARTCLK/(32*lBaud) = ulK/lBaud, with 2048*M+N from 2048 to 8191
+	ulK = (unsigned long)ClkFreq(CLK_FREQ_UART)*64;
+	ulDiv = ulK/8191/lBaud;
+	if (ulDiv < 1)
+		ulDiv = 1;
+	ulDivMax = ulK/2048/lBaud;
+	if (ulDivMax > 0xFFFF)
+		ulDivMax = 0xFFFF;
+	for (; (ulDiv <= ulDivMax) && (ulBestErr != 0); ulDiv++)
+		{
+		ulQ = (ulK/ulDiv + lBaud/2)/lBaud;
+		if (ulQ < 2048)
+			ulQ = 2048;
+		if (ulQ > 8191)
+			ulQ = 8191;
+		ulErr = ulDiv*ulQ*lBaud;
+		ulErr = (ulErr > ulK) ? ulErr - ulK : ulK - ulErr;
+		if (ulErr < ulBestErr)
+			{
+			ulBestErr = ulErr;
+			ulBestDiv = ulDiv;
+			ulBestQ = ulQ;
+			}
+		}
+	pPort->COMDIV = ulBestDiv;
+	pPort->COMFBR = 0x8000|ulBestQ;			// FBEN, M in bits 11-12, N in bits 0-10
+	ulErr = ulBestDiv*ulBestQ*lBaud;
+	return (int)(((float)ulK - (float)ulErr)*1000000.0f/(float)ulErr);
+	}
+
 /**
 	@brief int UrtBrk(ADI_UART_TypeDef *pPort, int iBrk)
 			==========Force SOUT pin to 0
@@ -311,4 +344,207 @@ int UrtIntSta(ADI_UART_TypeDef *pPort)
 	return pPort->COMIIR;
 	}
 
+/**
+	@brief int UrtWrite(ADI_UART_TypeDef *pPort, const unsigned char *pBuf, int iLen)
+			==========Queue bytes for interrupt driven transmission.
+	@param pPort :{pADI_UART,}	\n
+		Set to pADI_UART. Only one channel available.
+	@param pBuf :{}	\n
+		Bytes to send. They are copied, so the buffer can be reused on return.
+	@param iLen :{0-URT_TX_SIZE-1}	\n
+		Number of bytes to send.
+	@return Number of bytes queued. Less than iLen if the queue is full:
+		the caller can retry the rest later or drop it.
+	@note
+		- Enables the transmit buffer empty interrupt. UART_Int_Handler must call
+		  UrtWriteIsr() when COMIIR reports the transmit buffer empty, and the
+		  UART interrupt must be enabled in the NVIC.
+		- Must not be called from an interrupt handler while the main loop also uses it.
+**/
+
+int UrtWrite(ADI_UART_TypeDef *pPort, const unsigned char *pBuf, int iLen)
+	{
+	unsigned int uiHead = uiUrtTxHead;
+	int iFree = (uiUrtTxTail - uiHead - 1) & (URT_TX_SIZE-1);
+	int i;
+
+	if (iLen > iFree)
+		iLen = iFree;
+	for (i = 0; i < iLen; i++)
+		{
+		ucUrtTxBuf[uiHead] = pBuf[i];
+		uiHead = (uiHead + 1) & (URT_TX_SIZE-1);
+		}
+	uiUrtTxHead = uiHead;						// publish the data to UrtWriteIsr()
+	if (iLen)
+		pPort->COMIEN |= COMIEN_ETBEI;			// interrupt fires at once if COMTX is already empty
+	return iLen;
+	}
+
+/**
+	@brief int UrtWriteFree(ADI_UART_TypeDef *pPort)
+			==========Space left in the UrtWrite() queue.
+	@param pPort :{pADI_UART,}	\n
+		Set to pADI_UART. Only one channel available.
+	@return Number of bytes UrtWrite() can accept now.
+**/
+
+int UrtWriteFree(ADI_UART_TypeDef *pPort)
+	{
+	(void)pPort;
+	return (uiUrtTxTail - uiUrtTxHead - 1) & (URT_TX_SIZE-1);
+	}
+
+/**
+	@brief int UrtWriteIsr(ADI_UART_TypeDef *pPort)
+			==========Send the next queued byte. Call from UART_Int_Handler.
+	@param pPort :{pADI_UART,}	\n
+		Set to pADI_UART. Only one channel available.
+	@return 1 if a byte was written to COMTX, 0 if the queue is empty.
+	@note
+		- Disables the transmit buffer empty interrupt when the queue is empty;
+		  UrtWrite() enables it again.
+**/
+
+int UrtWriteIsr(ADI_UART_TypeDef *pPort)
+	{
+	unsigned int uiTail = uiUrtTxTail;
+
+	if (uiTail == uiUrtTxHead)
+		{
+		pPort->COMIEN &= ~COMIEN_ETBEI;
+		return 0;
+		}
+	if ((pPort->COMLSR & COMLSR_THRE) == 0)
+		return 0;
+	pPort->COMTX = ucUrtTxBuf[uiTail];
+	uiUrtTxTail = (uiTail + 1) & (URT_TX_SIZE-1);
+	return 1;
+	}
+
+/**
+	@brief int UrtCrc16(const unsigned char *pBuf, int iLen, int iCrc)
+			==========Calculate a CRC-16/CCITT-FALSE (polynomial 0x1021, MSB first).
+	@param pBuf :{}	\n
+		Data.
+	@param iLen :{}	\n
+		Number of bytes.
+	@param iCrc :{0xFFFF,}	\n
+		Start value, 0xFFFF for a new CRC or the result of a previous call to continue.
+	@return CRC of the data. 0 when the data ends with its own CRC sent MSB first.
+**/
+
+int UrtCrc16(const unsigned char *pBuf, int iLen, int iCrc)
+	{
+	unsigned int uiCrc = iCrc;
+	int i;
+
+	for (i = 0; i < iLen; i++)
+		{
+		uiCrc = (uiCrc << 4) ^ usUrtCrcTbl[((uiCrc >> 12) ^ (pBuf[i] >> 4)) & 0xF];
+		uiCrc = (uiCrc << 4) ^ usUrtCrcTbl[((uiCrc >> 12) ^ pBuf[i]) & 0xF];
+		}
+	return uiCrc & 0xFFFF;
+	}
+
+/**
+	@brief int UrtCobs(const unsigned char *pIn, int iLen, unsigned char *pOut)
+			==========Frame a packet with COBS (consistent overhead byte stuffing).
+	@param pIn :{}	\n
+		Packet.
+	@param iLen :{}	\n
+		Number of bytes of the packet.
+	@param pOut :{}	\n
+		Frame, URT_COBS_LEN(iLen) bytes long at least.
+	@return Number of bytes of the frame, the 0 delimiter included.
+	@note
+		- The frame contains no 0 byte but the delimiter at its end. Each code byte gives
+		  the distance to the next 0 of the packet, 0xFF for a run of 254 bytes without 0.
+**/
+
+int UrtCobs(const unsigned char *pIn, int iLen, unsigned char *pOut)
+	{
+	int iCode = 0;
+	int iOut = 1;
+	int i;
+
+	for (i = 0; i < iLen; i++)
+		{
+		if (pIn[i] == 0)
+			{
+			pOut[iCode] = (unsigned char)(iOut - iCode);
+			iCode = iOut++;
+			}
+		else
+			{
+			pOut[iOut++] = pIn[i];
+			if (iOut - iCode == 0xFF)			// longest run, the next code byte adds no 0
+				{
+				pOut[iCode] = 0xFF;
+				iCode = iOut++;
+				}
+			}
+		}
+	pOut[iCode] = (unsigned char)(iOut - iCode);
+	pOut[iOut++] = 0;						// frame delimiter
+	return iOut;
+	}
+
+/**
+	@brief int UrtTlmSend(ADI_UART_TypeDef *pPort, int iChan, unsigned long ulTime, const long *plVal, int iNum, int iFmt)
+			==========Queue a binary telemetry packet.
+	@param pPort :{pADI_UART,}	\n
+		Set to pADI_UART. Only one channel available.
+	@param iChan :{0-255}	\n
+		Channel id.
+	@param ulTime :{}	\n
+		Timestamp of the first value, in units chosen by the application.
+	@param plVal :{}	\n
+		Values, raw ADC codes or fixed point values.
+	@param iNum :{1-URT_TLM_MAX}	\n
+		Number of values.
+	@param iFmt :{URT_TLM_I16|iDec, URT_TLM_I24|iDec, URT_TLM_I32|iDec}	\n
+		Bytes sent per value, ORed with the number of decimals of fixed point values (0-15).
+		- URT_TLM_I16 to send the 16 LSBs of each value.
+		- URT_TLM_I24 to send the 24 LSBs of each value, enough for ADC codes.
+		- URT_TLM_I32 to send each value in full.
+	@return Number of bytes queued, 0 if the packet was dropped because the UrtWrite()
+		queue had no room for it, -1 for invalid arguments.
+	@note
+		- Packet before encoding: iChan, iFmt, ulTime (4 bytes), the values, all
+		  little endian, then the CRC-16 of these bytes (UrtCrc16(), MSB first).
+		- The packet is framed with UrtCobs(). A receiver resynchronises on the next 0
+		  after an error.
+		- The packet is queued whole or not at all, so packets are never interleaved.
+**/
+
+int UrtTlmSend(ADI_UART_TypeDef *pPort, int iChan, unsigned long ulTime, const long *plVal, int iNum, int iFmt)
+	{
+	unsigned char ucRaw[6+4*URT_TLM_MAX+2];
+	unsigned char ucPkt[URT_COBS_LEN(sizeof(ucRaw))];
+	int iSize = (iFmt >> 4) & 7;
+	int iLen = 0;
+	int iOut;
+	int i, j;
+
+	if ((iNum < 1) || (iNum > URT_TLM_MAX) || (iSize < 2) || (iSize > 4))
+		return -1;
+	ucRaw[iLen++] = (unsigned char)iChan;
+	ucRaw[iLen++] = (unsigned char)iFmt;
+	for (j = 0; j < 4; j++)
+		ucRaw[iLen++] = (unsigned char)(ulTime >> (8*j));
+	for (i = 0; i < iNum; i++)
+		for (j = 0; j < iSize; j++)
+			ucRaw[iLen++] = (unsigned char)((unsigned long)plVal[i] >> (8*j));
+	i = UrtCrc16(ucRaw, iLen, 0xFFFF);
+	ucRaw[iLen++] = (unsigned char)(i >> 8);
+	ucRaw[iLen++] = (unsigned char)i;
+
+	iOut = UrtCobs(ucRaw, iLen, ucPkt);
+
+	if (UrtWriteFree(pPort) < iOut)
+		return 0;
+	return UrtWrite(pPort, ucPkt, iOut);
+	}
+
    /**@}*/
@@ -3,18 +3,24 @@
    @file     UrtLib.h
    @brief    Set of UART peripheral functions.
    - Configure the UART pins by setting the mux options in GPCON
-   - Configure UART with UrtCfg().
+   - Configure UART with UrtCfg(), change the baud rate with UrtBaud().
    - Set modem control with UrtMod() if desired.
    - Check space in Tx buffer with UrtLinSta().
    - Output character with UrtTx().
    - Read characters with UrtRx().
+   - Queue data for interrupt driven transmission with UrtWrite().
+   - Queue binary telemetry packets with UrtTlmSend(), frame packets with UrtCobs().
    
-   @version  V0.2
+   @version  V0.6
    @author   ADI
-   @date     October 2012
+   @date     October 2026
    @par Revision History:
    - V0.1, March 2012: initial version. 
    - V0.2, October 2012: Fixed Baud rate generation function
+   - V0.3, October 2026: Added UrtWrite(), UrtWriteFree() and UrtWriteIsr().
+   - V0.4, October 2026: Added UrtTlmSend() and UrtCrc16().
+   - V0.5, October 2026: Added UrtBaud(), B460800 and B921600.
+   - V0.6, October 2026: Added UrtCobs() and URT_TLM_BATCH.
  
 
 
@@ -29,6 +35,7 @@ to ensure that the resulting application performs as required and is safe.
 #include <ADuCM360.h>
 
 extern int UrtCfg(ADI_UART_TypeDef *pPort, int iBaud, int iBits, int iFormat);
+extern int UrtBaud(ADI_UART_TypeDef *pPort, long lBaud);
 extern int UrtBrk(ADI_UART_TypeDef *pPort, int iBrk);
 extern int UrtLinSta(ADI_UART_TypeDef *pPort);
 extern int UrtTx(ADI_UART_TypeDef *pPort, int iTx);
@@ -38,6 +45,33 @@ extern int UrtModSta(ADI_UART_TypeDef *pPort);
 extern int UrtDma(ADI_UART_TypeDef *pPort, int iDmaSel);
 extern int UrtIntCfg(ADI_UART_TypeDef *pPort, int iIrq);
 extern int UrtIntSta(ADI_UART_TypeDef *pPort);
+extern int UrtWrite(ADI_UART_TypeDef *pPort, const unsigned char *pBuf, int iLen);
+extern int UrtWriteFree(ADI_UART_TypeDef *pPort);
+extern int UrtWriteIsr(ADI_UART_TypeDef *pPort);
+extern int UrtCrc16(const unsigned char *pBuf, int iLen, int iCrc);
+extern int UrtCobs(const unsigned char *pIn, int iLen, unsigned char *pOut);
+extern int UrtTlmSend(ADI_UART_TypeDef *pPort, int iChan, unsigned long ulTime, const long *plVal, int iNum, int iFmt);
+
+// UrtWrite() queue size in bytes, must be a power of 2. One byte is kept free.
+#ifndef URT_TX_SIZE
+#define URT_TX_SIZE	256
+#endif
+
+// UrtTlmSend() maximum values per packet, sets the size of its buffers on the stack
+#ifndef URT_TLM_MAX
+#define URT_TLM_MAX	16
+#endif
+
+// UrtTlmSend() value formats, ORed with the number of decimals (0-15)
+#define URT_TLM_I16	0x20
+#define URT_TLM_I24	0x30
+#define URT_TLM_I32	0x40
+
+// Format byte of the multi-channel batches of common/TlmLib.h, ORed with the number of decimals
+#define URT_TLM_BATCH	0x80
+
+// UrtCobs() frame length for a packet of iLen bytes, delimiter included
+#define URT_COBS_LEN(iLen)	((iLen) + (iLen)/254 + 2)
 
 
 // baud rate settings
@@ -52,3 +86,5 @@ extern int UrtIntSta(ADI_UART_TypeDef *pPort);
 #define B115200	115200
 #define B230400	230400
 #define B430800	430800
+#define B460800	460800
+#define B921600	921600
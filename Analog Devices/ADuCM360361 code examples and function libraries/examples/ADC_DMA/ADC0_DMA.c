@@ -21,13 +21,14 @@
    - EVAL-ADuCM360MKZ or similar hardware is assumed
    - Results will be more accurate if System calibration is added.
    
-   @version V0.2
+   @version V0.3
    @author  ADI
-   @date    February 2013
+   @date    October 2026
 
    @par     Revision History:
    - V0.1, October 2012: initial version. 
    - V0.2, February 2013: Fixed a bug in SendString().
+   - V0.3, October 2026: RTD conversion moved to common/TempLib.h.
 
 
 
@@ -56,6 +57,8 @@ to ensure that the resulting application performs as required and is safe.
 #include <..\common\PwmLib.h>
 #include <..\common\DioLib.h>
 #include <..\common\DmaLib.h>
+#define TEMPLIB_RTD                         // RTD conversion
+#include <..\common\TempLib.h>
 
 void ADC0INIT(void);                          // Init ADC0
 void SINC2INIT(void);                         // Init SINC2
@@ -64,19 +67,7 @@ void DMAINIT(void);                           // Setup DMA controller
 void SendString(void);					          // Transmit string using UART
 void IEXCINIT(void);                 	       // Setup Excitation Current sources
 void SendResultToUART(void);			          // Send measurement results to UART - in ASCII String format
-float CalculateRTDTemp(float r);              // Calculates final temperature based on RTD resistance measurement
 void delay(long int);
-//RTD constants
-#define TMIN (-40)  					             // = minimum temperature in degC
-#define TMAX (125)  					             // = maximum temperature in degC
-#define RMIN (84.2707)  				          // = input resistance in ohms at -40 degC
-#define RMAX (147.951)  				          // = input resistance in ohms at 125 degC
-#define NSEG 30  						             // = number of sections in table
-#define RSEG 2.12269  					          // = (RMAX-RMIN)/NSEG = resistance  in ohms of each segment
-//RTD lookup table
-const float C_rtd[] = {-40.0006,-34.6322,-29.2542,-23.8669,-18.4704,-13.0649,-7.65042,-2.22714,3.20489,8.64565,14.0952,
-						19.5536,25.0208,30.497,35.9821,41.4762,46.9794,52.4917,58.0131,63.5436,69.0834,74.6325,80.1909,
-						85.7587,91.3359,96.9225,102.519,108.124,113.74,119.365,124.999};
 float fVRTD = 0.0 ;								    // RTD voltage, 
 float fRrtd = 0.0;								    // resistance of the RTD
 float fTRTD = 0.0;								    // RTD temperature
@@ -282,18 +273,6 @@ void SendResultToUART(void)
 	if (nLen <64)
  		SendString();
 }
-float CalculateRTDTemp(float r) 
-{
-	float t;
-	int j;
-	j=(int)((r-RMIN)/RSEG);       // determine which coefficients to use
-	if (j<0)                      // if input is under-range..
-		j=0;                        // ..then use lowest coefficients
-	else if (j>NSEG-1)            // if input is over-range..
-		j=NSEG-1;                   // ..then use highest coefficients
-	t = C_rtd[j]+(r-(RMIN+RSEG*j))*(C_rtd[j+1]-C_rtd[j])/RSEG;
-	return t;
-}
 
 // Simple Delay routine
 void delay (long int length)
@@ -10,14 +10,19 @@
    - The DAC is also initialised to output 150mV.
    - The DAC output may be connected to AIN1, AIN0 to ground for test purposes 
    - Default Baud rate is 9600 
+   - Define TLM_BINARY to send the ADC1 codes as binary telemetry packets instead of
+     text, 16 codes per packet. Decode them with tools/TlmDump.
 
-   @version V0.2
+   @version V0.5
    @author  ADI
-   @date    February 2013
+   @date    October 2026
 
    @par     Revision History:
    - V0.1, September 2012: initial version. 
    - V0.2, February 2013: Fixed a bug with ucTxBufferEmpty.
+   - V0.3, October 2026: Results queued with UrtWrite() instead of waiting for each character.
+   - V0.4, October 2026: Result formatted with FmtLib instead of sprintf().
+   - V0.5, October 2026: Added the TLM_BINARY option.
               
 All files for ADuCM360/361 provided by ADI, including this file, are
 provided  as is without warranty of any kind, either expressed or implied.
@@ -27,14 +32,13 @@ to ensure that the resulting application performs as required and is safe.
 
 **/
 
-#include <stdio.h>
-#include <string.h>
 #include <aducm360.h>
 
 #include <..\common\AdcLib.h>
 #include <..\common\IexcLib.h>
 #include <..\common\DacLib.h>
 #include <..\common\UrtLib.h>
+#include <..\common\FmtLib.h>
 #include <..\common\ClkLib.h>
 #include <..\common\WutLib.h>
 #include <..\common\WdtLib.h>
@@ -49,19 +53,25 @@ void DACINIT(void);
 void UARTINIT (void);
 
 
+//#define TLM_BINARY                            // Uncomment to send binary packets instead of text
+#define TLM_NUM 16                              // ADC1 codes per binary packet
+
 void delay(long int);
 volatile unsigned char bSendResultToUART = 0;	// Flag used to indicate ADC0 resutl ready to send to UART	
 unsigned char szTemp[64] = "";					// Used to store ADC0 result before printing to UART
-unsigned char ucTxBufferEmpty  = 0;				// Used to indicate that the UART Tx buffer is empty
 volatile  long ulADC1Result = 0;		        // Variable that ADC1DAT is read into in ADC1 IRQ
 volatile unsigned char ucComRx = 0;
 volatile unsigned char ucADC0ERR = 0;
 float  fVoltage = 0.0;   			            // ADC value converted to voltage
 float fVolts = 0.0;
+#ifdef TLM_BINARY
+long lTlmBuf[TLM_NUM];                          // ADC1 codes waiting to be sent
+unsigned long ulTlmSample = 0;                  // Number of the first code in lTlmBuf, used as timestamp
+int iTlmNum = 0;
+#endif
 
 int main (void)
 {
-   unsigned char i = 0;
    unsigned char nLen = 0;
 
    pADI_WDT ->T3CON = 0;
@@ -85,22 +95,24 @@ int main (void)
       {
          DioTgl(pADI_GP1,0x8);            // Toggle P1.3
          bSendResultToUART = 0;            // Clear flag
+#ifdef TLM_BINARY
+         lTlmBuf[iTlmNum++] = ulADC1Result >> 4; // 24 MSBs of the 28 bit code, 1.2V/2^24 per lsb
+         if (iTlmNum == TLM_NUM)
+         {
+            UrtTlmSend(pADI_UART,1,ulTlmSample,lTlmBuf,TLM_NUM,URT_TLM_I24); // Packet dropped if the UART is still busy
+            ulTlmSample += TLM_NUM;
+            iTlmNum = 0;
+         }
+         continue;
+#endif
          fVolts = fVoltage;
          fVolts   = (1.2 / 268435456);      // Internal reference, calculate lsb size in volts
          fVoltage = (ulADC1Result * fVolts);   // Calculate ADC result in volts
-         sprintf ( (char*)szTemp, "Voltage: %fV \r\n",fVoltage );// Scan string with the Temperature Result                           
-         nLen = strlen((char*)szTemp);      // Call function to calcualte the length of scanned string
-         if (nLen <64)
-         {
-            for ( i = 0 ; i < nLen ; i++ )	// loop to send ADC1 result	to UART
-            {
-               ucTxBufferEmpty = 0;	   // Clear flag
-               UrtTx(pADI_UART,szTemp[i]);// Load UART Tx register.
-               while (ucTxBufferEmpty == 0)// Wait for UART Tx interrupt
-               {
-               }
-            }
-         }
+         nLen = FmtStr((char*)szTemp, "Voltage: ");   // Format the result, nLen is the string length
+         nLen += FmtFlt((char*)szTemp+nLen, fVoltage, 6);
+         nLen += FmtStr((char*)szTemp+nLen, "V \r\n");
+         if (UrtWriteFree(pADI_UART) >= nLen)   // Drop the result if the UART is still busy with older ones
+            UrtWrite(pADI_UART,szTemp,nLen);   // Queue ADC1 result, sent by UART_Int_Handler
       }
       
    }
@@ -181,7 +193,7 @@ void UART_Int_Handler ()
    ucCOMIID0 = UrtIntSta(pADI_UART);         // Read UART Interrupt ID register         
    if ((ucCOMIID0 & 0x2) == 0x2)             // Transmit buffer empty
    {
-      ucTxBufferEmpty = 1;
+      UrtWriteIsr(pADI_UART);                // Send next queued character
    }
    if ((ucCOMIID0 & 0x4) == 0x4)             // Receive byte
    {
@@ -5,17 +5,40 @@
    - The RTD connected to AIN0/AIN1 will be used for Cold Junction compensation.
    - This file will measure the thermocouple/RTD inputs and send the measured voltages and
      temperature to the UART (9600 baud by default).
+   - With MODBUS_SLAVE defined the results are not printed, they are read as Modbus RTU
+     input registers instead (slave address 1, 19200 baud, 8 data bits, no parity):
+     30001-30002 final temperature, 30003-30004 RTD temperature, 30005-30006
+     thermocouple voltage and 30007-30008 RTD resistance, floats, high word first.
+     30009-30010 counts the ADC errors, which are not printed in this mode.
+   - With TRACE_ON defined each ADC1 sample and each result is also recorded with
+     common/TrcLib.h and sent in binary bursts between the text lines. Decode them with
+     tools/TrcDump -f Thermocouple.trc.
+   - With TLM_BATCHED defined the results are not printed, the final and RTD temperatures
+     are sent as binary batches with common/TlmLib.h, 8 results per packet, timestamped
+     in ADC1 conversions. Decode them with tools/TlmDump.
+   - With CMD_ON defined the acquisition is tuned with text commands on the UART, one per
+     line: SAMPLES n (samples averaged per channel), SF n and AF n (ADC1 filter), PGA n
+     (gain 2^n), OUTDIV n (one result sent every n) and SAVE to keep them in flash.
+     "NAME" reads a value and "?" lists them. New values are used from the next cycle.
    - For this simple example, the internal reference will used for the thermocouple measurement
      and a precision 5k6 resistor as the reference for the RTD
 
-   @version V0.2
+   @version V0.10
    @author  ADI
-   @date    February 2013
+   @date    October 2026
 
    @par     Revision History:
    - V0.1, September 2012: initial version. 
    - V0.2, February 2013: Fixed a bug in SendString().
                           Corrected C_cold_junctionN variable.
+   - V0.3, October 2026: RTD/thermocouple conversion moved to common/TempLib.h.
+   - V0.4, October 2026: SendString() queues strings with UrtWrite().
+   - V0.5, October 2026: Results formatted with FmtLib instead of sprintf(), 3 decimals.
+   - V0.6, October 2026: Optional Modbus RTU slave with common/MbsLib.h (MODBUS_SLAVE).
+   - V0.7, October 2026: Optional binary trace with common/TrcLib.h (TRACE_ON).
+   - V0.8, October 2026: Optional batched binary results with common/TlmLib.h (TLM_BATCHED).
+   - V0.9, October 2026: Acquisition parameters in AcqParam, tunable with common/CmdLib.h (CMD_ON).
+   - V0.10, October 2026: Modbus slave configured before the UART interrupt, ADC errors counted in an input register.
 
 All files for ADuCM360/361 provided by ADI, including this file, are
 provided  as is without warranty of any kind, either expressed or implied.
@@ -25,8 +48,6 @@ to ensure that the resulting application performs as required and is safe.
 
 **/
 
-#include <stdio.h>
-#include <string.h>
 #include <ADuCM360.h>
 #include "FlashEraseWrite.h"
 
@@ -35,11 +56,20 @@ to ensure that the resulting application performs as required and is safe.
 #include <..\common\DioLib.h>
 #include <..\common\WdtLib.h>
 #include <..\common\UrtLib.h>
+#include <..\common\FmtLib.h>
+#include <..\common\MbsLib.h>
+#include <..\common\DmaLib.h>
+#include <..\common\TrcLib.h>
+#include <..\common\TlmLib.h>
+#include <..\common\CmdLib.h>
 #include <..\common\GptLib.h>
 #include <..\common\DioLib.h>
 #include <..\common\AdcLib.h>
 #include <..\common\DacLib.h>
 #include <..\common\RstLib.h>
+#define TEMPLIB_RTD										// RTD and thermocouple conversions
+#define TEMPLIB_TC
+#include <..\common\TempLib.h>
 
 
 #define calibrateADC1	0		// Set to 0 if you don't want to calibrate
@@ -49,68 +79,35 @@ to ensure that the resulting application performs as required and is safe.
 
 #define THERMOCOUPLE 	0		// Used for switching ADC0 to Thermocouple channel
 #define RTD 				1		// Used for switching ADC0 to RTD channel
-#define SAMPLENO			0x5	// Number of samples to be taken between channel switching
-
-
-// Thermocouple temperature constants
-#define THER_T_MIN_P (0)  			// = minimum positive temperature in degC 
-#define THER_T_MAX_P (350) 	 	// = maximum positive temperature in degC
-#define THER_V_MIN_P (0)  			// = input voltage in mV at 0 degC
-#define THER_V_MAX_P (17.819)  	// = input voltage in mV at 350 degC
-#define THER_N_SEG_P (30)  		// = number of sections in table
-#define THER_V_SEG_P (0.59397) 	// = (THER_V_MAX-THER_V_MIN)/THER_N_SEG = Voltage in mV of each segment
-#define THER_T_MIN_N (0)  			// = minimum negative temperature in degC
-#define THER_T_MAX_N (-200)	  	// = maximum negative temperature in degC
-#define THER_V_MIN_N (0)  			// = input voltage in mV at 0 degC
-#define THER_V_MAX_N (-5.603)  	// = input voltage in mV at -200 degC
-#define THER_N_SEG_N (20)  		// = number of sections in table
-#define THER_V_SEG_N (-0.28015) 	// = (THER_V_MAX-THER_V_MIN)/THER_N_SEG = Voltage in mV of each segment
-// Thermocouple lookup tables....
-const float C_themocoupleP[THER_N_SEG_P+1] = {0.0, 	15.1417, 	29.8016, 	44.0289, 	57.8675, 	71.3563, 
-									84.5295, 	97.4175, 	110.047, 	122.441, 	134.62,		146.602, 
-									158.402, 	170.034, 	181.51, 	192.841, 	204.035, 	215.101, 
-									226.046, 	236.877, 	247.6,		258.221, 	268.745, 	279.177, 
-									289.522, 	299.784, 	309.969, 	320.079, 	330.119, 	340.092, 
-									350.001};
-const float C_themocoupleN[THER_N_SEG_N+1] = {0.0,		-7.30137,	-14.7101,	-22.2655, 
-									-29.9855, 	-37.8791, 	-45.9548, 	-54.2258, 
-									-62.7115, 	-71.4378, 	-80.4368,	-89.7453, 
-									-99.4048, 	-109.463, 	-119.978, 	-131.025, 
-									-142.707, 	-155.173, 	-168.641, 	-183.422, 
-									-199.964};
-// Cold Junction constants
-#define COLDJ_T_MIN_P (0)  		// = minimum positive temperature in degC 
-#define COLDJ_T_MAX_P (125)		// = maximum positive temperature in degC
-#define COLDJ_V_MIN_P (0)  		// = input voltage in mV at 0 degC
-#define COLDJ_V_MAX_P (5.470)  	// = input voltage in mV at 125 degC
-#define COLDJ_N_SEG_P (20) 		// = number of sections in table
-#define COLDJ_T_SEG_P (6.25)		// = (COLDJ_T_MAX-COLDJ_T_MIN)/COLDJ_N_SEG = Temperature in degC of each segment
-#define COLDJ_T_MIN_N (0)  		// = minimum negative temperature in degC
-#define COLDJ_T_MAX_N (-40)	  	// = maximum negative temperature in degC
-#define COLDJ_V_MIN_N (0)  		// = input voltage in mV at 0 degC
-#define COLDJ_V_MAX_N (-1.475)	// = input voltage in mV at -40 degC
-#define COLDJ_N_SEG_N (10) 		// = number of sections in table
-#define COLDJ_T_SEG_N (-4) 		// = (COLDJ_T_MAX-COLDJ_T_MIN)/COLDJ_N_SEG = Temperature in degC of each segment
-//Cold junction lookup table. Used for converting cold junction temperature to thermocouple voltage
-const float C_cold_junctionP[COLDJ_N_SEG_P+1] = {0.0,	0.2435,	0.4899,	0.7393,	0.9920,	1.2479, 1.5072,	1.7698,
-												2.0357,	2.3050,	2.5776,	2.8534,	3.1323,	3.4144,	3.6995, 3.9875,
-												4.2785,	4.5723,	4.8689,	5.1683,	5.4703};
-const float C_cold_junctionN[COLDJ_N_SEG_N+1] = {0.0,		-0.1543,	-0.3072,	-0.4586,	-0.6085,
-												-0.7568,	-0.9036,	-1.0489,	-1.1925,	-1.3345,
-												-1.4750};
-//RTD constants
-#define TMIN (-40)  		// = minimum temperature in degC
-#define TMAX (125)  		// = maximum temperature in degC
-#define RMIN (84.2707)  // = input resistance in ohms at -40 degC
-#define RMAX (147.951)  // = input resistance in ohms at 125 degC
-#define NSEG 30  			// = number of sections in table
-#define RSEG 2.12269  	// = (RMAX-RMIN)/NSEG = resistance  in ohms of each segment
-//RTD lookup table
-const float C_rtd[] = {-40.0006,-34.6322,-29.2542,-23.8669,-18.4704,-13.0649,-7.65042,-2.22714,3.20489,8.64565,14.0952,
-						19.5536,25.0208,30.497,35.9821,41.4762,46.9794,52.4917,58.0131,63.5436,69.0834,74.6325,80.1909,
-						85.7587,91.3359,96.9225,102.519,108.124,113.74,119.365,124.999};
-
-
+#define SAMPLENO			0x5	// Number of samples to be taken between channel switching, default of SAMPLES
+#define SAMPLEMAX			16		// Largest number of samples between channel switching
+
+//#define MODBUS_SLAVE				// Uncomment to read the results over Modbus RTU instead of text
+#define MODBUS_ADDR		1		// Modbus slave address
+#define MODBUS_BAUD		B19200	// Modbus baud rate
+
+//#define TRACE_ON					// Uncomment to record ADC samples and results with TrcLib
+#define TRC_ID_ADC1		1		// ADC1 sample: channel (0 thermocouple, 1 RTD), ADC1DAT
+#define TRC_ID_RESULT	2		// result: final temperature and RTD temperature in mC
+#define TRC_ID_ADCERR	3		// ADC1 error: ADC1STA
+
+//#define TLM_BATCHED				// Uncomment to send the results as binary batches instead of text
+#define TLM_N				8		// results per batch
+#define TLM_WINDOW		100		// longest batch, in ADC1 conversions
+#define TLM_CH_FINAL		0		// channel of the final temperature, mC
+#define TLM_CH_RTD		1		// channel of the RTD temperature, mC
+
+//#define CMD_ON						// Uncomment to tune the acquisition with text commands
+#define PARAM_PAGE		0x1FA00	// Flash page of the parameters saved with SAVE
+#define PARAM_KEY			0x41435130	// Marks saved parameters
+#define CMD_SAVE			6		// CmdPoll() result of SAVE, its place in AcqCmd[] plus 1
+
+#if defined(MODBUS_SLAVE) && (defined(TRACE_ON) || defined(TLM_BATCHED) || defined(CMD_ON))
+#error "MODBUS_SLAVE, TRACE_ON, TLM_BATCHED and CMD_ON use the UART"
+#endif
+#if defined(TRACE_ON) && defined(TLM_BATCHED)
+#error "TRACE_ON and TLM_BATCHED both use the UART transmit DMA channel"
+#endif
 
 void ADC1INIT(void);									// Init ADC1
 void UARTInit(void);			            // Enables UART
@@ -119,20 +116,19 @@ void delay(long int);								  // Simple delay function
 void SendString(void);								// Transmit string using UART
 void SystemZeroCalibration(void);			// Calibrate using external inputs
 void SystemFullCalibration(void);			// Calibrate using external inputs
-float CalculateRTDTemp(float r);			// returns RTD Temperature reading
-float CalculateThermoCoupleTemp(float v);		// returns Thermocouple Temperature reading
-float CalculateColdJVoltage(float t);	// converts cold junction temperature to an equvalent thermocouple voltage
 void ADC1RTDCfg(void);                // RTD ADC1 settings
 void ADC1ThermocoupleCfg(void);       // Tc ADC1 settings
 void SendString(void);					// Transmit string using UART
 void SendResultToUART(void);			// Send measurement results to UART - in ASCII String format
+void AcqApply(void);						// Use the parameters set by commands
+void AcqSave(void);							// Save the parameters set by commands to flash
+void AcqLoad(void);							// Load the parameters saved in flash
 
 volatile unsigned char bSendResultToUART = 0;	// Flag used to indicate ADC1 result ready to send to UART
 volatile unsigned char ucComRx = 0;		// variable that ComRx is read into in UART IRQ
 unsigned char szTemp[64] = "";				// Used to store string before printing to UART
-unsigned char ucTxBufferEmpty  = 0;		// Used to indicate that the UART Tx buffer is empty
-volatile  long ulADC1DATThermocouple[SAMPLENO];	// Variable that ADC1DAT is read into when sampling TC
-volatile  long ulADC1DATRtd[SAMPLENO];// Variable that ADC1DAT is read into when sampling RTD
+volatile  long ulADC1DATThermocouple[SAMPLEMAX];	// Variable that ADC1DAT is read into when sampling TC
+volatile  long ulADC1DATRtd[SAMPLEMAX];// Variable that ADC1DAT is read into when sampling RTD
 unsigned long ulADC1CONThermocouple;	// used to set ADC1CON which sets channel to thermocouple
 unsigned long ulADC1CONRtd;			 			// used to set ADC1CON which sets channel to RTD
 unsigned char ucADCInput;							// Used to indicate what channel the ADC1 is sampling
@@ -141,6 +137,7 @@ unsigned char ucIEXCCON = 0;					// Used to setup IEXCON
 unsigned char ucIEXDAT = 0;						// Used to setup IEXDAT
 unsigned char ucWaitForUart = 0;			// Used by calibration routines to wait for user input
 volatile unsigned char ucADCERR = 0;	// Used to indicate an ADC error
+unsigned long ulAdcErrors = 0;				// ADC errors seen, input register 8 with MODBUS_SLAVE
 unsigned int uiFEESTA;
 volatile unsigned char ucFlashCmdStatus = 0;
 volatile unsigned char ucWaitForCmdToComplete = 0;
@@ -155,13 +152,49 @@ float fVThermocouple = 0.0;						// thermoucouple voltage
 float fVRTD = 0.0 ;										// RTD voltage, 
 float fRrtd = 0.0;										// resistance of the RTD
 float fColdJVolt = 0.0;								// cold junction equivalent thermocouple voltage
-float fFinalVoltage = 0.0;						// fFinalVoltage = thermocouple voltage + cold j voltage
 float fTThermocouple = 0.0;					  // thermoucouple temperature
 float fTRTD = 0.0;										// RTD temperature
 float fFinalTemp = 0.0;								// Final temperature including cold j compensation
 unsigned char nLen = 0;								// Used for sending strings to UART
-unsigned char i = 0;									// counter used in SendString()
 unsigned char ucCounter = 0;
+volatile unsigned long ulAdcConv = 0;			// ADC1 conversions, timestamps of the batched results
+unsigned long ulResults = 0;						// results computed, for OUTDIV
+
+// Acquisition parameters
+typedef struct
+{
+	long lSamples;							// samples averaged per channel, 1 to SAMPLEMAX
+	long lSf;									// ADC1 sinc filter decimation factor
+	long lAf;									// ADC1 averaging factor
+	long lPga;									// ADC1 PGA gain is 2^lPga
+	long lOutDiv;								// one result sent every lOutDiv
+	long lKey;									// PARAM_KEY when saved in flash
+} AcqParam;
+
+const int iPgaGain[8] = {ADCMDE_PGA_G1,ADCMDE_PGA_G2,ADCMDE_PGA_G4,ADCMDE_PGA_G8,
+								 ADCMDE_PGA_G16,ADCMDE_PGA_G32,ADCMDE_PGA_G64,ADCMDE_PGA_G128};
+AcqParam Acq = {SAMPLENO, 124, 0, 5, 1, PARAM_KEY};	// Parameters in use, changed only between cycles
+
+#ifdef CMD_ON
+AcqParam AcqNew;									// Parameters set by the commands
+unsigned char bAcqNew = 0;						// AcqNew to be used from the next cycle
+const CmdMap AcqCmd[] = {
+	{"SAMPLES", &AcqNew.lSamples, 1, SAMPLEMAX},
+	{"SF", &AcqNew.lSf, 0, 127},
+	{"AF", &AcqNew.lAf, 0, 15},
+	{"PGA", &AcqNew.lPga, 0, 7},
+	{"OUTDIV", &AcqNew.lOutDiv, 1, 1000},
+	{"SAVE", 0, 0, 0}};
+#endif
+
+#ifdef MODBUS_SLAVE
+const MbsMap MbsInput[] = {							// Input registers, read in place by function 04
+	{0, 2, &fFinalTemp, MBS_F32, 0},
+	{2, 2, &fTRTD, MBS_F32, 0},
+	{4, 2, &fVThermocouple, MBS_F32, 0},
+	{6, 2, &fRrtd, MBS_F32, 0},
+	{8, 2, &ulAdcErrors, MBS_U32, 0}};
+#endif
 
 int main (void)
 {
@@ -177,51 +210,102 @@ int main (void)
 	DioOen(pADI_GP1,0x8);							                              // used for debug (pin 1.3)
 	UARTInit();						                                          // Init UART to 9600
         NVIC_EnableIRQ(FLASH_IRQn);					                            // Enable Flash and UART interrupt sources
-	NVIC_EnableIRQ(UART_IRQn);
+#ifdef MODBUS_SLAVE
+	MbsCfg(pADI_UART,pADI_TM0,MODBUS_ADDR,MODBUS_BAUD);			// 3.5 character frame time on timer 0
+	MbsMapCfg(0,0,MbsInput,sizeof(MbsInput)/sizeof(MbsInput[0]));
+	NVIC_EnableIRQ(TIMER0_IRQn);
+#endif
+	NVIC_EnableIRQ(UART_IRQn);										// MbsRxIsr() needs the frame timer
+#ifdef CMD_ON
+	AcqLoad();
+	AcqNew = Acq;
+	CmdCfg(pADI_UART,AcqCmd,sizeof(AcqCmd)/sizeof(AcqCmd[0]));
+#endif
 	ucADCInput = THERMOCOUPLE;			                                //	Indicate that ADC1 is sampling thermocouple
 	ADC1INIT();								                                      // Init ADC1
 	IEXCINIT();																										  // Init IEXC0 for 200uA on AIN5
 	NVIC_EnableIRQ(ADC1_IRQn);					                            // Flash/UART/ADC1 IRQ
-	sprintf ( (char*)szTemp, "Program Started. Please wait for the first temperature result\r\n");
-	nLen = strlen((char*)szTemp);
-	if (nLen <64)
- 		SendString();
+#ifdef TRACE_ON
+	DmaBase();
+	GptCfg(pADI_TM1,TCON_CLK_PCLK,TCON_PRE_DIV256,TCON_UP|TCON_ENABLE);  // Free running timestamps, 16us
+	TrcCfg(pADI_UART,pADI_TM1);
+	NVIC_EnableIRQ(DMA_UART_TX_IRQn);
+#endif
+#ifdef TLM_BATCHED
+	DmaBase();
+	TlmCfg(pADI_UART,TLM_N,TLM_WINDOW,3);
+	NVIC_EnableIRQ(DMA_UART_TX_IRQn);
+#endif
+#ifndef MODBUS_SLAVE
+	nLen = FmtStr((char*)szTemp, "Program Started. Please wait for the first temperature result\r\n");
+	SendString();
+#endif
 
 	fVolts	= (1.2 / 268435456);			// Internal reference	
 	while(1)
 	{
 		delay(0x1FFFFF);
+#ifdef TRACE_ON
+		TrcFlush();                                      // Send the events recorded so far
+#endif
+#ifdef TLM_BATCHED
+		TlmPoll(ulAdcConv);                              // Send the batch when its window is over
+#endif
+#ifdef CMD_ON
+		if (!TrcBusy() && !TlmBusy())                    // Answers go through UrtWrite()
+		{
+			int iCmd = CmdPoll();
+
+			if (iCmd == CMD_SAVE)
+				AcqSave();
+			else if (iCmd != 0)
+				bAcqNew = 1;
+		}
+#endif
 		if(bSendResultToUART == 1)
 		{
 			fVThermocouple = 0;
 			fVRTD =0;
-			for (ucCounter = 0; ucCounter < SAMPLENO; ucCounter++)
+			for (ucCounter = 0; ucCounter < Acq.lSamples; ucCounter++)
 			{
 				fVThermocouple += (ulADC1DATThermocouple[ucCounter] * fVolts);  	// Thermocouple voltage
 				fVRTD += ((float)ulADC1DATRtd[ucCounter]  / 268435456);	  		   // RTD voltage	in terms of reference voltage
 			}
-			fVThermocouple = fVThermocouple/SAMPLENO;					// Get the average of the results
-			fVRTD = fVRTD/SAMPLENO;
+			fVThermocouple = fVThermocouple/Acq.lSamples;					// Get the average of the results
+			fVRTD = fVRTD/Acq.lSamples;
 			fRrtd = fVRTD * 5600;											// RTD resistance
 			fTRTD =	CalculateRTDTemp(fRrtd);							// RTD temperature
-			fColdJVolt = CalculateColdJVoltage(fTRTD);				// get an equvalent thermocouple voltage
-			fFinalVoltage = fVThermocouple + fColdJVolt;
-			//fTThermocouple = CalculateThermoCoupleTemp(fVThermocouple);
-			fFinalTemp = CalculateThermoCoupleTemp(fFinalVoltage);	// Thermocouple temperature
-			SendResultToUART();
+			fFinalTemp = CalculateCjcTemp(fVThermocouple, fTRTD);		// Cold junction compensated thermocouple temperature
+#ifdef TRACE_ON
+			TRC(TRC_ID_RESULT, (long)(fFinalTemp*1000), (long)(fTRTD*1000));
+#endif
+			if ((ulResults++ % Acq.lOutDiv) == 0)
+			{
+#if defined(TLM_BATCHED)
+				TlmAdd(TLM_CH_FINAL, ulAdcConv, (long)(fFinalTemp*1000));
+				TlmAdd(TLM_CH_RTD, ulAdcConv, (long)(fTRTD*1000));
+#elif !defined(MODBUS_SLAVE)
+				SendResultToUART();
+#endif
+			}
+#ifdef CMD_ON
+			if (bAcqNew)                                 // ADC1 samples are ignored until the flag is cleared
+				AcqApply();
+#endif
                         bSendResultToUART = 0;
 		}
 		if (ucADCERR != 0)
 		{
+#ifdef MODBUS_SLAVE
+			ulAdcErrors++;                                  // Only Modbus responses on the line
+#else
 		   if (ucADCERR == 1)
-		   		sprintf ( (char*)szTemp, "ADC error on ADC0  \r\n");// Send error message to UART  
+		   		nLen = FmtStr((char*)szTemp, "ADC error on ADC0  \r\n");// Send error message to UART  
 			if (ucADCERR == 2)
-		   		sprintf ( (char*)szTemp, "ADC error on ADC1  \r\n");// Send error message to UART
+		   		nLen = FmtStr((char*)szTemp, "ADC error on ADC1  \r\n");// Send error message to UART
 		   if ((ucADCERR == 1) | (ucADCERR == 2))                          
-			{	nLen = strlen((char*)szTemp);
-			  	if (nLen <64)
-		 			SendString();
-	      }
+		 		SendString();
+#endif
 			ucADCERR = 0;
 	   }
 	}
@@ -229,86 +313,18 @@ int main (void)
 void ADC1RTDCfg(void)
 {
 	AdcPin(pADI_ADC1,ADCCON_ADCCN_AIN1,ADCCON_ADCCP_AIN0);
-	AdcRng(pADI_ADC1,ADCCON_ADCREF_EXTREF,ADCMDE_PGA_G32,ADCCON_ADCCODE_INT);
+	AdcRng(pADI_ADC1,ADCCON_ADCREF_EXTREF,iPgaGain[Acq.lPga],ADCCON_ADCCODE_INT);
 }
 void ADC1ThermocoupleCfg(void)
 {
 	AdcPin(pADI_ADC1,ADCCON_ADCCN_AIN3,ADCCON_ADCCP_AIN2);          // Select AIn2/AIN3 as ADC inputs
-	AdcRng(pADI_ADC1,ADCCON_ADCREF_INTREF,ADCMDE_PGA_G32,ADCCON_ADCCODE_INT); // Internal reference, Gain=32
-}
-float CalculateRTDTemp(float r) {
-	float t;
-	int j;
-	j=(float)(r-RMIN)/RSEG;       // determine which coefficients to use
-	if (j<0)               // if input is under-range..
-		j=0;                // ..then use lowest coefficients
-	else if (j>NSEG-1)     // if input is over-range..
-		j=NSEG-1;            // ..then use highest coefficients
-	t = C_rtd[j]+(r-(RMIN+RSEG*j))*(C_rtd[j+1]-C_rtd[j])/RSEG;
-	return t;
-} 
-float CalculateThermoCoupleTemp(float v)
-{	
-	float fresult = 0;
-	signed int j = 0;
-	float fMVthermocouple = v*1000;			//thermocouple voltage in mV
-	if (fMVthermocouple >= 0)
-	{
-  		j=(fMVthermocouple - THER_V_MIN_P) / THER_V_SEG_P;			// determine which coefficient to use
-  		if (j>THER_N_SEG_P-1)     									// if input is over-range..
-    		j=THER_N_SEG_P-1;            							// ..then use highest coefficients
-		
-		// Use the closest known temperature value and then use a linear approximation beetween the
-		// enclosing data points
-  		fresult = C_themocoupleP[j] + (fMVthermocouple - (THER_V_MIN_P+THER_V_SEG_P*j) )*
-			(C_themocoupleP[j+1]-C_themocoupleP[j]) / THER_V_SEG_P;		 // Slope
-	}
-	else if (fMVthermocouple < 0)
-	{
-		j=(fMVthermocouple - THER_V_MIN_N) / THER_V_SEG_N;		// determine which coefficient to use
-		if (j>THER_N_SEG_N-1)    								// if input is over-range..
-    		j=THER_N_SEG_N-1;          							// ..then use highest coefficients
-		fresult = C_themocoupleN[j] + (fMVthermocouple- (THER_V_MIN_N+THER_V_SEG_N*j) )*
-			(C_themocoupleN[j+1]-C_themocoupleN[j]) / THER_V_SEG_N;
-	} 
-   	return  fresult;
-}
-
-float CalculateColdJVoltage(float t)
-{
-	float fresult = 0;
-	signed int j = 0;
-	if (t >= 0)
-	{
-  		j=(t - COLDJ_T_MIN_P) / COLDJ_T_SEG_P;				// determine which coefficient to use
-  		if (j>COLDJ_N_SEG_P-1)     							// if input is over-range..
-    		j=COLDJ_N_SEG_P-1;            					// ..then use highest coefficients
-		
-		// Use the closest known voltage and then use a linear approximation beetween the
-		// enclosing data points
-  		fresult = C_cold_junctionP[j] + (t - (COLDJ_T_MIN_P+COLDJ_T_SEG_P*j) )*
-			(C_cold_junctionP[j+1]-C_cold_junctionP[j]) / COLDJ_T_SEG_P;		 // Slope
-	
-	}
-	else if (t < 0)
-	{
-		j=(j - COLDJ_T_MIN_N) / COLDJ_T_SEG_N;				// determine which coefficient to use
-		if (j>COLDJ_N_SEG_N-1)    							// if input is over-range..
-    		j=COLDJ_N_SEG_N-1;         						// ..then use highest coefficients
-
-		fresult = C_cold_junctionN[j] + (t - (COLDJ_T_MIN_N+COLDJ_T_SEG_N*j) )*
-			(C_cold_junctionN[j+1]-C_cold_junctionN[j]) / COLDJ_T_SEG_N;
-	}
-	return fresult/1000.0;
+	AdcRng(pADI_ADC1,ADCCON_ADCREF_INTREF,iPgaGain[Acq.lPga],ADCCON_ADCCODE_INT); // Internal reference, Gain=32 by default
 }
-
 void SystemZeroCalibration(void)
 {
 	ucWaitForUart = 1;
-	sprintf ( (char*)szTemp, "Set Zero Scale Voltage - Press return when ready \r\n");                         
-	nLen = strlen((char*)szTemp);
- 	if (nLen <64)
-		 	SendString();
+	nLen = FmtStr((char*)szTemp, "Set Zero Scale Voltage - Press return when ready \r\n");
+	SendString();
 	while (ucWaitForUart == 1)
 	{}
 	AdcGo(pADI_ADC1,ADCMDE_ADCMD_SYSOCAL);	// ADC1 System Zero scale calibration
@@ -318,10 +334,8 @@ void SystemZeroCalibration(void)
 void SystemFullCalibration(void)
 {
 	ucWaitForUart = 1;
-	sprintf ( (char*)szTemp, "Set Full Scale Voltage - Press return when ready \r\n");                         
-	nLen = strlen((char*)szTemp);
- 	if (nLen <64)
-		 	SendString();
+	nLen = FmtStr((char*)szTemp, "Set Full Scale Voltage - Press return when ready \r\n");
+	SendString();
 	while (ucWaitForUart == 1)
 	{}
 	AdcGo(pADI_ADC0,ADCMDE_ADCMD_SYSGCAL);							// ADC1 System Full scale calibration
@@ -338,9 +352,9 @@ void ADC1INIT(void)
 	AdcMski(pADI_ADC1,ADCMSKI_RDY,1);						                  	// Enable ADC1 /rdy IRQ
 	// Thermocouple settings
 	AdcPin(pADI_ADC1,ADCCON_ADCCN_AIN3,ADCCON_ADCCP_AIN2);          // Select AIn2/AIN3 as ADC inputs
-	AdcRng(pADI_ADC1,ADCCON_ADCREF_INTREF,ADCMDE_PGA_G32,ADCCON_ADCCODE_INT); // Internal reference, Gain=32
+	AdcRng(pADI_ADC1,ADCCON_ADCREF_INTREF,iPgaGain[Acq.lPga],ADCCON_ADCCODE_INT); // Internal reference, Gain=32 by default
 //	ADC1CON = ulADC1CONThermocouple;
-	AdcFlt(pADI_ADC1,124,0xD00,FLT_NORMAL);							              // Chop On, 3.75Hz sampling rate, chop on
+	AdcFlt(pADI_ADC1,Acq.lSf,Acq.lAf,FLT_NORMAL);							              // SF=124, AF=0 by default, 3.75Hz sampling rate
 	AdcGo(pADI_ADC1,ADCMDE_ADCMD_IDLE);                             // Set ADC1 for Idle mode
 	delay(0xFFFFF);
 	if (calibrateADC1 == 1)
@@ -365,7 +379,11 @@ void ADC1INIT(void)
 }
 void UARTInit(void)
 {
+#ifdef MODBUS_SLAVE
+   UrtCfg(pADI_UART,MODBUS_BAUD,COMLCR_WLS_8BITS,COMLCR_STOP_EN);   // 8-bits, no parity, 2 stop bits as Modbus RTU requires
+#else
    UrtCfg(pADI_UART,B9600,COMLCR_WLS_8BITS,0);   // setup baud rate for 9600, 8-bits
+#endif
    UrtMod(pADI_UART,COMMCR_DTR,0);  			  // Setup modem bits
    UrtIntCfg(pADI_UART,COMIEN_ERBFI|COMIEN_ETBEI|COMIEN_ELSI|COMIEN_EDSSI|COMIEN_EDMAT|COMIEN_EDMAR);  // Setup UART IRQ sources
    DioPul(pADI_GP0,0xFF);								              // Enable pullup on P0.7/0.6
@@ -387,47 +405,88 @@ void delay (long int length)
 }
 void SendString (void)
 {
-   for ( i = 0 ; i < nLen ; i++ )	// loop to send ADC0 result
-	{
-  		 ucTxBufferEmpty = 0;
-		 UrtTx(pADI_UART,szTemp[i]);
-  		 while (ucTxBufferEmpty == 0)
-  		 {
-  		 }
-	}
+   int iSent = 0;
+
+#ifdef TRACE_ON
+   while (TrcBusy())                  // Wait for the trace burst being sent
+   {}
+#endif
+#ifdef TLM_BATCHED
+   while (TlmBusy())                  // Wait for the packet being sent
+   {}
+#endif
+   while (iSent < nLen)                // UrtWrite() takes what fits, wait only while the queue is full
+      iSent += UrtWrite(pADI_UART,szTemp+iSent,nLen-iSent);
 } 
 void SendResultToUART(void)
 {
-    sprintf ( (char*)szTemp, "RTD Resistance: %fOhms \r\n",fRrtd );                          
-    nLen = strlen((char*)szTemp);
-    if (nLen <64)
-            SendString();
+    nLen = FmtStr((char*)szTemp, "RTD Resistance: ");
+    nLen += FmtFlt((char*)szTemp+nLen, fRrtd, 3);
+    nLen += FmtStr((char*)szTemp+nLen, "Ohms \r\n");
+    SendString();
     
-    sprintf ( (char*)szTemp, "RTD Temperature: %fC \r\n",fTRTD );// Send the Result to the UART                          
-    nLen = strlen((char*)szTemp);
-    if (nLen <64)
-            SendString();
+    nLen = FmtStr((char*)szTemp, "RTD Temperature: ");           // Send the Result to the UART
+    nLen += FmtFlt((char*)szTemp+nLen, fTRTD, 3);
+    nLen += FmtStr((char*)szTemp+nLen, "C \r\n");
+    SendString();
     
-    sprintf ( (char*)szTemp, "Cold Junction Voltage: %fmV \r\n",(fColdJVolt*1000) );// Send the Result to the UART                          
-    nLen = strlen((char*)szTemp);
-    if (nLen <64)
-            SendString();
+    fColdJVolt = CalculateColdJVoltage(fTRTD);				// for display only
+    nLen = FmtStr((char*)szTemp, "Cold Junction Voltage: ");
+    nLen += FmtFlt((char*)szTemp+nLen, fColdJVolt*1000, 3);
+    nLen += FmtStr((char*)szTemp+nLen, "mV \r\n");
+    SendString();
     
-    sprintf ( (char*)szTemp, "Thermoucouple Voltage: %fmV \r\n",(fVThermocouple*1000) );// Send the Result to the UART                          
-    nLen = strlen((char*)szTemp);
-    if (nLen <64)
-            SendString();
-
-    /*sprintf ( (char*)szTemp, "TC Temperature: %fC \r\n",fTThermocouple );// Used for evaluating TC                          
-    nLen = strlen((char*)szTemp);
-    if (nLen <64)
-            SendString();*/ 
+    nLen = FmtStr((char*)szTemp, "Thermoucouple Voltage: ");
+    nLen += FmtFlt((char*)szTemp+nLen, fVThermocouple*1000, 3);
+    nLen += FmtStr((char*)szTemp+nLen, "mV \r\n");
+    SendString();
+
+    /*nLen = FmtStr((char*)szTemp, "TC Temperature: ");            // Used for evaluating TC
+    nLen += FmtFlt((char*)szTemp+nLen, fTThermocouple, 3);
+    nLen += FmtStr((char*)szTemp+nLen, "C \r\n");
+    SendString();*/ 
     
-    sprintf ( (char*)szTemp, "Final Temperature: %fC \r\n\n\n\n",fFinalTemp );// Send the Result to the UART                          
-    nLen = strlen((char*)szTemp);
-    if (nLen <64)
-            SendString();
+    nLen = FmtStr((char*)szTemp, "Final Temperature: ");
+    nLen += FmtFlt((char*)szTemp+nLen, fFinalTemp, 3);
+    nLen += FmtStr((char*)szTemp+nLen, "C \r\n\n\n\n");
+    SendString();
+}
+
+#ifdef CMD_ON
+// Use the new parameters. Called between two cycles, when ADC1 is back on the thermocouple
+// and its samples are not stored, so a cycle never mixes old and new parameters.
+void AcqApply(void)
+{
+	Acq = AcqNew;
+	bAcqNew = 0;
+	AdcGo(pADI_ADC1,ADCMDE_ADCMD_IDLE);
+	AdcFlt(pADI_ADC1,Acq.lSf,Acq.lAf,FLT_NORMAL);
+	ADC1ThermocoupleCfg();
+	ucSampleNo = 0;
+	AdcGo(pADI_ADC1,ADCMDE_ADCMD_CONT);                 // Restarts the filter with the new settings
+}
+void AcqSave(void)
+{
+	AcqNew.lKey = PARAM_KEY;
+	ErasePage(PARAM_PAGE);
+	while ((pADI_FEE->FEESTA & 0x1) == 0x1)             // Wait for the erase to complete
+	{}
+	WriteToFlash((unsigned long *)&AcqNew,PARAM_PAGE,sizeof(AcqNew));
+}
+void AcqLoad(void)
+{
+	const AcqParam *pSaved = (const AcqParam *)PARAM_PAGE;
+
+	if ((pSaved->lKey != PARAM_KEY) ||                    // Keep the defaults if nothing valid is saved
+	    (pSaved->lSamples < 1) || (pSaved->lSamples > SAMPLEMAX) ||
+	    (pSaved->lSf < 0) || (pSaved->lSf > 127) ||
+	    (pSaved->lAf < 0) || (pSaved->lAf > 15) ||
+	    (pSaved->lPga < 0) || (pSaved->lPga > 7) ||
+	    (pSaved->lOutDiv < 1) || (pSaved->lOutDiv > 1000))
+		return;
+	Acq = *pSaved;
 }
+#endif
 void ExtIntEnable(void) 
 {
    
@@ -506,7 +565,11 @@ void WDog_Tmr_Int_Handler()
 void Test_OSC_Int_Handler()
 {}
 void GP_Tmr0_Int_Handler()
-{}
+{
+#ifdef MODBUS_SLAVE
+	MbsTmrIsr();											// 3.5 character time elapsed, answer the frame
+#endif
+}
 void GP_Tmr1_Int_Handler()
 {}
 void ADC0_Int_Handler()
@@ -520,9 +583,15 @@ void ADC1_Int_Handler ()
    if ((uiADCSTA & 0x10) == 0x10)			// Check for an error condition
    		ucADCERR = 2;
 	ulADC1DAT = AdcRd(pADI_ADC1);
+	ulAdcConv++;
+#ifdef TRACE_ON
+	TRC(TRC_ID_ADC1, ucADCInput, ulADC1DAT);
+	if (ucADCERR == 2)
+		TRC(TRC_ID_ADCERR, uiADCSTA, 0);
+#endif
 	if( bSendResultToUART == 0 )
 	{
-		if(ucSampleNo < SAMPLENO){
+		if(ucSampleNo < Acq.lSamples){
 			if (ucADCInput == THERMOCOUPLE){
 				ulADC1DATThermocouple[ucSampleNo] = ulADC1DAT;}
 			else{   
@@ -591,12 +660,18 @@ void UART_Int_Handler ()
 	ucCOMIID0 = UrtIntSta(pADI_UART);			// Read UART Interrupt ID register
 	if ((ucCOMIID0 & 0x2) == 0x2)	  			// Transmit buffer empty
 	{
-	  ucTxBufferEmpty = 1;
+	  UrtWriteIsr(pADI_UART);            // Send next queued character
 	}
 	if ((ucCOMIID0 & 0x4) == 0x4)	  			// Receive byte
 	{
 		ucComRx	= UrtRx(pADI_UART);
 		ucWaitForUart = 0;
+#ifdef MODBUS_SLAVE
+		MbsRxIsr(ucComRx);
+#endif
+#ifdef CMD_ON
+		CmdRxIsr(ucComRx);
+#endif
 	}
 } 
 void SPI0_Int_Handler ()
@@ -622,6 +697,12 @@ void DMA_SPI1_RX_Int_Handler ()
 }
 void DMA_UART_TX_Int_Handler ()
 {
+#ifdef TRACE_ON
+	TrcTxIsr();                        // Trace burst header or events sent
+#endif
+#ifdef TLM_BATCHED
+	TlmTxIsr();                        // Telemetry packet sent
+#endif
 }
 
 void DMA_I2C0_STX_Int_Handler ()
@@ -17,9 +17,9 @@
    
    Baud rate of UART interface is 19200
 
-   @version  V0.3
+   @version  V0.4
    @author   ADI
-   @date     February 2013 
+   @date     October 2026 
    @par Revision History:
    - V0.1, September 2010: initial version. 
    - V0.2, October 2012: Changed comments - 19200 baud for UART used.
@@ -27,6 +27,7 @@
    - V0.3, February 2013: Corrected SystemFullCalibration() function.
                          Changed comments: ADC1 is used for temperature measurements.
                          Fixed a bug in SendString().
+   - V0.4, October 2026: RTD/thermocouple conversion moved to common/TempLib.h.
 
 All files for ADuCM360/361 provided by ADI, including this file, are
 provided  as is without warranty of any kind, either expressed or implied.
@@ -40,7 +41,6 @@ to ensure that the resulting application performs as required and is safe.
 #include <string.h>
 #include <ADuCM360.h>
 #include "FlashEraseWrite.h"
-#include "TempCalc.h"
 
 #include <..\common\ClkLib.h>
 #include <..\common\IexcLib.h>
@@ -52,6 +52,9 @@ to ensure that the resulting application performs as required and is safe.
 #include <..\common\AdcLib.h>
 #include <..\common\DacLib.h>
 #include <..\common\RstLib.h>
+#define TEMPLIB_RTD										// RTD and thermocouple conversions
+#define TEMPLIB_TC
+#include <..\common\TempLib.h>
 
 
 #define calibrateADC1	0		// Set to 0 if you don't want to calibrate
@@ -128,7 +131,6 @@ float fVThermocouple = 0.0;						// thermoucouple voltage
 float fVRTD = 0.0 ;										// RTD voltage, 
 float fRrtd = 0.0;										// resistance of the RTD
 float fColdJVolt = 0.0;								// cold junction equivalent thermocouple voltage
-float fFinalVoltage = 0.0;						// fFinalVoltage = thermocouple voltage + cold j voltage
 float fTThermocouple = 0.0;					  // thermoucouple temperature
 float fTRTD = 0.0;										// RTD temperature
 float fFinalTemp = 0.0;								// Final temperature including cold j compensation
@@ -198,10 +200,7 @@ int main (void)
 			fVRTD = fVRTD/SAMPLENO;
 			fRrtd = fVRTD * 5600;											                          // RTD resistance
 			fTRTD =	CalculateRTDTemp(fRrtd);							                      // RTD temperature
-			fColdJVolt = CalculateColdJVoltage(fTRTD);				                  // get an equvalent thermocouple voltage
-			fFinalVoltage = fVThermocouple + fColdJVolt;
-			//fTThermocouple = CalculateThermoCoupleTemp(fVThermocouple);
-			fFinalTemp = CalculateThermoCoupleTemp(fFinalVoltage);	            // Thermocouple temperature
+			fFinalTemp = CalculateCjcTemp(fVThermocouple, fTRTD);		// Cold junction compensated thermocouple temperature
 			if (ucFirstLoop == 1)
 				UpdateDAC();
 			else
@@ -552,6 +551,7 @@ void SendResultToUART(void)
     if (nLen <64)
             SendString();
     
+    fColdJVolt = CalculateColdJVoltage(fTRTD);				// for display only
     sprintf ( (char*)szTemp, "Cold Junction Voltage: %fmV \r\n",(fColdJVolt*1000) );// Send the Result to the UART                          
     nLen = strlen((char*)szTemp);
     if (nLen <64)
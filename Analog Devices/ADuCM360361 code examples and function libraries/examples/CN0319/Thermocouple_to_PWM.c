@@ -13,9 +13,13 @@
    
    Baud rate of UART interface is 19200
 
-   @version  V0.1
+   @version  V0.2
    @author   ADI
-   @date     April 2013 
+   @date     October 2026
+
+   @par Revision History:
+   - V0.1, April 2013: initial version.
+   - V0.2, October 2026: RTD/thermocouple conversion moved to common/TempLib.h.
 
 All files for ADuCM360/361 provided by ADI, including this file, are
 provided  as is without warranty of any kind, either expressed or implied.
@@ -30,7 +34,6 @@ to ensure that the resulting application performs as required and is safe.
 #include <string.h>
 #include <ADuCM360.h>
 #include "FlashEraseWrite.h"
-#include "TempCalc.h"
 
 #include <..\common\AdcLib.h>
 #include <..\common\IexcLib.h>
@@ -40,6 +43,9 @@ to ensure that the resulting application performs as required and is safe.
 #include <..\common\WdtLib.h>
 #include <..\common\PwmLib.h>
 #include <..\common\DioLib.h>
+#define TEMPLIB_RTD										// RTD and thermocouple conversions
+#define TEMPLIB_TC
+#include <..\common\TempLib.h>
 
 
 
@@ -92,7 +98,6 @@ float fTRTD = 0.0;                       // RTD temperature
 float fVolts = 0.0;	                     // ADC to voltage constant
 float fVThermocouple = 0.0;						   // thermoucouple voltage
 float fColdJVolt = 0.0;		               // cold junction equivalent thermocouple voltage
-float fFinalVoltage = 0.0;						   // fFinalVoltage = thermocouple voltage + cold j voltage
 float fTThermocouple = 0.0;					     // thermoucouple temperature
 float fFinalTemp = 0.0;								   // Final temperature including cold j compensation
 //PWM variables
@@ -173,10 +178,7 @@ int main (void)
       fVRTD = fVRTD/SAMPLENO;							
       fRrtd = fVRTD * 5600;											                          // RTD resistance			
       fTRTD =	CalculateRTDTemp(fRrtd);							                      // RTD temperature			
-      fColdJVolt = CalculateColdJVoltage(fTRTD);				                  // get an equvalent thermocouple voltage			
-      fFinalVoltage = fVThermocouple + fColdJVolt;			
-      //fTThermocouple = CalculateThermoCoupleTemp(fVThermocouple);		
-      fFinalTemp = CalculateThermoCoupleTemp(fFinalVoltage);	    
+      fFinalTemp = CalculateCjcTemp(fVThermocouple, fTRTD);		// Cold junction compensated thermocouple temperature
       Ioutfonction(fFinalTemp);                     //PWM out
        
       if (calibratePWM == 1)                           // Calibrate PWM and use these values  
@@ -245,6 +247,7 @@ void SendResultToUART(void)
     if (nLen <64)
             SendString();
     
+    fColdJVolt = CalculateColdJVoltage(fTRTD);				// for display only
     sprintf ( (char*)szTemp, "Cold Junction Voltage: %fmV \r\n",(fColdJVolt*1000) );// Send the Result to the UART                          
     nLen = strlen((char*)szTemp);
     if (nLen <64)
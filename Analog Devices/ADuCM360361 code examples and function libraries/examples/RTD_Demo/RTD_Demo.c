@@ -17,13 +17,15 @@
    - EVAL-ADuCM360MKZ or similar hardware is assumed
    - Results will be more accurate if System calibration is added 
 
-   @version V0.2
+   @version V0.4
    @author  ADI
-   @date    February 2013
+   @date    October 2026
 
    @par     Revision History:
    - V0.1, September 2012: initial version. 
    - V0.2, February 2013: Fixed a bug in SendString().
+   - V0.3, October 2026: RTD conversion moved to common/TempLib.h.
+   - V0.4, October 2026: SendString() queues strings with UrtWrite().
               
 All files for ADuCM360/361 provided by ADI, including this file, are
 provided  as is without warranty of any kind, either expressed or implied.
@@ -51,6 +53,8 @@ to ensure that the resulting application performs as required and is safe.
 #include <..\common\IntLib.h>
 #include <..\common\PwmLib.h>
 #include <..\common\DioLib.h>
+#define TEMPLIB_RTD                         // RTD conversion
+#include <..\common\TempLib.h>
 
 void ADC1INIT(void);                // Init ADC1
 void UARTINIT (void);
@@ -58,20 +62,8 @@ void SendString(void);              // Transmit string using UART
 void IEXCINIT(void);                // Setup Excitation Current sources
 void SendResultToUART(void);        // Send measurement results to UART - in ASCII String format
 void SendErrorToUART(void);         // Send Error String to UART to indicate PGA overrange occured
-float CalculateRTDTemp(float r);    // returns RTD Temperature reading
 
 #define SAMPLENO        0x8         // Number of samples to be taken between channel switching
-//RTD constants
-#define TMIN (-40)                  // = minimum temperature in degC
-#define TMAX (125)                  // = maximum temperature in degC
-#define RMIN (84.2707)              // = input resistance in ohms at -40 degC
-#define RMAX (147.951)              // = input resistance in ohms at 125 degC
-#define NSEG 30                     // = number of sections in table
-#define RSEG 2.12269                // = (RMAX-RMIN)/NSEG = resistance  in ohms of each segment
-//RTD lookup table
-const float C_rtd[] = {-40.0006,-34.6322,-29.2542,-23.8669,-18.4704,-13.0649,-7.65042,-2.22714,3.20489,8.64565,14.0952,
-                        19.5536,25.0208,30.497,35.9821,41.4762,46.9794,52.4917,58.0131,63.5436,69.0834,74.6325,80.1909,
-                        85.7587,91.3359,96.9225,102.519,108.124,113.74,119.365,124.999};
 
 volatile unsigned char bSendResultToUART = 0;   // Flag used to indicate ADC1 result ready to send to UART	
 volatile double long ulADC1Result = 0;          // Variable that ADC1DAT is read into in ADC1 IRQ
@@ -90,10 +82,8 @@ volatile long ulADC1DATRtd[SAMPLENO];     // Variable that ADC1DAT is read into
 unsigned long ulADC1CONRtd;               // used to set ADC1CON which sets channel to RTD
 unsigned char ucCounter = 0;
 // UART-based external variables
-unsigned char ucTxBufferEmpty  = 0;       // Used to indicate that the UART Tx buffer is empty
 unsigned char szTemp[64] = "";            // Used to store string before printing to UART
 unsigned char nLen = 0;
-unsigned char i = 0;
 unsigned char ucWaitForUart = 0;          // Used by calibration routines to wait for user input
 
 int main (void)
@@ -196,14 +186,10 @@ void UARTINIT (void)
 }
 void SendString (void)
 {
-   for ( i = 0 ; i < nLen ; i++ )	// loop to send ADC0 result
-   {
-      ucTxBufferEmpty = 0;
-      UrtTx(pADI_UART,szTemp[i]);
-      while (ucTxBufferEmpty == 0)
-      {
-      }
-   }
+   int iSent = 0;
+
+   while (iSent < nLen)                // UrtWrite() takes what fits, wait only while the queue is full
+      iSent += UrtWrite(pADI_UART,szTemp+iSent,nLen-iSent);
 } 
 void SendResultToUART(void)
 {
@@ -260,19 +246,6 @@ void IEXCINIT(void)
    IexcDat(IEXCDAT_IDAT_200uA,IDAT0En);         // Set output for 200uA
    IexcCfg(IEXCCON_PD_off,IEXCCON_REFSEL_Int,IEXCCON_IPSEL1_Off,IEXCCON_IPSEL0_AIN6); //Setup IEXC) for AIN6
 }
-float CalculateRTDTemp(float r) 
-{
-   float t;
-   int j;
-   j=(int)((r-RMIN)/RSEG);       // determine which coefficients to use
-   if (j<0)               // if input is under-range..
-      j=0;                // ..then use lowest coefficients
-   else if (j>NSEG-1)     // if input is over-range..
-      j=NSEG-1;            // ..then use highest coefficients
-   t = C_rtd[j]+(r-(RMIN+RSEG*j))*(C_rtd[j+1]-C_rtd[j])/RSEG;
-   return t;
-}
-
 void WakeUp_Int_Handler(void)
 {
   
@@ -330,7 +303,7 @@ void UART_Int_Handler ()
    ucCOMIID0 = UrtIntSta(pADI_UART);   // Read UART Interrupt ID register
    if ((ucCOMIID0 & 0x2) == 0x2)       // Transmit buffer empty
    {
-      ucTxBufferEmpty = 1;
+      UrtWriteIsr(pADI_UART);            // Send next queued character
    }
    if ((ucCOMIID0 & 0x4) == 0x4)       // Receive byte
    {
@@ -1,14 +1,32 @@
 /**
- ***************************************************************************** 
+ *****************************************************************************
    @example  AD5421.c
    @brief    This file contains functions written for the ADuCM360 that excercie the AD5421 via the SPI1 bus.
-   @version  V0.2
+   - Each 24-bit command is one SPI1 frame: the three bytes are written to the 3-byte
+     FIFO together and the function returns at once.
+   - Frames issued while one is in flight wait in a small queue, the next one is
+     started from SPI1_Int_Handler through AD5421_SpiIsr().
+   - Register reads are non-blocking: AD5421_Read() queues the read command and
+     AD5421_ReadDone() returns the data once the following frame has clocked it out.
+   - With automatic fault readback on in the control register, every frame clocks the
+     fault register out. AD5421_SpiIsr() keeps it in a status struct, so each DAC write
+     also checks the faults without extra frames. AD5421_Monitor() adds a loop voltage
+     or temperature conversion (AD5421_InitADC) after every Nth DAC write; its result
+     comes back in bits 7-0 of the fault register. Read the struct with AD5421_Status().
+   - Built with SPI_PROF defined, each frame is added to the SPI1 profile of
+     common/SpiLib.c with SpiProfXferAdd(), and the blocking reads count as CPU waits.
+   @version  V0.6
    @author   ADI
-   @date     January 2013
+   @date     October 2026
 
    @par Revision History:
-   - V0.1, May 2012: initial version. 
+   - V0.1, May 2012: initial version.
    - V0.2, January 2013: added Doxygen comments
+   - V0.3, October 2026: frames queued and sent from the SPI1 interrupt, non-blocking readback.
+   - V0.4, October 2026: fault and ADC monitoring from the automatic fault readback,
+     offset/gain adjust, load DAC and ADC functions.
+   - V0.5, October 2026: SPI1 clock set to the AD5421 maximum with SpiBaudHz().
+   - V0.6, October 2026: SPI_PROF frame timing and waits.
 
 
 All files for ADuCM360/361 provided by ADI, including this file, are
@@ -24,20 +42,42 @@ to ensure that the resulting application performs as required and is safe.
 #include <ADuCM360.h>
 #include <..\common\SpiLib.h>
 #include "AD5421.h"
- 
+
+ // Frame queue. Only AD5421_SpiIsr() takes frames out, AD5421_Send() masks SPI1_IRQn
+ // while it adds one.
+ static volatile unsigned long ulQueue[AD5421_QUEUE];
+ static volatile int iQueueHead = 0;				// next frame to send
+ static volatile int iQueueNum = 0;				// frames waiting
+ static volatile int iInFlight = 0;				// a frame is in the FIFO
+ static volatile unsigned long ulInFlight = 0;	// command of that frame
+ static volatile int iRdWait = 0;				// 1 read queued, 2 its data comes with the frame in flight
+ static volatile int iRdOk = 0;					// ulRdData holds the result of AD5421_Read()
+ static volatile unsigned long ulRdData = 0;
+ static volatile unsigned long ulRdCmd = 0;		// command of that read
+ static volatile int iAutoFault = 0;				// frames clock out the fault register
+ static volatile AD5421_STA Sta;
+ static int iAdcEvery = 0;						// AD5421_InitADC() after every Nth DAC write, 0 never
+ static int iAdcCount = 0;
+#ifdef SPI_PROF
+ static unsigned short usInFlight = 0;			// SpiProfTime() when the frame in flight started
+#endif
+
  // Init. ADuCM360 to AD5421 interface.
  // If using ADuCM360EBZ evaluation board, ensure all S6 switches are "ON"
- extern unsigned char ucTxComplete;
- extern unsigned long ulRxData;
  void SPI1INIT(void);            // Init SPI1 Interface
- 
+ static void AD5421_Start(unsigned long ulCmd);
+ static void AD5421_Fault(unsigned long ulFault);
+ static unsigned long AD5421_ReadWait(unsigned long ulCmd);
+
  void SPI1INIT (void)
 {
 	pADI_GP0->GPCON &= 0xFF00;
 	pADI_GP0->GPCON |= 0x55; 					  // Configure P0[3:0] for SPI1
-	SpiBaud(pADI_SPI1,10,SPIDIV_BCRST_DIS);
+	SpiBaudHz(pADI_SPI1,AD5421_SCLK_HZ,SPIDIV_BCRST_DIS);	// fastest the SPI1 clock allows, up to 30MHz
 //	SpiCfg(pADI_SPI1,SPICON_MOD_TX3RX3,SPICON_MASEN_EN,SPICON_CON_EN|SPICON_RXOF_EN|
 //	       SPICON_ZEN_EN|SPICON_TIM_TXWR|SPICON_CPOL_HIGH|SPICON_CPHA_SAMPLETRAILING|SPICON_ENABLE_EN);
+	// 3-byte FIFO and continuous mode: CS stays low while the FIFO holds the frame,
+	// Tx IRQ once its three bytes are out
 	SpiCfg(pADI_SPI1,SPICON_MOD_TX3RX3,SPICON_MASEN_EN,SPICON_CON_EN|
 	    SPICON_RXOF_EN|SPICON_ZEN_EN|SPICON_TIM_TXWR|SPICON_CPHA_SAMPLETRAILING|SPICON_ENABLE_EN);
 }
@@ -47,190 +87,255 @@ void AD5421INIT(void)
 	pADI_GP0->GPCLR |= 0x20;					// Clear P0.5 to clear /LDAC=0
 	pADI_GP1->GPPUL |= 0x4;					  // Enable Pull-up on P1.2 to read Fault pin level
 	pADI_GP1->GPOEN &= 0xFC;					// Enable P1.2 as an input to read Fault pin level
+	iQueueHead = 0;
+	iQueueNum = 0;
+	iInFlight = 0;
+	iRdWait = 0;
+	iRdOk = 0;
+	iAutoFault = 0;
+	memset((void *)&Sta,0,sizeof(Sta));
 	SPI1INIT();
+	SpiFifoFlush(pADI_SPI1,SPICON_TFLUSH_EN,SPICON_RFLUSH_EN);
 }
 
- // Write to IDAC data register								
- void AD5421_WriteToDAC(unsigned long ulDACValue)
+ // Load one 24-bit frame into the FIFO, SPI1 interrupt masked or in AD5421_SpiIsr()
+ static void AD5421_Start(unsigned long ulCmd)
  {
-	unsigned long ulCMD = 0;
-	unsigned long ulValue = 0; 	
-
-	SpiFifoFlush(pADI_SPI1,SPICON_TFLUSH_EN,SPICON_RFLUSH_DIS);
-	ulCMD = ((WRITEDAC)<<16);
-	ulValue = ulDACValue;
-	ulValue = (ulValue & 0x0000FFFF);	 // Take 16-bit Register value
-	ulValue |= ulCMD;					 // Append Command to bits 23-16.
-	SpiTx(pADI_SPI1,(unsigned char)(ulValue >> 16));
-	SpiTx(pADI_SPI1,(unsigned char)(ulValue >> 8));
-	SpiTx(pADI_SPI1,(unsigned char)(ulValue));
-   ucTxComplete = 0;
-	while (ucTxComplete == 0) {}
-	ucTxComplete = 0;
- }
- // Write to IDAC Control register		
- void AD5421_WriteToCon(unsigned long ulConValue)
+	ulInFlight = ulCmd;
+	iInFlight = 1;
+#ifdef SPI_PROF
+	usInFlight = SpiProfTime();
+#endif
+	SpiTx(pADI_SPI1,(unsigned char)(ulCmd >> 16));
+	SpiTx(pADI_SPI1,(unsigned char)(ulCmd >> 8));
+	SpiTx(pADI_SPI1,(unsigned char)(ulCmd));
+ }
+
+ // Queue a 24-bit frame, command in bits 23-16. Returns 0 if the queue is full.
+ // iMerge = 1 replaces a frame with the same command still waiting in the queue
+ // instead of adding one: the DAC only needs the latest value.
+ int AD5421_Send(unsigned long ulFrame, int iMerge)
  {
- 	unsigned long ulCMD = 0;
-	unsigned long ulValue = 0; 	
-	SpiFifoFlush(pADI_SPI1,SPICON_TFLUSH_EN,SPICON_RFLUSH_DIS);
-	ulCMD = ((WRITECON)<<16);
-	ulValue = ulConValue;
-	ulValue = (ulValue & 0x0000FFFF);	 // Take 16-bit Register value
-	ulValue |= ulCMD;					 // Append Command to bits 23-16.
-	SpiFifoFlush(pADI_SPI1,SPICON_TFLUSH_DIS,SPICON_RFLUSH_DIS);
-  SpiTx(pADI_SPI1,(unsigned char)(ulValue >> 16));
-	SpiTx(pADI_SPI1,(unsigned char)(ulValue >> 8));
-	SpiTx(pADI_SPI1,(unsigned char)(ulValue));
+	int i1, iOk = 1;
 
-	while (ucTxComplete == 0) {}
-	ucTxComplete = 0;
+	NVIC_DisableIRQ(SPI1_IRQn);
+	if (iInFlight == 0)
+		AD5421_Start(ulFrame);
+	else
+	{
+		for (i1 = 0; iMerge && i1 < iQueueNum; i1++)
+		{
+			int iPos = (iQueueHead + i1) % AD5421_QUEUE;
+			if ((ulQueue[iPos] >> 16) == (ulFrame >> 16))
+			{
+				ulQueue[iPos] = ulFrame;
+				break;
+			}
+		}
+		if (!iMerge || i1 == iQueueNum)
+		{
+			if (iQueueNum < AD5421_QUEUE)
+				ulQueue[(iQueueHead + iQueueNum++) % AD5421_QUEUE] = ulFrame;
+			else
+				iOk = 0;
+		}
+	}
+	NVIC_EnableIRQ(SPI1_IRQn);
+	return iOk;
+ }
 
+ // 1 while frames are queued or in flight
+ int AD5421_Busy(void)
+ {
+	return iInFlight;
  }
- // Write to IDAC Offset adjust register		
- void AD5421_WriteToOffAdj(unsigned long ulOffAdjValue)
+
+ // Call from SPI1_Int_Handler on the SPI1 Tx IRQ: collects the frame just sent
+ // and starts the next one.
+ void AD5421_SpiIsr(void)
  {
+	unsigned long ulRx;
 
+	ulRx = SpiRx(pADI_SPI1);
+	ulRx = (ulRx << 8);
+	ulRx |= SpiRx(pADI_SPI1);
+	ulRx = (ulRx << 8);
+	ulRx |= SpiRx(pADI_SPI1);
+	if (iInFlight == 0)
+		return;
+#ifdef SPI_PROF
+	SpiProfXferAdd(pADI_SPI1,usInFlight,3);
+#endif
+	if (iRdWait == 2)								// this frame clocked out the register read before
+	{
+		ulRdData = ulRx & 0xFFFF;
+		iRdOk = 1;
+		iRdWait = 0;
+		if (ulRdCmd == READFAULT)
+			AD5421_Fault(ulRdData);
+	}
+	else if (iAutoFault)							// automatic fault readback
+		AD5421_Fault(ulRx & 0xFFFF);
+	if ((ulInFlight >> 16) == WRITEDAC)
+		Sta.ulWrites++;
+	if ((ulInFlight >> 16) == WRITECON)				// readback on or off from the next frame
+		iAutoFault = (ulInFlight & AD5421_CON_NOAUTOFLT) == 0;
+	if ((ulInFlight >> 16) == AD5421RESET)
+		iAutoFault = 0;
+	if ((ulInFlight & 0x800000) && iRdWait == 1)	// read command sent, data comes with the next frame
+		iRdWait = 2;
+	if (iQueueNum)
+	{
+		unsigned long ulNext = ulQueue[iQueueHead];
+		iQueueHead = (iQueueHead + 1) % AD5421_QUEUE;
+		iQueueNum--;
+		AD5421_Start(ulNext);
+	}
+	else if (iRdWait == 2)
+		AD5421_Start((unsigned long)AD5421NOP << 16);	// nothing queued, clock the data out with a NOP
+	else
+		iInFlight = 0;
  }
- // Write to IDAC Gain adjust register
- void AD5421_WriteToGnAdj(unsigned long ulDACValue)	
+
+ // Fault register received, from AD5421_SpiIsr()
+ static void AD5421_Fault(unsigned long ulFault)
  {
+	Sta.ulFault = ulFault;
+	Sta.ulFaultSeen |= ulFault & AD5421_FLT_MSK;
+	Sta.ucAdc = (unsigned char)ulFault;
+	Sta.ulReads++;
+	if (ulFault & AD5421_FLT_MSK)
+		Sta.ulFaultReads++;
  }
- // Load the IDAC output
- void AD5421_LoadDac(void)
+
+ // Copy the status and clear ulFaultSeen. Returns the fault bits seen since the last call.
+ unsigned long AD5421_Status(AD5421_STA *pSta)
  {
- 
+	NVIC_DisableIRQ(SPI1_IRQn);
+	*pSta = Sta;
+	Sta.ulFaultSeen = 0;
+	NVIC_EnableIRQ(SPI1_IRQn);
+	return pSta->ulFaultSeen;
  }
- // force Alarm condition on IDAC output								
- void AD5421_ForceAlarm(void)
+
+ // Start an ADC conversion after every iEvery DAC writes, 0 to stop. The control
+ // register selects loop voltage or die temperature (AD5421_CON_ADCTEMP) and must
+ // have the ADC and the automatic fault readback on.
+ void AD5421_Monitor(int iEvery)
  {
-    unsigned long ulCMD = 0;
+	iAdcEvery = iEvery;
+	iAdcCount = 0;
+ }
 
-	 ulCMD = ((FORCEALARM)<<16);
-	 SpiFifoFlush(pADI_SPI1,SPICON_TFLUSH_EN,SPICON_RFLUSH_DIS);
-	 SpiTx(pADI_SPI1,(unsigned char)(ulCMD >> 16));
-	 SpiTx(pADI_SPI1,(unsigned char)(ulCMD >> 8));
-	 SpiTx(pADI_SPI1,(unsigned char)(ulCMD));
-	 while (ucTxComplete == 0) {}
-	 ucTxComplete = 0;
+ // Start a register read, ulCmd one of READDAC..READFAULT. Returns 0 while an
+ // earlier read is not finished or the queue is full.
+ int AD5421_Read(unsigned long ulCmd)
+ {
+	if (iRdWait)
+		return 0;
+	iRdOk = 0;
+	ulRdCmd = ulCmd & 0xFF;
+	iRdWait = 1;
+	if (AD5421_Send((ulCmd & 0xFF) << 16, 0) == 0)
+	{
+		iRdWait = 0;
+		return 0;
+	}
+	return 1;
+ }
 
-	 SpiFifoFlush(pADI_SPI1,SPICON_TFLUSH_EN,SPICON_RFLUSH_DIS);
-	 SpiTx(pADI_SPI1,(unsigned char)(ulCMD >> 16));
-	 SpiTx(pADI_SPI1,(unsigned char)(ulCMD >> 8));
-	 SpiTx(pADI_SPI1,(unsigned char)(ulCMD));
+ // Returns 1 and the 16-bit register value once the read started by AD5421_Read() is done
+ int AD5421_ReadDone(unsigned long *pulData)
+ {
+	if (iRdOk == 0)
+		return 0;
+	iRdOk = 0;
+	*pulData = ulRdData;
+	return 1;
  }
- // Reset AD5421							
- void AD5421_Reset(void)
+
+ // Blocking read for start-up code, not for the measurement loop
+ static unsigned long AD5421_ReadWait(unsigned long ulCmd)
  {
- 	unsigned long ulCMD = 0;
+	unsigned long ulData = 0;
 
-	ulCMD = ((AD5421RESET)<<16);
-	SpiFifoFlush(pADI_SPI1,SPICON_TFLUSH_EN,SPICON_RFLUSH_DIS);
-//	SpiFifoFlush(pADI_SPI1,SPICON_TFLUSH_DIS,SPICON_RFLUSH_DIS);
-	SpiTx(pADI_SPI1,(unsigned char)(ulCMD >> 16));
-	SpiTx(pADI_SPI1,(unsigned char)(ulCMD >> 8));
-	SpiTx(pADI_SPI1,(unsigned char)(ulCMD));
-	while (ucTxComplete == 0) {}
-	ucTxComplete = 0;
+	SPI_PROF_WAIT(pADI_SPI1,AD5421_Read(ulCmd) == 0);
+	SPI_PROF_WAIT(pADI_SPI1,AD5421_ReadDone(&ulData) == 0);
+	return ulData;
+ }
 
-	SpiFifoFlush(pADI_SPI1,SPICON_TFLUSH_EN,SPICON_RFLUSH_DIS);
-//	SpiFifoFlush(pADI_SPI1,SPICON_TFLUSH_DIS,SPICON_RFLUSH_DIS);
-	SpiTx(pADI_SPI1,(unsigned char)(ulCMD >> 16));
-	SpiTx(pADI_SPI1,(unsigned char)(ulCMD >> 8));
-	SpiTx(pADI_SPI1,(unsigned char)(ulCMD));
+ // Write to IDAC data register
+ void AD5421_WriteToDAC(unsigned long ulDACValue)
+ {
+	// Take 16-bit Register value, append Command to bits 23-16.
+	AD5421_Send(((unsigned long)WRITEDAC << 16) | (ulDACValue & 0xFFFF), 1);
+	if (iAdcEvery && ++iAdcCount >= iAdcEvery)
+	{
+		iAdcCount = 0;
+		AD5421_InitADC();
+	}
+ }
+ // Write to IDAC Control register
+ void AD5421_WriteToCon(unsigned long ulConValue)
+ {
+	AD5421_Send(((unsigned long)WRITECON << 16) | (ulConValue & 0xFFFF), 0);
+ }
+ // Write to IDAC Offset adjust register, 0x8000 for no offset
+ void AD5421_WriteToOffAdj(unsigned long ulOffAdjValue)
+ {
+	AD5421_Send(((unsigned long)WRITEOFFADJ << 16) | (ulOffAdjValue & 0xFFFF), 0);
+ }
+ // Write to IDAC Gain adjust register, 0xFFFF for gain 1
+ void AD5421_WriteToGnAdj(unsigned long ulDACValue)
+ {
+	AD5421_Send(((unsigned long)WRITEGNADJ << 16) | (ulDACValue & 0xFFFF), 0);
+ }
+ // Load the IDAC output, when /LDAC is held high
+ void AD5421_LoadDac(void)
+ {
+	AD5421_Send((unsigned long)LOADDAC << 16, 0);
+ }
+ // force Alarm condition on IDAC output
+ void AD5421_ForceAlarm(void)
+ {
+	// sent twice, as in the previous version
+	AD5421_Send((unsigned long)FORCEALARM << 16, 0);
+	AD5421_Send((unsigned long)FORCEALARM << 16, 0);
+ }
+ // Reset AD5421. Wait for AD5421_Busy() = 0, then 50us, before the next command.
+ void AD5421_Reset(void)
+ {
+	AD5421_Send((unsigned long)AD5421RESET << 16, 0);
+	AD5421_Send((unsigned long)AD5421RESET << 16, 0);
  }
- // Measure Vloop or die temp via ADC								
+ // Measure Vloop or die temp via ADC. The result is in bits 7-0 of the next fault
+ // register readings, AD5421_STA.ucAdc.
  void AD5421_InitADC(void)
  {
- 
+	AD5421_Send((unsigned long)INITADC << 16, 1);
  }
- // Read to IDAC data register								
+ // Read to IDAC data register, blocking
  unsigned long AD5421_ReadDAC(unsigned long ulDACValue)
  {
-  	unsigned long ulCMD = 0;
-	unsigned long ulValue = 0;
-	unsigned long ulData = 0; 	
-	
-	SpiFifoFlush(pADI_SPI1,SPICON_TFLUSH_EN,SPICON_RFLUSH_EN);
-
-	ulCMD = ((READDAC)<<16);
-	ulValue = ulDACValue;
-	ulValue = (ulValue & 0x0000FFFF);	 // Take 16-bit Register value
-	ulValue |= ulCMD;					 // Append Command to bits 23-16.
-	
-	SpiTx(pADI_SPI1,(unsigned char)(ulValue >> 16));
-	SpiTx(pADI_SPI1,(unsigned char)(ulValue >> 8));
-	SpiTx(pADI_SPI1,(unsigned char)(ulValue));
-	while (ucTxComplete == 0) {}
-	ucTxComplete = 0;
-
-	ulData = ulRxData;
-	
-	return ulData;
- }	
- // Read IDAC Control register		
+	return AD5421_ReadWait(READDAC);
+ }
+ // Read IDAC Control register, blocking
  unsigned long AD5421_ReadCon(unsigned long ulConValue)
  {
- 	unsigned long ulCMD = 0;
-	unsigned long ulValue = 0; 	
-	unsigned long ulData = 0;
-	
-	SpiFifoFlush(pADI_SPI1,SPICON_TFLUSH_EN,SPICON_RFLUSH_EN);
-	ulCMD = ((READCON)<<16);
-	ulValue = ulConValue;
-	ulValue = (ulValue & 0x0000FFFF);	 // Take 16-bit Register value
-	ulValue |= ulCMD;					 // Append Command to bits 23-16.
-
-  SpiTx(pADI_SPI1,(unsigned char)(ulValue >> 16));
-	SpiTx(pADI_SPI1,(unsigned char)(ulValue >> 8));
-	SpiTx(pADI_SPI1,(unsigned char)(ulValue));
-	while (ucTxComplete == 0) {}
-	ucTxComplete = 0;
-
-	ulData = ulRxData;
-
-	return ulData;
- }		
- // Read IDAC Offset adjust register	
- void AD5421_ReadOffAdj(unsigned long ulOffAdjValue)
+	return AD5421_ReadWait(READCON);
+ }
+ // Read IDAC Offset adjust register, blocking
+ unsigned long AD5421_ReadOffAdj(unsigned long ulOffAdjValue)
  {
- 
- }	
- // Read IDAC Gain adjust register
- void AD5421_ReadGnAdj(unsigned long ulDACValue)
+	return AD5421_ReadWait(READOFFADJ);
+ }
+ // Read IDAC Gain adjust register, blocking
+ unsigned long AD5421_ReadGnAdj(unsigned long ulDACValue)
  {
- 
+	return AD5421_ReadWait(READGNADJ);
  }
- // Read Fault register		
+ // Read Fault register, blocking
  unsigned long  AD5421_ReadFault(unsigned long ulDACValue)
  {
- 	unsigned long ulCMD = 0;
-	unsigned long ulValue = 0;
-	unsigned long ulData = 0; 	
-	
-	SpiFifoFlush(pADI_SPI1,SPICON_TFLUSH_EN,SPICON_RFLUSH_DIS);
-	SpiFifoFlush(pADI_SPI1,SPICON_TFLUSH_DIS,SPICON_RFLUSH_DIS);
-	ulCMD = ((READFAULT)<<16);
-	ulValue = ulDACValue;
-	ulValue = (ulValue & 0x0000FFFF);	 // Take 16-bit Register value
-	ulValue |= ulCMD;					 // Append Command to bits 23-16.
-
-  SpiTx(pADI_SPI1,(unsigned char)(ulValue >> 16));
-	SpiTx(pADI_SPI1,(unsigned char)(ulValue >> 8));
-	SpiTx(pADI_SPI1,(unsigned char)(ulValue));
-	while (ucTxComplete == 0) {}
-	ucTxComplete = 0;
-
-	SpiFifoFlush(pADI_SPI1,SPICON_TFLUSH_DIS,SPICON_RFLUSH_EN);
-	SpiFifoFlush(pADI_SPI1,SPICON_TFLUSH_DIS,SPICON_RFLUSH_DIS);
-	SpiTx(pADI_SPI1,0);
-	SpiTx(pADI_SPI1,0);
-	SpiTx(pADI_SPI1,0);
-	while (ucTxComplete == 0) {}
-	ulData = ulRxData;
-	
-	return ulData;
- }		
- 
-
- 
\ No newline at end of file
+	return AD5421_ReadWait(READFAULT);
+ }
@@ -9,9 +9,17 @@
  void AD5421_InitADC(void);								              // Measure Vloop or die temp via ADC
  unsigned long AD5421_ReadDAC(unsigned long ulDACValue);// Read to IDAC data register
  unsigned long  AD5421_ReadCon(unsigned long ulConValue);// Read IDAC Control register
- void AD5421_ReadOffAdj(unsigned long ulOffAdjValue);	  // Read IDAC Offset adjust register
- void AD5421_ReadGnAdj(unsigned long ulDACValue);		    // Read IDAC Gain adjust register
+ unsigned long AD5421_ReadOffAdj(unsigned long ulOffAdjValue);// Read IDAC Offset adjust register
+ unsigned long AD5421_ReadGnAdj(unsigned long ulDACValue);// Read IDAC Gain adjust register
  unsigned long  AD5421_ReadFault(unsigned long ulDACValue);// Read Fault register
+ int AD5421_Send(unsigned long ulFrame, int iMerge);	// Queue a 24-bit frame, returns at once
+ int AD5421_Busy(void);									// 1 while frames are queued or in flight
+ void AD5421_SpiIsr(void);								// Call from SPI1_Int_Handler on SPI1 Tx IRQ
+ int AD5421_Read(unsigned long ulCmd);					// Start a register read, READDAC..READFAULT
+ int AD5421_ReadDone(unsigned long *pulData);			// 1 and the register value once the read is done
+ void AD5421_Monitor(int iEvery);						// ADC conversion after every iEvery DAC writes
+
+ #define AD5421_SCLK_HZ		30000000	// maximum SCLK frequency of the AD5421
 
  #define WRITEDAC 			1
  #define WRITECON 			2
@@ -26,6 +34,43 @@
  #define READOFFADJ			0x83
  #define READGNADJ 			0x84
  #define READFAULT 			0x85
+ #define AD5421NOP 			9			// no operation, clocks out the data of a read
+
+ // Control register bits
+ #define AD5421_CON_NOWDT		0x1000		// SPI watchdog off
+ #define AD5421_CON_NOAUTOFLT	0x0800		// automatic fault readback off
+ #define AD5421_CON_MINCUR		0x0200		// minimum loop current on
+ #define AD5421_CON_ADCTEMP		0x0100		// ADC measures die temperature instead of Vloop
+ #define AD5421_CON_ADCON		0x0080		// ADC on
+ #define AD5421_CON_NOINTREF	0x0040		// internal reference off
+
+ // Fault register bits, bits 7-0 hold the last ADC result
+ #define AD5421_FLT_SPI		0x8000		// SPI watchdog timeout
+ #define AD5421_FLT_PEC		0x4000		// packet error check
+ #define AD5421_FLT_IOVER		0x2000		// loop current over range
+ #define AD5421_FLT_IUNDER		0x1000		// loop current under range
+ #define AD5421_FLT_T140		0x0800		// die above 140C
+ #define AD5421_FLT_T100		0x0400		// die above 100C
+ #define AD5421_FLT_V6		0x0200		// Vloop below 6V
+ #define AD5421_FLT_V12		0x0100		// Vloop below 12V
+ #define AD5421_FLT_MSK		0xFF00
+
+ // Kept up to date by AD5421_SpiIsr(), read with AD5421_Status()
+ typedef struct
+ {
+	unsigned long ulFault;			// last fault register read
+	unsigned long ulFaultSeen;		// fault bits seen since the last AD5421_Status()
+	unsigned char ucAdc;			// Vloop or temperature code of the last conversion
+	unsigned long ulReads;			// fault register readings
+	unsigned long ulFaultReads;		// readings with a fault bit set
+	unsigned long ulWrites;			// DAC writes sent
+ } AD5421_STA;
+
+ unsigned long AD5421_Status(AD5421_STA *pSta);		// Copy the status, returns the fault bits seen
+
+ #ifndef AD5421_QUEUE
+ #define AD5421_QUEUE		8			// frames waiting behind the one in flight
+ #endif
 
  static unsigned long ul5421CON = 0;
  static unsigned long ul5421DAT = 0;
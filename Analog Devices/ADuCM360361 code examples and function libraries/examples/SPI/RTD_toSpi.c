@@ -26,10 +26,19 @@
    - Results will be more accurate if System calibration is added
 				 
    - The RTD reading is also sent to the IDAC; TMIN = 4mA; TMAX = 20mA
+   - Define SPI_PROF for the whole project to time the AD5421 frames on timer 1 and
+     print the SPI1 frames, bus time and CPU waits with each result.
 
-   @version V0.1
+   @version V0.5
    @author  ADI
-   @date    February 2013
+   @date    October 2026
+
+   @par     Revision History:
+   - V0.1, February 2013: initial version.
+   - V0.2, October 2026: RTD conversion moved to common/TempLib.h.
+   - V0.3, October 2026: AD5421 frames sent from the SPI1 interrupt, no waits on ucTxComplete.
+   - V0.4, October 2026: AD5421 faults and Vloop read back with every DAC update.
+   - V0.5, October 2026: SPI_PROF profile of the AD5421 frames.
 
               
 All files for ADuCM360/361 provided by ADI, including this file, are
@@ -53,6 +62,9 @@ to ensure that the resulting application performs as required and is safe.
 #include <..\common\IntLib.h>
 #include <..\common\DioLib.h>
 #include <..\common\SpiLib.h>
+#include <..\common\GptLib.h>
+#define TEMPLIB_RTD                         // RTD conversion
+#include <..\common\TempLib.h>
 #include "AD5421.h"
 
 void ADC1INIT(void);					                   // Init ADC1
@@ -62,20 +74,8 @@ void SendString(void);					                 // Transmit string using UART
 void IEXCINIT(void);                 	           // Setup Excitation Current sources
 void SendResultToUART(void);			               // Send measurement results to UART - in ASCII String format
 void SendErrorToUART(void);				               // Send Error String to UART to indicate PGA overrange occured
-float CalculateRTDTemp(float r);		             // returns RTD Temperature reading
 void SendResultToAD5421(void);                   // Converts RTD temeprature to 4-20mA value and sends to SPI (AD5421)
 #define SAMPLENO			0x8			                   // Number of samples to be taken between channel switching
-//RTD constants
-#define TMIN (-40)  					                   // = minimum temperature in degC
-#define TMAX (125)  					                   // = maximum temperature in degC
-#define RMIN (84.2707)  				                 // = input resistance in ohms at -40 degC
-#define RMAX (147.951)  				                 // = input resistance in ohms at 125 degC
-#define NSEG 30  						                     // = number of sections in table
-#define RSEG 2.12269  					                 // = (RMAX-RMIN)/NSEG = resistance  in ohms of each segment
-//RTD lookup table
-const float C_rtd[] = {-40.0006,-34.6322,-29.2542,-23.8669,-18.4704,-13.0649,-7.65042,-2.22714,3.20489,8.64565,14.0952,
-						19.5536,25.0208,30.497,35.9821,41.4762,46.9794,52.4917,58.0131,63.5436,69.0834,74.6325,80.1909,
-						85.7587,91.3359,96.9225,102.519,108.124,113.74,119.365,124.999};
 
 volatile unsigned char bSendResultToUART = 0;	   // Flag used to indicate ADC1 result ready to send to UART	
 volatile double long ulADC1Result = 0;		       // Variable that ADC1DAT is read into in ADC1 IRQ
@@ -103,16 +103,22 @@ unsigned char i = 0;
 unsigned char ucWaitForUart = 0;				         // Used by calibration routines to wait for user input
 
 // SPI variables
-unsigned char ucTxComplete = 0;                  // Flag used to indicate SPI transfer complete
-unsigned long ulRxData = 0;                      // Used to read SPI1 values
 unsigned long ulDacVal = 0;                      // Used to readback AD5421 DAC value through SPI1
+AD5421_STA AD5421Status;                         // AD5421 faults and Vloop, from the automatic fault readback
+#ifdef SPI_PROF
+SPI_PROF_DEV AD5421Prof;                         // AD5421 frames, SPI1 is profile 1
+#endif
 int main (void)
 {
 
    DioOen(pADI_GP1,0x8);                         // Set P1.3 as an output for test purposes
    WdtCfg(T3CON_PRE_DIV1,T3CON_IRQ_EN,T3CON_PD_DIS); // Disable Watchdog timer resets
    //Disable clock to unused peripherals
+#ifdef SPI_PROF
+   ClkDis(CLKDIS_DISSPI0CLK|CLKDIS_DISI2CCLK|CLKDIS_DISPWMCLK|CLKDIS_DIST0CLK); // Timer 1 times the SPI1 frames
+#else
    ClkDis(CLKDIS_DISSPI0CLK|CLKDIS_DISI2CCLK|CLKDIS_DISPWMCLK|CLKDIS_DIST0CLK|CLKDIS_DIST1CLK); // Only enable clock to used blocks
+#endif
    ClkCfg(CLK_CD3,CLK_HF,CLKSYSDIV_DIV2EN_DIS,CLK_UCLKCG);     // Select CD3 for CPU clock
    ClkSel(CLK_CD3,CLK_CD7,CLK_CD3,CLK_CD7);      // Select CD3 for UART and SPI1 System clock
    AdcGo(pADI_ADC1,ADCMDE_ADCMD_IDLE);			     // Place ADC1 in Idle mode
@@ -120,25 +126,22 @@ int main (void)
    ADC1INIT();									                 // Setup ADC1
    IEXCINIT();									                 // Setup Excitation current source
    AD5421INIT();
+#ifdef SPI_PROF
+   GptCfg(pADI_TM1,TCON_CLK_UCLK,TCON_PRE_DIV16,TCON_UP|TCON_ENABLE); // Free running, 1us from the 16MHz UCLK
+   SpiProfCfg(pADI_TM1);
+#endif
    NVIC_EnableIRQ(ADC1_IRQn);					           // Enable ADC1, SPI1 and UART interrupt sources
    NVIC_EnableIRQ(UART_IRQn);
    NVIC_EnableIRQ(SPI1_IRQn);
 	
 	 AD5421_Reset();                               // reset AD5421 via SPI1
-   while (ucTxComplete == 0){}                   // Wait for SPI1 interrupt
-   ucTxComplete = 0;
+   SPI_PROF_WAIT(pADI_SPI1,AD5421_Busy());      // Wait for the reset frames to go out
 	 delay(1500);                                  // AD5421 requires 50uS delay after reset command before issueing more commands
 	 ul5421FAULT = AD5421_ReadFault(0x0);
-   while (ucTxComplete == 0){}
-   ucTxComplete = 0;
-   AD5421_WriteToCon(0xFC80);				             // Watchdog off, Int ref on, disable automatic readback of Fault register
-   ucTxComplete = 0;	 
+   AD5421_WriteToCon(0xF480);				             // Watchdog off, Int ref on, ADC on Vloop, automatic readback of Fault register
 	 ul5421CON = AD5421_ReadCon(0x0);		           // Read AD5421 control register - debug only
-
-   SpiFifoFlush(pADI_SPI1,SPICON_TFLUSH_DIS,SPICON_RFLUSH_EN);
    ul5421FAULT = AD5421_ReadFault(0x0);          // Read AD5421 fault register - debug only
-   while (ucTxComplete == 0){}
-   ucTxComplete = 0;	 
+   AD5421_Monitor(1);                            // Measure Vloop after every DAC update
    while (1)
    {
 		// reset calculation variables
@@ -261,6 +264,19 @@ void SendResultToUART(void)
 	nLen = strlen((char*)szTemp);
 	if (nLen <64)
  		SendString();
+
+	ul5421FAULT = AD5421_Status(&AD5421Status);    // Fault bits seen since the last update
+	sprintf ( (char*)szTemp, "IDAC Fault: 0x%04lX Vloop code: %u \r\n",ul5421FAULT,AD5421Status.ucAdc );
+	nLen = strlen((char*)szTemp);
+	if (nLen <64)
+ 		SendString();
+#ifdef SPI_PROF
+	SpiProfRd(1,&AD5421Prof,1);                    // AD5421 frames since the last result
+	sprintf ( (char*)szTemp, "AD5421 frames: %lu SPI1: %luus wait: %luus \r\n",AD5421Prof.ulXfers,AD5421Prof.ulBusy,AD5421Prof.ulWait );
+	nLen = strlen((char*)szTemp);
+	if (nLen <64)
+ 		SendString();
+#endif
 	
 	sprintf ( (char*)szTemp, "RTD Temperature: %fC \r\n\n\n",fTRTD );                          
 	nLen = strlen((char*)szTemp);
@@ -280,7 +296,7 @@ void SendResultToAD5421(void)
 	fFrationOfFS = fTRTD/165;
 	uiADC0RESULT = (unsigned int)(fFrationOfFS * 0xFFFF);
 	fCurrent = (4 + (fFrationOfFS*16));
-	AD5421_WriteToDAC(uiADC0RESULT);
+	AD5421_WriteToDAC(uiADC0RESULT);               // queued, returns at once
 }
 void SendErrorToUART(void)
 {
@@ -306,19 +322,6 @@ void IEXCINIT(void)
 	IexcCfg(IEXCCON_PD_off,IEXCCON_REFSEL_Int,IEXCCON_IPSEL1_Off,IEXCCON_IPSEL0_AIN5); //Setup IEXC) for AIN5
 //	IexcCfg(IEXCCON_PD_off,IEXCCON_REFSEL_Int,IEXCCON_IPSEL1_Off,IEXCCON_IPSEL0_AIN6); //Setup IEXC) for AIN6 - for EVAL-ADuCM360MKZ board
 }
-float CalculateRTDTemp(float r) 
-{
-	float t;
-	int j;
-	j=(int)((r-RMIN)/RSEG);                        // determine which coefficients to use
-	if (j<0)                                       // if input is under-range..
-		j=0;                                         // ..then use lowest coefficients
-	else if (j>NSEG-1)                             // if input is over-range..
-		j=NSEG-1;                                    // ..then use highest coefficients
-	t = C_rtd[j]+(r-(RMIN+RSEG*j))*(C_rtd[j+1]-C_rtd[j])/RSEG;
-	return t;
-}
-
 void WakeUp_Int_Handler(void)
 {
   
@@ -398,12 +401,7 @@ void SPI1_Int_Handler ()
 	}
 	if ((uiSPI1STA & SPI1STA_TX) == SPI1STA_TX)	 	 // SPI1 Tx IRQ
 	{
-		ucTxComplete = 1;
-		ulRxData = SpiRx(pADI_SPI1);
-		ulRxData = (ulRxData << 8);
-		ulRxData |= SpiRx(pADI_SPI1);
-		ulRxData = (ulRxData << 8);
-		ulRxData |= SpiRx(pADI_SPI1);
+		AD5421_SpiIsr();                             // AD5421 frame sent, start the next one
 	}
 	if ((uiSPI1STA & SPI1STA_TXUR) == SPI1STA_TXUR)// SPI1 Tx underflow IRQ
 	{
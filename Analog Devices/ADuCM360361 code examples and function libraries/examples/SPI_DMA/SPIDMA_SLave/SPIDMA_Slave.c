@@ -2,11 +2,13 @@
  *****************************************************************************
    @example  SPIDMA_Slave.c
    @brief    SPI1 Slave DMA example
-      Expects a 16-byte array on SPI1 RX input
+      Expects 16-byte frames on SPI1 RX input. The DMA receives continuously
+      into a ring with SpiDmaRxCfg(), so the master can send frames back to
+      back while the main loop copies the complete ones out.
 
-   @version  V0.1
+   @version  V0.2
    @author   ADI
-   @date     October 2012 
+   @date     October 2026 
 
 
 All files for ADuCM360/361 provided by ADI, including this file, are
@@ -15,6 +17,9 @@ The user assumes any and all risk from the use of this code.
 It is the responsibility of the person integrating this code into an application
 to ensure that the resulting application performs as required and is safe.
 
+   - V0.1, October 2012: First version, re-armed a single 16 byte DMA transfer from the main loop.
+   - V0.2, October 2026: Continuous reception with SpiDmaRxCfg(), frames counted and
+     overruns read with SpiDmaRxOvr().
 
 **/
 
@@ -37,12 +42,20 @@ void delay(long int);
 void SPI1INIT(void);
 void DMAINIT(void);
 
+// Frame length in bytes. Set to 0 to end each frame when CS (P0.3) goes high instead,
+// with P0.3 also wired to EINT4.
+#define SPI1_FRAME   16
+
 unsigned char ucIrqCnt = 0;                              // Used to count number of SPI1 DMA interrupts
-unsigned char ucSPIDMAEnable = 0;                        // Flag used to setup 2nd and subsequent transfers
-unsigned char uxSPI1RxData[16];
+unsigned char uxSPI1RxData[SPI_DMA_RX_SIZE];            // Longest frame the ring can hold
+unsigned long ulFrames = 0;                              // Complete frames received
+int iOverruns = 0;                                       // Times the main loop fell a ring behind
 
 int main (void)
 {
+   unsigned char *pucSpan;
+   int iLen, iEnd, iCnt = 0, iDrop = 0;
+
    WdtCfg(T3CON_PRE_DIV1,T3CON_IRQ_EN,T3CON_PD_DIS);      // Disable Watchdog timer resets
    DioOen(pADI_GP1,0x8);                                  // Set P1.3 as an output to toggle the LED
    //Disable clock to unused peripherals
@@ -57,20 +70,30 @@ int main (void)
    NVIC_EnableIRQ(DMA_SPI1_RX_IRQn);                      // SPI1 Rx DMA interrupt enable
    while (1)
    {
-	    
-	 DioTgl(pADI_GP1,0x8);	// Toggle P1.3
-	 delay(0x60000);		// Delay routine	
-     if (ucSPIDMAEnable ==1)
-		 {
-      //  SetCycleCtrl(SPI1RX_C,16,DMA_DSTINC_BYTE|DMA_SRCINC_NO|DMA_SIZE_BYTE|DMA_BASIC); // re-Enable SPI RX DMA for next transfer
-			 DmaStructPtrInSetup(SPI1RX_C,16,uxSPI1RxData);;    // Setup source/destination pointer fields
-			 DmaCycleCntCtrl(SPI1RX_C,16,DMA_DSTINC_BYTE|
-			    DMA_SRCINC_NO|DMA_SIZE_BYTE|DMA_BASIC);         // re-Enable SPI RX DMA for next transfer
-			 DmaClr(DMARMSKCLR_SPI1RX,0,0,0);
-	     DmaSet(0,DMAENSET_SPI1RX,0,
- 	        DMAPRISET_SPI1RX);                              // Enable SPI1 DMA primary structure
-			 ucSPIDMAEnable = 0;
-     }			 
+      // Copy out every complete frame. A frame that wraps around the end of the
+      // ring comes in two spans, the last one with iEnd = 1.
+      while ((iLen = SpiDmaRxSpan(&pucSpan,&iEnd)) != 0)
+      {
+         if (iCnt + iLen > (int)sizeof(uxSPI1RxData))
+            iDrop = 1;                                   // Longer than the buffer, drop it
+         else
+            memcpy(uxSPI1RxData+iCnt,pucSpan,iLen);
+         iCnt += iLen;
+         if (!SpiDmaRxDone(iLen))
+            iDrop = 1;                                   // Overwritten while copied, drop it
+         if (iEnd)
+         {
+            if (!iDrop)
+            {
+               ulFrames++;                               // uxSPI1RxData[0..iCnt-1] holds the frame
+               if ((ulFrames & 0x3F) == 0)
+                  DioTgl(pADI_GP1,0x8);                  // Toggle P1.3 every 64 frames
+            }
+            iCnt = 0;
+            iDrop = 0;
+         }
+      }
+      iOverruns = SpiDmaRxOvr();
    }
 }
 
@@ -83,16 +106,7 @@ void SPI1INIT(void)
 	  SPICON_CON_EN|SPICON_SOEN_EN|SPICON_RXOF_EN|
 	  SPICON_ZEN_EN|SPICON_CPHA_SAMPLETRAILING|
 	  SPICON_ENABLE_EN);                                    // Enable SPI1 Slave mode, continuous transfer, 
-	SpiDma(pADI_SPI1,SPIDMA_IENRXDMA_EN,SPIDMA_IENTXDMA_EN, // Enable SPI1 DMA operation - Tx and Rx
-	   SPIDMA_ENABLE_EN);
-	DmaPeripheralStructSetup(SPI1RX_C,DMA_DSTINC_BYTE|
-	   DMA_SRCINC_NO|DMA_SIZE_BYTE);                        // Setup SPI1 Rx DMA structure
-  DmaStructPtrInSetup(SPI1RX_C,16,uxSPI1RxData);          // Setup source/destination pointer fields
-	DmaCycleCntCtrl(SPI1RX_C,16,DMA_DSTINC_BYTE|
-	   DMA_SRCINC_NO|DMA_SIZE_BYTE|DMA_BASIC);              // Enable SPI RX DMA for next transfer
-	DmaClr(DMARMSKCLR_SPI1RX,0,0,0);
-	DmaSet(0,DMAENSET_SPI1RX,0,
- 	     DMAPRISET_SPI1RX);                                 // Enable SPI1 DMA primary structure   
+	SpiDmaRxCfg(pADI_SPI1,SPI1_FRAME);                      // Receive continuously into the ring, both DMA structures
 }
 void DMAINIT(void)  
 {
@@ -114,7 +128,9 @@ void Ext_Int2_Handler ()
 }
 void Ext_Int4_Handler ()
 {         
- 
+#if SPI1_FRAME == 0
+	SpiDmaRxCsIsr();                                        // CS high - end of frame
+#endif
 }
 void GP_Tmr0_Int_Handler(void)
 {
@@ -143,9 +159,8 @@ void UART_Int_Handler ()
 } 
 void DMA_SPI1_RX_Int_Handler()
 {
-	DmaSet(DMARMSKSET_SPI1RX,DMAENSET_SPI1RX,0,0);
+	SpiDmaRxIsr();                                          // Half of the ring full, re-arm it
 	ucIrqCnt++;
-	ucSPIDMAEnable = 1;
 } 
 void I2C0_Slave_Int_Handler(void) 
 {
@@ -4,15 +4,19 @@
    @brief    UART DMA example
 	Trigerring external IRQ4 sends the number of times the IRQ was triggered
    over the uart
+   Received frames are echoed back. They are received with DMA into a ring, timer 0
+   detects the end of each frame, and each frame is sent back by DMA from the ring
+   without being copied.
 
-   @version V0.2
+   @version V0.3
    @author  ADI
-   @date    February 2013
+   @date    October 2026
 
    @par     Revision History:
    - V0.1, October 2012: initial version. 
    - V0.2, February 2013: Removed unused function SendString() and variable 
    ucTxBufferEmpty.
+   - V0.3, October 2026: Receive into a ring with UrtDmaRxCfg() instead of 32 byte packets.
               
 All files for ADuCM360/361 provided by ADI, including this file, are
 provided  as is without warranty of any kind, either expressed or implied.
@@ -42,8 +46,10 @@ void delay(long int);
 void DMAINIT(void);
 // UART-based external variables
 unsigned char szTemp[64] = "";                       // Used to store string before printing to UART
-unsigned char szPacketIn[32];	                       // Used to store received bytes from UART
-unsigned char ucPacketRcvd = 0;                      // Flag to indicate Received packet
+unsigned char *pucSpan;                              // Received bytes being echoed, in the UrtDmaRxCfg() ring
+int iSpanLen = 0;                                    // Number of bytes at pucSpan, 0 if none
+int iSpanEnd = 0;                                    // Set if pucSpan ends a frame
+volatile unsigned char ucTxBusy = 0;                 // Set while the UART TX DMA is sending
 unsigned char nLen = 0;
 unsigned char i = 0;
 unsigned char ucSendString  = 0;                     // Used to trigger sending string to UART
@@ -54,7 +60,7 @@ int main (void)
    DioOen(pADI_GP1,0x8);                             // Set P1.3 as an output for test purposes
    WdtCfg(T3CON_PRE_DIV1,T3CON_IRQ_EN,T3CON_PD_DIS); // Disable Watchdog timer resets
    //Disable clock to unused peripherals
-   ClkDis(CLKDIS_DISSPI0CLK|CLKDIS_DISSPI1CLK|CLKDIS_DISI2CCLK|CLKDIS_DISPWMCLK|CLKDIS_DIST0CLK|CLKDIS_DIST1CLK); // Only enable clock to used blocks
+   ClkDis(CLKDIS_DISSPI0CLK|CLKDIS_DISSPI1CLK|CLKDIS_DISI2CCLK|CLKDIS_DISPWMCLK|CLKDIS_DIST1CLK); // Only enable clock to used blocks
    ClkCfg(CLK_CD0,CLK_HF,CLKSYSDIV_DIV2EN,CLK_UCLKCG);// Select CD0 for CPU clock with 8MHz UCLK (div2 enabled on oscillator output)
    ClkSel(CLK_CD7,CLK_CD7,CLK_CD0,CLK_CD7);           // Select CD0 for UART System clock
 	 DMAINIT();                                         // Initialize DMA controller
@@ -63,10 +69,11 @@ int main (void)
 	 NVIC_EnableIRQ(EINT4_IRQn);                        // Enable IRQ4 interrupt
    NVIC_EnableIRQ(DMA_UART_TX_IRQn);                  // Enable UART Tx DMA interrupts
    NVIC_EnableIRQ(DMA_UART_RX_IRQn);                  // Enable UART Rx DMA interrupts
+   NVIC_EnableIRQ(TIMER0_IRQn);                       // Enable timer 0 interrupt - end of frame detection
    ucSendString = 0;
    while (1)
    {
-      if (ucSendString == 1)
+      if ((ucSendString == 1) && (ucTxBusy == 0))
 			{
 		     ucSendString = 0;				
   				sprintf ( (char*)szTemp, "External IRQ4 count: %d \r\n",ucIRQCnt ); 
@@ -74,6 +81,7 @@ int main (void)
          if (nLen <64)
 				 {
           
+					 ucTxBusy = 1;
 					 DmaStructPtrOutSetup(UARTTX_C,64,szTemp);  // Setup UARTTX source/destination pointers and number of bytes to send
 					 DmaCycleCntCtrl(UARTTX_C,64,DMA_DSTINC_NO| // Setup CHNL_CFG settings
 				   	  DMA_SRCINC_BYTE|DMA_SIZE_BYTE|DMA_BASIC);
@@ -83,23 +91,25 @@ int main (void)
 					 UrtTx(pADI_UART,0);                        // Send byte 0 to the UART to start transfer
 				 }
 			 }
-			 if (ucPacketRcvd == 1)
+			 if ((ucTxBusy == 0) && (iSpanLen != 0))
 			 {
-				 ucPacketRcvd = 0;
-				 // Send out received packet first
-				 DmaStructPtrOutSetup(UARTTX_C,32,szPacketIn);//Setup UARTRX source/destination pointers and number of bytes to receive
-				 DmaCycleCntCtrl(UARTTX_C,32,DMA_DSTINC_NO|   // Setup CHNL_CFG settings
+				 UrtDmaRxDone(iSpanLen);                      // Echo sent, release the bytes
+				 iSpanLen = 0;
+			 }
+			 if ((ucTxBusy == 0) && (iSpanLen == 0))
+			 {
+				 iSpanLen = UrtDmaRxSpan(&pucSpan,&iSpanEnd); // Next received bytes, in place in the ring
+				 if (iSpanLen != 0)
+				 {
+					 ucTxBusy = 1;
+					 DmaStructPtrOutSetup(UARTTX_C,iSpanLen,pucSpan);// Send them back straight from the ring
+					 DmaCycleCntCtrl(UARTTX_C,iSpanLen,DMA_DSTINC_NO|
 				   	  DMA_SRCINC_BYTE|DMA_SIZE_BYTE|DMA_BASIC);
-					 DmaClr(DMARMSKCLR_UARTTX,0,0,0);           // Enable UART RX DMA channel
+					 DmaClr(DMARMSKCLR_UARTTX,0,0,0);
 	         DmaSet(0,DMAENSET_UARTTX,0,
  	            DMAPRISET_UARTTX);                      // Enable UART DMA primary structure
 					 UrtTx(pADI_UART,0);                        // Send byte 0 to the UART to start transfer
-				 // re-enable UARTRX DMA
-				 	DmaStructPtrInSetup(UARTRX_C,32,szPacketIn);
-	        DmaCycleCntCtrl(UARTRX_C,32,DMA_DSTINC_BYTE|
-		        DMA_SRCINC_NO|DMA_SIZE_BYTE|DMA_BASIC);
-	        DmaClr(DMARMSKCLR_UARTRX,0,0,0);
-	        DmaSet(0,DMAENSET_UARTRX,0,0);              // Enable UART DMA primary structure
+				 }
 			 }
       delay(0x60000);		// Delay routine
 			DioTgl(pADI_GP1,0x8);                           // Toggle LED, P1.3
@@ -119,13 +129,8 @@ void UARTINIT (void)
 	UrtDma(pADI_UART,COMIEN_EDMAT|COMIEN_EDMAR);        // Enable UART DMA interrupts	
 	DmaPeripheralStructSetup(UARTTX_C,DMA_DSTINC_NO|    // Enable DMA write channel
 	    DMA_SRCINC_BYTE|DMA_SIZE_BYTE);
-	DmaPeripheralStructSetup(UARTRX_C,DMA_DSTINC_BYTE|  // Enable DMA UART Read channel
-	    DMA_SRCINC_NO|DMA_SIZE_BYTE);
-	DmaStructPtrInSetup(UARTRX_C,32,szPacketIn);
-	DmaCycleCntCtrl(UARTRX_C,32,DMA_DSTINC_BYTE|
-		DMA_SRCINC_NO|DMA_SIZE_BYTE|DMA_BASIC);
-	DmaClr(DMARMSKCLR_UARTRX,0,0,0);
-	DmaSet(0,DMAENSET_UARTRX,0,0);                      // Enable UART RX DMA primary structure
+	UrtDmaRxCfg(pADI_UART,pADI_TM0,3125);              // Receive into the DMA ring, a frame ends after
+	                                                    // 3 idle characters at 9600 baud (3125us)
 	
 }
 void DMAINIT(void)  
@@ -150,6 +155,7 @@ void Ext_Int4_Handler ()
 }
 void GP_Tmr0_Int_Handler(void)
 {
+   UrtDmaRxTmrIsr();                                  // End the frame if the line was idle
 
 }
 
@@ -180,6 +186,7 @@ void DMA_UART_TX_Int_Handler()
 
    ucCOMIID0 = UrtIntSta(pADI_UART);                // Read UART Interrupt ID register 
 	 DmaSet(DMARMSKSET_UARTTX,DMAENSET_UARTTX,0,0);   // MASK UART DMA channel to prevent further interrupts triggering - unmask when ready to re-transmit
+	 ucTxBusy = 0;                                    // Ready for the next transfer
   
 } 
 void DMA_UART_RX_Int_Handler()
@@ -187,9 +194,8 @@ void DMA_UART_RX_Int_Handler()
 	volatile unsigned char ucCOMSTA0 = 0;
    volatile unsigned char ucCOMIID0 = 0;
 
-  DmaSet(DMARMSKSET_UARTRX,DMAENSET_UARTRX,0,0);    // MASK UART DMA RX channel to prevent further interrupts triggering - unmask when ready to re-transmit 
 	ucCOMIID0 = UrtIntSta(pADI_UART);                 // Read UART Interrupt ID register 
-	 ucPacketRcvd = 1;                                // Flag to indicate packet received
+	UrtDmaRxIsr();                                    // Half of the ring full, re-arm it
 	 
   
 }
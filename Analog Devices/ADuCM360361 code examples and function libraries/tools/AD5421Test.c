@@ -0,0 +1,644 @@
+/**
+ *****************************************************************************
+   @file     AD5421Test.c
+   @brief    Host test of the queued AD5421 driver of examples/SPI/AD5421.c.
+   - Runs examples/SPI/AD5421.c unchanged against a model of SPI1 and of the AD5421.
+     SpiTx() and SpiRx() are stand-ins that fill the 4-byte Tx FIFO and empty the
+     Rx FIFO. One byte leaves per Clock(); in continuous mode CS goes high when the
+     Tx FIFO is empty, which ends the frame at the AD5421, and the Tx interrupt calls
+     AD5421_SpiIsr() unless SPI1_IRQn is masked. The AD5421 model runs each 24-bit
+     frame and clocks out the register read by the frame before.
+   - queue     Random AD5421_Send() frames with a sequence number, faster than the bus.
+               Every frame accepted without merge must reach the AD5421 once and in
+               order, merged DAC writes must arrive in order with the last one last,
+               and frames must only be refused when the queue is full.
+   - reads     AD5421_Read() of random registers between queued writes, with and
+               without other frames queued behind the read. AD5421_ReadDone() must
+               give the register value when the AD5421 ran the read, and a second
+               AD5421_Read() is refused until then.
+   - blocking  AD5421_ReadDAC() and the other blocking reads with the bus clocked
+               from a timer signal, as by the SPI1 interrupt on the device.
+   - faults    DAC writes, reads, control register changes, resets and AD5421_Monitor()
+               settings while the fault bits change. With automatic fault readback on,
+               the AD5421 model clocks its fault register out with every frame that
+               does not carry read data, and an ADC conversion sets its bits 7-0.
+               AD5421_Status() must match the readings the model sent, ADC code and
+               counters included, and conversions must follow every Nth DAC write.
+   - prof      Built with SPI_PROF defined, SpiProfTime(), SpiProfXferAdd() and
+               SpiProfWait() are stand-ins with a time that counts the bytes sent.
+               Each frame must be added once from AD5421_SpiIsr(), as 3 bytes of SPI1
+               from the time its first byte was queued, and each blocking read must
+               count two CPU waits.
+   Each frame must be 3 bytes long and no Rx FIFO overflow is allowed.
+   Prints one line per test and exits with 1 if any failed.
+
+   Build:  sed 's/<\.\.\\common\\SpiLib\.h>/"SpiLib.h"/' ../examples/SPI/AD5421.c > AD5421Host.c
+           gcc -O2 -Ihost -I../common -I../examples/SPI -o AD5421Test AD5421Test.c AD5421Host.c
+   Add -DSPI_PROF to the gcc line to check the profiling hooks too.
+   AD5421.c includes SpiLib.h with a Windows path, the sed line makes a copy gcc reads.
+
+   Usage:  AD5421Test [-n frames] [-s seed]
+   - -n : frames per test, default 100000.
+   - -s : seed of rand(), default 1.
+
+   @version  V0.1
+   @date     October 2026
+
+**/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <sys/time.h>
+#include "SpiLib.h"
+#include "AD5421.h"
+
+#define LOG		(1 << 16)			// frames kept, a power of 2
+
+static ADI_SPI_TypeDef Spi0, Spi1;
+static ADI_GPIO_TypeDef Gp0, Gp1, Gp2;
+ADI_SPI_TypeDef *pADI_SPI0 = &Spi0;
+ADI_SPI_TypeDef *pADI_SPI1 = &Spi1;
+ADI_GPIO_TypeDef *pADI_GP0 = &Gp0;
+ADI_GPIO_TypeDef *pADI_GP1 = &Gp1;
+ADI_GPIO_TypeDef *pADI_GP2 = &Gp2;
+
+static int iFailed = 0;
+
+// SPI1 model
+static unsigned char ucTxFifo[SPI_FIFO], ucRxFifo[SPI_FIFO];
+static int iTxNum = 0, iRxNum = 0;
+static int iSpiCon = 0;
+static volatile int iMasked = 0, iIrqPending = 0, iInIsr = 0;
+static unsigned long ulSpiErr = 0;		// FIFO misuse and frames that are not 3 bytes
+static volatile unsigned long ulTicks = 0;	// timer signals of the blocking test
+
+// AD5421 model
+static unsigned long ulReg[6];				// DAC, CON, OFFADJ, GNADJ, FAULT by command number
+static unsigned long ulFrame = 0;			// bits received in this frame
+static int iBits = 0;
+static unsigned long ulOut = 0;				// word clocked out during this frame
+static int iReadNext = 0;					// register to clock out with the next frame, 0 none
+static unsigned long ulLog[LOG];			// frames run, in order
+static unsigned long ulLogNum = 0;
+static unsigned long ulReadVal = 0;			// value clocked out for the last read
+static unsigned int uiAdcSeq = 0;			// conversions run, gives the next ADC code
+static unsigned long ulInitAdc = 0;			// INITADC frames run
+static AD5421_STA Exp;						// status the driver should report
+#ifdef SPI_PROF
+static unsigned short usTime = 0;			// bytes sent, the profiling time
+static unsigned short usFrameStart = 0;		// usTime when the first byte of the frame was queued
+static unsigned long ulProfFrames = 0, ulProfXfers = 0, ulProfBad = 0;
+static unsigned long ulProfWaits = 0, ulProfWaitTicks = 0, ulBlockingReads = 0;
+#endif
+
+// Registers by command: WRITEDAC 1 to WRITEGNADJ 4, READFAULT reads ulReg[5]
+static void Ad5421Frame(unsigned long ulCmd)
+{
+	int iCmd = (int)(ulCmd >> 16);
+
+	ulLog[ulLogNum++ & (LOG-1)] = ulCmd;
+	if ((iCmd >= WRITEDAC) && (iCmd <= WRITEGNADJ))
+		ulReg[iCmd] = ulCmd & 0xFFFF;
+	else if (iCmd == AD5421RESET)
+	{
+		ulReg[WRITEDAC] = 0;
+		ulReg[WRITECON] = AD5421_CON_NOAUTOFLT;
+		ulReg[WRITEOFFADJ] = 0x8000;
+		ulReg[WRITEGNADJ] = 0xFFFF;
+	}
+	if ((iCmd >= READDAC) && (iCmd <= READFAULT))
+		iReadNext = iCmd - READDAC + 1;
+	if (iCmd == WRITEDAC)
+		Exp.ulWrites++;
+	if ((iCmd == INITADC) && (ulReg[WRITECON] & AD5421_CON_ADCON))
+	{
+		// Vloop or die temperature code in bits 7-0 of the fault register
+		uiAdcSeq++;
+		ulReg[5] = (ulReg[5] & AD5421_FLT_MSK) |
+				   ((uiAdcSeq*37 + ((ulReg[WRITECON] & AD5421_CON_ADCTEMP) ? 0x80 : 0)) & 0xFF);
+		ulInitAdc++;
+	}
+}
+
+// Fault register clocked out, by a READFAULT read or the automatic readback
+static void Ad5421Fault(void)
+{
+	Exp.ulFault = ulReg[5];
+	Exp.ulFaultSeen |= ulReg[5] & AD5421_FLT_MSK;
+	Exp.ucAdc = (unsigned char)ulReg[5];
+	Exp.ulReads++;
+	if (ulReg[5] & AD5421_FLT_MSK)
+		Exp.ulFaultReads++;
+}
+
+// One byte time of the bus
+static void Clock(void)
+{
+	int iMiso;
+
+	if (iTxNum == 0)
+		return;
+	if (iBits == 0)
+	{
+		ulOut = 0;
+		if (iReadNext)
+		{
+			ulOut = ulReg[iReadNext];
+			ulReadVal = ulOut;
+			if (iReadNext == 5)
+				Ad5421Fault();
+			iReadNext = 0;
+		}
+		else if (!(ulReg[WRITECON] & AD5421_CON_NOAUTOFLT))
+		{
+			ulOut = ulReg[5];
+			Ad5421Fault();
+		}
+	}
+	iMiso = (int)(ulOut >> (16 - iBits)) & 0xFF;
+#ifdef SPI_PROF
+	usTime++;
+#endif
+	ulFrame = (ulFrame << 8) | ucTxFifo[0];
+	iBits += 8;
+	memmove(ucTxFifo, ucTxFifo + 1, --iTxNum);
+	if (iRxNum < SPI_FIFO)
+		ucRxFifo[iRxNum++] = (unsigned char)iMiso;
+	else
+		ulSpiErr++;
+	if (iTxNum)
+		return;
+	// Tx FIFO empty: CS goes high and the frame ends
+	if (iBits != 24)
+		ulSpiErr++;
+	else
+		Ad5421Frame(ulFrame & 0xFFFFFF);
+#ifdef SPI_PROF
+	ulProfFrames++;
+#endif
+	iBits = 0;
+	ulFrame = 0;
+	iIrqPending = 1;
+	if (!iMasked)
+	{
+		iIrqPending = 0;
+		iInIsr = 1;
+		AD5421_SpiIsr();
+		iInIsr = 0;
+	}
+}
+
+int SpiCfg(ADI_SPI_TypeDef *pSPI, int iFifoSize, int iMasterEn, int iConfig)
+{
+	iSpiCon = iFifoSize | iMasterEn | iConfig;
+	pSPI->SPICON = (uint16_t)iSpiCon;
+	return 1;
+}
+
+long SpiBaudHz(ADI_SPI_TypeDef *pSPI, long lHz, int iCserr)
+{
+	(void)pSPI;
+	(void)iCserr;
+	return (lHz > 8000000) ? 8000000 : lHz;
+}
+
+int SpiFifoFlush(ADI_SPI_TypeDef *pSPI, int iTxFlush, int iRxFlush)
+{
+	(void)pSPI;
+	if (iTxFlush)
+		iTxNum = 0;
+	if (iRxFlush)
+		iRxNum = 0;
+	return 1;
+}
+
+int SpiTx(ADI_SPI_TypeDef *pSPI, int iTx)
+{
+	// the FIFO is filled from the interrupt or with it masked
+	if ((pSPI != pADI_SPI1) || (iTxNum == SPI_FIFO) || (!iMasked && !iInIsr))
+	{
+		ulSpiErr++;
+		return 0;
+	}
+#ifdef SPI_PROF
+	if ((iTxNum == 0) && (iBits == 0))
+		usFrameStart = usTime;
+#endif
+	ucTxFifo[iTxNum++] = (unsigned char)iTx;
+	return 1;
+}
+
+int SpiRx(ADI_SPI_TypeDef *pSPI)
+{
+	int iRx;
+
+	if ((pSPI != pADI_SPI1) || (iRxNum == 0))
+	{
+		ulSpiErr++;
+		return 0;
+	}
+	iRx = ucRxFifo[0];
+	memmove(ucRxFifo, ucRxFifo + 1, --iRxNum);
+	return iRx;
+}
+
+// SPI1_IRQn masking. With the timer signal of the blocking test, masking blocks it.
+void NVIC_DisableIRQ(IRQn_Type IRQn)
+{
+	sigset_t Set;
+
+	if (IRQn != SPI1_IRQn)
+		return;
+	sigemptyset(&Set);
+	sigaddset(&Set, SIGALRM);
+	sigprocmask(SIG_BLOCK, &Set, 0);
+	iMasked = 1;
+}
+
+void NVIC_EnableIRQ(IRQn_Type IRQn)
+{
+	sigset_t Set;
+
+	if (IRQn != SPI1_IRQn)
+		return;
+	iMasked = 0;
+	if (iIrqPending)
+	{
+		iIrqPending = 0;
+		iInIsr = 1;
+		AD5421_SpiIsr();
+		iInIsr = 0;
+	}
+	sigemptyset(&Set);
+	sigaddset(&Set, SIGALRM);
+	sigprocmask(SIG_UNBLOCK, &Set, 0);
+}
+
+#ifdef SPI_PROF
+unsigned short SpiProfTime(void)
+{
+	return usTime;
+}
+
+// Frames end in AD5421_SpiIsr(), 3 bytes of SPI1 from when the first one was queued
+int SpiProfXferAdd(ADI_SPI_TypeDef *pSPI, unsigned short usStart, int iBytes)
+{
+	if ((pSPI != pADI_SPI1) || (iBytes != 3) || (usStart != usFrameStart) || !iInIsr)
+		ulProfBad++;
+	ulProfXfers++;
+	return 1;
+}
+
+int SpiProfWait(ADI_SPI_TypeDef *pSPI, unsigned short usStart)
+{
+	if ((pSPI != pADI_SPI1) || iInIsr)
+		ulProfBad++;
+	ulProfWaits++;
+	ulProfWaitTicks += (unsigned short)(usTime - usStart);
+	return 1;
+}
+#endif
+
+static void Result(const char *szTest, unsigned long ulRun, unsigned long ulBad, const char *szMore)
+{
+	printf("%-9s %8lu run, %6lu failed%s\n", szTest, ulRun, ulBad, szMore);
+	if (ulBad)
+		iFailed = 1;
+}
+
+static void Init(void)
+{
+	ulReg[WRITEDAC] = 0;
+	ulReg[WRITECON] = AD5421_CON_NOAUTOFLT;
+	ulReg[WRITEOFFADJ] = 0x8000;
+	ulReg[WRITEGNADJ] = 0xFFFF;
+	ulReg[5] = 0;
+	iTxNum = iRxNum = 0;
+	iBits = 0;
+	iReadNext = 0;
+	iSpiCon = 0;
+	memset(&Exp, 0, sizeof(Exp));
+	AD5421INIT();
+	if ((iSpiCon & (SPICON_MOD_MSK|SPICON_CON_EN|SPICON_MASEN_EN|SPICON_ENABLE_EN)) !=
+		(SPICON_MOD_TX3RX3|SPICON_CON_EN|SPICON_MASEN_EN|SPICON_ENABLE_EN))
+		ulSpiErr++;
+}
+
+static void Drain(void)
+{
+	int i;
+
+	for (i = 0; (i < 1000) && AD5421_Busy(); i++)
+		Clock();
+}
+
+// Frame being sent, 0 if none
+static unsigned long InFlight(void)
+{
+	unsigned long ulCmd = ulFrame;
+	int i;
+
+	if ((iBits == 0) && (iTxNum == 0))
+		return 0;
+	for (i = 0; i < iTxNum; i++)
+		ulCmd = (ulCmd << 8) | ucTxFifo[i];
+	return ulCmd & 0xFFFFFF;
+}
+
+static void Queue(int iN)
+{
+	static unsigned long ulSent[LOG];			// frames accepted without merge, in order
+	unsigned long ulNumSent = 0, ulDacSent = 0, ulDacLast = 0, ulRefused = 0;
+	unsigned long ulBad = 0, ulLog0, ulRun = 0, ulDacRun = 0, ulDacPrev = 0, k;
+	char szMore[80];
+
+	Init();
+	ulLog0 = ulLogNum;
+	for (k = 1; k <= (unsigned long)iN; k++)
+	{
+		int iMerge = rand() % 3 == 0;
+		unsigned long ulCmd = ((unsigned long)(iMerge ? WRITEDAC : WRITEOFFADJ) << 16) | (k & 0xFFFF);
+		unsigned long ulFly = InFlight();
+		int i, iHeld, iDacWaiting;
+
+		// frames held by the driver: those without merge not run yet, the DAC write in
+		// flight and the one waiting, if any
+		for (; ulLog0 + ulRun + ulDacRun < ulLogNum; )
+		{
+			unsigned long ulDone = ulLog[(ulLog0 + ulRun + ulDacRun) & (LOG-1)];
+
+			if ((ulDone >> 16) == WRITEDAC)
+			{
+				// merged DAC writes arrive in order, sequence numbers wrap at 2^16
+				if (((ulDone - ulDacPrev) & 0xFFFF) - 1 >= 0x7FFF)
+					ulBad++;
+				ulDacPrev = ulDone & 0xFFFF;
+				ulDacRun++;
+				continue;
+			}
+			if ((ulRun >= ulNumSent) || (ulDone != ulSent[ulRun & (LOG-1)]))
+				ulBad++;
+			ulRun++;
+		}
+		iDacWaiting = ulDacLast && (ulDacLast != ulFly) && ((ulDacLast & 0xFFFF) != ulDacPrev);
+		iHeld = (int)(ulNumSent - ulRun) + ((ulFly >> 16) == WRITEDAC) + iDacWaiting;
+		if (iHeld > AD5421_QUEUE + 1)
+			ulBad++;
+		if (AD5421_Send(ulCmd, iMerge))
+		{
+			if (iMerge)
+			{
+				ulDacLast = ulCmd;
+				ulDacSent++;
+			}
+			else
+				ulSent[ulNumSent++ & (LOG-1)] = ulCmd;
+		}
+		else if ((iHeld < AD5421_QUEUE + 1) || (iMerge && iDacWaiting))	// refused with room left
+			ulBad++;
+		else
+			ulRefused++;
+		// about one frame on the bus for every two sent, so the queue fills up
+		for (i = rand() % 4; i > 0; i--)
+			Clock();
+	}
+	Drain();
+	for (k = ulLog0 + ulRun + ulDacRun; k < ulLogNum; k++)
+	{
+		unsigned long ulDone = ulLog[k & (LOG-1)];
+
+		if ((ulDone >> 16) == WRITEDAC)
+		{
+			if (((ulDone - ulDacPrev) & 0xFFFF) - 1 >= 0x7FFF)
+				ulBad++;
+			ulDacPrev = ulDone & 0xFFFF;
+			ulDacRun++;
+			continue;
+		}
+		if ((ulRun >= ulNumSent) || (ulDone != ulSent[ulRun & (LOG-1)]))
+			ulBad++;
+		ulRun++;
+	}
+	// every frame without merge once, the last DAC write last, some merged and refused
+	if ((ulRun != ulNumSent) || (ulDacPrev != (ulDacLast & 0xFFFF)) || (ulReg[WRITEDAC] != (ulDacLast & 0xFFFF)) ||
+		(ulDacRun == ulDacSent) || (ulRefused == 0) || ulSpiErr)
+		ulBad++;
+	sprintf(szMore, ", %lu frames, %lu DAC writes merged, %lu refused", ulLogNum - ulLog0,
+			ulDacSent - ulDacRun, ulRefused);
+	Result("queue", (unsigned long)iN, ulBad, szMore);
+}
+
+static void Reads(int iN)
+{
+	unsigned long ulBad = 0, ulReads = 0, ulNops = 0, ulLog0;
+	char szMore[80];
+	int k;
+
+	Init();
+	ulLog0 = ulLogNum;
+	for (k = 0; k < iN; k++)
+	{
+		unsigned long ulCmd = READDAC + rand() % 5, ulData = 0, ulLogRead;
+		int i;
+
+		ulReg[5] = (unsigned long)rand() & 0xFFFF;
+		for (i = rand() % 3; i > 0; i--)
+			AD5421_Send(((unsigned long)(WRITEDAC + rand() % 4) << 16) | ((unsigned long)rand() & 0xFFFF), 0);
+		if (!AD5421_Read(ulCmd))
+		{
+			ulBad++;
+			continue;
+		}
+		ulLogRead = ulLogNum;
+		for (i = rand() % 3; i > 0; i--)
+			AD5421_Send(((unsigned long)(WRITEDAC + rand() % 4) << 16) | ((unsigned long)rand() & 0xFFFF), 0);
+		for (i = 0; (i < 200) && !AD5421_ReadDone(&ulData); i++)
+		{
+			if (AD5421_Read(READDAC))			// still running
+				ulBad++;
+			Clock();
+		}
+		// the read ran, the value comes from the registers at that time
+		for (; (ulLogRead < ulLogNum) && ((ulLog[ulLogRead & (LOG-1)] >> 16) != ulCmd); ulLogRead++)
+			;
+		if ((i == 200) || (ulLogRead == ulLogNum) || (ulData != ulReadVal))
+			ulBad++;
+		ulReads++;
+		Drain();
+	}
+	for (; ulLog0 < ulLogNum; ulLog0++)
+		if ((ulLog[ulLog0 & (LOG-1)] >> 16) == AD5421NOP)
+			ulNops++;
+	if (ulSpiErr || (ulNops == 0))
+		ulBad++;
+	sprintf(szMore, ", %lu NOP frames", ulNops);
+	Result("reads", ulReads, ulBad, szMore);
+}
+
+static void Tick(int iSig)
+{
+	(void)iSig;
+	if (!iMasked)
+		Clock();
+	if (++ulTicks > 1000000)
+	{
+		printf("blocking read does not end\n");
+		exit(1);
+	}
+}
+
+static void Blocking(int iN)
+{
+	static const int iCmds[5] = {READDAC, READCON, READOFFADJ, READGNADJ, READFAULT};
+	struct itimerval Tv;
+	unsigned long ulBad = 0, ulData, ulExp;
+	int k;
+
+	Init();
+	signal(SIGALRM, Tick);
+	memset(&Tv, 0, sizeof(Tv));
+	Tv.it_interval.tv_usec = Tv.it_value.tv_usec = 20;
+	setitimer(ITIMER_REAL, &Tv, 0);
+	for (k = 0; k < iN; k++)
+	{
+		int iCmd = iCmds[rand() % 5];
+
+		ulTicks = 0;
+#ifdef SPI_PROF
+		ulBlockingReads++;
+#endif
+		AD5421_WriteToDAC((unsigned long)rand() & 0xFFFF);
+		AD5421_WriteToGnAdj((unsigned long)rand() & 0xFFFF);
+		NVIC_DisableIRQ(SPI1_IRQn);
+		ulReg[5] = (unsigned long)rand() & 0xFFFF;
+		NVIC_EnableIRQ(SPI1_IRQn);
+		switch (iCmd)
+		{
+		case READDAC:		ulData = AD5421_ReadDAC(0);		break;
+		case READCON:		ulData = AD5421_ReadCon(0);		break;
+		case READOFFADJ:	ulData = AD5421_ReadOffAdj(0);	break;
+		case READGNADJ:		ulData = AD5421_ReadGnAdj(0);	break;
+		default:			ulData = AD5421_ReadFault(0);	break;
+		}
+		// reads run after the writes queued before them
+		NVIC_DisableIRQ(SPI1_IRQn);
+		ulExp = ulReg[iCmd - READDAC + 1];
+		NVIC_EnableIRQ(SPI1_IRQn);
+		if (ulData != ulExp)
+			ulBad++;
+	}
+	memset(&Tv, 0, sizeof(Tv));
+	setitimer(ITIMER_REAL, &Tv, 0);
+	signal(SIGALRM, SIG_DFL);
+	if (ulSpiErr)
+		ulBad++;
+	Result("blocking", (unsigned long)iN, ulBad, "");
+}
+
+static void Faults(int iN)
+{
+	static const unsigned long ulFlt[8] = {AD5421_FLT_SPI, AD5421_FLT_PEC, AD5421_FLT_IOVER, AD5421_FLT_IUNDER,
+										   AD5421_FLT_T140, AD5421_FLT_T100, AD5421_FLT_V6, AD5421_FLT_V12};
+	unsigned long ulBad = 0, ulSeen, ulAdc = 0, ulRun = 0;
+	int iEvery = 0, iCount = 0;
+	AD5421_STA Sta;
+	char szMore[100];
+	int k;
+
+	Init();
+	AD5421_Monitor(0);
+	AD5421_WriteToCon(AD5421_CON_NOWDT|AD5421_CON_ADCON);
+	for (k = 0; k < iN; k++)
+	{
+		unsigned long ulAdc0 = ulInitAdc, ulData;
+		int iAdc = 0, i;
+
+		if (rand() % 20 == 0)
+		{
+			iEvery = rand() % 5;
+			iCount = 0;
+			AD5421_Monitor(iEvery);
+		}
+		switch (rand() % 30)
+		{
+		case 0:
+			AD5421_Reset();
+			Drain();
+			// fall through
+		case 1:
+		case 2:
+			AD5421_WriteToCon(AD5421_CON_NOWDT|AD5421_CON_ADCON|((rand() & 1) ? AD5421_CON_ADCTEMP : 0)|
+							  ((rand() % 4) ? 0 : AD5421_CON_NOAUTOFLT));
+			break;
+		case 3:
+			AD5421_Read(READFAULT);
+			break;
+		case 4:
+			AD5421_Read(READCON);
+			break;
+		}
+		for (i = rand() % 6; i > 0; i--)
+		{
+			AD5421_WriteToDAC((unsigned long)rand() & 0xFFFF);
+			if (iEvery && (++iCount >= iEvery))
+			{
+				iCount = 0;
+				iAdc++;
+			}
+			if (rand() % 4 == 0)
+				ulReg[5] ^= ulFlt[rand() % 8];
+			else if (rand() % 8 == 0)
+				ulReg[5] &= ~AD5421_FLT_MSK;		// faults gone
+			Clock();
+		}
+		Drain();
+		AD5421_ReadDone(&ulData);
+		// each conversion asked for runs, merged ones once
+		if (((ulInitAdc - ulAdc0 == 0) && iAdc && (ulReg[WRITECON] & AD5421_CON_ADCON)) || (ulInitAdc - ulAdc0 > (unsigned long)iAdc))
+			ulBad++;
+		ulAdc += iAdc;
+		ulSeen = AD5421_Status(&Sta);
+		if ((ulSeen != Exp.ulFaultSeen) || (Sta.ulFaultSeen != Exp.ulFaultSeen) || (Sta.ulFault != Exp.ulFault) ||
+			(Sta.ucAdc != Exp.ucAdc) || (Sta.ulReads != Exp.ulReads) || (Sta.ulFaultReads != Exp.ulFaultReads) ||
+			(Sta.ulWrites != Exp.ulWrites))
+			ulBad++;
+		Exp.ulFaultSeen = 0;
+		ulRun++;
+	}
+	if (ulSpiErr || (Exp.ulReads == 0) || (Exp.ulFaultReads == 0) || (ulInitAdc == 0))
+		ulBad++;
+	sprintf(szMore, ", %lu fault readings, %lu with faults, %lu conversions of %lu asked",
+			Exp.ulReads, Exp.ulFaultReads, ulInitAdc, ulAdc);
+	Result("faults", ulRun, ulBad, szMore);
+}
+
+int main(int argc, char *argv[])
+{
+	int iN = 100000;
+	int i;
+
+	for (i = 1; i + 1 < argc; i += 2)
+	{
+		if (!strcmp(argv[i], "-n"))
+			iN = atoi(argv[i+1]);
+		else if (!strcmp(argv[i], "-s"))
+			srand(atoi(argv[i+1]));
+	}
+	Queue(iN);
+	Reads(iN/10);
+	Blocking(iN/100);
+	Faults(iN/10);
+#ifdef SPI_PROF
+	{
+		char szMore[80];
+
+		// a blocking read waits for its frame and the one that clocks the data out
+		sprintf(szMore, ", %lu frames, %lu waits of %lu byte times", ulProfXfers, ulProfWaits, ulProfWaitTicks);
+		Result("prof", ulProfXfers, ulProfBad + (ulProfXfers != ulProfFrames) + (ulProfWaits != 2*ulBlockingReads) +
+			   (ulProfWaitTicks < 6*ulBlockingReads), szMore);
+	}
+#endif
+	return iFailed;
+}
@@ -0,0 +1,217 @@
+/**
+ *****************************************************************************
+   @file     CmdTest.c
+   @brief    Host test of the text command interpreter of common/CmdLib.c.
+   - Runs common/CmdLib.c, common/FmtLib.c and common/UrtLib.c unchanged. The lines
+     are fed byte by byte to CmdRxIsr(), CmdPoll() runs them and its answers are
+     read from the UrtWrite() queue through UrtWriteIsr().
+   - lines   Fixed lines: the list, reads, settings in range and out of range,
+             decimal and hexadecimal values, case, spaces, backspace, empty lines,
+             lines of CMD_LINE_MAX characters and longer, bad values, unknown
+             names, actions, and bytes received before CmdPoll() ran the last line.
+             Each must give its answer, return value and variables.
+   - random  Random settings and reads, checked against strtol() and the ranges.
+   Prints one line per test and exits with 1 if any failed.
+
+   Build:  gcc -O2 -Ihost -o CmdTest CmdTest.c ../common/CmdLib.c ../common/FmtLib.c ../common/UrtLib.c
+
+   Usage:  CmdTest [-n lines] [-s seed]
+   - -n : random lines, default 100000.
+   - -s : seed of rand(), default 1.
+
+   @version  V0.1
+   @date     October 2026
+
+**/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../common/CmdLib.h"
+#include "../common/UrtLib.h"
+
+static ADI_UART_TypeDef Uart;
+ADI_UART_TypeDef *pADI_UART = &Uart;
+
+static long lSamples, lSf, lOffs;
+static const CmdMap Map[4] =
+{
+	{"SAMPLES",	&lSamples,	1,		16},
+	{"SF",		&lSf,		0,		127},
+	{"OFFS",	&lOffs,		-1000,	1000},
+	{"SAVE",	0,			0,		0},
+};
+
+static int iFailed = 0;
+
+// UrtBaud() reads the UART clock, not used here
+long ClkFreq(int iClk)
+{
+	(void)iClk;
+	return 16000000;
+}
+
+static void Result(const char *szTest, unsigned long ulRun, unsigned long ulBad)
+{
+	printf("%-8s %8lu run, %6lu failed\n", szTest, ulRun, ulBad);
+	if (ulBad)
+		iFailed = 1;
+}
+
+// Feed a line to CmdRxIsr() and run it. Returns what CmdPoll() returned, the answer in szOut.
+static int Run(const char *szIn, char *szOut)
+{
+	int iRet, iLen = 0;
+
+	for (; *szIn; szIn++)
+		CmdRxIsr((unsigned char)*szIn);
+	iRet = CmdPoll();
+	Uart.COMLSR = COMLSR_THRE|COMLSR_TEMT;		// each byte leaves at once
+	while (Uart.COMIEN & COMIEN_ETBEI)
+		if (UrtWriteIsr(pADI_UART))
+			szOut[iLen++] = (char)Uart.COMTX;
+	szOut[iLen] = 0;
+	return iRet;
+}
+
+typedef struct
+{
+	const char *szIn;
+	const char *szOut;
+	int iRet;
+	long lSamples, lSf, lOffs;		// variables after the line
+} Line;
+
+static const Line Lines[] =
+{
+	{"?\r",							"SAMPLES=5 1..16\r\nSF=124 0..127\r\nOFFS=0 -1000..1000\r\nSAVE\r\n", 0, 5, 124, 0},
+	{"samples 8\r",					"OK\r\n",			1, 8, 124, 0},
+	{"SAMPLES\n",					"SAMPLES=8\r\n",	0, 8, 124, 0},
+	{"SAMPLES 8\r",					"OK\r\n",			1, 8, 124, 0},
+	{"Samples 0\r",					"ERR\r\n",			0, 8, 124, 0},
+	{"samples 17\r",				"ERR\r\n",			0, 8, 124, 0},
+	{"sf 0x7f\r",					"OK\r\n",			2, 8, 127, 0},
+	{"SF 128\r",					"ERR\r\n",			0, 8, 127, 0},
+	{"sf 0X1A\r",					"OK\r\n",			2, 8, 26, 0},
+	{"offs -1000\r",				"OK\r\n",			3, 8, 26, -1000},
+	{"offs -1001\r",				"ERR\r\n",			0, 8, 26, -1000},
+	{"offs -0x10\r",				"OK\r\n",			3, 8, 26, -16},
+	{"  offs   7  \r",				"OK\r\n",			3, 8, 26, 7},
+	{"offs 0x\r",					"ERR\r\n",			0, 8, 26, 7},
+	{"offs -\r",					"ERR\r\n",			0, 8, 26, 7},
+	{"offs 12a\r",					"ERR\r\n",			0, 8, 26, 7},
+	{"offs 0xg\r",					"ERR\r\n",			0, 8, 26, 7},
+	{"offs 1 2\r",					"ERR\r\n",			0, 8, 26, 7},
+	{"offs 2147483647\r",			"ERR\r\n",			0, 8, 26, 7},
+	{"offs 2147483648\r",			"ERR\r\n",			0, 8, 26, 7},
+	{"offs 99999999999\r",			"ERR\r\n",			0, 8, 26, 7},
+	{"offs 0x100000000\r",			"ERR\r\n",			0, 8, 26, 7},
+	{"OFFS-3\r",					"ERR\r\n",			0, 8, 26, 7},
+	{"OFFS\r",						"OFFS=7\r\n",		0, 8, 26, 7},
+	{"save\r\n",					"OK\r\n",			4, 8, 26, 7},
+	{"save 3\r",					"ERR\r\n",			0, 8, 26, 7},
+	{"sav\r",						"ERR\r\n",			0, 8, 26, 7},
+	{"saves\r",						"ERR\r\n",			0, 8, 26, 7},
+	{"bogus\r",						"ERR\r\n",			0, 8, 26, 7},
+	{"sax\bve\r",					"OK\r\n",			4, 8, 26, 7},
+	{"x\x7f\x7f\x7fsave\r",			"OK\r\n",			4, 8, 26, 7},
+	{"\r\n\r",						"",					0, 8, 26, 7},
+	{"\b\r",						"",					0, 8, 26, 7},
+	// CMD_LINE_MAX characters, then one more
+	{"OFFS 5                          \r",	"OK\r\n",	3, 8, 26, 5},
+	{"OFFS 6                           \r",	"",			0, 8, 26, 5},
+	{"OFFS 6                           \b\r",	"",		0, 8, 26, 5},
+	{"OFFS 6\r",					"OK\r\n",			3, 8, 26, 6},
+	// bytes received while the line waits for CmdPoll() are ignored
+	{"save\rsf 1\r",				"OK\r\n",			4, 8, 26, 6},
+	{"",							"",					0, 8, 26, 6},
+	{"sf\r",						"SF=26\r\n",		0, 8, 26, 6},
+};
+
+static void Fixed(void)
+{
+	char szOut[URT_TX_SIZE+1];
+	unsigned long ulBad = 0;
+	unsigned int k;
+
+	lSamples = 5;
+	lSf = 124;
+	lOffs = 0;
+	CmdCfg(pADI_UART, Map, 4);
+	for (k = 0; k < sizeof(Lines)/sizeof(Lines[0]); k++)
+	{
+		const Line *pL = &Lines[k];
+		int iRet = Run(pL->szIn, szOut);
+
+		if ((iRet != pL->iRet) || strcmp(szOut, pL->szOut) || (lSamples != pL->lSamples) ||
+			(lSf != pL->lSf) || (lOffs != pL->lOffs))
+		{
+			printf("line %u: got %d \"%s\" %ld %ld %ld\n", k, iRet, szOut, lSamples, lSf, lOffs);
+			ulBad++;
+		}
+	}
+	Result("lines", k, ulBad);
+}
+
+static void Random(int iN)
+{
+	char szIn[80], szOut[URT_TX_SIZE+1], szExp[40];
+	unsigned long ulBad = 0;
+	int k, i;
+
+	CmdCfg(pADI_UART, Map, 4);
+	for (k = 0; k < iN; k++)
+	{
+		int iCmd = rand() % 3;
+		const CmdMap *pCmd = &Map[iCmd];
+		long lOld = *pCmd->plVal, lVal, lExp;
+		int iLen = 0, iRet, iOk;
+
+		for (i = 0; pCmd->szName[i]; i++)
+			szIn[iLen++] = (rand() & 1) ? pCmd->szName[i] : (char)(pCmd->szName[i] | 0x20);
+		if (rand() % 5 == 0)
+		{
+			// read
+			szIn[iLen++] = '\r';
+			szIn[iLen] = 0;
+			iRet = Run(szIn, szOut);
+			sprintf(szExp, "%s=%ld\r\n", pCmd->szName, lOld);
+			if ((iRet != 0) || strcmp(szOut, szExp))
+				ulBad++;
+			continue;
+		}
+		lVal = pCmd->lMin - 50 + rand() % (pCmd->lMax - pCmd->lMin + 101);
+		if (rand() % 20 == 0)
+			lVal = (long)rand() * ((rand() & 1) ? 1 : -1);
+		iLen += sprintf(szIn + iLen, "%.*s", 1 + rand() % 3, "   ");
+		if (rand() & 1)
+			iLen += sprintf(szIn + iLen, (rand() & 1) ? "%s0x%lx" : "%s0X%lX", (lVal < 0) ? "-" : "", labs(lVal));
+		else
+			iLen += sprintf(szIn + iLen, "%ld", lVal);
+		iLen += sprintf(szIn + iLen, "%.*s\r", rand() % 3, "  ");
+		lExp = strtol(strchr(szIn, ' '), 0, 0);
+		iOk = (lExp == lVal) && (lVal >= pCmd->lMin) && (lVal <= pCmd->lMax);
+		iRet = Run(szIn, szOut);
+		if (strcmp(szOut, iOk ? "OK\r\n" : "ERR\r\n") || (iRet != (iOk ? iCmd + 1 : 0)) ||
+			(*pCmd->plVal != (iOk ? lVal : lOld)))
+			ulBad++;
+	}
+	Result("random", iN, ulBad);
+}
+
+int main(int argc, char *argv[])
+{
+	int iN = 100000;
+	int i;
+
+	for (i = 1; i + 1 < argc; i += 2)
+	{
+		if (!strcmp(argv[i], "-n"))
+			iN = atoi(argv[i+1]);
+		else if (!strcmp(argv[i], "-s"))
+			srand(atoi(argv[i+1]));
+	}
+	Fixed();
+	Random(iN);
+	return iFailed;
+}
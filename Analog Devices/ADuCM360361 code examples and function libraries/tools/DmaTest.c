@@ -0,0 +1,639 @@
+/**
+ *****************************************************************************
+   @file     DmaTest.c
+   @brief    Host test of the UART and SPI1 DMA receive rings of common/DmaLib.c.
+   - Runs common/DmaLib.c unchanged against a model of the DMA controller: each UART
+     receive request moves COMRX to the active UARTRX_C structure found through
+     DMAPDBPTR, counts n_minus_1 down and, at the end of a structure, stops it,
+     switches to the other one and raises the DMA interrupt. A request that finds
+     the active structure stopped ends the channel, like the controller does.
+   - Time runs in character slots. The line sends frames of 1 to 100 bytes with gaps
+     inside a frame shorter than the idle period and at least two periods between
+     frames. The timer calls UrtDmaRxTmrIsr() every period and the DMA interrupt is
+     served after a random delay.
+   - The application reads the frames at random times with UrtDmaRxSpan() and
+     UrtDmaRxDone(), without letting the ring overflow. Every frame must come back
+     whole, in order, with its end where it was sent.
+   - config  The idle timer load over the whole iIdle range, up to 1s, and the
+             channel set up by UrtDmaRxCfg().
+   - Then checks the overrun cases: an application that stops reading, and a span
+     overwritten while it is used. The frames that follow must come back intact.
+   - The SPI1 slave ring runs the same way, one byte per slot into SPI1RX_C, with
+     fixed frames and with frames ended by SpiDmaRxCsIsr() on the CS edge:
+     - spifixed  Fixed frames of random lengths up to half the ring.
+     - spics     CS frames of 1 byte up to the whole ring. Every span must start where
+                 the last one ended, end at the frame end or the end of the ring, and
+                 hold the bytes sent, and SpiDmaRxSpan() must give every complete frame.
+     - spijoin   CS edges while SPI_DMA_RX_FRAMES frames wait are refused, and those
+                 bytes come back joined to the next frame.
+     - spiovr    Overruns in both modes, a span overwritten while used and a CS frame
+                 longer than the ring. Each must be counted once, however often the
+                 application polls, and the frames after it must come back intact.
+   Prints one line per test and exits with 1 if any failed.
+
+   Build:  gcc -O2 -no-pie -Wno-pointer-to-int-cast -Ihost -o DmaTest DmaTest.c ../common/DmaLib.c
+
+   Usage:  DmaTest [-n frames] [-s seed]
+   - -n : frames of the random run, default 20000.
+   - -s : seed of rand(), default 1.
+
+   @version  V0.1
+   @date     October 2026
+
+**/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "../common/DmaLib.h"
+
+#define FRAME_MAX	100
+#define FRAMES		32					// frames the test keeps until they are read, a power of 2
+#define PERIOD		4					// idle period in character slots
+#define DMA_LATE	40					// longest delay of the DMA interrupt in slots
+#define HALF		(URT_DMA_RX_SIZE/2)
+#define SPI_HALF	(SPI_DMA_RX_SIZE/2)
+#define SPI_LOG		4096				// SPI1 bytes kept, a power of 2 above SPI_DMA_RX_SIZE
+
+static ADI_UART_TypeDef Uart;
+static ADI_TIMER_TypeDef Tm0, Tm1;
+static ADI_SPI_TypeDef Spi1;
+static ADI_DMA_TypeDef Dma;
+static ADI_I2C_TypeDef I2c;
+static ADI_DAC_TypeDef Dac;
+static ADI_ADC_TypeDef Adc0, Adc1;
+static ADI_ADCSTEP_TypeDef AdcStep;
+ADI_UART_TypeDef *pADI_UART = &Uart;
+ADI_TIMER_TypeDef *pADI_TM0 = &Tm0;
+ADI_TIMER_TypeDef *pADI_TM1 = &Tm1;
+ADI_SPI_TypeDef *pADI_SPI1 = &Spi1;
+ADI_DMA_TypeDef *pADI_DMA = &Dma;
+ADI_I2C_TypeDef *pADI_I2C = &I2c;
+ADI_DAC_TypeDef *pADI_DAC = &Dac;
+ADI_ADC_TypeDef *pADI_ADC0 = &Adc0;
+ADI_ADC_TypeDef *pADI_ADC1 = &Adc1;
+ADI_ADCSTEP_TypeDef *pADI_ADCSTEP = &AdcStep;
+
+static int iFailed = 0;
+
+// Frames sent and not read yet
+static unsigned char ucFrm[FRAMES][FRAME_MAX];
+static int iFrmLen[FRAMES];
+static unsigned int uiFrmIn = 0, uiFrmOut = 0;
+static int iFrmOff = 0;					// bytes of the oldest frame already read
+static unsigned long ulSent = 0, ulRead = 0, ulLost = 0, ulBad = 0;
+
+// Model state
+static long lSlot = 0;
+static long lDmaDue = -1;				// slot of the pending DMA interrupt, -1 if none
+static int iDmaPend = 0;
+static unsigned long ulDmaInt = 0, ulTmrInt = 0;
+
+// SPI1 ring: bytes received and read since SpiDmaRxCfg(), and the CS frame ends not read
+static unsigned char ucSpiLog[SPI_LOG];
+static unsigned long ulSpiIn = 0, ulSpiOut = 0, ulSpiLast = 0;
+static unsigned long ulSpiEnd[SPI_DMA_RX_FRAMES];
+static unsigned int uiSpiHead = 0, uiSpiTail = 0;
+static int iSpiFrame = 0;
+static unsigned char *pSpiRing = 0;
+static int iSpiPend = 0;
+static long lSpiDue = -1;
+static unsigned long ulSpiDmaInt = 0, ulSpiFrames = 0, ulSpiBad = 0, ulSpiLost = 0;
+
+long ClkFreq(int iClk)
+{
+	(void)iClk;
+	return 16000000;
+}
+
+static void Result(const char *szTest, int iOk, const char *szMore)
+{
+	printf("%-10s %s  %s\n", szTest, iOk ? "ok    " : "FAILED", szMore);
+	if (!iOk)
+		iFailed = 1;
+}
+
+// Channel enables and alternate selects. The set and clear registers only change
+// the bits written as 1, so a write to DMAENSET for one channel keeps the others.
+static unsigned int uiDmaEn = 0, uiDmaAlt = 0;
+
+// Register writes the controller acts on: enable and alternate set/clear
+static void DmaLatch(void)
+{
+	uiDmaEn = (uiDmaEn | Dma.DMAENSET) & ~Dma.DMAENCLR;
+	uiDmaAlt = (uiDmaAlt | Dma.DMAALTSET) & ~Dma.DMAALTCLR;
+	Dma.DMAENSET = uiDmaEn;
+	Dma.DMAALTSET = uiDmaAlt;
+	Dma.DMAENCLR = 0;
+	Dma.DMAALTCLR = 0;
+}
+
+static DmaDesc *DmaActive(int iCh)
+{
+	DmaDesc *pBase = (DmaDesc *)(uintptr_t)Dma.DMAPDBPTR;
+
+	return pBase + iCh + ((Dma.DMAALTSET & (1u << iCh)) ? CCD_SIZE : 0);
+}
+
+// One request of channel iCh, 0 based. Returns 1 if the byte was moved.
+static int DmaReq(int iCh)
+{
+	DmaDesc *pDesc = DmaActive(iCh);
+	unsigned int n;
+
+	if (!(Dma.DMACFG & 1) || !(Dma.DMAENSET & (1u << iCh)))
+		return 0;
+	if (pDesc->ctrlCfg.Bits.cycle_ctrl != DMA_PING)
+	{
+		uiDmaEn &= ~(1u << iCh);		// invalid structure, the channel stops
+		Dma.DMAENSET = uiDmaEn;
+		return 0;
+	}
+	n = pDesc->ctrlCfg.Bits.n_minus_1;
+	*(unsigned char *)(uintptr_t)(pDesc->destEndPtr - n) = *(volatile unsigned char *)(uintptr_t)pDesc->srcEndPtr;
+	if (n)
+		pDesc->ctrlCfg.Bits.n_minus_1 = n - 1;
+	else
+	{
+		pDesc->ctrlCfg.Bits.cycle_ctrl = DMA_STOP;
+		uiDmaAlt ^= 1u << iCh;
+		Dma.DMAALTSET = uiDmaAlt;
+		if (iCh == SPI1RX_C-1)
+			iSpiPend++;
+		else
+			iDmaPend++;
+	}
+	return 1;
+}
+
+// Start of the ring, from the primary structure set up by UrtDmaRxCfg()
+static unsigned char *Ring(void)
+{
+	DmaDesc *pBase = (DmaDesc *)(uintptr_t)Dma.DMAPDBPTR;
+
+	return (unsigned char *)(uintptr_t)pBase[UARTRX_C-1].destEndPtr - (HALF - 1);
+}
+
+// Read all complete frames and check them against those sent. Returns the bytes read.
+static int Consume(void)
+{
+	unsigned char *pBuf;
+	int iEnd, iLen, iTotal = 0;
+
+	while ((iLen = UrtDmaRxSpan(&pBuf, &iEnd)) > 0)
+	{
+		int iIdx = (int)(pBuf - Ring());
+		int iExp = (uiFrmOut != uiFrmIn) ? iFrmLen[uiFrmOut & (FRAMES-1)] : 0;
+
+		if ((iIdx < 0) || (iIdx + iLen > URT_DMA_RX_SIZE) || (!iEnd && (iIdx + iLen != URT_DMA_RX_SIZE)) ||
+			(iFrmOff + iLen > iExp) || (iEnd && (iFrmOff + iLen != iExp)) ||
+			memcmp(pBuf, ucFrm[uiFrmOut & (FRAMES-1)] + iFrmOff, iLen))
+			ulBad++;
+		if (!UrtDmaRxDone(iLen))
+			ulBad++;
+		iTotal += iLen;
+		ulRead += iLen;
+		iFrmOff += iLen;
+		if (iEnd)
+		{
+			uiFrmOut++;
+			iFrmOff = 0;
+		}
+	}
+	return iTotal;
+}
+
+// One character slot: a byte or none, the DMA interrupt when due, the timer every PERIOD
+static void Slot(int iByte)
+{
+	if (iByte >= 0)
+	{
+		Uart.COMRX = (unsigned short)iByte;
+		if ((Uart.COMIEN & COMIEN_EDMAR) && DmaReq(UARTRX_C-1))
+			ulSent++;
+		else
+			ulLost++;
+	}
+	if (iDmaPend && (lDmaDue < 0))
+		lDmaDue = lSlot + rand() % (DMA_LATE + 1);
+	if (iDmaPend && (lDmaDue <= lSlot))
+	{
+		UrtDmaRxIsr();
+		ulDmaInt++;
+		iDmaPend--;
+		lDmaDue = -1;
+	}
+	if ((lSlot % PERIOD == 0) && (Tm0.CON & TCON_ENABLE))
+	{
+		UrtDmaRxTmrIsr();
+		ulTmrInt++;
+	}
+	lSlot++;
+}
+
+// Send one frame of iLen random bytes, then the idle time that ends it
+static void Send(int iLen, int iGaps)
+{
+	unsigned char *pFrm = ucFrm[uiFrmIn & (FRAMES-1)];
+	int i, g;
+
+	iFrmLen[uiFrmIn & (FRAMES-1)] = iLen;
+	uiFrmIn++;
+	for (i = 0; i < iLen; i++)
+	{
+		pFrm[i] = (unsigned char)rand();
+		Slot(pFrm[i]);
+		for (g = (iGaps && (i + 1 < iLen) && rand() % 8 == 0) ? rand() % PERIOD : 0; g > 0; g--)
+			Slot(-1);
+	}
+	for (g = 2*PERIOD + 1 + (iGaps ? rand() % 20 : 0); g > 0; g--)
+		Slot(-1);
+}
+
+static void Config(void)
+{
+	DmaDesc *pBase;
+	char szMore[120];
+	int iOk;
+
+	memset(&Dma, 0, sizeof(Dma));
+	DmaBase();
+	iOk = UrtDmaRxCfg(pADI_UART, pADI_TM0, 100000);
+	iOk = iOk && (Tm0.LD == 6250) && ((Tm0.CON & 3) == TCON_PRE_DIV256);
+	iOk = iOk && UrtDmaRxCfg(pADI_UART, pADI_TM0, 1000000) && (Tm0.LD == 62500) && ((Tm0.CON & 3) == TCON_PRE_DIV256);
+	iOk = iOk && UrtDmaRxCfg(pADI_UART, pADI_TM0, 500001) && (Tm0.LD == 31250) && ((Tm0.CON & 3) == TCON_PRE_DIV256);
+	iOk = iOk && UrtDmaRxCfg(pADI_UART, pADI_TM0, 1) && (Tm0.LD == 1) && ((Tm0.CON & 3) == TCON_PRE_DIV16);
+	iOk = iOk && UrtDmaRxCfg(pADI_UART, pADI_TM0, 1000) && (Tm0.LD == 1000) && ((Tm0.CON & 3) == TCON_PRE_DIV16);
+	DmaLatch();
+	pBase = (DmaDesc *)(uintptr_t)Dma.DMAPDBPTR;
+	iOk = iOk && (Dma.DMACFG & 1) && (Dma.DMAENSET & DMAENSET_UARTRX) && !(Dma.DMAALTSET & DMAALTSET_UARTRX);
+	iOk = iOk && (Uart.COMIEN & COMIEN_EDMAR) && (Tm0.CON & TCON_ENABLE) && (Tm0.CON & TCON_MOD_PERIODIC);
+	iOk = iOk && (pBase[UARTRX_C-1].ctrlCfg.Bits.cycle_ctrl == DMA_PING) && (pBase[UARTRX_C-1].ctrlCfg.Bits.n_minus_1 == HALF-1);
+	iOk = iOk && (pBase[UARTRX_C-1+CCD_SIZE].ctrlCfg.Bits.cycle_ctrl == DMA_PING);
+	iOk = iOk && (pBase[UARTRX_C-1+CCD_SIZE].destEndPtr == pBase[UARTRX_C-1].destEndPtr + HALF);
+	iOk = iOk && (pBase[UARTRX_C-1].srcEndPtr == (unsigned int)(uintptr_t)&Uart.COMRX);
+	sprintf(szMore, "T0LD %d for 1ms, ring %d bytes in two halves", Tm0.LD, URT_DMA_RX_SIZE);
+	Result("config", iOk, szMore);
+}
+
+static void Random(int iN)
+{
+	char szMore[160];
+	int k;
+
+	for (k = 0; k < iN; k++)
+	{
+		int iLen = 1 + rand() % FRAME_MAX;
+		int iUnread = (int)(ulSent - ulRead);
+
+		// Read when the next frame could overwrite unread bytes or the frame queue is full
+		if ((iUnread + iLen > URT_DMA_RX_SIZE) || (uiFrmIn - uiFrmOut >= URT_DMA_RX_FRAMES) || (rand() % 3 == 0))
+			Consume();
+		if ((ulSent - ulRead + iLen > URT_DMA_RX_SIZE) || (uiFrmIn - uiFrmOut >= URT_DMA_RX_FRAMES))
+		{
+			ulBad++;					// frames the application has not been given
+			break;
+		}
+		Send(iLen, 1);
+	}
+	Consume();
+	sprintf(szMore, "%d frames, %lu bytes, %lu DMA and %lu timer interrupts, %lu bad, %lu lost, %d overruns",
+			iN, ulRead, ulDmaInt, ulTmrInt, ulBad, ulLost, UrtDmaRxOvr());
+	Result("random", (ulBad == 0) && (ulLost == 0) && (ulRead == ulSent) && (uiFrmOut == uiFrmIn) &&
+		   (UrtDmaRxOvr() == 0), szMore);
+}
+
+static void Overrun(void)
+{
+	unsigned char *pBuf;
+	unsigned long ulBad0;
+	char szMore[120];
+	int iEnd, iLen, iOvr = UrtDmaRxOvr(), iOk, i;
+
+	// The application stops reading: 6 frames of 60 bytes overrun the ring
+	for (i = 0; i < 6; i++)
+		Send(60, 0);
+	iOk = (UrtDmaRxSpan(&pBuf, &iEnd) == 0) && (UrtDmaRxOvr() == iOvr + 1);
+	uiFrmOut = uiFrmIn;					// the waiting frames are dropped
+	iFrmOff = 0;
+	ulRead = ulSent;
+	ulBad0 = ulBad;
+	for (i = 0; i < 3; i++)
+		Send(50, 0);
+	Consume();
+	iOk = iOk && (ulBad == ulBad0) && (uiFrmOut == uiFrmIn);
+
+	// A span overwritten while it is used
+	Send(40, 0);
+	iLen = UrtDmaRxSpan(&pBuf, &iEnd);
+	for (i = 0; i < 6; i++)
+		Send(50, 0);
+	iOk = iOk && (iLen == 40) && (UrtDmaRxDone(iLen) == 0) && (UrtDmaRxOvr() == iOvr + 2);
+	iOk = iOk && (UrtDmaRxSpan(&pBuf, &iEnd) == 0) && (UrtDmaRxOvr() == iOvr + 3);
+	uiFrmOut = uiFrmIn;
+	ulRead = ulSent;
+	for (i = 0; i < 3; i++)
+		Send(70, 0);
+	Consume();
+	iOk = iOk && (ulBad == ulBad0) && (uiFrmOut == uiFrmIn) && (ulLost == 0);
+	sprintf(szMore, "%d overruns counted, the frames after them intact", UrtDmaRxOvr() - iOvr);
+	Result("overrun", iOk, szMore);
+}
+
+static void SpiRing(int iFrame)
+{
+	DmaDesc *pBase = (DmaDesc *)(uintptr_t)Dma.DMAPDBPTR;
+
+	SpiDmaRxCfg(pADI_SPI1, iFrame);
+	DmaLatch();
+	pSpiRing = (unsigned char *)(uintptr_t)pBase[SPI1RX_C-1].destEndPtr - (SPI_HALF - 1);
+	iSpiFrame = iFrame;
+	ulSpiIn = ulSpiOut = ulSpiLast = 0;
+	uiSpiHead = uiSpiTail = 0;
+	iSpiPend = 0;
+	lSpiDue = -1;
+}
+
+// One byte time of SPI1: a byte or none, and the DMA interrupt when due
+static void SpiSlot(int iByte)
+{
+	if (iByte >= 0)
+	{
+		Spi1.SPIRX = (unsigned short)iByte;
+		if ((Spi1.SPIDMA & SPIDMA_IENRXDMA_EN) && DmaReq(SPI1RX_C-1))
+			ucSpiLog[ulSpiIn++ & (SPI_LOG-1)] = (unsigned char)iByte;
+		else
+			ulSpiLost++;
+	}
+	if (iSpiPend && (lSpiDue < 0))
+		lSpiDue = lSlot + rand() % (DMA_LATE + 1);
+	if (iSpiPend && (lSpiDue <= lSlot))
+	{
+		SpiDmaRxIsr();
+		ulSpiDmaInt++;
+		iSpiPend--;
+		lSpiDue = -1;
+	}
+	lSlot++;
+}
+
+// CS goes high. The frame ends unless no byte came or the frame queue is full.
+static void SpiCs(void)
+{
+	int iExp = (ulSpiIn != ulSpiLast) && (uiSpiHead - uiSpiTail < SPI_DMA_RX_FRAMES);
+
+	if (SpiDmaRxCsIsr() != iExp)
+		ulSpiBad++;
+	if (iExp)
+	{
+		ulSpiEnd[uiSpiHead++ & (SPI_DMA_RX_FRAMES-1)] = ulSpiIn;
+		ulSpiLast = ulSpiIn;
+	}
+}
+
+// Send iLen random bytes with short gaps, then CS high in CS mode
+static void SpiSend(int iLen)
+{
+	int i;
+
+	for (i = 0; i < iLen; i++)
+	{
+		SpiSlot(rand() & 0xFF);
+		if (rand() % 16 == 0)
+			SpiSlot(-1);
+	}
+	if (!iSpiFrame)
+		SpiCs();
+	ulSpiFrames++;
+	for (i = rand() % 4; i > 0; i--)
+		SpiSlot(-1);
+}
+
+// End of the frame being read
+static unsigned long SpiEnd(void)
+{
+	if (iSpiFrame)
+		return ulSpiOut - ulSpiOut % iSpiFrame + iSpiFrame;
+	return (uiSpiHead != uiSpiTail) ? ulSpiEnd[uiSpiTail & (SPI_DMA_RX_FRAMES-1)] : ulSpiOut;
+}
+
+// Read all complete frames and check them against the bytes sent
+static void SpiConsume(void)
+{
+	unsigned char *pBuf;
+	int iEnd, iLen, i;
+
+	while ((iLen = SpiDmaRxSpan(&pBuf, &iEnd)) > 0)
+	{
+		unsigned long ulEnd = SpiEnd();
+		int iIdx = (int)(ulSpiOut & (SPI_DMA_RX_SIZE-1));
+		int iExp = (int)(ulEnd - ulSpiOut);
+
+		if (iIdx + iExp > SPI_DMA_RX_SIZE)
+			iExp = SPI_DMA_RX_SIZE - iIdx;
+		if ((pBuf != pSpiRing + iIdx) || (iLen != iExp) || (iEnd != (ulSpiOut + iLen == ulEnd)))
+			ulSpiBad++;
+		for (i = 0; i < iLen; i++)
+			if (pBuf[i] != ucSpiLog[(ulSpiOut + i) & (SPI_LOG-1)])
+				ulSpiBad++;
+		if (!SpiDmaRxDone(iLen))
+			ulSpiBad++;
+		ulSpiOut += iLen;
+		if (iEnd && !iSpiFrame)
+			uiSpiTail++;
+	}
+	// no complete frame left
+	if ((SpiEnd() <= ulSpiIn) && (iSpiFrame || (uiSpiHead != uiSpiTail)))
+		ulSpiBad++;
+}
+
+static void SpiConfig(void)
+{
+	DmaDesc *pBase = (DmaDesc *)(uintptr_t)Dma.DMAPDBPTR;
+	char szMore[120];
+	int iOk;
+
+	SpiRing(16);
+	iOk = (Dma.DMAENSET & DMAENSET_SPI1RX) && !(Dma.DMAALTSET & DMAALTSET_SPI1RX);
+	iOk = iOk && (Spi1.SPIDMA == (SPIDMA_IENRXDMA_EN|SPIDMA_ENABLE_EN));
+	iOk = iOk && (pBase[SPI1RX_C-1].ctrlCfg.Bits.cycle_ctrl == DMA_PING) && (pBase[SPI1RX_C-1].ctrlCfg.Bits.n_minus_1 == SPI_HALF-1);
+	iOk = iOk && (pBase[SPI1RX_C-1+CCD_SIZE].ctrlCfg.Bits.cycle_ctrl == DMA_PING);
+	iOk = iOk && (pBase[SPI1RX_C-1+CCD_SIZE].destEndPtr == pBase[SPI1RX_C-1].destEndPtr + SPI_HALF);
+	iOk = iOk && (pBase[SPI1RX_C-1].srcEndPtr == (unsigned int)(uintptr_t)&Spi1.SPIRX);
+	iOk = iOk && (pBase[SPI1RX_C-1+CCD_SIZE].srcEndPtr == (unsigned int)(uintptr_t)&Spi1.SPIRX);
+	// the UART ring keeps running
+	iOk = iOk && (Dma.DMAENSET & DMAENSET_UARTRX);
+	sprintf(szMore, "ring %d bytes in two halves", SPI_DMA_RX_SIZE);
+	Result("spicfg", iOk, szMore);
+}
+
+static void SpiRandom(const char *szTest, int iN, int iFrame)
+{
+	unsigned long ulDmaInt0 = ulSpiDmaInt;
+	char szMore[160];
+	int iOvr, k;
+
+	SpiRing(iFrame);
+	iOvr = SpiDmaRxOvr();
+	ulSpiBad = ulSpiLost = ulSpiFrames = 0;
+	for (k = 0; k < iN; k++)
+	{
+		int iLen;
+
+		if (iFrame)
+			iLen = iFrame;
+		else
+			iLen = (rand() % 8 == 0) ? 1 + rand() % SPI_DMA_RX_SIZE : 1 + rand() % 32;
+		// Read when the frame could overwrite unread bytes or the frame queue is full
+		if ((ulSpiIn - ulSpiOut + iLen > SPI_DMA_RX_SIZE) || (uiSpiHead - uiSpiTail >= SPI_DMA_RX_FRAMES) ||
+			(rand() % 3 == 0))
+			SpiConsume();
+		if ((ulSpiIn - ulSpiOut + iLen > SPI_DMA_RX_SIZE) || (uiSpiHead - uiSpiTail >= SPI_DMA_RX_FRAMES))
+		{
+			ulSpiBad++;
+			break;
+		}
+		SpiSend(iLen);
+		// fixed frames of a new length from time to time
+		if (iFrame && (rand() % 500 == 0))
+		{
+			SpiConsume();
+			iFrame = 1 + rand() % SPI_HALF;
+			SpiRing(iFrame);
+		}
+	}
+	SpiConsume();
+	sprintf(szMore, "%lu frames, %lu DMA interrupts, %lu bad, %lu lost, %d overruns",
+			ulSpiFrames, ulSpiDmaInt - ulDmaInt0, ulSpiBad, ulSpiLost, SpiDmaRxOvr() - iOvr);
+	Result(szTest, (ulSpiBad == 0) && (ulSpiLost == 0) && (ulSpiOut == ulSpiIn) && (uiSpiHead == uiSpiTail) &&
+		   (SpiDmaRxOvr() == iOvr), szMore);
+}
+
+static void SpiJoin(void)
+{
+	char szMore[120];
+	int iOk, i;
+
+	SpiRing(0);
+	ulSpiBad = 0;
+	// SPI_DMA_RX_FRAMES frames wait, the next two CS edges are refused
+	for (i = 0; i < SPI_DMA_RX_FRAMES + 2; i++)
+		SpiSend(5);
+	iOk = (uiSpiHead == SPI_DMA_RX_FRAMES) && (ulSpiIn - ulSpiLast == 10);
+	SpiConsume();
+	iOk = iOk && (ulSpiOut == ulSpiLast);
+	// the next edge ends one frame of 15 bytes
+	SpiSend(5);
+	iOk = iOk && (uiSpiHead - uiSpiTail == 1) && (SpiEnd() - ulSpiOut == 15);
+	SpiConsume();
+	// CS edge with no byte
+	SpiCs();
+	iOk = iOk && (ulSpiBad == 0) && (ulSpiOut == ulSpiIn) && (uiSpiHead == uiSpiTail) && (SpiDmaRxOvr() == 0);
+	sprintf(szMore, "%d frames wait, the 2 after them joined to the next", SPI_DMA_RX_FRAMES);
+	Result("spijoin", iOk, szMore);
+}
+
+// Poll SpiDmaRxSpan() a few times after an overrun, it must be counted once
+static int SpiPollOvr(int iOvr)
+{
+	unsigned char *pBuf;
+	int iEnd, iOk = 1, i;
+
+	for (i = 0; i < 3; i++)
+		iOk = iOk && (SpiDmaRxSpan(&pBuf, &iEnd) == 0) && (SpiDmaRxOvr() == iOvr);
+	return iOk;
+}
+
+static void SpiOverrun(void)
+{
+	unsigned char *pBuf;
+	char szMore[120];
+	int iEnd, iLen, iOvr, iOvrFixed, iOk, i;
+
+	ulSpiBad = 0;
+	// Fixed frames: reading goes on from the start of the frame being received
+	SpiRing(16);
+	iOvr = SpiDmaRxOvr();
+	for (i = 0; i < 20; i++)
+		SpiSend(16);
+	SpiSend(7);
+	iOk = SpiPollOvr(iOvr + 1);
+	ulSpiOut = ulSpiIn - ulSpiIn % 16;
+	SpiSend(9);
+	for (i = 0; i < 3; i++)
+		SpiSend(16);
+	SpiConsume();
+	iOk = iOk && (ulSpiBad == 0) && (ulSpiOut == ulSpiIn) && (SpiDmaRxOvr() == iOvr + 1);
+	iOvrFixed = SpiDmaRxOvr() - iOvr;
+
+	// CS frames: the frames that waited are dropped
+	SpiRing(0);
+	iOvr = SpiDmaRxOvr();
+	for (i = 0; i < 6; i++)
+		SpiSend(60);
+	iOk = iOk && SpiPollOvr(iOvr + 1);
+	ulSpiOut = ulSpiIn;
+	uiSpiTail = uiSpiHead;
+	for (i = 0; i < 3; i++)
+		SpiSend(50);
+	SpiConsume();
+	iOk = iOk && (ulSpiBad == 0) && (ulSpiOut == ulSpiIn);
+
+	// A span overwritten while it is used, the first part if the frame wraps
+	SpiSend(40);
+	iLen = SpiDmaRxSpan(&pBuf, &iEnd);
+	for (i = 0; i < 6; i++)
+		SpiSend(50);
+	iOk = iOk && (iLen > 0) && (SpiDmaRxDone(iLen) == 0) && (SpiDmaRxOvr() == iOvr + 2);
+	iOk = iOk && SpiPollOvr(iOvr + 3);
+	ulSpiOut = ulSpiIn;
+	uiSpiTail = uiSpiHead;
+	for (i = 0; i < 3; i++)
+		SpiSend(70);
+	SpiConsume();
+	iOk = iOk && (ulSpiBad == 0) && (ulSpiOut == ulSpiIn);
+
+	// A frame longer than the ring: it is dropped at its CS edge
+	SpiSend(20);
+	SpiConsume();
+	for (i = 0; i < SPI_DMA_RX_SIZE + 44; i++)
+		SpiSlot(rand() & 0xFF);
+	iOk = iOk && SpiPollOvr(iOvr + 4);
+	ulSpiOut = ulSpiIn;
+	uiSpiTail = uiSpiHead;
+	SpiCs();
+	iOk = iOk && (SpiDmaRxSpan(&pBuf, &iEnd) == 0) && (SpiDmaRxOvr() == iOvr + 4);
+	ulSpiOut = ulSpiIn;
+	uiSpiTail = uiSpiHead;
+	for (i = 0; i < 3; i++)
+		SpiSend(30);
+	SpiConsume();
+	iOk = iOk && (ulSpiBad == 0) && (ulSpiOut == ulSpiIn) && (uiSpiHead == uiSpiTail) && (ulSpiLost == 0);
+	iOk = iOk && (SpiDmaRxOvr() == iOvr + 4);
+	sprintf(szMore, "%d overruns counted, the frames after them intact", iOvrFixed + SpiDmaRxOvr() - iOvr);
+	Result("spiovr", iOk, szMore);
+}
+
+int main(int argc, char *argv[])
+{
+	int iN = 20000;
+	int i;
+
+	for (i = 1; i + 1 < argc; i += 2)
+	{
+		if (!strcmp(argv[i], "-n"))
+			iN = atoi(argv[i+1]);
+		else if (!strcmp(argv[i], "-s"))
+			srand(atoi(argv[i+1]));
+	}
+	Config();
+	Random(iN);
+	Overrun();
+	SpiConfig();
+	SpiRandom("spifixed", iN, 16);
+	SpiRandom("spics", iN, 0);
+	SpiJoin();
+	SpiOverrun();
+	return iFailed;
+}
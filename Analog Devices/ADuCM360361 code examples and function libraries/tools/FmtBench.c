@@ -0,0 +1,179 @@
+/**
+ *****************************************************************************
+   @file     FmtBench.c
+   @brief    Host benchmark of common/FmtLib.c against sprintf().
+   - Formats the CN0221 result lines ("RTD Temperature: 23.456C \r\n" ...) with
+     sprintf("%f")/strlen() as the examples did, with sprintf("%.*f") at the same
+     precision as FmtLib, and with FmtStr()/FmtFlt().
+   - Reports ns per line and characters per second for each.
+   - Checks FmtFlt() against sprintf("%.*f") and FmtFix() against sprintf("%ld") on
+     random values and prints the number of differences. FmtFlt() scales the fraction
+     in single precision, so its last decimal can differ within a few float ulps of a
+     rounding tie.
+
+   Build:  gcc -O2 -o FmtBench FmtBench.c
+
+   Usage:  FmtBench [-n lines] [-r repeats] [-d decimals] [-s seed]
+   - -n : lines per measurement, default 200000.
+   - -r : repeats per measurement, the fastest is reported. Default 5.
+   - -d : decimals written by FmtFlt() and "%.*f", default 3.
+
+   @version  V0.1
+   @date     October 2026
+
+**/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "../common/FmtLib.c"
+
+#define NFIELD			5				// result lines per CN0221 measurement cycle
+
+static const char *szLabel[NFIELD] = {"RTD Resistance: ", "RTD Temperature: ", "Cold Junction Voltage: ",
+									  "Thermoucouple Voltage: ", "Final Temperature: "};
+static const char *szUnit[NFIELD] = {"Ohms \r\n", "C \r\n", "mV \r\n", "mV \r\n", "C \r\n\n\n\n"};
+
+volatile int iSink;
+static int iRepeats = 5;
+
+static double Now(void)
+{
+	struct timespec Ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &Ts);
+	return Ts.tv_sec*1e9 + Ts.tv_nsec;
+}
+
+static float Rand(float fLo, float fHi)
+{
+	return fLo + (fHi - fLo)*(float)(rand()/(RAND_MAX + 1.0));
+}
+
+// Line formatters, each returns the line length as passed to UrtWrite()
+static int LinePrintf(char *szBuf, int iField, float fVal, int iDec)
+{
+	(void)iDec;
+	sprintf(szBuf, "%s%f%s", szLabel[iField], fVal, szUnit[iField]);
+	return (int)strlen(szBuf);
+}
+
+static int LinePrintfDec(char *szBuf, int iField, float fVal, int iDec)
+{
+	return sprintf(szBuf, "%s%.*f%s", szLabel[iField], iDec, fVal, szUnit[iField]);
+}
+
+static int LineFmt(char *szBuf, int iField, float fVal, int iDec)
+{
+	int iLen = FmtStr(szBuf, szLabel[iField]);
+
+	iLen += FmtFlt(szBuf + iLen, fVal, iDec);
+	return iLen + FmtStr(szBuf + iLen, szUnit[iField]);
+}
+
+static double Time(int (*pfLine)(char *, int, float, int), const float *pfVal, int iN, int iDec, double *pdChars)
+{
+	char szBuf[64];
+	double dBest = 1e30;
+	int i, r;
+	long lChars = 0;
+
+	for (r = 0; r < iRepeats; r++)
+	{
+		double dT0 = Now();
+		lChars = 0;
+		for (i = 0; i < iN; i++)
+			lChars += pfLine(szBuf, i%NFIELD, pfVal[i], iDec);
+		dT0 = (Now() - dT0)/iN;
+		iSink = (int)lChars;
+		if (dT0 < dBest)
+			dBest = dT0;
+	}
+	*pdChars = (double)lChars/iN;
+	return dBest;
+}
+
+// Differences between FmtLib and sprintf over random values
+static void Check(int iN, int iDec)
+{
+	char szA[64], szB[64];
+	int i, iFlt = 0, iFix = 0, iFltAll = 0;
+
+	for (i = 0; i < iN; i++)
+	{
+		float fVal = Rand(-2000.0f, 2000.0f);
+		long lVal = (long)(rand() - RAND_MAX/2) * ((i & 1) ? 1 : 4093);
+		int d = i % 7;
+
+		FmtFlt(szA, fVal, iDec);
+		sprintf(szB, "%.*f", iDec, fVal);
+		if (strcmp(szA, szB) && strcmp(szB + 1, szA))	// "-0.000" is written "0.000"
+			iFlt++;
+		FmtFlt(szA, fVal, d);
+		sprintf(szB, "%.*f", d, fVal);
+		if (strcmp(szA, szB) && strcmp(szB + 1, szA))
+			iFltAll++;
+		FmtFix(szA, lVal, 0);
+		sprintf(szB, "%ld", lVal);
+		if (strcmp(szA, szB))
+			iFix++;
+	}
+	printf("FmtFlt  %%.%df, |x| < 2000       : %d of %d differ from sprintf\n", iDec, iFlt, iN);
+	printf("FmtFlt  %%.0f..%%.6f, |x| < 2000: %d of %d differ from sprintf\n", iFltAll, iN);
+	printf("FmtFix  %%ld                     : %d of %d differ from sprintf\n", iFix, iN);
+}
+
+int main(int argc, char *argv[])
+{
+	char szLine[64];
+	float *pfVal;
+	double dPf, dPfDec, dFmt, dChPf, dChPfDec, dChFmt;
+	int iN = 200000, iDec = 3, i;
+
+	for (i = 1; i < argc; i++)
+	{
+		if (!strcmp(argv[i], "-n") && i+1 < argc)
+			iN = atoi(argv[++i]);
+		else if (!strcmp(argv[i], "-r") && i+1 < argc)
+			iRepeats = atoi(argv[++i]);
+		else if (!strcmp(argv[i], "-d") && i+1 < argc)
+			iDec = atoi(argv[++i]);
+		else if (!strcmp(argv[i], "-s") && i+1 < argc)
+			srand(atoi(argv[++i]));
+		else
+		{
+			fprintf(stderr, "usage: FmtBench [-n lines] [-r repeats] [-d decimals] [-s seed]\n");
+			return 2;
+		}
+	}
+	if (iN < NFIELD || iRepeats < 1 || iDec < 0 || iDec > 6)
+		return 2;
+
+	// Values in the ranges the CN0221 example prints
+	pfVal = malloc(iN*sizeof(float));
+	for (i = 0; i < iN; i++)
+	{
+		switch (i%NFIELD)
+		{
+		case 0:  pfVal[i] = Rand(84.0f, 148.0f);   break;	// RTD ohms
+		case 1:  pfVal[i] = Rand(-40.0f, 125.0f);  break;	// RTD degC
+		case 2:  pfVal[i] = Rand(-1.5f, 5.5f);     break;	// cold junction mV
+		case 3:  pfVal[i] = Rand(-5.6f, 17.8f);    break;	// thermocouple mV
+		default: pfVal[i] = Rand(-200.0f, 350.0f); break;	// final degC
+		}
+	}
+
+	dPf = Time(LinePrintf, pfVal, iN, iDec, &dChPf);
+	dPfDec = Time(LinePrintfDec, pfVal, iN, iDec, &dChPfDec);
+	dFmt = Time(LineFmt, pfVal, iN, iDec, &dChFmt);
+
+	LineFmt(szLine, 1, 23.4567f, iDec);
+	printf("%d lines, e.g. \"%.*s\"\n\n", iN, (int)strlen(szLine) - 3, szLine);
+	printf("%-26s %9s %11s %9s\n", "formatter", "ns/line", "Mchar/s", "speed");
+	printf("%-26s %9.1f %11.2f %8.2fx\n", "sprintf %f + strlen", dPf, dChPf/dPf*1e3, 1.0);
+	printf("%-26s %9.1f %11.2f %8.2fx\n", "sprintf %.*f", dPfDec, dChPfDec/dPfDec*1e3, dPf/dPfDec);
+	printf("%-26s %9.1f %11.2f %8.2fx\n\n", "FmtStr + FmtFlt", dFmt, dChFmt/dFmt*1e3, dPf/dFmt);
+	Check(iN, iDec);
+	return 0;
+}
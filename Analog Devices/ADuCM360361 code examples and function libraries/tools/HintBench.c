@@ -0,0 +1,249 @@
+/**
+ *****************************************************************************
+   @file     HintBench.c
+   @brief    Host benchmark for the segment hints of the TempLib non-uniform lookups.
+   - Builds non-uniform thermocouple (-200..350degC) and RTD (-40..125degC) tables
+     with breakpoints equally spaced in temperature, so unequally spaced in input.
+   - Replays a temperature trace through TempLutNu() (binary search every call) and
+     TempLutNuHint() (one hint per channel) and reports ns per lookup, how often the
+     hint or a neighbour segment was used, and any output mismatch.
+   - The same inputs are also run in shuffled order, the worst case for the hint.
+
+   Build:  gcc -O2 -o HintBench HintBench.c -lm
+
+   Usage:  HintBench [-n cycles] [-k segments] [-r repeats] [-f recorded.txt] [-s seed]
+   - -n : measurement cycles synthesised when no file is given, default 200000.
+   - -k : segments in each table, default 64.
+   - -r : repeats per measurement, the fastest is reported. Default 5.
+   - -f : recorded ADC1DAT values in the TempBench format, one "thermocouple_code rtd_code"
+          pair per line, SAMPLENO lines per measurement cycle.
+
+   @version  V0.1
+   @date     October 2026
+
+**/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "RefCurves.h"
+#include "../common/TempLib.h"
+
+#define SAMPLENO		5				// samples per channel per cycle, as in Thermocouple_to_UART.c
+#define ADC_FS			268435456.0		// 2^28, ADC1DAT full scale
+#define ADC_VREF		1.2				// internal reference
+#define RTD_RREF		5600.0			// RTD reference resistor
+#define MAX_SEG			4096
+
+typedef struct
+{
+	const char *szName;
+	float fX[MAX_SEG+1];				// breakpoints (table input)
+	float fT[MAX_SEG+1];				// temperature at each breakpoint
+	int iNSeg;
+} NuTable;
+
+volatile float fSink;
+static int iRepeats = 5;
+
+static double Now(void)
+{
+	struct timespec Ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &Ts);
+	return Ts.tv_sec*1e9 + Ts.tv_nsec;
+}
+
+static double Rand(double dLo, double dHi)
+{
+	return dLo + (dHi - dLo)*(rand()/(RAND_MAX + 1.0));
+}
+
+static void Build(NuTable *pTbl, const char *szName, double (*pfX)(double), double dTMin, double dTMax, int iNSeg)
+{
+	int j;
+
+	pTbl->szName = szName;
+	pTbl->iNSeg = iNSeg;
+	for (j = 0; j <= iNSeg; j++)
+	{
+		pTbl->fT[j] = (float)(dTMin + (dTMax - dTMin)*j/iNSeg);
+		pTbl->fX[j] = (float)pfX(pTbl->fT[j]);
+	}
+}
+
+// One table over a sequence of inputs: binary search against hint
+static void Run(const NuTable *pTbl, const float *pfIn, int iN, const char *szOrder)
+{
+	double dBin = 1e30, dHint = 1e30;
+	int i, r, iHint, iNear = 0, iMismatch = 0;
+
+	for (r = 0; r < iRepeats; r++)
+	{
+		double dT0 = Now();
+		float fAcc = 0.0f;
+		for (i = 0; i < iN; i++)
+			fAcc += TempLutNu(pfIn[i], pTbl->fX, pTbl->iNSeg, pTbl->fT);
+		dT0 = (Now() - dT0)/iN;
+		fSink = fAcc;
+		if (dT0 < dBin)
+			dBin = dT0;
+
+		iHint = 0;
+		dT0 = Now();
+		fAcc = 0.0f;
+		for (i = 0; i < iN; i++)
+			fAcc += TempLutNuHint(pfIn[i], pTbl->fX, pTbl->iNSeg, pTbl->fT, &iHint);
+		dT0 = (Now() - dT0)/iN;
+		fSink = fAcc;
+		if (dT0 < dHint)
+			dHint = dT0;
+	}
+	iHint = 0;
+	for (i = 0; i < iN; i++)
+	{
+		int iPrev = iHint;
+		float fH = TempLutNuHint(pfIn[i], pTbl->fX, pTbl->iNSeg, pTbl->fT, &iHint);
+		if (fH != TempLutNu(pfIn[i], pTbl->fX, pTbl->iNSeg, pTbl->fT))
+			iMismatch++;
+		if (abs(iHint - iPrev) <= 1)
+			iNear++;
+	}
+	printf("%-13s %-8s %9.2f %9.2f %7.2fx %8.2f%% %9d\n", pTbl->szName, szOrder,
+		   dBin, dHint, dBin/dHint, 100.0*iNear/iN, iMismatch);
+}
+
+static void Shuffle(float *pf, int iN)
+{
+	int i;
+
+	for (i = iN-1; i > 0; i--)
+	{
+		int j = rand() % (i+1);
+		float f = pf[i];
+		pf[i] = pf[j];
+		pf[j] = f;
+	}
+}
+
+static int Load(const char *szFile, long **pplTc, long **pplRtd)
+{
+	FILE *pF = fopen(szFile, "r");
+	long lTc, lRtd;
+	int iN = 0, iSize = 4096;
+
+	if (pF == 0)
+	{
+		perror(szFile);
+		exit(1);
+	}
+	*pplTc = malloc(iSize*sizeof(long));
+	*pplRtd = malloc(iSize*sizeof(long));
+	while (fscanf(pF, "%ld %ld", &lTc, &lRtd) == 2)
+	{
+		if (iN == iSize)
+		{
+			iSize *= 2;
+			*pplTc = realloc(*pplTc, iSize*sizeof(long));
+			*pplRtd = realloc(*pplRtd, iSize*sizeof(long));
+		}
+		(*pplTc)[iN] = lTc;
+		(*pplRtd)[iN] = lRtd;
+		iN++;
+	}
+	fclose(pF);
+	return iN/SAMPLENO;
+}
+
+// Slowly drifting hot and cold junctions with ADC noise, as in TempBench
+static void Synthesise(long *plTc, long *plRtd, int iCycles)
+{
+	double dTh = 20.0, dTc = 25.0;
+	int i, s;
+
+	for (i = 0; i < iCycles; i++)
+	{
+		dTh += Rand(-0.5, 0.5);
+		dTc += Rand(-0.05, 0.05);
+		if (dTh < -190.0 || dTh > 340.0)
+			dTh = Rand(-150.0, 300.0);
+		if (dTc < -35.0 || dTc > 120.0)
+			dTc = Rand(0.0, 50.0);
+		for (s = 0; s < SAMPLENO; s++)
+		{
+			double dVtc = (RefTcE(dTh) - RefTcE(dTc))/1000.0;
+			plTc[i*SAMPLENO + s] = (long)(dVtc/ADC_VREF*ADC_FS + Rand(-40.0, 40.0));
+			plRtd[i*SAMPLENO + s] = (long)(RefRtdR(dTc)/RTD_RREF*ADC_FS + Rand(-40.0, 40.0));
+		}
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	static NuTable Tc, Rtd;
+	const char *szFile = 0;
+	long *plTc, *plRtd;
+	float *pfTcMv, *pfOhm;
+	int iCycles = 200000, iNSeg = 64, i, s;
+
+	for (i = 1; i < argc; i++)
+	{
+		if (!strcmp(argv[i], "-n") && i+1 < argc)
+			iCycles = atoi(argv[++i]);
+		else if (!strcmp(argv[i], "-k") && i+1 < argc)
+			iNSeg = atoi(argv[++i]);
+		else if (!strcmp(argv[i], "-r") && i+1 < argc)
+			iRepeats = atoi(argv[++i]);
+		else if (!strcmp(argv[i], "-f") && i+1 < argc)
+			szFile = argv[++i];
+		else if (!strcmp(argv[i], "-s") && i+1 < argc)
+			srand(atoi(argv[++i]));
+		else
+		{
+			fprintf(stderr, "usage: HintBench [-n cycles] [-k segments] [-r repeats] [-f recorded.txt] [-s seed]\n");
+			return 2;
+		}
+	}
+	if (iNSeg < 2 || iNSeg > MAX_SEG || iRepeats < 1)
+		return 2;
+
+	if (szFile)
+		iCycles = Load(szFile, &plTc, &plRtd);
+	else
+	{
+		plTc = malloc(iCycles*SAMPLENO*sizeof(long));
+		plRtd = malloc(iCycles*SAMPLENO*sizeof(long));
+		Synthesise(plTc, plRtd, iCycles);
+	}
+	if (iCycles < 1)
+		return 1;
+
+	// Averaged table inputs per cycle, as the CN0221 main loop computes them
+	pfTcMv = malloc(iCycles*sizeof(float));
+	pfOhm = malloc(iCycles*sizeof(float));
+	for (i = 0; i < iCycles; i++)
+	{
+		double dTc = 0.0, dRtd = 0.0;
+		for (s = 0; s < SAMPLENO; s++)
+		{
+			dTc += plTc[i*SAMPLENO + s];
+			dRtd += plRtd[i*SAMPLENO + s];
+		}
+		pfOhm[i] = (float)(dRtd/SAMPLENO/ADC_FS*RTD_RREF);
+		pfTcMv[i] = (float)(dTc/SAMPLENO/ADC_FS*ADC_VREF*1000.0 + RefTcE(RefRtdT(pfOhm[i])));
+	}
+
+	Build(&Tc, "Thermocouple", RefTcE, -200.0, 350.0, iNSeg);
+	Build(&Rtd, "RTD", RefRtdR, -40.0, 125.0, iNSeg);
+	printf("%d cycles%s, %d segments per table\n\n", iCycles, szFile ? " (recorded)" : "", iNSeg);
+	printf("%-13s %-8s %9s %9s %8s %9s %9s\n", "table", "order", "ns/bin", "ns/hint", "speed", "near", "mismatch");
+	Run(&Tc, pfTcMv, iCycles, "trace");
+	Run(&Rtd, pfOhm, iCycles, "trace");
+	Shuffle(pfTcMv, iCycles);
+	Shuffle(pfOhm, iCycles);
+	Run(&Tc, pfTcMv, iCycles, "shuffled");
+	Run(&Rtd, pfOhm, iCycles, "shuffled");
+	return 0;
+}
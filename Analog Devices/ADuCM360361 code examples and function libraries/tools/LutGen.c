@@ -0,0 +1,386 @@
+/**
+ *****************************************************************************
+   @file     LutGen.c
+   @brief    Host tool to size the piecewise linear lookup tables used by TempCalc.
+   - Picks the smallest number of segments that keeps the interpolation error
+     below a target, for a uniform table or a non-uniform (breakpoint) table.
+   - Emits a header with the same #define and table names as TempCalc.h/TempCalc.c.
+   - Prints the worst-case error and the flash used by the table to stderr.
+
+   Build:  gcc -O2 -o LutGen LutGen.c -lm
+
+   Usage:  LutGen -t <table> [-r tmin tmax] [-e maxerr] [-n] [-s] [-o file]
+           LutGen -c <curve.csv> -p <NAME> -r xmin xmax [-e maxerr] [-n] [-s] [-o file]
+   - -t rtd|ther_p|ther_n|coldj : built-in Type T thermocouple / PT100 curves.
+   - -r : temperature range in degC for built-in tables (x range for -c curves).
+   - -e : maximum interpolation error in output units (degC, or mV for the coldj table).
+          Default 0.01.
+   - -n : non-uniform table. Adds a breakpoint table <table>_x[] and defines <NU>.
+   - -s : declare the tables static so the header can be included from several files.
+   - -c : custom curve, one "x y" pair per line (comma or blank separated), x monotonic.
+          The curve is linearly interpolated, so supply it densely (e.g. 0.1degC steps).
+   - -p : prefix for custom curve macros (NAME_X_MIN, NAME_N_SEG, ...) and table C_NAME.
+
+   Example: LutGen -t ther_p -r 0 350 -e 0.05 -o TherP.h
+
+   @version  V0.1
+   @date     October 2026
+
+**/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "RefCurves.h"
+
+#define LUT_MAX_SEG		1024		// largest table the tool will emit
+#define LUT_SAMPLES		64			// error samples per segment
+#define LUT_MAX_CURVE	100000		// largest custom curve accepted
+
+typedef struct
+{
+	const char *szName;				// table name on the command line
+	const char *szTable;			// name of the output table
+	const char *szXMin;				// macro names as used in TempCalc.h
+	const char *szXMax;
+	const char *szYMin;
+	const char *szYMax;
+	const char *szNSeg;
+	const char *szXSeg;
+	const char *szNu;				// defined for non-uniform tables
+	const char *szXUnit;
+	const char *szYUnit;
+	double (*pfX)(double);			// temperature -> table input
+	double (*pfY)(double);			// table input -> reference output
+	double dTMin;					// default temperature range
+	double dTMax;
+} LutTable;
+
+static double Identity(double d) { return d; }
+
+static const LutTable C_tables[] =
+{
+	{"rtd", "C_rtd", "RMIN", "RMAX", "TMIN", "TMAX", "NSEG", "RSEG", "RTD_NU",
+		"ohms", "degC", RefRtdR, RefRtdT, -40.0, 125.0},
+	{"ther_p", "C_themocoupleP", "THER_V_MIN_P", "THER_V_MAX_P", "THER_T_MIN_P", "THER_T_MAX_P",
+		"THER_N_SEG_P", "THER_V_SEG_P", "THER_NU_P", "mV", "degC", RefTcE, RefTcT, 0.0, 350.0},
+	{"ther_n", "C_themocoupleN", "THER_V_MIN_N", "THER_V_MAX_N", "THER_T_MIN_N", "THER_T_MAX_N",
+		"THER_N_SEG_N", "THER_V_SEG_N", "THER_NU_N", "mV", "degC", RefTcE, RefTcT, 0.0, -200.0},
+	{"coldj", "C_cold_junction", "COLDJ_T_MIN", "COLDJ_T_MAX", "COLDJ_V_MIN", "COLDJ_V_MAX",
+		"COLDJ_N_SEG", "COLDJ_T_SEG", "COLDJ_NU", "degC", "mV", Identity, RefTcE, -40.0, 125.0},
+};
+
+// Custom curve loaded with -c
+static double *pdCurveX = 0;
+static double *pdCurveY = 0;
+static int iCurveLen = 0;
+
+static double CurveY(double dX)
+{
+	int iLo = 0;
+	int iHi = iCurveLen - 1;
+	int iDir = (pdCurveX[iHi] > pdCurveX[0]) ? 1 : -1;
+
+	while (iHi - iLo > 1)					// binary search for the enclosing pair
+	{
+		int iMid = (iLo + iHi)/2;
+		if ((dX - pdCurveX[iMid])*iDir >= 0)
+			iLo = iMid;
+		else
+			iHi = iMid;
+	}
+	return pdCurveY[iLo] + (dX - pdCurveX[iLo])*(pdCurveY[iHi] - pdCurveY[iLo])/(pdCurveX[iHi] - pdCurveX[iLo]);
+}
+
+static int CurveLoad(const char *szFile)
+{
+	FILE *pF = fopen(szFile, "r");
+	char szLine[256];
+	int iSize = 1024;
+
+	if (pF == 0)
+		return 0;
+	pdCurveX = malloc(iSize*sizeof(double));
+	pdCurveY = malloc(iSize*sizeof(double));
+	while (fgets(szLine, sizeof(szLine), pF) && iCurveLen < LUT_MAX_CURVE)
+	{
+		char *p;
+		double dX, dY;
+		for (p = szLine; *p; p++)
+			if (*p == ',' || *p == ';')
+				*p = ' ';
+		if (sscanf(szLine, "%lf %lf", &dX, &dY) != 2)
+			continue;							// header or comment line
+		if (iCurveLen == iSize)
+		{
+			iSize *= 2;
+			pdCurveX = realloc(pdCurveX, iSize*sizeof(double));
+			pdCurveY = realloc(pdCurveY, iSize*sizeof(double));
+		}
+		pdCurveX[iCurveLen] = dX;
+		pdCurveY[iCurveLen] = dY;
+		iCurveLen++;
+	}
+	fclose(pF);
+	return iCurveLen >= 2;
+}
+
+// Round through the text representation the header will contain, then to float
+static double AsEmitted(double d)
+{
+	char sz[32];
+
+	if (fabs(d) < 1e-9)
+		d = 0.0;								// bisection residue at the 0degC/0mV origin
+	sprintf(sz, "%.7g", d);
+	return (float)strtod(sz, 0);
+}
+
+// Worst-case error of the chord between (dXa,dYa) and (dXb,dYb) against the curve
+static double ChordErr(double (*pfY)(double), double dXa, double dYa, double dXb, double dYb, double *pdAt)
+{
+	int i;
+	double dMax = 0.0;
+
+	for (i = 0; i <= LUT_SAMPLES; i++)
+	{
+		double dX = dXa + (dXb - dXa)*i/LUT_SAMPLES;
+		double dErr = fabs(dYa + (dX - dXa)*(dYb - dYa)/(dXb - dXa) - pfY(dX));
+		if (dErr > dMax)
+		{
+			dMax = dErr;
+			if (pdAt)
+				*pdAt = dX;
+		}
+	}
+	return dMax;
+}
+
+// Uniform table: smallest segment count meeting dMaxErr. Returns segment count or 0.
+static int FitUniform(double (*pfY)(double), double dX0, double dX1, double dMaxErr,
+					  double *pdX, double *pdY, double *pdErr, double *pdAt)
+{
+	int iN, j;
+
+	for (iN = 1; iN <= LUT_MAX_SEG; iN++)
+	{
+		double dSeg = AsEmitted((dX1 - dX0)/iN);
+		double dWorst = 0.0;
+		double dAt = dX0;
+
+		for (j = 0; j <= iN; j++)
+		{
+			pdX[j] = dX0 + dSeg*j;				// same expression as TempCalc: XMIN+XSEG*j
+			pdY[j] = AsEmitted(pfY(pdX[j]));
+		}
+		for (j = 0; j < iN; j++)
+		{
+			double dAtSeg;
+			double dErr = ChordErr(pfY, pdX[j], pdY[j], pdX[j+1], pdY[j+1], &dAtSeg);
+			if (dErr > dWorst)
+			{
+				dWorst = dErr;
+				dAt = dAtSeg;
+			}
+		}
+		if (dWorst <= dMaxErr)
+		{
+			*pdErr = dWorst;
+			*pdAt = dAt;
+			return iN;
+		}
+	}
+	return 0;
+}
+
+// Non-uniform table: greedily extend every segment as far as the error allows
+static int FitNonUniform(double (*pfY)(double), double dX0, double dX1, double dMaxErr,
+						 double *pdX, double *pdY, double *pdErr, double *pdAt)
+{
+	int iN = 0;
+	double dWorst = 0.0;
+
+	pdX[0] = AsEmitted(dX0);
+	pdY[0] = AsEmitted(pfY(pdX[0]));
+	while (iN < LUT_MAX_SEG)
+	{
+		double dLo = pdX[iN];
+		double dHi = dX1;
+		double dAt, dErr;
+		int i;
+
+		if (ChordErr(pfY, pdX[iN], pdY[iN], dX1, AsEmitted(pfY(dX1)), 0) > dMaxErr)
+		{
+			for (i = 0; i < 48; i++)			// longest segment whose chord meets the target
+			{
+				double dMid = 0.5*(dLo + dHi);
+				if (ChordErr(pfY, pdX[iN], pdY[iN], dMid, AsEmitted(pfY(dMid)), 0) <= dMaxErr*0.999)
+					dLo = dMid;
+				else
+					dHi = dMid;
+			}
+			if (AsEmitted(dLo) == pdX[iN])
+				return 0;						// target below float resolution
+			dHi = dLo;
+		}
+		pdX[iN+1] = AsEmitted(dHi);
+		pdY[iN+1] = AsEmitted(pfY(pdX[iN+1]));
+		dErr = ChordErr(pfY, pdX[iN], pdY[iN], pdX[iN+1], pdY[iN+1], &dAt);
+		if (dErr > dWorst)
+		{
+			dWorst = dErr;
+			*pdAt = dAt;
+		}
+		iN++;
+		if (pdX[iN] == AsEmitted(dX1))
+		{
+			*pdErr = dWorst;
+			return iN;
+		}
+	}
+	return 0;
+}
+
+static void EmitTable(FILE *pF, const char *szStatic, const char *szName, const char *szSize, const double *pd, int iN)
+{
+	int j;
+
+	fprintf(pF, "%sconst float %s[%s+1] = {", szStatic, szName, szSize);
+	for (j = 0; j <= iN; j++)
+		fprintf(pF, "%s%.7g%s", (j % 8) ? "\t" : "\n\t", pd[j], (j < iN) ? "," : "");
+	fprintf(pF, "};\n");
+}
+
+static void Usage(void)
+{
+	fprintf(stderr, "usage: LutGen -t rtd|ther_p|ther_n|coldj [-r tmin tmax] [-e maxerr] [-n] [-s] [-o file]\n"
+					"       LutGen -c curve.csv -p NAME -r xmin xmax [-e maxerr] [-n] [-s] [-o file]\n");
+	exit(2);
+}
+
+int main(int argc, char *argv[])
+{
+	static double dX[LUT_MAX_SEG+1], dY[LUT_MAX_SEG+1];
+	static char szMacro[8][64];
+	LutTable Tbl;
+	const char *szOut = 0;
+	const char *szCurve = 0;
+	const char *szPrefix = 0;
+	const char *szStatic = "";
+	double dTMin = 0.0, dTMax = 0.0, dMaxErr = 0.01;
+	double dX0, dX1, dErr = 0.0, dAt = 0.0;
+	int iRange = 0, iNonUniform = 0, iN, i;
+	FILE *pF = stdout;
+
+	memset(&Tbl, 0, sizeof(Tbl));
+	for (i = 1; i < argc; i++)
+	{
+		if (!strcmp(argv[i], "-t") && i+1 < argc)
+		{
+			unsigned int u;
+			for (u = 0; u < sizeof(C_tables)/sizeof(C_tables[0]); u++)
+				if (!strcmp(argv[i+1], C_tables[u].szName))
+					Tbl = C_tables[u];
+			if (Tbl.szName == 0)
+				Usage();
+			i++;
+		}
+		else if (!strcmp(argv[i], "-r") && i+2 < argc)
+		{
+			dTMin = atof(argv[i+1]);
+			dTMax = atof(argv[i+2]);
+			iRange = 1;
+			i += 2;
+		}
+		else if (!strcmp(argv[i], "-e") && i+1 < argc)
+			dMaxErr = atof(argv[++i]);
+		else if (!strcmp(argv[i], "-o") && i+1 < argc)
+			szOut = argv[++i];
+		else if (!strcmp(argv[i], "-c") && i+1 < argc)
+			szCurve = argv[++i];
+		else if (!strcmp(argv[i], "-p") && i+1 < argc)
+			szPrefix = argv[++i];
+		else if (!strcmp(argv[i], "-n"))
+			iNonUniform = 1;
+		else if (!strcmp(argv[i], "-s"))
+			szStatic = "static ";
+		else
+			Usage();
+	}
+
+	if (szCurve)
+	{
+		const char *szSuffix[8] = {"C_", "_X_MIN", "_X_MAX", "_Y_MIN", "_Y_MAX", "_N_SEG", "_X_SEG", "_NU"};
+		if (szPrefix == 0 || !iRange || !CurveLoad(szCurve))
+			Usage();
+		sprintf(szMacro[0], "C_%s", szPrefix);
+		for (i = 1; i < 8; i++)
+			sprintf(szMacro[i], "%s%s", szPrefix, szSuffix[i]);
+		Tbl.szName = szCurve;
+		Tbl.szTable = szMacro[0];
+		Tbl.szXMin = szMacro[1];
+		Tbl.szXMax = szMacro[2];
+		Tbl.szYMin = szMacro[3];
+		Tbl.szYMax = szMacro[4];
+		Tbl.szNSeg = szMacro[5];
+		Tbl.szXSeg = szMacro[6];
+		Tbl.szNu = szMacro[7];
+		Tbl.szXUnit = "x";
+		Tbl.szYUnit = "y";
+		Tbl.pfX = Identity;
+		Tbl.pfY = CurveY;
+	}
+	else if (Tbl.szName == 0)
+		Usage();
+	if (!iRange)
+	{
+		dTMin = Tbl.dTMin;
+		dTMax = Tbl.dTMax;
+	}
+
+	dX0 = AsEmitted(Tbl.pfX(dTMin));
+	dX1 = Tbl.pfX(dTMax);
+	if (iNonUniform)
+		iN = FitNonUniform(Tbl.pfY, dX0, dX1, dMaxErr, dX, dY, &dErr, &dAt);
+	else
+		iN = FitUniform(Tbl.pfY, dX0, dX1, dMaxErr, dX, dY, &dErr, &dAt);
+	if (iN == 0)
+	{
+		fprintf(stderr, "LutGen: %g %s cannot be met with %d segments\n", dMaxErr, Tbl.szYUnit, LUT_MAX_SEG);
+		return 1;
+	}
+
+	if (szOut && (pF = fopen(szOut, "w")) == 0)
+	{
+		perror(szOut);
+		return 1;
+	}
+	fprintf(pF, "// Generated by LutGen for %s over %g..%g: %d %s segments\n",
+			Tbl.szName, dTMin, dTMax, iN, iNonUniform ? "non-uniform" : "uniform");
+	fprintf(pF, "// Worst-case interpolation error %.4g %s at %.6g %s\n", dErr, Tbl.szYUnit, dAt, Tbl.szXUnit);
+	if (iNonUniform)
+		fprintf(pF, "#define %s\t\t\t// = breakpoints in %s_x\n", Tbl.szNu, Tbl.szTable);
+	fprintf(pF, "#define %s (%.7g)\t\t// = minimum output in %s\n", Tbl.szYMin, dY[0], Tbl.szYUnit);
+	fprintf(pF, "#define %s (%.7g)\t\t// = maximum output in %s\n", Tbl.szYMax, dY[iN], Tbl.szYUnit);
+	fprintf(pF, "#define %s (%.7g)\t\t// = input in %s at %s\n", Tbl.szXMin, dX[0], Tbl.szXUnit, Tbl.szYMin);
+	fprintf(pF, "#define %s (%.7g)\t\t// = input in %s at %s\n", Tbl.szXMax, dX[iN], Tbl.szXUnit, Tbl.szYMax);
+	fprintf(pF, "#define %s (%d)\t\t// = number of sections in table\n", Tbl.szNSeg, iN);
+	if (iNonUniform)
+	{
+		char szBreak[80];
+		sprintf(szBreak, "%s_x", Tbl.szTable);
+		EmitTable(pF, szStatic, szBreak, Tbl.szNSeg, dX, iN);
+	}
+	else
+		fprintf(pF, "#define %s (%.7g)\t\t// = (%s-%s)/%s = input in %s of each segment\n",
+				Tbl.szXSeg, AsEmitted((dX1 - dX0)/iN), Tbl.szXMax, Tbl.szXMin, Tbl.szNSeg, Tbl.szXUnit);
+	EmitTable(pF, szStatic, Tbl.szTable, Tbl.szNSeg, dY, iN);
+	if (pF != stdout)
+		fclose(pF);
+
+	fprintf(stderr, "%s: %d segments, worst-case error %.4g %s at %.6g %s, %d bytes of flash\n",
+			Tbl.szName, iN, dErr, Tbl.szYUnit, dAt, Tbl.szXUnit,
+			(int)((iN + 1)*sizeof(float)*(iNonUniform ? 2 : 1)));
+	return 0;
+}
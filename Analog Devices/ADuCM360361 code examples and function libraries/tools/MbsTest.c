@@ -0,0 +1,315 @@
+/**
+ *****************************************************************************
+   @file     MbsTest.c
+   @brief    Host test of the Modbus RTU slave of common/MbsLib.c over the simulated UART of UrtSim.c.
+   - Runs common/MbsLib.c, common/UrtLib.c and common/GptLib.c unchanged. The UART
+     handler calls UrtWriteIsr() and MbsRxIsr() like UART_Int_Handler of
+     examples/CN0221/Thermocouple_to_UART.c. Timer 0 is counted down by the main loop:
+     MbsTmrIsr() runs once the timer is enabled and no byte came for the time set
+     by MbsCfg() in T0LD.
+   - Acts as the master on the pty, with its own bitwise CRC, and checks every
+     response byte for byte:
+       03/04   reads of 16 bit, 32 bit and float registers, across blocks and from
+               the low half of a 32 bit value.
+       06/16   writes, checked in the application variables.
+       01      unsupported function.
+       02      unmapped, read only or half of a 32 bit value.
+       03      count out of range or byte count that does not match.
+       silent  other slave address, bad CRC, short frame and broadcast (executed).
+   - First checks the T0LD and prescaler MbsCfg() sets down to 37 baud, and that it
+     refuses 36 baud, whose 3.5 characters do not fit in the timer.
+   - Also checks the MbsSta() counters and reports the turnaround, from the last
+     request byte sent to the first response byte read.
+   Prints one line per request and exits with 1 if any failed.
+
+   Build:  gcc -O2 -Ihost -o MbsTest MbsTest.c UrtSim.c ../common/MbsLib.c ../common/UrtLib.c
+                ../common/GptLib.c -lpthread
+
+   Usage:  MbsTest [-b baud]
+   - -b : baud rate, default 19200.
+
+   @version  V0.1
+   @date     October 2026
+
+**/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "UrtSim.h"
+#include "../common/MbsLib.h"
+#include "../common/UrtLib.h"
+#include "../common/GptLib.h"
+#include "../common/ClkLib.h"
+
+#define SLAVE		17
+#define NO_RSP		-1					// expected length of a request not answered
+
+static ADI_TIMER_TypeDef Tm0, Tm1;
+ADI_TIMER_TypeDef *pADI_TM0 = &Tm0;
+ADI_TIMER_TypeDef *pADI_TM1 = &Tm1;
+
+static long lBaud = 19200;
+static volatile double dLastRx = 0;		// time of the last byte given to MbsRxIsr()
+static unsigned long ulSent = 0;		// bytes written to the pty by the master
+static int iFd = -1;
+static int iFailed = 0;
+static double dTurnMax = 0;
+
+// Holding registers 0-3 U16, 4-5 F32, 6-7 U32 read only, 8 U16 read only
+static volatile unsigned short usHold[4] = {0x1234, 0x5678, 0x9ABC, 0xDEF0};
+static volatile float fHold = 25.5f;		// 0x41CC0000
+static volatile unsigned long ulHoldRo = 0xDEADBEEF;
+static volatile unsigned short usHoldRo = 0x0102;
+// Input registers 0-1 F32, 2 U16
+static volatile float fInput = -1.0f;		// 0xBF800000
+static volatile unsigned short usInput = 0x8001;
+
+static const MbsMap Hold[] = {
+	{0, 4, usHold, MBS_U16, 1},
+	{4, 2, &fHold, MBS_F32, 1},
+	{6, 2, &ulHoldRo, MBS_U32, 0},
+	{8, 1, &usHoldRo, MBS_U16, 0}};
+static const MbsMap Input[] = {
+	{0, 2, &fInput, MBS_F32, 0},
+	{2, 1, &usInput, MBS_U16, 0}};
+
+static void UartIsr(void)
+{
+	int iIir = UrtIntSta(pADI_UART);
+
+	if ((iIir & 0x2) == 0x2)
+		UrtWriteIsr(pADI_UART);
+	if ((iIir & 0x4) == 0x4)
+	{
+		MbsRxIsr(UrtRx(pADI_UART));
+		dLastRx = UrtSimNow();
+	}
+}
+
+// Frame timer: count down from T0LD while enabled, restarted by each byte. The
+// master sends its frames without gaps, so a gap while it still has bytes on the
+// line is the host late to run the simulator, not the end of the frame.
+static void Tm0Poll(void)
+{
+	double dTick = ((Tm0.CON & 3) == TCON_PRE_DIV256 ? 256.0 : 16.0)/ClkFreq(CLK_FREQ_CORE);
+
+	UrtSimLock();
+	if ((Tm0.CON & TCON_ENABLE) && (UrtSimSta(URT_SIM_RX) == ulSent) &&
+		(UrtSimNow() - dLastRx >= Tm0.LD*dTick))
+		MbsTmrIsr();
+	UrtSimUnlock();
+}
+
+// CRC-16/MODBUS, bit by bit
+static int Crc(const unsigned char *pBuf, int iLen)
+{
+	unsigned int uiCrc = 0xFFFF;
+	int i;
+
+	while (iLen-- > 0)
+	{
+		uiCrc ^= *pBuf++;
+		for (i = 0; i < 8; i++)
+			uiCrc = (uiCrc & 1) ? (uiCrc >> 1) ^ 0xA001 : uiCrc >> 1;
+	}
+	return (int)uiCrc;
+}
+
+static void Wait(double dSeconds)
+{
+	double dEnd = UrtSimNow() + dSeconds;
+
+	while (UrtSimNow() < dEnd)
+	{
+		Tm0Poll();
+		usleep(50);
+	}
+}
+
+// Send a request with its CRC, or with a wrong one, and read the response. Returns its length.
+static int Transact(const unsigned char *pReq, int iLen, int iBadCrc, unsigned char *pRsp, double *pdTurn)
+{
+	unsigned char ucFrame[MBS_FRAME_MAX + 2];
+	double dChar = 10.0/UrtSimBaud();			// 8N1
+	double dSent, dLast;
+	int iCrc, iRsp = 0;
+
+	*pdTurn = 0;
+	memcpy(ucFrame, pReq, iLen);
+	iCrc = Crc(pReq, iLen) ^ iBadCrc;
+	ucFrame[iLen++] = (unsigned char)iCrc;
+	ucFrame[iLen++] = (unsigned char)(iCrc >> 8);
+	while (read(iFd, pRsp, MBS_FRAME_MAX) > 0)
+		;									// late bytes of a previous response
+	if (write(iFd, ucFrame, iLen) != iLen)
+		return 0;
+	ulSent += iLen;
+	// The request leaves the pty at the baud rate
+	dSent = UrtSimNow() + iLen*dChar;
+	dLast = dSent;
+	while (UrtSimNow() - dLast < 20*dChar + 0.02)
+	{
+		int n = read(iFd, pRsp + iRsp, MBS_FRAME_MAX - iRsp);
+
+		if (n > 0)
+		{
+			if (iRsp == 0)
+				*pdTurn = UrtSimNow() - dSent;
+			iRsp += n;
+			dLast = UrtSimNow();
+		}
+		Tm0Poll();
+		usleep(50);
+	}
+	return iRsp;
+}
+
+// One request and its expected response, NO_RSP if none
+static void Check(const char *szName, const unsigned char *pReq, int iLen, int iBadCrc,
+				  const unsigned char *pExp, int iExp)
+{
+	unsigned char ucRsp[MBS_FRAME_MAX];
+	double dTurn;
+	int iRsp = Transact(pReq, iLen, iBadCrc, ucRsp, &dTurn);
+	int iOk, i;
+
+	if (iExp == NO_RSP)
+		iOk = iRsp == 0;
+	else
+		iOk = (iRsp == iExp + 2) && !memcmp(ucRsp, pExp, iExp) && (Crc(ucRsp, iRsp) == 0);
+	printf("%-22s %s  ", szName, iOk ? "ok    " : "FAILED");
+	for (i = 0; i < iRsp; i++)
+		printf(" %02X", ucRsp[i]);
+	if (iRsp)
+		printf("  (%.2fms)", dTurn*1e3);
+	printf("\n");
+	if (!iOk)
+	{
+		printf("%-22s expected", "");
+		for (i = 0; i < iExp; i++)
+			printf(" %02X", pExp[i]);
+		printf(iExp == NO_RSP ? " nothing\n" : " + CRC\n");
+		iFailed = 1;
+	}
+	if (dTurn > dTurnMax)
+		dTurnMax = dTurn;
+}
+
+static void CheckVal(const char *szName, unsigned long ulGot, unsigned long ulExp)
+{
+	if (ulGot == ulExp)
+		return;
+	printf("%-22s FAILED   %lX, expected %lX\n", szName, ulGot, ulExp);
+	iFailed = 1;
+}
+
+static unsigned long F32Bits(float f)
+{
+	unsigned int ui;
+
+	memcpy(&ui, &f, 4);
+	return ui;
+}
+
+#define CHECK(name, req, bad, ...)	do { static const unsigned char r[] = req, e[] = {__VA_ARGS__}; \
+		Check(name, r, sizeof(r), bad, e, sizeof(e)); } while (0)
+#define SILENT(name, req, bad)		do { static const unsigned char r[] = req; \
+		Check(name, r, sizeof(r), bad, 0, NO_RSP); } while (0)
+#define REQ(...)	{__VA_ARGS__}
+
+int main(int argc, char *argv[])
+{
+	int iFrames, iCrcErr, iExc;
+
+	if ((argc == 3) && !strcmp(argv[1], "-b"))
+		lBaud = atol(argv[2]);
+	else if (argc != 1)
+	{
+		fprintf(stderr, "usage: MbsTest [-b baud]\n");
+		return 2;
+	}
+	CheckVal("crc 123456789", MbsCrc16((const unsigned char *)"123456789", 9), 0x4B37);
+	// 38500000/baud us of PCLK/16 counts at 1MHz, /16 again above 0xFFFF
+	CheckVal("cfg 115200", MbsCfg(pADI_UART, pADI_TM0, SLAVE, 115200) && ((Tm0.CON & 3) == TCON_PRE_DIV16), 1);
+	CheckVal("  T0LD", Tm0.LD, 1750);
+	CheckVal("cfg 300", MbsCfg(pADI_UART, pADI_TM0, SLAVE, 300) && ((Tm0.CON & 3) == TCON_PRE_DIV256), 1);
+	CheckVal("  T0LD", Tm0.LD, 128333/16);
+	CheckVal("cfg 50", MbsCfg(pADI_UART, pADI_TM0, SLAVE, 50) && ((Tm0.CON & 3) == TCON_PRE_DIV256), 1);
+	CheckVal("  T0LD", Tm0.LD, 770000/16);
+	CheckVal("cfg 37", MbsCfg(pADI_UART, pADI_TM0, SLAVE, 37) && ((Tm0.CON & 3) == TCON_PRE_DIV256), 1);
+	CheckVal("  T0LD", Tm0.LD, 1040540/16);
+	CheckVal("cfg 36", MbsCfg(pADI_UART, pADI_TM0, SLAVE, 36), 0);
+	if (!UrtSimStart(UartIsr, 0))
+	{
+		perror("pty");
+		return 1;
+	}
+	iFd = open(UrtSimPty(), O_RDWR|O_NOCTTY|O_NONBLOCK);		// raw, set by UrtSimStart()
+	UrtSimLock();
+	UrtCfg(pADI_UART, B9600, COMLCR_WLS_8BITS, 0);
+	UrtBaud(pADI_UART, lBaud);
+	if (!MbsCfg(pADI_UART, pADI_TM0, SLAVE, lBaud))
+		iFailed = 1;
+	MbsMapCfg(Hold, 4, Input, 2);
+	UrtIntCfg(pADI_UART, COMIEN_ERBFI);
+	UrtSimUnlock();
+	printf("%s, %.0f baud, slave %d, end of frame after %.2fms\n", UrtSimPty(), UrtSimBaud(), SLAVE,
+			Tm0.LD*((Tm0.CON & 3) == TCON_PRE_DIV256 ? 256.0 : 16.0)/ClkFreq(CLK_FREQ_CORE)*1e3);
+
+	CHECK("03 read 0-8", REQ(SLAVE, 3, 0, 0, 0, 9), 0,
+		SLAVE, 3, 18, 0x12, 0x34, 0x56, 0x78, 0x9A, 0xBC, 0xDE, 0xF0,
+		0x41, 0xCC, 0x00, 0x00, 0xDE, 0xAD, 0xBE, 0xEF, 0x01, 0x02);
+	CHECK("03 read 5-6", REQ(SLAVE, 3, 0, 5, 0, 2), 0,
+		SLAVE, 3, 4, 0x00, 0x00, 0xDE, 0xAD);
+	CHECK("04 read 0-2", REQ(SLAVE, 4, 0, 0, 0, 3), 0,
+		SLAVE, 4, 6, 0xBF, 0x80, 0x00, 0x00, 0x80, 0x01);
+	CHECK("06 write 1", REQ(SLAVE, 6, 0, 1, 0xAB, 0xCD), 0,
+		SLAVE, 6, 0, 1, 0xAB, 0xCD);
+	CheckVal("  usHold[1]", usHold[1], 0xABCD);
+	CHECK("16 write 2-5", REQ(SLAVE, 16, 0, 2, 0, 4, 8, 0x11, 0x22, 0x33, 0x44, 0x42, 0x48, 0x00, 0x00), 0,
+		SLAVE, 16, 0, 2, 0, 4);
+	CheckVal("  usHold[2]", usHold[2], 0x1122);
+	CheckVal("  usHold[3]", usHold[3], 0x3344);
+	CheckVal("  fHold", F32Bits(fHold), F32Bits(50.0f));
+	CHECK("03 read back 0-5", REQ(SLAVE, 3, 0, 0, 0, 6), 0,
+		SLAVE, 3, 12, 0x12, 0x34, 0xAB, 0xCD, 0x11, 0x22, 0x33, 0x44, 0x42, 0x48, 0x00, 0x00);
+
+	CHECK("exc 01 function 01", REQ(SLAVE, 1, 0, 0, 0, 1), 0, SLAVE, 0x81, 1);
+	CHECK("exc 01 function 05", REQ(SLAVE, 5, 0, 0, 0xFF, 0), 0, SLAVE, 0x85, 1);
+	CHECK("exc 02 read 9", REQ(SLAVE, 3, 0, 9, 0, 1), 0, SLAVE, 0x83, 2);
+	CHECK("exc 02 read 7-9", REQ(SLAVE, 3, 0, 7, 0, 3), 0, SLAVE, 0x83, 2);
+	CHECK("exc 02 input 3", REQ(SLAVE, 4, 0, 3, 0, 1), 0, SLAVE, 0x84, 2);
+	CHECK("exc 02 write ro 8", REQ(SLAVE, 6, 0, 8, 0, 0), 0, SLAVE, 0x86, 2);
+	CHECK("exc 02 write half 4", REQ(SLAVE, 6, 0, 4, 0, 0), 0, SLAVE, 0x86, 2);
+	CHECK("exc 02 write 3-4", REQ(SLAVE, 16, 0, 3, 0, 2, 4, 0, 0, 0, 0), 0, SLAVE, 0x90, 2);
+	CheckVal("  usHold[3] kept", usHold[3], 0x3344);
+	CHECK("exc 03 read 0 regs", REQ(SLAVE, 3, 0, 0, 0, 0), 0, SLAVE, 0x83, 3);
+	CHECK("exc 03 read 126 regs", REQ(SLAVE, 4, 0, 0, 0, 126), 0, SLAVE, 0x84, 3);
+	CHECK("exc 03 byte count", REQ(SLAVE, 16, 0, 0, 0, 2, 3, 0, 0, 0, 0), 0, SLAVE, 0x90, 3);
+	CHECK("exc 03 06 length", REQ(SLAVE, 6, 0, 0, 0, 0, 0), 0, SLAVE, 0x86, 3);
+
+	SILENT("other slave", REQ(SLAVE + 1, 3, 0, 0, 0, 1), 0);
+	SILENT("bad crc", REQ(SLAVE, 3, 0, 0, 0, 1), 0x0100);
+	SILENT("short frame", REQ(SLAVE, 3, 0, 0), 0);
+	SILENT("broadcast 06 write 0", REQ(0, 6, 0, 0, 0x55, 0xAA), 0);
+	CheckVal("  usHold[0]", usHold[0], 0x55AA);
+	CHECK("03 after errors", REQ(SLAVE, 3, 0, 0, 0, 1), 0, SLAVE, 3, 2, 0x55, 0xAA);
+	Wait(0.01);
+
+	UrtSimLock();
+	iFrames = MbsSta(MBS_STA_FRAMES);
+	iCrcErr = MbsSta(MBS_STA_CRC);
+	iExc = MbsSta(MBS_STA_EXC);
+	UrtSimUnlock();
+	printf("counters: %d frames, %d crc, %d exceptions, %d tx full, turnaround max %.2fms\n",
+			iFrames, iCrcErr, iExc, MbsSta(MBS_STA_TXFULL), dTurnMax*1e3);
+	CheckVal("MBS_STA_FRAMES", iFrames, 19);
+	CheckVal("MBS_STA_CRC", iCrcErr, 2);
+	CheckVal("MBS_STA_EXC", iExc, 12);
+	UrtSimStop();
+	printf("%s\n", iFailed ? "FAILED" : "all passed");
+	return iFailed;
+}
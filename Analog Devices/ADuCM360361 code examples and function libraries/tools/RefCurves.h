@@ -0,0 +1,88 @@
+/**
+ *****************************************************************************
+   @file     RefCurves.h
+   @brief    Reference sensor curves for the host tools.
+   - RefTcE() : Type T thermocouple voltage in mV for a temperature in degC (NIST ITS-90).
+   - RefTcT() : inverse of RefTcE(), solved numerically.
+   - RefRtdR() : PT100 resistance in ohms for a temperature in degC (Callendar-Van Dusen, IEC 60751).
+   - RefRtdT() : inverse of RefRtdR(), solved numerically.
+   These are the curves the TempCalc lookup tables were derived from. They are
+   evaluated in double precision and are only meant for host side tools.
+
+   @version  V0.1
+   @date     October 2026
+
+**/
+
+#ifndef REFCURVES_H
+#define REFCURVES_H
+
+#include <math.h>
+
+// NIST ITS-90 Type T coefficients, -270degC to 0degC
+static const double C_dRefTcNeg[15] = {0.0,
+	0.387481063640E-01, 0.441944343470E-04, 0.118443231050E-06, 0.200329735540E-07,
+	0.901380195590E-09, 0.226511565930E-10, 0.360711542050E-12, 0.384939398830E-14,
+	0.282135219250E-16, 0.142515947790E-18, 0.487686622860E-21, 0.107955392700E-23,
+	0.139450270620E-26, 0.797951539270E-30};
+// NIST ITS-90 Type T coefficients, 0degC to 400degC
+static const double C_dRefTcPos[9] = {0.0,
+	0.387481063640E-01, 0.332922278800E-04, 0.206182434040E-06, -0.218822568460E-08,
+	0.109968809280E-10, -0.308157587720E-13, 0.454791352900E-16, -0.275129016730E-19};
+
+// IEC 60751 PT100 coefficients
+#define REF_RTD_R0	(100.0)
+#define REF_RTD_A	(3.9083E-3)
+#define REF_RTD_B	(-5.775E-7)
+#define REF_RTD_C	(-4.183E-12)
+
+// Thermocouple voltage in mV at temperature dT in degC
+static __inline double RefTcE(double dT)
+{
+	const double *pC = (dT < 0) ? C_dRefTcNeg : C_dRefTcPos;
+	int iN = (dT < 0) ? 15 : 9;
+	double dE = 0.0;
+
+	while (iN-- > 0)
+		dE = dE*dT + pC[iN];
+	return dE;
+}
+
+// PT100 resistance in ohms at temperature dT in degC
+static __inline double RefRtdR(double dT)
+{
+	double dC = (dT < 0) ? REF_RTD_C : 0.0;
+
+	return REF_RTD_R0*(1.0 + REF_RTD_A*dT + REF_RTD_B*dT*dT + dC*(dT-100.0)*dT*dT*dT);
+}
+
+// Solve pfForward(t) = dY for t by bisection; both curves are monotonic in their range
+static __inline double RefInvert(double (*pfForward)(double), double dY, double dLo, double dHi)
+{
+	int i;
+	double dMid = 0.0;
+
+	for (i = 0; i < 100; i++)
+	{
+		dMid = 0.5*(dLo + dHi);
+		if (pfForward(dMid) < dY)
+			dLo = dMid;
+		else
+			dHi = dMid;
+	}
+	return dMid;
+}
+
+// Thermocouple temperature in degC for a voltage dMv in mV
+static __inline double RefTcT(double dMv)
+{
+	return RefInvert(RefTcE, dMv, -270.0, 400.0);
+}
+
+// RTD temperature in degC for a resistance dR in ohms
+static __inline double RefRtdT(double dR)
+{
+	return RefInvert(RefRtdR, dR, -200.0, 850.0);
+}
+
+#endif
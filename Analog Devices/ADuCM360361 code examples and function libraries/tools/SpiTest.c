@@ -0,0 +1,644 @@
+/**
+ *****************************************************************************
+   @file     SpiTest.c
+   @brief    Host test of the interrupt driven SpiXfer() transfers of common/SpiLib.c.
+   - Runs a copy of common/SpiLib.c in which SPITX writes, SPIRX reads and the FIFO
+     flushes call SpiHostTx(), SpiHostRx() and SpiHostFlush(), against a model of
+     the 4-byte FIFOs of SPI0 and SPI1. One byte leaves the Tx FIFO per Clock(),
+     the slave answer goes to the Rx FIFO and SPICNT counts it. The interrupt is
+     raised when the Tx FIFO is empty, as with SPICON_TIM_TXWR, and served after a
+     random delay.
+   - xfer    Random transfers of 1 to XFER_MAX bytes on both SPIs at once, with
+             pTx = 0, pRx = 0 or pRx = pTx, stale bytes in the Rx FIFO before the start,
+             SpiXferIsr() called again between interrupts and SpiXfer() called
+             while busy. Every block must be SPI_FIFO bytes or the rest of the
+             transfer with SPICON_MOD set to match, every byte sent once and in order,
+             every byte received in place, the buffers untouched past the end, and
+             SpiXferIsr() and SpiXferSta() must give the bytes left and the counters.
+   - lost    The same with the Rx FIFO dropping the end of some blocks. The missing
+             bytes must read as 0 and be counted in SPI_XFER_LOST.
+   - wait    SpiXfer() and SpiXferWait() on SPI0 with the bus clocked from a timer
+             signal, as by the SPI0 interrupt on the device.
+   - baud    SpiBaudHz() and SpiFreq() with random SPI0 and SPI1 clocks from ClkFreq()
+             and random targets, exact rates and extreme values. The divider must
+             give the fastest rate not above the target, or the slowest one, the
+             return value and SpiFreq() must be the rate set, CS error detection
+             must be as asked and the other SPI left alone.
+   - prof    Built with SPI_PROF defined, after xfer, lost and wait: SpiProfRd() of
+             each device against the transfers the test started on it with
+             SpiProfDev(), the SpiProfXferAdd() calls and, for wait, the time in
+             SpiXferWait(). The timer counts the bytes sent, up for xfer and wait and
+             down for lost.
+   Prints one line per test and exits with 1 if any failed.
+
+   Build:  sed -e 's/pSPI->SPITX = \(.*\);/SpiHostTx(pSPI,\1);/' -e 's/pSPI->SPIRX;/SpiHostRx(pSPI);/' \
+               -e 's/pSPI->SPICON\t|= \(0x[12]000\);/SpiHostFlush(pSPI,\1);/' ../common/SpiLib.c > SpiHost.c
+           gcc -O2 -Ihost -I../common -o SpiTest SpiTest.c SpiHost.c
+   or, to check the profiles too:
+           gcc -O2 -DSPI_PROF -Ihost -I../common -o SpiTest SpiTest.c SpiHost.c
+   SPITX and SPIRX are plain memory in host/ADuCM360.h, the sed line makes the copy
+   that goes through the FIFO model.
+
+   Usage:  SpiTest [-n transfers] [-s seed]
+   - -n : transfers per test, default 100000.
+   - -s : seed of rand(), default 1.
+
+   @version  V0.1
+   @date     October 2026
+
+**/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <sys/time.h>
+#include <limits.h>
+#include "SpiLib.h"
+#include "ClkLib.h"
+
+#define XFER_MAX	40					// longest transfer
+#define GUARD		4					// bytes checked past the end of the buffers
+
+static ADI_SPI_TypeDef Spi0, Spi1;
+ADI_SPI_TypeDef *pADI_SPI0 = &Spi0;
+ADI_SPI_TypeDef *pADI_SPI1 = &Spi1;
+
+static int iFailed = 0;
+
+// FIFO model and the transfer the test expects on one SPI
+typedef struct
+{
+	ADI_SPI_TypeDef *pSPI;
+	unsigned char ucTxFifo[SPI_FIFO], ucRxFifo[SPI_FIFO];
+	int iTxNum, iRxNum;
+	int iBlock;							// bytes of the block being sent, 0 before its first byte
+	int iLosing;						// the Rx FIFO drops the rest of the block
+	int iIrq;							// interrupt pending
+	unsigned long ulErr;				// FIFO misuse and wrong bytes sent
+	int iBusy, iLen, iSent, iMode;		// iMode: 0 pTx and pRx, 1 pTx = 0, 2 pRx = 0, 3 pRx = pTx
+	int iSteps;							// test steps since SpiXfer()
+	int iDev, iSel;						// profile of the transfer, selected with SpiProfDev()
+	unsigned short usStart;				// timer at SpiXfer()
+	unsigned char ucTx[XFER_MAX+GUARD], ucRx[XFER_MAX+GUARD];
+	unsigned char ucSent[XFER_MAX];		// pTx before the transfer
+	unsigned char ucMiso[XFER_MAX];		// slave answer
+	unsigned char ucExp[XFER_MAX];		// bytes the buffer must hold, 0 where lost
+	unsigned long ulIsr, ulLost, ulBytes;	// SpiXferSta() counters
+	unsigned long ulIrqs;				// interrupts raised
+} Model;
+
+static Model Spi[2];
+static int iLoseP = 0;					// 1 in iLoseP bytes starts a loss, 0 none
+static unsigned long ulRun, ulBad;
+static volatile unsigned long ulTicks = 0;	// timer signals of the wait test
+
+#ifdef SPI_PROF
+// Profiling timer, one tick per byte sent, and the profiles SpiLib should hold
+static ADI_TIMER_TypeDef Tmr;
+static SPI_PROF_DEV Prof[SPI_PROF_DEVS];
+
+static unsigned short ProfTicks(unsigned short usFrom, unsigned short usTo)
+{
+	return (Tmr.CON & TCON_UP) ? (unsigned short)(usTo - usFrom) : (unsigned short)(usFrom - usTo);
+}
+
+static void ProfAdd(int iDev, unsigned short usStart, int iBytes)
+{
+	SPI_PROF_DEV *pP = &Prof[iDev];
+	unsigned long ulTicks = ProfTicks(usStart, Tmr.VAL);
+
+	pP->ulXfers++;
+	pP->ulBytes += (unsigned long)iBytes;
+	pP->ulBusy += ulTicks;
+	if (ulTicks > pP->ulMax)
+		pP->ulMax = ulTicks;
+	pP->usStart = usStart;
+	pP->usEnd = Tmr.VAL;
+}
+
+static void ProfSel(Model *pM, int iDev)
+{
+	SpiProfDev(pM->pSPI, iDev);
+	pM->iSel = iDev;
+}
+#endif
+
+static Model *Mod(ADI_SPI_TypeDef *pSPI)
+{
+	return &Spi[pSPI == pADI_SPI1];
+}
+
+static void Sta(Model *pM)
+{
+	pM->pSPI->SPISTA = (uint16_t)((pM->iRxNum << 8) | (pM->iTxNum << 1));
+}
+
+void SpiHostTx(ADI_SPI_TypeDef *pSPI, int iTx)
+{
+	Model *pM = Mod(pSPI);
+
+	if (pM->iTxNum == SPI_FIFO)
+		pM->ulErr++;
+	else
+		pM->ucTxFifo[pM->iTxNum++] = (unsigned char)iTx;
+	Sta(pM);
+}
+
+int SpiHostRx(ADI_SPI_TypeDef *pSPI)
+{
+	Model *pM = Mod(pSPI);
+	int iRx;
+
+	if (pM->iRxNum == 0)
+	{
+		pM->ulErr++;
+		return 0;
+	}
+	iRx = pM->ucRxFifo[0];
+	memmove(pM->ucRxFifo, pM->ucRxFifo + 1, --pM->iRxNum);
+	Sta(pM);
+	return iRx;
+}
+
+void SpiHostFlush(ADI_SPI_TypeDef *pSPI, int iFlush)
+{
+	Model *pM = Mod(pSPI);
+
+	if (iFlush == SPICON_TFLUSH_EN)
+		pM->iTxNum = 0;
+	if (iFlush == SPICON_RFLUSH_EN)
+		pM->iRxNum = 0;
+	Sta(pM);
+}
+
+// SpiProfRd() masks interrupts, only the timer signal of the wait test here
+static unsigned long ulPriMask = 0;
+
+unsigned long __get_PRIMASK(void)
+{
+	return ulPriMask;
+}
+
+void __disable_irq(void)
+{
+	sigset_t Set;
+
+	sigemptyset(&Set);
+	sigaddset(&Set, SIGALRM);
+	sigprocmask(SIG_BLOCK, &Set, 0);
+	ulPriMask = 1;
+}
+
+void __set_PRIMASK(unsigned long ulPm)
+{
+	sigset_t Set;
+
+	ulPriMask = ulPm;
+	if (ulPm)
+		return;
+	sigemptyset(&Set);
+	sigaddset(&Set, SIGALRM);
+	sigprocmask(SIG_UNBLOCK, &Set, 0);
+}
+
+// SpiBaudHz() and SpiFreq() read the SPI clock
+static long lClkHz[2] = {16000000, 16000000};	// SPI0 and SPI1
+
+long ClkFreq(int iClk)
+{
+	if (iClk == CLK_FREQ_SPI0)
+		return lClkHz[0];
+	if (iClk == CLK_FREQ_SPI1)
+		return lClkHz[1];
+	return 0;
+}
+
+// One byte time of the bus
+static void Clock(Model *pM)
+{
+	int iNum;
+
+	if (pM->iTxNum == 0)
+		return;
+	if (pM->iBlock == 0)
+	{
+		// a block is SPI_FIFO bytes or the rest, with the IRQ threshold on its last byte
+		iNum = pM->iLen - pM->iSent;
+		if (iNum > SPI_FIFO)
+			iNum = SPI_FIFO;
+		if ((pM->iTxNum != iNum) || (((pM->pSPI->SPICON & SPICON_MOD_MSK) >> 14) + 1 != iNum))
+			pM->ulErr++;
+		pM->iBlock = pM->iTxNum;
+	}
+	if ((pM->iSent >= pM->iLen) || (pM->ucTxFifo[0] != ((pM->iMode == 1) ? 0xFF : pM->ucSent[pM->iSent])))
+		pM->ulErr++;
+	memmove(pM->ucTxFifo, pM->ucTxFifo + 1, --pM->iTxNum);
+	pM->pSPI->SPICNT = (uint16_t)((pM->pSPI->SPICNT + 1) & 0xFF);
+	if (iLoseP && (rand() % iLoseP == 0))
+		pM->iLosing = 1;
+	if (pM->iSent < pM->iLen)
+	{
+		if (pM->iLosing)
+		{
+			pM->ucExp[pM->iSent] = 0;
+			pM->ulLost++;
+		}
+		else if (pM->iRxNum == SPI_FIFO)
+			pM->ulErr++;
+		else
+		{
+			pM->ucRxFifo[pM->iRxNum++] = pM->ucMiso[pM->iSent];
+			pM->ucExp[pM->iSent] = pM->ucMiso[pM->iSent];
+		}
+		pM->iSent++;
+	}
+	Sta(pM);
+#ifdef SPI_PROF
+	Tmr.VAL = (Tmr.CON & TCON_UP) ? Tmr.VAL + 1 : Tmr.VAL - 1;
+#endif
+	if (pM->iTxNum)
+		return;
+	pM->iBlock = 0;
+	pM->iLosing = 0;
+	pM->iIrq = 1;
+	pM->ulIrqs++;
+}
+
+// Compare the buffers and the counters at the end of a transfer
+static void End(Model *pM)
+{
+	const unsigned char *pBuf = (pM->iMode == 3) ? pM->ucTx : pM->ucRx;
+	int iBad = 0, i;
+
+	pM->iBusy = 0;
+	pM->ulBytes += (unsigned long)pM->iLen;
+	if (pM->iMode == 2)
+	{
+		for (i = 0; i < XFER_MAX + GUARD; i++)
+			if (pM->ucRx[i] != 0xA5)
+				iBad = 1;
+	}
+	else
+	{
+		if (memcmp(pBuf, pM->ucExp, (size_t)pM->iLen))
+			iBad = 1;
+		for (i = pM->iLen; i < pM->iLen + GUARD; i++)
+			if (pBuf[i] != 0xA5)
+				iBad = 1;
+	}
+	if (pM->iTxNum || pM->iRxNum || pM->ulErr ||
+		(SpiXferSta(pM->pSPI, SPI_XFER_BYTES) != pM->ulBytes) ||
+		(SpiXferSta(pM->pSPI, SPI_XFER_IRQ) != pM->ulIsr) ||
+		(SpiXferSta(pM->pSPI, SPI_XFER_LOST) != pM->ulLost))
+		iBad = 1;
+	ulBad += (unsigned long)iBad;
+	ulRun++;
+	pM->ulErr = 0;
+#ifdef SPI_PROF
+	ProfAdd(pM->iDev, pM->usStart, pM->iLen);
+#endif
+}
+
+// SPIx_Int_Handler
+static void Isr(Model *pM)
+{
+	int iLeft, iExp = pM->iBusy ? pM->iLen - pM->iSent : 0;
+
+	pM->iIrq = 0;
+	if (pM->iBusy)
+		pM->ulIsr++;
+	iLeft = SpiXferIsr(pM->pSPI);
+	if ((iLeft != iExp) || (SpiXferSta(pM->pSPI, SPI_XFER_LEFT) != (unsigned long)iExp))
+		pM->ulErr++;
+	if (pM->iBusy && (iExp == 0))
+		End(pM);
+}
+
+static void Start(Model *pM)
+{
+	unsigned char *pTx, *pRx;
+	int i;
+
+	pM->iLen = (rand() & 1) ? 1 + rand() % XFER_MAX : 1 + rand() % (2*SPI_FIFO + 1);
+	pM->iMode = rand() % 4;
+	for (i = 0; i < XFER_MAX; i++)
+	{
+		pM->ucTx[i] = (unsigned char)rand();
+		pM->ucMiso[i] = (unsigned char)rand();
+	}
+	memset(pM->ucTx + pM->iLen, 0xA5, GUARD);
+	memset(pM->ucRx, 0xA5, sizeof(pM->ucRx));
+	memcpy(pM->ucSent, pM->ucTx, sizeof(pM->ucSent));
+	pTx = (pM->iMode == 1) ? 0 : pM->ucTx;
+	pRx = (pM->iMode == 2) ? 0 : ((pM->iMode == 3) ? pM->ucTx : pM->ucRx);
+	// bytes left in the Rx FIFO by someone else, SpiXfer() flushes them
+	pM->iRxNum = rand() % 3;
+	Sta(pM);
+	pM->iSent = 0;
+	pM->iBlock = 0;
+	pM->iLosing = 0;
+	pM->iSteps = 0;
+#ifdef SPI_PROF
+	if (rand() & 1)
+		ProfSel(pM, rand() % SPI_PROF_DEVS);
+	pM->iDev = pM->iSel;
+	pM->usStart = Tmr.VAL;
+#endif
+	pM->iBusy = 1;
+	if (SpiXfer(pM->pSPI, pTx, pRx, pM->iLen) != 1)
+	{
+		pM->ulErr++;
+		pM->iBusy = 0;
+	}
+}
+
+static void Init(void)
+{
+	int i;
+
+	for (i = 0; i < 2; i++)
+	{
+		Model *pM = &Spi[i];
+		ADI_SPI_TypeDef *pSPI = i ? pADI_SPI1 : pADI_SPI0;
+
+		memset(pM, 0, sizeof(Model));
+		pM->pSPI = pSPI;
+		SpiCfg(pSPI, SPICON_MOD_TX1RX1, SPICON_MASEN_EN, SPICON_CON_EN|SPICON_TIM_TXWR|SPICON_ENABLE_EN);
+		pSPI->SPICNT = (uint16_t)(rand() & 0xFF);
+		// counters from the tests before
+		pM->ulIsr = SpiXferSta(pSPI, SPI_XFER_IRQ);
+		pM->ulLost = SpiXferSta(pSPI, SPI_XFER_LOST);
+		pM->ulBytes = SpiXferSta(pSPI, SPI_XFER_BYTES);
+	}
+	ulRun = ulBad = 0;
+#ifdef SPI_PROF
+	// SpiProfCfg() clears the profiles, the device selections stay
+	Tmr.VAL = (uint16_t)rand();
+	SpiProfCfg(&Tmr);
+	memset(Prof, 0, sizeof(Prof));
+	Spi[0].iSel = 0;
+	Spi[1].iSel = 1;
+	SpiProfDev(pADI_SPI0, 0);
+	SpiProfDev(pADI_SPI1, 1);
+#endif
+}
+
+static void Result(const char *szTest, unsigned long ulRunT, unsigned long ulBadT, const char *szMore)
+{
+	printf("%-6s %8lu run, %6lu failed%s\n", szTest, ulRunT, ulBadT, szMore);
+	if (ulBadT)
+		iFailed = 1;
+}
+
+#ifdef SPI_PROF
+// Compare the profiles and clear them. The CPU waits may be up to ulSlack ticks
+// short of Prof[].ulWait, by the bytes sent before SpiXferWait() read the timer.
+static void ProfCheck(unsigned long ulSlack)
+{
+	static const SPI_PROF_DEV Zero;
+	SPI_PROF_DEV P;
+	unsigned long ulRunP = 0, ulBadP = 0;
+	unsigned short usT;
+	char szMore[80];
+	int i;
+
+	for (i = 0; i < SPI_PROF_DEVS; i++)
+	{
+		SPI_PROF_DEV *pE = &Prof[i];
+
+		if ((SpiProfRd(i, &P, 1) != 1) || (P.ulXfers != pE->ulXfers) || (P.ulBytes != pE->ulBytes) ||
+			(P.ulBusy != pE->ulBusy) || (P.ulMax != pE->ulMax) || (P.usStart != pE->usStart) ||
+			(P.usEnd != pE->usEnd) || (P.ulWait > pE->ulWait) || (P.ulWait + ulSlack < pE->ulWait))
+			ulBadP++;
+		if ((SpiProfRd(i, &P, 0) != 1) || memcmp(&P, &Zero, sizeof(P)))
+			ulBadP++;
+		ulRunP += pE->ulXfers;
+	}
+	if ((SpiProfRd(-1, &P, 0) != 0) || (SpiProfRd(SPI_PROF_DEVS, &P, 0) != 0) ||
+		(SpiProfDev(pADI_SPI0, -1) != 0) || (SpiProfDev(pADI_SPI1, SPI_PROF_DEVS) != 0))
+		ulBadP++;
+	// without a timer only the transfers and bytes are counted
+	SpiProfCfg(0);
+	usT = SpiProfTime();
+	SpiProfXferAdd(pADI_SPI1, usT, 5);
+	SPI_PROF_WAIT(pADI_SPI1, 0);
+	if ((SpiProfRd(Spi[1].iSel, &P, 1) != 1) || (P.ulXfers != 1) || (P.ulBytes != 5) || P.ulBusy || P.ulWait)
+		ulBadP++;
+	sprintf(szMore, ", timer counting %s", (Tmr.CON & TCON_UP) ? "up" : "down");
+	Result("prof", ulRunP, ulBadP, szMore);
+}
+#endif
+
+static void Xfers(const char *szTest, int iN, int iLose)
+{
+	unsigned char ucOther[4] = {0};
+	unsigned long ulBytes = 0, ulIrqs = 0, ulLost = 0;
+	char szMore[80];
+	int i;
+
+	iLoseP = iLose;
+#ifdef SPI_PROF
+	Tmr.CON = iLose ? 0 : TCON_UP;
+#endif
+	Init();
+	for (i = 0; i < 2; i++)
+		ulBytes -= Spi[i].ulBytes, ulLost -= Spi[i].ulLost;
+	while (ulRun < (unsigned long)iN)
+	{
+		Model *pM = &Spi[rand() & 1];
+
+		if (!pM->iBusy)
+		{
+			// SpiXferIsr() with no transfer running does nothing
+			if (rand() % 8 == 0)
+				Isr(pM);
+			Start(pM);
+			continue;
+		}
+		if (++pM->iSteps > 1000*XFER_MAX)
+		{
+			printf("transfer does not end\n");
+			exit(1);
+		}
+		switch (rand() % 8)
+		{
+		case 0:
+			Isr(pM);
+			break;
+		case 1:
+			if (SpiXfer(pM->pSPI, ucOther, ucOther, 4) != 0)
+				pM->ulErr++;
+#ifdef SPI_PROF
+			// the running transfer stays on its device
+			ProfSel(pM, rand() % SPI_PROF_DEVS);
+			if (rand() % 4 == 0)
+			{
+				// a transfer of another driver that started up to 1000 ticks ago
+				unsigned short usStart = (unsigned short)((Tmr.CON & TCON_UP) ? Tmr.VAL - rand() % 1000 : Tmr.VAL + rand() % 1000);
+				int iBytes = 1 + rand() % 8;
+
+				SpiProfXferAdd(pM->pSPI, usStart, iBytes);
+				ProfAdd(pM->iSel, usStart, iBytes);
+			}
+#endif
+			break;
+		default:
+			Clock(pM);
+			if (pM->iIrq && (rand() & 1))
+				Isr(pM);
+			break;
+		}
+	}
+	for (i = 0; i < 2; i++)
+	{
+		// finish the transfer still running
+		Model *pM = &Spi[i];
+		int k;
+
+		for (k = 0; pM->iBusy && (k < 4*XFER_MAX); k++)
+		{
+			Clock(pM);
+			if (pM->iIrq)
+				Isr(pM);
+		}
+		if (pM->iBusy)
+			ulBad++;
+		ulBytes += pM->ulBytes;
+		ulLost += pM->ulLost;
+		ulIrqs += pM->ulIrqs;
+	}
+	sprintf(szMore, ", %.2f bytes per interrupt, %lu lost", ulIrqs ? (double)ulBytes/ulIrqs : 0.0, ulLost);
+	Result(szTest, ulRun, ulBad, szMore);
+	iLoseP = 0;
+#ifdef SPI_PROF
+	ProfCheck(0);
+#endif
+}
+
+static void Tick(int iSig)
+{
+	Model *pM = &Spi[0];
+
+	(void)iSig;
+	if (ulPriMask)
+		return;
+	Clock(pM);
+	if (pM->iIrq)
+		Isr(pM);
+	if (++ulTicks > 1000000)
+	{
+		printf("SpiXferWait() does not end\n");
+		exit(1);
+	}
+}
+
+static void Wait(int iN)
+{
+	Model *pM = &Spi[0];
+	struct itimerval Tv;
+	int k;
+
+#ifdef SPI_PROF
+	Tmr.CON = TCON_UP;
+#endif
+	Init();
+	signal(SIGALRM, Tick);
+	memset(&Tv, 0, sizeof(Tv));
+	Tv.it_interval.tv_usec = Tv.it_value.tv_usec = 20;
+	setitimer(ITIMER_REAL, &Tv, 0);
+	for (k = 0; k < iN; k++)
+	{
+		ulTicks = 0;
+		Start(pM);
+		SpiXferWait(pADI_SPI0);
+		if (pM->iBusy || SpiXferSta(pADI_SPI0, SPI_XFER_LEFT))
+			ulBad++;
+	}
+	memset(&Tv, 0, sizeof(Tv));
+	setitimer(ITIMER_REAL, &Tv, 0);
+	signal(SIGALRM, SIG_DFL);
+	Result("wait", ulRun, ulBad, "");
+#ifdef SPI_PROF
+	// SpiXferWait() waits for all of each transfer, but a byte may leave before it starts
+	for (k = 0; k < SPI_PROF_DEVS; k++)
+		Prof[k].ulWait = Prof[k].ulBusy;
+	ProfCheck((unsigned long)iN);
+#endif
+}
+
+static void Baud(int iN)
+{
+	static const long lClks[6] = {16000000, 8000000, 4000000, 1000000, 125000, 32768};
+	static const long lOdd[5] = {0, -7, 1, LONG_MAX, 0x7FFFFFFF};
+	unsigned long ulSlow = 0;
+	char szMore[80];
+	int k;
+
+	ulRun = ulBad = 0;
+	for (k = 0; k < iN; k++)
+	{
+		int iSpi = rand() & 1, iCserr = (rand() & 1) ? SPIDIV_BCRST_EN : SPIDIV_BCRST_DIS, iDiv;
+		ADI_SPI_TypeDef *pSPI = iSpi ? pADI_SPI1 : pADI_SPI0;
+		ADI_SPI_TypeDef *pOther = iSpi ? pADI_SPI0 : pADI_SPI1;
+		long lClk, lHz, lGot;
+		uint16_t usOther;
+		int iBad = 0;
+
+		lClkHz[0] = (rand() & 1) ? lClks[rand() % 6] : 1 + rand() % 16000000;
+		lClkHz[1] = (rand() & 1) ? lClks[rand() % 6] : 1 + rand() % 16000000;
+		lClk = lClkHz[iSpi];
+		switch (rand() % 4)
+		{
+		case 0:		lHz = lOdd[rand() % 5];									break;
+		case 1:		lHz = lClk/(2*(1 + rand() % 64)) + rand() % 3 - 1;		break;
+		default:	lHz = 1 + rand() % lClk;								break;
+		}
+		pSPI->SPIDIV = (uint16_t)rand();
+		pOther->SPIDIV = usOther = (uint16_t)rand();
+		lGot = SpiBaudHz(pSPI, lHz, iCserr);
+		iDiv = pSPI->SPIDIV & 0x3F;
+		if (lHz < 1)
+			iBad = (lGot != 0);
+		else
+		{
+			// rates as reals: lClk/(2*(iDiv+1)) <= lHz unless iDiv is 63, and one less is above it
+			if ((pSPI->SPIDIV & ~0x3F) != iCserr)
+				iBad = 1;
+			if ((lGot != lClk/(2*(iDiv+1))) || (SpiFreq(pSPI) != lGot))
+				iBad = 1;
+			if ((iDiv < 63) && ((double)lClk > 2.0*(iDiv+1)*(double)lHz))
+				iBad = 1;
+			if ((iDiv > 0) && ((double)lClk <= 2.0*iDiv*(double)lHz))
+				iBad = 1;
+			if (iDiv == 63)
+				ulSlow++;
+		}
+		if (pOther->SPIDIV != usOther)
+			iBad = 1;
+		ulBad += (unsigned long)iBad;
+		ulRun++;
+	}
+	lClkHz[0] = lClkHz[1] = 16000000;
+	sprintf(szMore, ", %lu at the slowest divider", ulSlow);
+	Result("baud", ulRun, ulBad, szMore);
+}
+
+int main(int argc, char *argv[])
+{
+	int iN = 100000;
+	int i;
+
+	for (i = 1; i + 1 < argc; i += 2)
+	{
+		if (!strcmp(argv[i], "-n"))
+			iN = atoi(argv[i+1]);
+		else if (!strcmp(argv[i], "-s"))
+			srand(atoi(argv[i+1]));
+	}
+	Xfers("xfer", iN, 0);
+	Xfers("lost", iN, 16);
+	Wait(iN/100);
+	Baud(iN);
+	return iFailed;
+}
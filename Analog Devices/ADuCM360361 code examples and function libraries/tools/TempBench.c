@@ -0,0 +1,373 @@
+/**
+ *****************************************************************************
+   @file     TempBench.c
+   @brief    Host micro-benchmark for the temperature conversion path.
+   - Builds the original example code (TempCalcRef.c) as implementation A and
+     common/TempLib.h as implementation B. Either can be pointed at another file.
+   - Times CalculateRTDTemp(), CalculateThermoCoupleTemp(), CalculateColdJVoltage() and
+     the full CN0221 measurement cycle (sample averaging, RTD, cold junction, thermocouple).
+   - Reports ns per conversion, throughput, and max/RMS error against the NIST Type T
+     and IEC 60751 PT100 reference curves in RefCurves.h.
+   - Prints B against A so each change to the conversion path comes with numbers.
+
+   Build:  gcc -O2 -o TempBench TempBench.c -lm
+   A is the original TempCalc.c code by default. To compare against an earlier TempLib
+   instead, extract the common directory of that commit next to this file and point A
+   at it, from this directory:
+           mkdir -p old && git -C "$(git rev-parse --show-toplevel)" archive <commit> \
+               "Analog Devices/ADuCM360361 code examples and function libraries/common" \
+               | tar -x -C old --strip-components=2
+           gcc -O2 -DTEMPBENCH_IMPL_A='"old/common/TempLib.h"' -o TempBench TempBench.c -lm
+
+   Usage:  TempBench [-n conversions] [-r repeats] [-f recorded.txt] [-s seed]
+   - -n : inputs per sweep, default 1000000.
+   - -r : repeats per measurement, the fastest is reported. Default 5.
+   - -f : recorded ADC1DAT values, one "thermocouple_code rtd_code" pair per line,
+          SAMPLENO lines per measurement cycle. Without -f a slowly drifting trace
+          with ADC noise is synthesised.
+
+   @version  V0.1
+   @date     October 2026
+
+**/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "RefCurves.h"
+
+#ifndef TEMPBENCH_IMPL_A
+#define TEMPBENCH_IMPL_A "TempCalcRef.c"
+#endif
+#ifndef TEMPBENCH_IMPL_B
+#define TEMPBENCH_IMPL_B "../common/TempLib.h"
+#endif
+#define TEMPLIB_RTD						// sensors selected when an implementation is TempLib.h
+#define TEMPLIB_TC
+
+#define SAMPLENO		5				// samples per channel per cycle, as in Thermocouple_to_UART.c
+#define ADC_FS			268435456.0		// 2^28, ADC1DAT full scale
+#define ADC_VREF		1.2				// internal reference
+#define RTD_RREF		5600.0			// RTD reference resistor
+
+// Both builds define the same names, so every symbol is renamed per build
+// and TempBenchUndef.h drops the macros in between.
+#define CalculateRTDTemp			A_CalculateRTDTemp
+#define CalculateThermoCoupleTemp	A_CalculateThermoCoupleTemp
+#define CalculateColdJVoltage		A_CalculateColdJVoltage
+#define C_themocoupleP				A_C_themocoupleP
+#define C_themocoupleN				A_C_themocoupleN
+#define C_cold_junctionP			A_C_cold_junctionP
+#define C_cold_junctionN			A_C_cold_junctionN
+#define C_rtd						A_C_rtd
+#define TempLut						A_TempLut
+#define TempLutNu					A_TempLutNu
+#define TempTcMv					A_TempTcMv
+#define TempCjMv					A_TempCjMv
+#define CalculateCjcTemp			A_CalculateCjcTemp
+#include TEMPBENCH_IMPL_A
+#if defined(TEMPLIB_H) && defined(COLDJ_N_SEG)	// TempLib with the fused cold junction path
+#define TEMPBENCH_CJC_A A_CalculateCjcTemp
+#else
+#define TEMPBENCH_CJC_A 0
+#endif
+#include "TempBenchUndef.h"
+
+#define CalculateRTDTemp			B_CalculateRTDTemp
+#define CalculateThermoCoupleTemp	B_CalculateThermoCoupleTemp
+#define CalculateColdJVoltage		B_CalculateColdJVoltage
+#define C_themocoupleP				B_C_themocoupleP
+#define C_themocoupleN				B_C_themocoupleN
+#define C_cold_junctionP			B_C_cold_junctionP
+#define C_cold_junctionN			B_C_cold_junctionN
+#define C_rtd						B_C_rtd
+#define TempLut						B_TempLut
+#define TempLutNu					B_TempLutNu
+#define TempTcMv					B_TempTcMv
+#define TempCjMv					B_TempCjMv
+#define CalculateCjcTemp			B_CalculateCjcTemp
+#include TEMPBENCH_IMPL_B
+#if defined(TEMPLIB_H) && defined(COLDJ_N_SEG)
+#define TEMPBENCH_CJC_B B_CalculateCjcTemp
+#else
+#define TEMPBENCH_CJC_B 0
+#endif
+#include "TempBenchUndef.h"
+
+typedef struct
+{
+	const char *szName;
+	float (*pfRtd)(float r);			// ohms -> degC
+	float (*pfTc)(float v);				// V -> degC
+	float (*pfCj)(float t);				// degC -> V
+	float (*pfCjc)(float v, float t);	// V, cold junction degC -> degC, 0 if not provided
+} TempImpl;
+
+static const TempImpl C_impl[2] =
+{
+	{"A " TEMPBENCH_IMPL_A, A_CalculateRTDTemp, A_CalculateThermoCoupleTemp, A_CalculateColdJVoltage, TEMPBENCH_CJC_A},
+	{"B " TEMPBENCH_IMPL_B, B_CalculateRTDTemp, B_CalculateThermoCoupleTemp, B_CalculateColdJVoltage, TEMPBENCH_CJC_B},
+};
+
+typedef struct
+{
+	double dNs;							// ns per conversion, best of the repeats
+	double dMax;						// worst-case error against the reference
+	double dRms;
+} TempResult;
+
+volatile float fSink;					// keeps the timed loops from being optimised away
+static int iRepeats = 5;
+
+static double Now(void)
+{
+	struct timespec Ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &Ts);
+	return Ts.tv_sec*1e9 + Ts.tv_nsec;
+}
+
+static double Rand(double dLo, double dHi)
+{
+	return dLo + (dHi - dLo)*(rand()/(RAND_MAX + 1.0));
+}
+
+// Time pf over pfIn[] and compare with pdRef[] (reference outputs in the same units)
+static TempResult Run(float (*pf)(float), const float *pfIn, const double *pdRef, int iN)
+{
+	TempResult Res = {1e30, 0.0, 0.0};
+	double dSq = 0.0;
+	int i, r;
+
+	for (r = 0; r < iRepeats; r++)
+	{
+		double dT0 = Now();
+		float fAcc = 0.0f;
+		for (i = 0; i < iN; i++)
+			fAcc += pf(pfIn[i]);
+		dT0 = (Now() - dT0)/iN;
+		fSink = fAcc;
+		if (dT0 < Res.dNs)
+			Res.dNs = dT0;
+	}
+	for (i = 0; i < iN; i++)
+	{
+		double dErr = fabs(pf(pfIn[i]) - pdRef[i]);
+		if (dErr > Res.dMax)
+			Res.dMax = dErr;
+		dSq += dErr*dErr;
+	}
+	Res.dRms = sqrt(dSq/iN);
+	return Res;
+}
+
+// The main loop arithmetic of CN0221 Thermocouple_to_UART.c for one measurement cycle,
+// through CalculateCjcTemp() when the implementation has it
+static float Cycle(const TempImpl *pImpl, const long *plTc, const long *plRtd)
+{
+	float fVolts = (1.2 / 268435456);
+	float fVThermocouple = 0;
+	float fVRTD = 0;
+	float fRrtd, fTRTD, fColdJVolt, fFinalVoltage;
+	unsigned char ucCounter;
+
+	for (ucCounter = 0; ucCounter < SAMPLENO; ucCounter++)
+	{
+		fVThermocouple += (plTc[ucCounter] * fVolts);
+		fVRTD += ((float)plRtd[ucCounter] / 268435456);
+	}
+	fVThermocouple = fVThermocouple/SAMPLENO;
+	fVRTD = fVRTD/SAMPLENO;
+	fRrtd = fVRTD * 5600;
+	fTRTD = pImpl->pfRtd(fRrtd);
+	if (pImpl->pfCjc)
+		return pImpl->pfCjc(fVThermocouple, fTRTD);
+	fColdJVolt = pImpl->pfCj(fTRTD);
+	fFinalVoltage = fVThermocouple + fColdJVolt;
+	return pImpl->pfTc(fFinalVoltage);
+}
+
+static TempResult RunCycles(const TempImpl *pImpl, const long *plTc, const long *plRtd, const double *pdRef, int iCycles)
+{
+	TempResult Res = {1e30, 0.0, 0.0};
+	double dSq = 0.0;
+	int i, r;
+
+	for (r = 0; r < iRepeats; r++)
+	{
+		double dT0 = Now();
+		float fAcc = 0.0f;
+		for (i = 0; i < iCycles; i++)
+			fAcc += Cycle(pImpl, plTc + i*SAMPLENO, plRtd + i*SAMPLENO);
+		dT0 = (Now() - dT0)/iCycles;
+		fSink = fAcc;
+		if (dT0 < Res.dNs)
+			Res.dNs = dT0;
+	}
+	if (pdRef == 0)
+		return Res;
+	for (i = 0; i < iCycles; i++)
+	{
+		double dErr = fabs(Cycle(pImpl, plTc + i*SAMPLENO, plRtd + i*SAMPLENO) - pdRef[i]);
+		if (dErr > Res.dMax)
+			Res.dMax = dErr;
+		dSq += dErr*dErr;
+	}
+	Res.dRms = sqrt(dSq/iCycles);
+	return Res;
+}
+
+static void Report(const char *szWhat, const char *szUnit, const TempResult *pRes)
+{
+	int i;
+
+	for (i = 0; i < 2; i++)
+		printf("%-14s %c %9.2f %10.2f %12.5g %12.5g %s\n", szWhat, 'A' + i,
+			   pRes[i].dNs, 1e3/pRes[i].dNs, pRes[i].dMax, pRes[i].dRms, szUnit);
+	printf("%-14s   B/A speed %.2fx, max error %+.4g %s\n\n", szWhat,
+		   pRes[0].dNs/pRes[1].dNs, pRes[1].dMax - pRes[0].dMax, szUnit);
+}
+
+// Synthesise a recorded trace: slowly drifting hot and cold junctions plus ADC noise
+static int Synthesise(long *plTc, long *plRtd, double *pdRef, int iCycles)
+{
+	double dTh = 20.0, dTc = 25.0;
+	int i, s;
+
+	for (i = 0; i < iCycles; i++)
+	{
+		dTh += Rand(-0.5, 0.5);
+		dTc += Rand(-0.05, 0.05);
+		if (dTh < -190.0 || dTh > 340.0)
+			dTh = Rand(-150.0, 300.0);
+		if (dTc < -35.0 || dTc > 120.0)
+			dTc = Rand(0.0, 50.0);
+		pdRef[i] = dTh;
+		for (s = 0; s < SAMPLENO; s++)
+		{
+			double dVtc = (RefTcE(dTh) - RefTcE(dTc))/1000.0;
+			plTc[i*SAMPLENO + s] = (long)(dVtc/ADC_VREF*ADC_FS + Rand(-40.0, 40.0));
+			plRtd[i*SAMPLENO + s] = (long)(RefRtdR(dTc)/RTD_RREF*ADC_FS + Rand(-40.0, 40.0));
+		}
+	}
+	return iCycles;
+}
+
+static int Load(const char *szFile, long **pplTc, long **pplRtd)
+{
+	FILE *pF = fopen(szFile, "r");
+	long lTc, lRtd;
+	int iN = 0, iSize = 4096;
+
+	if (pF == 0)
+	{
+		perror(szFile);
+		exit(1);
+	}
+	*pplTc = malloc(iSize*sizeof(long));
+	*pplRtd = malloc(iSize*sizeof(long));
+	while (fscanf(pF, "%ld %ld", &lTc, &lRtd) == 2)
+	{
+		if (iN == iSize)
+		{
+			iSize *= 2;
+			*pplTc = realloc(*pplTc, iSize*sizeof(long));
+			*pplRtd = realloc(*pplRtd, iSize*sizeof(long));
+		}
+		(*pplTc)[iN] = lTc;
+		(*pplRtd)[iN] = lRtd;
+		iN++;
+	}
+	fclose(pF);
+	return iN/SAMPLENO;
+}
+
+int main(int argc, char *argv[])
+{
+	TempResult Res[2];
+	const char *szFile = 0;
+	float *pfIn;
+	double *pdRef;
+	long *plTc, *plRtd;
+	int iN = 1000000, iCycles, i, k;
+
+	for (i = 1; i < argc; i++)
+	{
+		if (!strcmp(argv[i], "-n") && i+1 < argc)
+			iN = atoi(argv[++i]);
+		else if (!strcmp(argv[i], "-r") && i+1 < argc)
+			iRepeats = atoi(argv[++i]);
+		else if (!strcmp(argv[i], "-f") && i+1 < argc)
+			szFile = argv[++i];
+		else if (!strcmp(argv[i], "-s") && i+1 < argc)
+			srand(atoi(argv[++i]));
+		else
+		{
+			fprintf(stderr, "usage: TempBench [-n conversions] [-r repeats] [-f recorded.txt] [-s seed]\n");
+			return 2;
+		}
+	}
+	if (iN < 1 || iRepeats < 1)
+		return 2;
+
+	pfIn = malloc(iN*sizeof(float));
+	pdRef = malloc(iN*sizeof(double));
+	for (i = 0; i < 2; i++)
+		printf("%s\n", C_impl[i].szName);
+	printf("\n%-14s %c %9s %10s %12s %12s\n", "conversion", ' ', "ns/conv", "Mconv/s", "max err", "rms err");
+
+	for (i = 0; i < iN; i++)					// RTD over -40..125degC
+	{
+		pfIn[i] = (float)Rand(RefRtdR(-40.0), RefRtdR(125.0));
+		pdRef[i] = RefRtdT(pfIn[i]);
+	}
+	for (k = 0; k < 2; k++)
+		Res[k] = Run(C_impl[k].pfRtd, pfIn, pdRef, iN);
+	Report("RTD", "degC", Res);
+
+	for (i = 0; i < iN; i++)					// thermocouple over -200..350degC
+	{
+		pfIn[i] = (float)(Rand(RefTcE(-200.0), RefTcE(350.0))/1000.0);
+		pdRef[i] = RefTcT(pfIn[i]*1000.0);
+	}
+	for (k = 0; k < 2; k++)
+		Res[k] = Run(C_impl[k].pfTc, pfIn, pdRef, iN);
+	Report("Thermocouple", "degC", Res);
+
+	for (i = 0; i < iN; i++)					// cold junction over -40..125degC, reported in mV
+	{
+		pfIn[i] = (float)Rand(-40.0, 125.0);
+		pdRef[i] = RefTcE(pfIn[i])/1000.0;
+	}
+	for (k = 0; k < 2; k++)
+	{
+		Res[k] = Run(C_impl[k].pfCj, pfIn, pdRef, iN);
+		Res[k].dMax *= 1000.0;
+		Res[k].dRms *= 1000.0;
+	}
+	Report("Cold junction", "mV", Res);
+
+	if (szFile)
+	{
+		iCycles = Load(szFile, &plTc, &plRtd);
+		pdRef = 0;								// no reference for recorded data
+	}
+	else
+	{
+		iCycles = iN/SAMPLENO;
+		plTc = malloc(iCycles*SAMPLENO*sizeof(long));
+		plRtd = malloc(iCycles*SAMPLENO*sizeof(long));
+		Synthesise(plTc, plRtd, pdRef, iCycles);
+	}
+	if (iCycles > 0)
+	{
+		for (k = 0; k < 2; k++)
+			Res[k] = RunCycles(&C_impl[k], plTc, plRtd, pdRef, iCycles);
+		printf("%d measurement cycles of %d samples per channel%s\n", iCycles, SAMPLENO,
+			   szFile ? " (recorded, no reference)" : "");
+		Report("CN0221 cycle", "degC", Res);
+	}
+	return 0;
+}
@@ -0,0 +1,54 @@
+// Drops the names one TempCalc or TempLib build defines so TempBench.c can include the next one.
+// Deliberately has no include guard.
+#undef CalculateRTDTemp
+#undef CalculateThermoCoupleTemp
+#undef CalculateColdJVoltage
+#undef C_themocoupleP
+#undef C_themocoupleN
+#undef C_cold_junctionP
+#undef C_cold_junctionN
+#undef C_rtd
+#undef TempLut
+#undef TempLutNu
+#undef TempTcMv
+#undef TempCjMv
+#undef CalculateCjcTemp
+#undef TEMPLIB_H
+#undef TEMPLIB_RTD_TABLES
+#undef TEMPLIB_TC_TABLES
+#undef THER_T_MIN_P
+#undef THER_T_MAX_P
+#undef THER_V_MIN_P
+#undef THER_V_MAX_P
+#undef THER_N_SEG_P
+#undef THER_V_SEG_P
+#undef THER_T_MIN_N
+#undef THER_T_MAX_N
+#undef THER_V_MIN_N
+#undef THER_V_MAX_N
+#undef THER_N_SEG_N
+#undef THER_V_SEG_N
+#undef COLDJ_T_MIN_P
+#undef COLDJ_T_MAX_P
+#undef COLDJ_V_MIN_P
+#undef COLDJ_V_MAX_P
+#undef COLDJ_N_SEG_P
+#undef COLDJ_T_SEG_P
+#undef COLDJ_T_MIN_N
+#undef COLDJ_T_MAX_N
+#undef COLDJ_V_MIN_N
+#undef COLDJ_V_MAX_N
+#undef COLDJ_N_SEG_N
+#undef COLDJ_T_SEG_N
+#undef COLDJ_T_MIN
+#undef COLDJ_T_MAX
+#undef COLDJ_V_MIN
+#undef COLDJ_V_MAX
+#undef COLDJ_N_SEG
+#undef COLDJ_T_SEG
+#undef TMIN
+#undef TMAX
+#undef RMIN
+#undef RMAX
+#undef NSEG
+#undef RSEG
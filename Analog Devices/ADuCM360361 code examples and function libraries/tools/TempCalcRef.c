@@ -14,9 +14,11 @@ TO ENSURE THAT THE RESULTING APPLICATION PERFORMS AS REQUIRED AND IS SAFE.
 Description:
 This file contains the functions to convert ADC results to temperature 
 based on measurements of the RTD and thermocouple.
+Kept unchanged from the CN0300/CN0319 examples as the TempBench baseline;
+the examples now use common/TempLib.h.
 
 */
-#include "TempCalc.h"
+#include "TempCalcRef.h"
 
 // Thermocouple lookup tables....
 const float C_themocoupleP[THER_N_SEG_P+1] = {0.0, 	15.1417, 	29.8016, 	44.0289, 	57.8675, 	71.3563, 
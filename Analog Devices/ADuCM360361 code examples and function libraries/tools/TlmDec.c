@@ -0,0 +1,221 @@
+/**
+ *****************************************************************************
+   @file     TlmDec.c
+   @brief    Host decoder for the binary telemetry packets of UrtTlmSend() and TlmLib.
+   - Packet before encoding: channel id, format, 4 byte timestamp, the values, all
+     little endian, then a CRC-16/CCITT-FALSE of these bytes, MSB first.
+   - Format byte: bytes per value in bits 4-6, decimals in bits 0-3.
+   - Batch packet (format bit 7 set): number of channels, format, 4 byte timestamp
+     base, then per channel its id, its number of values and for each value the
+     time difference and the zigzag value difference from the previous value, as
+     variable length numbers (7 bits per byte, LSB first). The first value of a
+     channel is relative to the base and 0. Then the CRC as above.
+   - Packets are COBS encoded and end with a 0 byte.
+   See common/UrtLib.c and common/TlmLib.c for the encoders.
+
+   @version  V0.2
+   @date     October 2026
+   @par Revision History:
+   - V0.1, October 2026: initial version.
+   - V0.2, October 2026: TlmLib batches.
+
+**/
+
+#include <string.h>
+#include "TlmDec.h"
+
+void TlmDecInit(TlmDec *pDec)
+{
+	memset(pDec, 0, sizeof(*pDec));
+}
+
+// Returns the decoded length, -1 if a code byte points past the end or is 0
+int TlmCobsDecode(const unsigned char *pIn, int iLen, unsigned char *pOut)
+{
+	int i = 0, iOut = 0;
+
+	while (i < iLen)
+	{
+		int iCode = pIn[i++];
+		int j;
+
+		if (iCode == 0 || i + iCode - 1 > iLen)
+			return -1;
+		for (j = 1; j < iCode; j++)
+			pOut[iOut++] = pIn[i++];
+		if (iCode < 0xFF && i < iLen)
+			pOut[iOut++] = 0;
+	}
+	return iOut;
+}
+
+int TlmCrc16(const unsigned char *pBuf, int iLen, int iCrc)
+{
+	unsigned int uiCrc = iCrc;
+	int i, b;
+
+	for (i = 0; i < iLen; i++)
+	{
+		uiCrc ^= (unsigned int)pBuf[i] << 8;
+		for (b = 0; b < 8; b++)
+			uiCrc = (uiCrc & 0x8000) ? (uiCrc << 1) ^ 0x1021 : uiCrc << 1;
+	}
+	return uiCrc & 0xFFFF;
+}
+
+static long SignExtend(unsigned long ulVal, int iBits)
+{
+	ulVal &= 0xFFFFFFFFUL >> (32 - iBits);
+	if (ulVal & (1UL << (iBits - 1)))
+		ulVal |= ~0UL << (iBits - 1);
+	return (long)ulVal;
+}
+
+static int Varint(const unsigned char *pRaw, int iLen, int *piPos, unsigned long *pulVal)
+{
+	int iShift;
+
+	*pulVal = 0;
+	for (iShift = 0; iShift < 35 && *piPos < iLen; iShift += 7)
+	{
+		unsigned char ucByte = pRaw[(*piPos)++];
+
+		*pulVal |= (unsigned long)(ucByte & 0x7F) << iShift;
+		if ((ucByte & 0x80) == 0)
+		{
+			*pulVal &= 0xFFFFFFFFUL;
+			return 1;
+		}
+	}
+	return 0;
+}
+
+static int ParseBatch(const unsigned char *pRaw, int iLen, TlmDec *pDec)
+{
+	unsigned long ulBase = 0;
+	int iBlocks = pRaw[0];
+	int b, i, j, iPos = 6;
+
+	if (iBlocks < 1 || iBlocks > TLM_MAX_CHAN)
+		return 0;
+	for (j = 0; j < 4; j++)
+		ulBase |= (unsigned long)pRaw[2 + j] << (8*j);
+	for (b = 0; b < iBlocks; b++)
+	{
+		TlmPkt *pPkt = &pDec->Next[b];
+		unsigned long ulTime = ulBase, ulVal = 0, ulDiff;
+
+		if (iPos + 2 > iLen)
+			return 0;
+		pPkt->iChan = pRaw[iPos++];
+		pPkt->iNum = pRaw[iPos++];
+		pPkt->iSize = 0;
+		pPkt->iDec = pRaw[1] & 0xF;
+		pPkt->iTimed = 1;
+		if (pPkt->iNum == 0 || pPkt->iNum > TLM_MAX_VAL)
+			return 0;
+		for (i = 0; i < pPkt->iNum; i++)
+		{
+			if (!Varint(pRaw, iLen, &iPos, &ulDiff))
+				return 0;
+			ulTime = (ulTime + ulDiff) & 0xFFFFFFFFUL;
+			if (!Varint(pRaw, iLen, &iPos, &ulDiff))
+				return 0;
+			ulDiff = (ulDiff >> 1) ^ (0UL - (ulDiff & 1));		// undo the zigzag
+			ulVal = (ulVal + ulDiff) & 0xFFFFFFFFUL;
+			pPkt->ulValTime[i] = ulTime;
+			pPkt->lVal[i] = SignExtend(ulVal, 32);
+		}
+		pPkt->ulTime = pPkt->ulValTime[0];
+	}
+	if (iPos != iLen)
+		return 0;
+	pDec->iNext = 0;
+	pDec->iNextNum = iBlocks;
+	return 1;
+}
+
+static int Parse(const unsigned char *pRaw, int iLen, TlmDec *pDec, TlmPkt *pPkt)
+{
+	int i, j, iPos = 6;
+
+	if (iLen < 8 || TlmCrc16(pRaw, iLen, 0xFFFF) != 0)
+		return 0;
+	iLen -= 2;
+	if (pRaw[1] & 0x80)
+		return ParseBatch(pRaw, iLen, pDec) && TlmDecNext(pDec, pPkt);
+	pPkt->iChan = pRaw[0];
+	pPkt->iSize = (pRaw[1] >> 4) & 7;
+	pPkt->iDec = pRaw[1] & 0xF;
+	pPkt->iTimed = 0;
+	if (pPkt->iSize < 2 || pPkt->iSize > 4 || (iLen - 6) % pPkt->iSize != 0)
+		return 0;
+	pPkt->ulTime = 0;
+	for (j = 0; j < 4; j++)
+		pPkt->ulTime |= (unsigned long)pRaw[2 + j] << (8*j);
+	pPkt->iNum = (iLen - 6)/pPkt->iSize;
+	if (pPkt->iNum > TLM_MAX_VAL)
+		return 0;
+	for (i = 0; i < pPkt->iNum; i++)
+	{
+		unsigned long ulVal = 0;
+
+		for (j = 0; j < pPkt->iSize; j++)
+			ulVal |= (unsigned long)pRaw[iPos++] << (8*j);
+		pPkt->lVal[i] = SignExtend(ulVal, 8*pPkt->iSize);
+		pPkt->ulValTime[i] = pPkt->ulTime;
+	}
+	return 1;
+}
+
+int TlmDecByte(TlmDec *pDec, unsigned char ucByte, TlmPkt *pPkt)
+{
+	unsigned char ucRaw[TLM_MAX_FRAME];
+	int iLen;
+
+	pDec->ulBytes++;
+	if (ucByte != 0)
+	{
+		if (pDec->iLen < TLM_MAX_FRAME)
+			pDec->ucBuf[pDec->iLen++] = ucByte;
+		else
+			pDec->iOverflow = 1;
+		return 0;
+	}
+	if (pDec->iLen == 0)						// back to back delimiters
+		return 0;
+	iLen = pDec->iOverflow ? -1 : TlmCobsDecode(pDec->ucBuf, pDec->iLen, ucRaw);
+	pDec->iLen = 0;
+	pDec->iOverflow = 0;
+	pDec->iNextNum = 0;
+	if (iLen < 8)
+	{
+		pDec->ulCobsErr++;
+		return -1;
+	}
+	if (!Parse(ucRaw, iLen, pDec, pPkt))
+	{
+		pDec->ulCrcErr++;
+		return -1;
+	}
+	pDec->ulPkts++;
+	return 1;
+}
+
+int TlmDecNext(TlmDec *pDec, TlmPkt *pPkt)
+{
+	if (pDec->iNext >= pDec->iNextNum)
+		return 0;
+	*pPkt = pDec->Next[pDec->iNext++];
+	return 1;
+}
+
+double TlmValue(const TlmPkt *pPkt, int i)
+{
+	double dVal = (double)pPkt->lVal[i];
+	int d;
+
+	for (d = 0; d < pPkt->iDec; d++)
+		dVal /= 10.0;
+	return dVal;
+}
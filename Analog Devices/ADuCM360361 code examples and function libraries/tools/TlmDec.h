@@ -0,0 +1,61 @@
+/**
+ *****************************************************************************
+   @file     TlmDec.h
+   @brief    Host decoder for the binary telemetry packets of UrtTlmSend() and TlmLib.
+   - Feed received bytes to TlmDecByte(), it returns 1 each time a valid packet
+     has been decoded into a TlmPkt.
+   - A TlmLib batch holds one TlmPkt per channel: TlmDecByte() gives the first,
+     get the others with TlmDecNext() until it returns 0.
+   - Get a value scaled by its number of decimals with TlmValue().
+   Frames with a COBS or CRC error are counted and skipped; the decoder
+   resynchronises on the next 0 byte.
+
+   @version  V0.2
+   @date     October 2026
+   @par Revision History:
+   - V0.1, October 2026: initial version.
+   - V0.2, October 2026: TlmLib batches, TlmDecNext() and timestamps per value.
+
+**/
+
+#ifndef TLMDEC_H
+#define TLMDEC_H
+
+#define TLM_MAX_VAL		255				// values per channel accepted by the decoder
+#define TLM_MAX_CHAN	16				// channels per batch accepted by the decoder
+#define TLM_MAX_FRAME	1100
+
+typedef struct
+{
+	int iChan;							// channel id
+	int iSize;							// bytes per value, 2 to 4, 0 for batches
+	int iDec;							// decimals of fixed point values, 0 for raw codes
+	unsigned long ulTime;				// timestamp of the first value
+	int iNum;							// number of values
+	long lVal[TLM_MAX_VAL];				// values, sign extended
+	int iTimed;							// 1 if ulValTime is known (batches), 0 otherwise
+	unsigned long ulValTime[TLM_MAX_VAL];	// timestamp of each value
+} TlmPkt;
+
+typedef struct
+{
+	unsigned char ucBuf[TLM_MAX_FRAME];	// encoded frame received so far
+	int iLen;
+	int iOverflow;						// frame longer than TLM_MAX_FRAME, dropped at its end
+	unsigned long ulPkts;				// valid packets
+	unsigned long ulBytes;				// bytes received, delimiters included
+	unsigned long ulCobsErr;			// frames with a COBS error or too short
+	unsigned long ulCrcErr;				// frames with a CRC or format error
+	TlmPkt Next[TLM_MAX_CHAN];			// channels of the last batch not returned yet
+	int iNext;
+	int iNextNum;
+} TlmDec;
+
+extern void TlmDecInit(TlmDec *pDec);
+extern int TlmDecByte(TlmDec *pDec, unsigned char ucByte, TlmPkt *pPkt);
+extern int TlmDecNext(TlmDec *pDec, TlmPkt *pPkt);
+extern int TlmCobsDecode(const unsigned char *pIn, int iLen, unsigned char *pOut);
+extern int TlmCrc16(const unsigned char *pBuf, int iLen, int iCrc);
+extern double TlmValue(const TlmPkt *pPkt, int i);
+
+#endif
@@ -0,0 +1,90 @@
+/**
+ *****************************************************************************
+   @file     TlmDump.c
+   @brief    Print the binary telemetry packets of UrtTlmSend() and TlmLib received on a serial port.
+   - Reads the byte stream from a file, or stdin when no file is given, and prints
+     one line per packet and channel: channel, timestamp and the values scaled by
+     their decimals.
+   - At the end prints the packet and error counts and the link bytes per value.
+
+   Build:  gcc -O2 -o TlmDump TlmDump.c TlmDec.c
+
+   Usage:  TlmDump [-q] [-t] [file]
+   - -q : only print the summary.
+   - -t : one line per value: channel, its own timestamp and the value. Values of
+          UrtTlmSend() packets all get the packet timestamp.
+   On Linux a port is read with: stty -F /dev/ttyUSB0 115200 raw && TlmDump /dev/ttyUSB0
+
+   @version  V0.2
+   @date     October 2026
+   @par Revision History:
+   - V0.1, October 2026: initial version.
+   - V0.2, October 2026: TlmLib batches, -t.
+
+**/
+
+#include <stdio.h>
+#include <string.h>
+#include "TlmDec.h"
+
+int main(int argc, char *argv[])
+{
+	TlmDec Dec;
+	TlmPkt Pkt;
+	FILE *pF = stdin;
+	unsigned long ulVals = 0;
+	int iQuiet = 0, iTimes = 0, c, i;
+
+	for (i = 1; i < argc; i++)
+	{
+		if (!strcmp(argv[i], "-q"))
+			iQuiet = 1;
+		else if (!strcmp(argv[i], "-t"))
+			iTimes = 1;
+		else if (argv[i][0] != '-' && pF == stdin)
+		{
+			pF = fopen(argv[i], "rb");
+			if (pF == 0)
+			{
+				perror(argv[i]);
+				return 1;
+			}
+		}
+		else
+		{
+			fprintf(stderr, "usage: TlmDump [-q] [-t] [file]\n");
+			return 2;
+		}
+	}
+
+	TlmDecInit(&Dec);
+	while ((c = getc(pF)) != EOF)
+	{
+		if (TlmDecByte(&Dec, (unsigned char)c, &Pkt) != 1)
+			continue;
+		do
+		{
+			ulVals += Pkt.iNum;
+			if (iQuiet)
+				continue;
+			if (iTimes)
+			{
+				for (i = 0; i < Pkt.iNum; i++)
+					printf("%d,%lu,%.*f\n", Pkt.iChan, Pkt.ulValTime[i], Pkt.iDec, TlmValue(&Pkt, i));
+				continue;
+			}
+			printf("%d,%lu", Pkt.iChan, Pkt.ulTime);
+			for (i = 0; i < Pkt.iNum; i++)
+				printf(",%.*f", Pkt.iDec, TlmValue(&Pkt, i));
+			printf("\n");
+		}
+		while (TlmDecNext(&Dec, &Pkt));
+		fflush(stdout);
+	}
+	fprintf(stderr, "%lu packets, %lu values, %lu bytes, %lu COBS errors, %lu CRC errors",
+			Dec.ulPkts, ulVals, Dec.ulBytes, Dec.ulCobsErr, Dec.ulCrcErr);
+	if (ulVals)
+		fprintf(stderr, ", %.2f bytes per value", (double)Dec.ulBytes/ulVals);
+	fprintf(stderr, "\n");
+	return 0;
+}
@@ -0,0 +1,453 @@
+/**
+ *****************************************************************************
+   @file     TlmTest.c
+   @brief    Host round trip test of the binary telemetry framing of common/UrtLib.c.
+   - cobs    UrtCobs() on random buffers up to 1000 bytes, from no 0 byte to many:
+             no 0 but the delimiter, length within URT_COBS_LEN(), and TlmCobsDecode()
+             (tools/TlmDec.c) gives the buffer back.
+   - crc     UrtCrc16() and TlmCrc16() of "123456789" are 0x29B1 (CRC-16/CCITT-FALSE),
+             and 0 over data followed by its CRC.
+   - packets Random UrtTlmSend() packets (channel, 16/24/32 bit values, decimals,
+             timestamp, 1 to URT_TLM_MAX values) are sent through UrtWrite() and
+             UrtWriteIsr() to an instant UART and decoded byte by byte with
+             TlmDecByte(). Every packet must come back with its values sign extended.
+   - errors  Same, with one random bit flipped in every other packet. A damaged
+             packet must be rejected and never decoded with wrong values. The only
+             other packet allowed to be lost is the one after a damaged delimiter.
+   - batch   common/TlmLib.c and common/DmaLib.c run unchanged against a model of
+             the UART transmitter and of the UARTTX_C DMA channel, one byte per
+             character slot. Both channels get random walk samples with jumps at
+             several rates, batch sizes and windows, with timestamps crossing 2^32.
+             Every sample added must be decoded once, in order, with its value and
+             timestamp, no block may hold more than the batch size, a window must
+             close its batch in time, samples may only be dropped while a packet is
+             on the line, and the TlmSta() counters must match the stream.
+   Prints one line per test and exits with 1 if any failed.
+
+   Build:  gcc -O2 -no-pie -Wno-pointer-to-int-cast -Ihost -o TlmTest TlmTest.c TlmDec.c
+                ../common/UrtLib.c ../common/TlmLib.c ../common/DmaLib.c
+
+   Usage:  TlmTest [-n packets] [-s seed]
+   - -n : packets per test, default 100000. cobs uses twice as many buffers, batch
+          runs as many character slots per setting.
+   - -s : seed of rand(), default 1.
+
+   @version  V0.1
+   @date     October 2026
+
+**/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "TlmDec.h"
+#include "../common/UrtLib.h"
+#include "../common/TlmLib.h"
+#include "../common/DmaLib.h"
+
+#define EMPTY		0xFFFF				// COMTX while the transmit buffer is empty
+#define PENDING		1024				// samples kept per channel for the check, a power of 2
+
+static ADI_UART_TypeDef Uart;
+static ADI_TIMER_TypeDef Tm0, Tm1;
+static ADI_SPI_TypeDef Spi1;
+static ADI_DMA_TypeDef Dma;
+static ADI_I2C_TypeDef I2c;
+static ADI_DAC_TypeDef Dac;
+static ADI_ADC_TypeDef Adc0, Adc1;
+static ADI_ADCSTEP_TypeDef AdcStep;
+ADI_UART_TypeDef *pADI_UART = &Uart;
+ADI_TIMER_TypeDef *pADI_TM0 = &Tm0;
+ADI_TIMER_TypeDef *pADI_TM1 = &Tm1;
+ADI_SPI_TypeDef *pADI_SPI1 = &Spi1;
+ADI_DMA_TypeDef *pADI_DMA = &Dma;
+ADI_I2C_TypeDef *pADI_I2C = &I2c;
+ADI_DAC_TypeDef *pADI_DAC = &Dac;
+ADI_ADC_TypeDef *pADI_ADC0 = &Adc0;
+ADI_ADC_TypeDef *pADI_ADC1 = &Adc1;
+ADI_ADCSTEP_TypeDef *pADI_ADCSTEP = &AdcStep;
+
+static int iFailed = 0;
+
+// UrtBaud() reads the UART clock, not used here
+long ClkFreq(int iClk)
+{
+	(void)iClk;
+	return 16000000;
+}
+
+static void Result(const char *szTest, unsigned long ulRun, unsigned long ulBad, const char *szMore)
+{
+	printf("%-8s %8lu run, %6lu failed%s\n", szTest, ulRun, ulBad, szMore);
+	if (ulBad)
+		iFailed = 1;
+}
+
+static void Cobs(int iN)
+{
+	static unsigned char ucIn[1000], ucEnc[URT_COBS_LEN(1000)], ucDec[URT_COBS_LEN(1000)];
+	unsigned long ulBad = 0;
+	int k, i;
+
+	for (k = 0; k < iN; k++)
+	{
+		int iLen = rand() % 1000;
+		int iZeros = rand() % 4;				// 0: no 0 byte, runs of 254 and more
+		int iEnc, iBad = 0;
+
+		for (i = 0; i < iLen; i++)
+			ucIn[i] = (iZeros && rand() % (50*iZeros) == 0) ? 0 : 1 + rand() % 255;
+		iEnc = UrtCobs(ucIn, iLen, ucEnc);
+		if (iEnc > URT_COBS_LEN(iLen) || ucEnc[iEnc-1] != 0)
+			iBad = 1;
+		for (i = 0; i < iEnc - 1 && !iBad; i++)
+			if (ucEnc[i] == 0)
+				iBad = 1;
+		if (!iBad && (TlmCobsDecode(ucEnc, iEnc - 1, ucDec) != iLen || memcmp(ucIn, ucDec, iLen)))
+			iBad = 1;
+		ulBad += iBad;
+	}
+	Result("cobs", iN, ulBad, "");
+}
+
+static void Crc(void)
+{
+	static const unsigned char ucChk[] = "123456789";
+	unsigned char ucBuf[12];
+	unsigned long ulBad = 0;
+	int iCrc;
+
+	ulBad += UrtCrc16(ucChk, 9, 0xFFFF) != 0x29B1;
+	ulBad += TlmCrc16(ucChk, 9, 0xFFFF) != 0x29B1;
+	memcpy(ucBuf, ucChk, 9);
+	iCrc = UrtCrc16(ucBuf, 9, 0xFFFF);
+	ucBuf[9] = (unsigned char)(iCrc >> 8);
+	ucBuf[10] = (unsigned char)iCrc;
+	ulBad += UrtCrc16(ucBuf, 11, 0xFFFF) != 0;
+	ulBad += UrtCrc16(ucChk + 4, 5, UrtCrc16(ucChk, 4, 0xFFFF)) != 0x29B1;	// in two parts
+	Result("crc", 4, ulBad, "");
+}
+
+// Value as the decoder returns it: iSize bytes, sign extended
+static long SignExt(long lVal, int iSize)
+{
+	int iShift = 8*(int)(sizeof(long) - iSize);
+
+	return (long)((unsigned long)lVal << iShift) >> iShift;
+}
+
+// Bytes sent by the UART for everything UrtWrite() queued
+static int Drain(unsigned char *pOut)
+{
+	int iLen = 0;
+
+	Uart.COMLSR = COMLSR_THRE|COMLSR_TEMT;		// each byte leaves at once
+	while (Uart.COMIEN & COMIEN_ETBEI)
+		if (UrtWriteIsr(pADI_UART))
+			pOut[iLen++] = (unsigned char)Uart.COMTX;
+	return iLen;
+}
+
+static void Packets(const char *szTest, int iN, int iErrors)
+{
+	static const int iSizes[3] = {URT_TLM_I16, URT_TLM_I24, URT_TLM_I32};
+	unsigned char ucLine[URT_TX_SIZE];
+	unsigned long ulBad = 0, ulRejected = 0, ulDamaged = 0, ulJoined = 0;
+	int iJoined = 0;
+	long lVal[URT_TLM_MAX];
+	TlmDec Dec;
+	TlmPkt Pkt;
+	char szMore[80];
+	int k, i, j;
+
+	TlmDecInit(&Dec);
+	for (k = 0; k < iN; k++)
+	{
+		int iChan = rand() % 256;
+		int iFmt = iSizes[rand() % 3] | (rand() % 16);
+		int iSize = (iFmt >> 4) & 7;
+		int iNum = 1 + rand() % URT_TLM_MAX;
+		unsigned long ulTime = ((unsigned long)rand() << 16) ^ (unsigned long)rand();
+		int iDamaged = iErrors && (k & 1);
+		int iLen, iAt = -1, iGot = 0, iOk = 0;
+
+		for (i = 0; i < iNum; i++)
+			lVal[i] = (long)(((unsigned long)rand() << 20) ^ (unsigned long)rand());
+		if (UrtTlmSend(pADI_UART, iChan, ulTime, lVal, iNum, iFmt) <= 0)
+		{
+			ulBad++;
+			continue;
+		}
+		iLen = Drain(ucLine);
+		if (iDamaged)
+		{
+			iAt = rand() % iLen;
+			ucLine[iAt] ^= (unsigned char)(1 << (rand() % 8));
+			ulDamaged++;
+		}
+		for (i = 0; i < iLen; i++)
+		{
+			int r = TlmDecByte(&Dec, ucLine[i], &Pkt);
+
+			if (r < 0)
+				ulRejected++;
+			if (r != 1)
+				continue;
+			iGot++;
+			iOk = Pkt.iChan == iChan && Pkt.iSize == iSize && Pkt.iDec == (iFmt & 0xF) &&
+				  Pkt.ulTime == (ulTime & 0xFFFFFFFF) && Pkt.iNum == iNum;
+			for (j = 0; iOk && j < iNum; j++)
+				iOk = Pkt.lVal[j] == SignExt(lVal[j], iSize);
+		}
+		// a flipped delimiter joins this frame to the next one, both are lost
+		if (iJoined && iGot == 0)
+			ulJoined++;
+		else if (iDamaged ? iGot != 0 : (iGot != 1 || !iOk))
+			ulBad++;
+		iJoined = iDamaged && iAt == iLen-1;
+	}
+	if (iErrors)
+		sprintf(szMore, ", %lu damaged, %lu lost with them, %lu frames rejected",
+				ulDamaged, ulJoined, ulRejected);
+	else
+		sprintf(szMore, ", %lu bytes", Dec.ulBytes);
+	Result(szTest, iN, ulBad, szMore);
+}
+
+// Batch test: samples added and not decoded yet, per channel
+static unsigned long ulPendTime[TLM_CHANS][PENDING];
+static long lPendVal[TLM_CHANS][PENDING];
+static unsigned long ulPendIn[TLM_CHANS], ulPendOut[TLM_CHANS];
+
+// Model state: DMA channel and UART shift register
+static unsigned int uiEn = 0, uiAlt = 0, uiMask = ~0u;
+static int iDmaInt = 0;
+static int iShift = -1;
+
+static TlmDec BatchDec;
+static unsigned long ulSlot = 0, ulBatchBad = 0, ulBatchVals = 0, ulBatchDrops = 0, ulBatchSettings = 0;
+static int iBatchSize, iBatchDec;
+static unsigned long ulBatchWindow;
+static unsigned long ulFrameStart = 0, ulFrameEnd = 0;	// times of the first and last byte of the frames
+
+// Act on the writes to the set and clear registers since the last slot
+static void DmaLatch(void)
+{
+	uiEn = (uiEn | Dma.DMAENSET) & ~Dma.DMAENCLR;
+	uiAlt = (uiAlt | Dma.DMAALTSET) & ~Dma.DMAALTCLR;
+	uiMask = (uiMask | Dma.DMARMSKSET) & ~Dma.DMARMSKCLR;
+	Dma.DMAENSET = Dma.DMAENCLR = Dma.DMAALTSET = Dma.DMAALTCLR = Dma.DMARMSKSET = Dma.DMARMSKCLR = 0;
+}
+
+// One request of channel iCh, 0 based, moving a byte from the source to COMTX
+static void DmaReq(int iCh)
+{
+	DmaDesc *pBase = (DmaDesc *)(uintptr_t)Dma.DMAPDBPTR;
+	DmaDesc *pDesc = pBase + iCh + ((uiAlt & (1u << iCh)) ? CCD_SIZE : 0);
+	unsigned int n;
+	int iCycle = pDesc->ctrlCfg.Bits.cycle_ctrl;
+
+	if ((iCycle != DMA_BASIC) && (iCycle != DMA_PING))
+	{
+		uiEn &= ~(1u << iCh);			// invalid structure, the cycle ends
+		return;
+	}
+	n = pDesc->ctrlCfg.Bits.n_minus_1;
+	Uart.COMTX = *(unsigned char *)(uintptr_t)(pDesc->srcEndPtr - n);
+	if (n)
+	{
+		pDesc->ctrlCfg.Bits.n_minus_1 = n - 1;
+		return;
+	}
+	pDesc->ctrlCfg.Bits.cycle_ctrl = DMA_STOP;
+	if (iCycle == DMA_PING)
+		uiAlt ^= 1u << iCh;
+	else
+		uiEn &= ~(1u << iCh);
+	iDmaInt++;
+}
+
+// Check a decoded block against the samples added to its channel. Returns the time
+// of its first sample.
+static unsigned long BatchBlock(const TlmPkt *pPkt)
+{
+	int iChan = pPkt->iChan, i;
+	unsigned long ulFirst = 0;
+
+	if ((iChan >= TLM_CHANS) || !pPkt->iTimed || (pPkt->iDec != iBatchDec) || (pPkt->iNum > iBatchSize))
+	{
+		ulBatchBad++;
+		return 0;
+	}
+	for (i = 0; i < pPkt->iNum; i++)
+	{
+		unsigned long k = ulPendOut[iChan] & (PENDING-1);
+
+		if ((ulPendOut[iChan] == ulPendIn[iChan]) ||
+			(pPkt->ulValTime[i] != (ulPendTime[iChan][k] & 0xFFFFFFFF)) || (pPkt->lVal[i] != lPendVal[iChan][k]))
+		{
+			ulBatchBad++;
+			return 0;
+		}
+		if (i == 0)
+			ulFirst = ulPendTime[iChan][k];
+		ulPendOut[iChan]++;
+		ulBatchVals++;
+	}
+	return ulFirst;
+}
+
+// One character slot of the line, the DMA and its interrupt
+static void BatchSlot(void)
+{
+	TlmPkt Pkt;
+	unsigned long ulNow = 0xFFFF0000 + ulSlot;
+
+	ulSlot++;
+	DmaLatch();
+	if ((iShift >= 0) && (ulFrameStart <= ulFrameEnd))
+		ulFrameStart = ulNow;
+	if ((iShift >= 0) && (TlmDecByte(&BatchDec, (unsigned char)iShift, &Pkt) == 1))
+	{
+		unsigned long ulBase = ulNow, ulFirst;
+
+		do
+		{
+			ulFirst = BatchBlock(&Pkt);
+			if (ulFirst < ulBase)
+				ulBase = ulFirst;
+		}
+		while (TlmDecNext(&BatchDec, &Pkt));
+		// Once its window is over, a batch leaves as soon as the previous packet has gone
+		if (ulBatchWindow && (ulFrameStart - ulBase > ((ulFrameEnd > ulBase + ulBatchWindow) ?
+														ulFrameEnd - ulBase : ulBatchWindow) + 3))
+			ulBatchBad++;
+	}
+	if (iShift == 0)
+		ulFrameEnd = ulNow;
+	iShift = -1;
+	if (Uart.COMTX != EMPTY)
+	{
+		iShift = Uart.COMTX;
+		Uart.COMTX = EMPTY;
+	}
+	if ((Uart.COMIEN & COMIEN_EDMAT) && (uiEn & DMAENSET_UARTTX) && !(uiMask & DMARMSKSET_UARTTX))
+		DmaReq(UARTTX_C-1);
+	Uart.COMLSR = (Uart.COMTX == EMPTY) ? COMLSR_THRE | ((iShift < 0) ? COMLSR_TEMT : 0) : 0;
+	for (; iDmaInt > 0; iDmaInt--)
+	{
+		TlmTxIsr();
+		DmaLatch();
+	}
+}
+
+// One setting: iRate is the percentage of slots with a sample, per channel
+static void BatchRun(int iN, int iBatch, unsigned long ulWindow, int iRate)
+{
+	static long lWalk[TLM_CHANS];
+	int k, i;
+
+	iBatchSize = iBatch;
+	iBatchDec = rand() % 16;
+	ulBatchWindow = ulWindow;
+	for (i = 0; i < TLM_CHANS; i++)
+		ulPendOut[i] = ulPendIn[i];
+	if (!TlmCfg(pADI_UART, iBatch, ulWindow, iBatchDec))
+		ulBatchBad++;
+	for (k = 0; k < iN; k++)
+	{
+		unsigned long ulNow = 0xFFFF0000 + ulSlot;		// wraps at 2^32 during the first setting
+
+		BatchSlot();
+		for (i = 0; i < TLM_CHANS; i++)
+		{
+			int r;
+
+			if (rand() % 100 >= iRate)
+				continue;
+			// values within about +-2^30, so that differences fit 32 bits as on the target
+			if (rand() % 50 == 0)
+				lWalk[i] = (long)((((unsigned long)rand() << 16) ^ (unsigned long)rand()) % (0x7FFFFFFFUL - 0x1FFFFF)) - 0x3FF00000L;
+			else
+				lWalk[i] += rand() % 201 - 100;
+			r = TlmAdd(i, ulNow, lWalk[i]);
+			if (r == 1)
+			{
+				ulPendTime[i][ulPendIn[i] & (PENDING-1)] = ulNow;
+				lPendVal[i][ulPendIn[i] & (PENDING-1)] = lWalk[i];
+				ulPendIn[i]++;
+			}
+			else if ((r != 0) || (!TlmBusy() && (Uart.COMLSR & COMLSR_TEMT)))	// dropped, line free
+				ulBatchBad++;
+			else
+				ulBatchDrops++;
+			if (ulPendIn[i] - ulPendOut[i] > PENDING/2)
+				ulBatchBad++;
+		}
+		TlmPoll(ulNow);
+	}
+	// No more samples: windows close, the rest is sent
+	for (k = 0; k < (int)ulWindow + 4*URT_COBS_LEN(TLM_RAW_MAX); k++)
+	{
+		BatchSlot();
+		TlmPoll(0xFFFF0000 + ulSlot);
+	}
+	// Without a window a batch smaller than its size stays held
+	for (i = 0; i < TLM_CHANS; i++)
+		if (ulPendIn[i] - ulPendOut[i] >= (unsigned long)(ulWindow ? 1 : iBatch))
+			ulBatchBad++;
+	if (TlmBusy())
+		ulBatchBad++;
+	ulBatchSettings++;
+}
+
+static void Batch(int iN)
+{
+	char szMore[120];
+	unsigned long ulHeld = 0;
+	int i;
+
+	Uart.COMTX = EMPTY;
+	Uart.COMLSR = COMLSR_THRE|COMLSR_TEMT;
+	Uart.COMIEN = 0;
+	TlmDecInit(&BatchDec);
+	DmaBase();
+	// batch size, window in slots, percentage of slots with a sample per channel
+	BatchRun(iN, TLM_BATCH, 0, 10);
+	BatchRun(iN, TLM_BATCH, 0, 60);			// faster than the line, samples dropped
+	BatchRun(iN, TLM_BATCH, 40, 2);			// closed by the window
+	BatchRun(iN, 5, 30, 8);
+	BatchRun(iN, 1, 0, 3);
+	BatchRun(iN, 1, 0, 20);					// one packet per sample, dropped
+	BatchRun(iN, TLM_BATCH, 200, 40);
+	for (i = 0; i < TLM_CHANS; i++)
+		ulHeld += ulPendIn[i] - ulPendOut[i];
+	if ((TlmSta(TLM_STA_PKTS) != BatchDec.ulPkts) || (TlmSta(TLM_STA_BYTES) != BatchDec.ulBytes) ||
+		(TlmSta(TLM_STA_DROP) != ulBatchDrops) || (TlmSta(TLM_STA_VALS) != ulBatchVals) ||
+		BatchDec.ulCobsErr || BatchDec.ulCrcErr || (ulBatchDrops == 0))
+		ulBatchBad++;
+	sprintf(szMore, ", %lu packets, %lu samples, %lu dropped, %lu held at the end, %lu bytes",
+			BatchDec.ulPkts, ulBatchVals, ulBatchDrops, ulHeld, BatchDec.ulBytes);
+	Result("batch", ulBatchSettings, ulBatchBad, szMore);
+}
+
+int main(int argc, char *argv[])
+{
+	int iN = 100000;
+	int i;
+
+	for (i = 1; i + 1 < argc; i += 2)
+	{
+		if (!strcmp(argv[i], "-n"))
+			iN = atoi(argv[i+1]);
+		else if (!strcmp(argv[i], "-s"))
+			srand(atoi(argv[i+1]));
+	}
+	Cobs(2*iN);
+	Crc();
+	Packets("packets", iN, 0);
+	Packets("errors", iN, 1);
+	Batch(iN);
+	return iFailed;
+}
@@ -0,0 +1,228 @@
+/**
+ *****************************************************************************
+   @file     TrcDump.c
+   @brief    Host decoder for the trace bursts of common/TrcLib.c.
+   - Reads the UART stream from a file or stdin, finds the bursts and prints one
+     line per event: timestamp, then the event text.
+   - The event text comes from a format file with one line per event id:
+         <id> <format>
+     The format is printf-like, with up to two conversions for the two arguments:
+     %d/%i signed, %u/%x/%X unsigned, %f the argument as a float (its 32 bits),
+     %c a character, flags/width/precision allowed, no length modifier. Lines
+     starting with # are comments. Events without a format are printed in hex.
+   - Bytes outside bursts (text sent with UrtWrite()) are skipped, or printed with -a.
+   - Reports the events the target dropped, and the totals on stderr at the end.
+
+   Build:  gcc -O2 -o TrcDump TrcDump.c
+
+   Usage:  TrcDump [-f formats] [-a] [file]
+     e.g.  stty -F /dev/ttyUSB0 115200 raw && TrcDump -f cn0221.trc /dev/ttyUSB0
+
+   @version  V0.1
+   @date     October 2026
+
+**/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TRC_MAGIC0		0xA5			// as common/TrcLib.h
+#define TRC_MAGIC1		0x54
+#define TRC_VERSION		1
+#define TRC_HDR_LEN		8
+#define TRC_ENTRY_LEN	12
+#define TRC_BURST		(1024/TRC_ENTRY_LEN)
+#define MAX_ID			65536
+
+static char *szFmt[MAX_ID];
+static int iAscii = 0;
+static unsigned long ulBursts = 0, ulEvents = 0, ulResync = 0, ulDropped = 0;
+
+static unsigned long Le(const unsigned char *p, int iLen)
+{
+	unsigned long ulVal = 0;
+
+	while (iLen--)
+		ulVal = (ulVal << 8) | p[iLen];
+	return ulVal;
+}
+
+static void LoadFormats(const char *szFile)
+{
+	FILE *pF = fopen(szFile, "r");
+	char szLine[512];
+
+	if (pF == NULL)
+	{
+		perror(szFile);
+		exit(2);
+	}
+	while (fgets(szLine, sizeof(szLine), pF))
+	{
+		char *pEnd;
+		long lId = strtol(szLine, &pEnd, 0);
+
+		if (szLine[0] == '#' || pEnd == szLine || lId <= 0 || lId >= MAX_ID)
+			continue;
+		while (*pEnd == ' ' || *pEnd == '\t')
+			pEnd++;
+		pEnd[strcspn(pEnd, "\r\n")] = 0;
+		free(szFmt[lId]);
+		szFmt[lId] = strdup(pEnd);
+	}
+	fclose(pF);
+}
+
+// Print an argument with one conversion spec, "%08x" etc.
+static void PrintArg(const char *szSpec, int iLen, unsigned long ulArg)
+{
+	char szOne[32];
+	char cConv = szSpec[iLen - 1];
+	union { unsigned int ui; float f; } Bits;
+
+	if (iLen >= (int)sizeof(szOne) - 2)
+		return;
+	memcpy(szOne, szSpec, iLen - 1);
+	szOne[iLen - 1] = 0;
+	Bits.ui = (unsigned int)ulArg;
+	switch (cConv)
+	{
+	case 'd': case 'i':
+		strcat(szOne, "ld"); printf(szOne, (long)(int)Bits.ui); break;
+	case 'u': case 'x': case 'X': case 'o':
+		szOne[iLen - 1] = 'l'; szOne[iLen] = cConv; szOne[iLen + 1] = 0;
+		printf(szOne, (unsigned long)Bits.ui); break;
+	case 'f': case 'e': case 'g':
+		szOne[iLen - 1] = cConv; szOne[iLen] = 0; printf(szOne, (double)Bits.f); break;
+	case 'c':
+		szOne[iLen - 1] = 'c'; szOne[iLen] = 0; printf(szOne, (int)(Bits.ui & 0xFF)); break;
+	default:
+		fwrite(szSpec, 1, iLen, stdout); break;
+	}
+}
+
+static void PrintEvent(const unsigned char *p)
+{
+	unsigned long ulHdr = Le(p, 4);
+	unsigned long ulArg[2];
+	int iId = (int)(ulHdr & 0xFFFF);
+	const char *s = szFmt[iId];
+	int iArg = 0;
+
+	ulArg[0] = Le(p + 4, 4);
+	ulArg[1] = Le(p + 8, 4);
+	printf("%5lu  ", (ulHdr >> 16) & 0xFFFF);
+	if (s == NULL)
+	{
+		printf("id %d: 0x%08lX 0x%08lX\n", iId, ulArg[0], ulArg[1]);
+		return;
+	}
+	while (*s)
+	{
+		int iLen;
+
+		if (*s != '%')
+		{
+			putchar(*s++);
+			continue;
+		}
+		if (s[1] == '%')
+		{
+			putchar('%');
+			s += 2;
+			continue;
+		}
+		iLen = 1 + (int)strspn(s + 1, "-+ #0123456789.");
+		if (s[iLen] == 0)
+			break;
+		iLen++;
+		if (iArg < 2)
+			PrintArg(s, iLen, ulArg[iArg++]);
+		s += iLen;
+	}
+	putchar('\n');
+}
+
+int main(int argc, char *argv[])
+{
+	FILE *pIn = stdin;
+	unsigned char ucBuf[TRC_HDR_LEN + TRC_BURST*TRC_ENTRY_LEN];
+	int iLen = 0, iNeed = TRC_HDR_LEN, iHave = 0, c, i;
+	unsigned long ulLastDrop = 0;
+
+	for (i = 1; i < argc; i++)
+	{
+		if (!strcmp(argv[i], "-f") && i+1 < argc)
+			LoadFormats(argv[++i]);
+		else if (!strcmp(argv[i], "-a"))
+			iAscii = 1;
+		else if (argv[i][0] == '-' || pIn != stdin)
+		{
+			fprintf(stderr, "usage: TrcDump [-f formats] [-a] [file]\n");
+			return 2;
+		}
+		else if ((pIn = fopen(argv[i], "rb")) == NULL)
+		{
+			perror(argv[i]);
+			return 2;
+		}
+	}
+
+	while ((c = getc(pIn)) != EOF)
+	{
+		// Find the header: magic, version and a plausible count
+		if (iLen < 2 && c != (iLen == 0 ? TRC_MAGIC0 : TRC_MAGIC1))
+		{
+			if (iLen == 1)
+			{
+				if (iAscii)
+					putchar(TRC_MAGIC0);
+				iLen = 0;
+				if (c == TRC_MAGIC0)
+				{
+					ucBuf[iLen++] = (unsigned char)c;
+					continue;
+				}
+			}
+			if (iAscii)
+				putchar(c);
+			continue;
+		}
+		ucBuf[iLen++] = (unsigned char)c;
+		if (iLen == TRC_HDR_LEN)
+		{
+			iHave = (int)Le(ucBuf + 4, 2);
+			if (ucBuf[2] != TRC_VERSION || ucBuf[3] != 0 || iHave == 0 || iHave > TRC_BURST)
+			{
+				ulResync++;
+				iLen = 0;
+				continue;
+			}
+			iNeed = TRC_HDR_LEN + iHave*TRC_ENTRY_LEN;
+		}
+		if (iLen < TRC_HDR_LEN || iLen < iNeed)
+			continue;
+
+		// Complete burst
+		{
+			unsigned long ulDrop = Le(ucBuf + 6, 2);
+
+			if (((ulDrop - ulLastDrop) & 0xFFFF) != 0)
+			{
+				printf("# %lu events dropped\n", (ulDrop - ulLastDrop) & 0xFFFF);
+				ulDropped += (ulDrop - ulLastDrop) & 0xFFFF;
+			}
+			ulLastDrop = ulDrop;
+		}
+		for (i = 0; i < iHave; i++)
+			PrintEvent(ucBuf + TRC_HDR_LEN + i*TRC_ENTRY_LEN);
+		ulBursts++;
+		ulEvents += iHave;
+		iLen = 0;
+		iNeed = TRC_HDR_LEN;
+	}
+	fflush(stdout);
+	fprintf(stderr, "%lu bursts, %lu events, %lu dropped, %lu bad headers\n", ulBursts, ulEvents, ulDropped, ulResync);
+	return 0;
+}
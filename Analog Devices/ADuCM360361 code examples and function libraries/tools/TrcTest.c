@@ -0,0 +1,291 @@
+/**
+ *****************************************************************************
+   @file     TrcTest.c
+   @brief    Host test of the deferred binary trace of common/TrcLib.c.
+   - Runs common/TrcLib.c, common/UrtLib.c and common/DmaLib.c unchanged against a
+     model of the UART transmitter and of the UARTTX_C DMA channel. Time runs in
+     character slots: one byte leaves the shift register per slot, the DMA moves a
+     byte to COMTX when the transmit buffer is empty and the channel is enabled and
+     not masked, and each structure that completes raises the DMA interrupt, which
+     calls TrcTxIsr().
+   - Interrupts record events with TRC() at random slots, also while a burst is sent,
+     sometimes faster than the ring empties so that events are dropped. The main loop
+     calls TrcFlush() and, between bursts, sends text lines with UrtWrite().
+   - The stream is decoded independently of tools/TrcDump.c and must hold every
+     recorded event once, in order, with its id, arguments and timestamp, the text
+     lines intact between the bursts and, in each burst header, the count of
+     events dropped so far.
+   Prints the result and exits with 1 if the check failed.
+
+   Build:  gcc -O2 -no-pie -Wno-pointer-to-int-cast -Ihost -o TrcTest TrcTest.c ../common/TrcLib.c
+                ../common/UrtLib.c ../common/DmaLib.c
+
+   Usage:  TrcTest [-n slots] [-s seed] [-o file]
+   - -n : character slots to run, default 2000000.
+   - -s : seed of rand(), default 1.
+   - -o : also write the stream to a file, to try TrcDump on it.
+
+   @version  V0.1
+   @date     October 2026
+
+**/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "../common/TrcLib.h"
+#include "../common/UrtLib.h"
+#include "../common/DmaLib.h"
+
+#define EMPTY		0xFFFF				// COMTX while the transmit buffer is empty
+#define EVENTS		(1 << 20)			// events kept for the check, a power of 2
+#define STREAM		(1 << 24)
+
+static ADI_UART_TypeDef Uart;
+static ADI_TIMER_TypeDef Tm0, Tm1;
+static ADI_SPI_TypeDef Spi1;
+static ADI_DMA_TypeDef Dma;
+static ADI_I2C_TypeDef I2c;
+static ADI_DAC_TypeDef Dac;
+static ADI_ADC_TypeDef Adc0, Adc1;
+static ADI_ADCSTEP_TypeDef AdcStep;
+ADI_UART_TypeDef *pADI_UART = &Uart;
+ADI_TIMER_TypeDef *pADI_TM0 = &Tm0;
+ADI_TIMER_TypeDef *pADI_TM1 = &Tm1;
+ADI_SPI_TypeDef *pADI_SPI1 = &Spi1;
+ADI_DMA_TypeDef *pADI_DMA = &Dma;
+ADI_I2C_TypeDef *pADI_I2C = &I2c;
+ADI_DAC_TypeDef *pADI_DAC = &Dac;
+ADI_ADC_TypeDef *pADI_ADC0 = &Adc0;
+ADI_ADC_TypeDef *pADI_ADC1 = &Adc1;
+ADI_ADCSTEP_TypeDef *pADI_ADCSTEP = &AdcStep;
+
+// Events recorded, in the order TrcLog() accepted them
+static TrcEntry Ev[EVENTS];
+static unsigned long ulEvIn = 0, ulDrops = 0;
+static unsigned long ulTextLines = 0;
+
+// Bytes sent on the line
+static unsigned char *pucLine;
+static unsigned long ulLine = 0;
+
+// Model state: DMA channel and UART shift register
+static unsigned int uiEn = 0, uiAlt = 0, uiMask = ~0u;
+static int iDmaInt = 0;
+static int iShift = -1;
+static unsigned long ulBursts = 0;
+static unsigned int uiFlushDrop[EVENTS];	// events dropped when each burst started
+static unsigned long ulFlushes = 0;
+
+long ClkFreq(int iClk)
+{
+	(void)iClk;
+	return 16000000;
+}
+
+// Act on the writes to the set and clear registers since the last slot
+static void DmaLatch(void)
+{
+	uiEn = (uiEn | Dma.DMAENSET) & ~Dma.DMAENCLR;
+	uiAlt = (uiAlt | Dma.DMAALTSET) & ~Dma.DMAALTCLR;
+	uiMask = (uiMask | Dma.DMARMSKSET) & ~Dma.DMARMSKCLR;
+	Dma.DMAENSET = Dma.DMAENCLR = Dma.DMAALTSET = Dma.DMAALTCLR = Dma.DMARMSKSET = Dma.DMARMSKCLR = 0;
+}
+
+// One request of channel iCh, 0 based, moving a byte from the source to COMTX
+static void DmaReq(int iCh)
+{
+	DmaDesc *pBase = (DmaDesc *)(uintptr_t)Dma.DMAPDBPTR;
+	DmaDesc *pDesc = pBase + iCh + ((uiAlt & (1u << iCh)) ? CCD_SIZE : 0);
+	unsigned int n;
+	int iCycle = pDesc->ctrlCfg.Bits.cycle_ctrl;
+
+	if ((iCycle != DMA_BASIC) && (iCycle != DMA_PING))
+	{
+		uiEn &= ~(1u << iCh);			// invalid structure, the cycle ends
+		return;
+	}
+	n = pDesc->ctrlCfg.Bits.n_minus_1;
+	Uart.COMTX = *(unsigned char *)(uintptr_t)(pDesc->srcEndPtr - n);
+	if (n)
+	{
+		pDesc->ctrlCfg.Bits.n_minus_1 = n - 1;
+		return;
+	}
+	pDesc->ctrlCfg.Bits.cycle_ctrl = DMA_STOP;
+	if (iCycle == DMA_PING)
+		uiAlt ^= 1u << iCh;
+	else
+		uiEn &= ~(1u << iCh);
+	iDmaInt++;
+}
+
+static void Trace(void)
+{
+	TrcEntry *pE = &Ev[ulEvIn & (EVENTS-1)];
+	int iId = 1 + rand() % 3;
+	unsigned long ulArg0 = ((unsigned long)rand() << 16) ^ (unsigned long)rand();
+	unsigned long ulArg1 = ulEvIn;
+
+	if (TRC(iId, ulArg0, ulArg1))
+	{
+		pE->ulHdr = (uint32_t)(iId | ((Tm0.VAL & 0xFFFFu) << 16));
+		pE->ulArg0 = (uint32_t)ulArg0;
+		pE->ulArg1 = (uint32_t)ulArg1;
+		ulEvIn++;
+	}
+	else
+		ulDrops++;
+}
+
+// One character slot of the line, the DMA, the interrupts and the main loop
+static void Slot(int iRate)
+{
+	int i;
+
+	Tm0.VAL++;
+	DmaLatch();
+	if (iShift >= 0)
+		pucLine[ulLine++ % STREAM] = (unsigned char)iShift;
+	iShift = -1;
+	if (Uart.COMTX != EMPTY)
+	{
+		iShift = Uart.COMTX;
+		Uart.COMTX = EMPTY;
+	}
+	if ((Uart.COMIEN & COMIEN_EDMAT) && (uiEn & DMAENSET_UARTTX) && !(uiMask & DMARMSKSET_UARTTX))
+		DmaReq(UARTTX_C-1);
+	Uart.COMLSR = (Uart.COMTX == EMPTY) ? COMLSR_THRE | ((iShift < 0) ? COMLSR_TEMT : 0) : 0;
+
+	// Interrupts: DMA end of structure, UART transmit buffer empty, events
+	for (; iDmaInt > 0; iDmaInt--)
+	{
+		if (TrcTxIsr())
+			ulBursts++;
+		DmaLatch();
+	}
+	if ((Uart.COMIEN & COMIEN_ETBEI) && (Uart.COMLSR & COMLSR_THRE))
+		UrtWriteIsr(pADI_UART);
+	for (i = rand() % 100; i < iRate; i += 100)
+		Trace();
+
+	// Main loop
+	if ((rand() % 8 == 0) && TrcFlush())
+		uiFlushDrop[ulFlushes++ & (EVENTS-1)] = (unsigned int)ulDrops;
+	if (!TrcBusy() && (rand() % 200 == 0))
+	{
+		char szText[40];
+		int iLen = sprintf(szText, "text %lu\r\n", ulTextLines);
+
+		if (UrtWrite(pADI_UART, (const unsigned char *)szText, iLen) == iLen)
+			ulTextLines++;
+	}
+	if (Uart.COMTX != EMPTY)
+		Uart.COMLSR &= ~(COMLSR_THRE|COMLSR_TEMT);
+}
+
+static unsigned long Le(const unsigned char *p, int iLen)
+{
+	unsigned long ulVal = 0;
+
+	while (iLen--)
+		ulVal = (ulVal << 8) | p[iLen];
+	return ulVal;
+}
+
+// Decode the stream. Returns the number of errors.
+static unsigned long Check(unsigned long *pulEvents, unsigned long *pulText, unsigned long *pulBursts)
+{
+	unsigned long ulErr = 0, ulEv = 0, ulText = 0, ulPos = 0, ulDrop = 0;
+	char szExp[40];
+
+	*pulEvents = *pulText = *pulBursts = 0;
+	while (ulPos < ulLine)
+	{
+		const unsigned char *p = pucLine + ulPos;
+
+		if ((p[0] == TRC_MAGIC0) && (ulPos + TRC_HDR_LEN <= ulLine))
+		{
+			int iNum = (int)Le(p + 4, 2), i;
+
+			if ((p[1] != TRC_MAGIC1) || (p[2] != TRC_VERSION) || (p[3] != 0) || (iNum < 1) ||
+				(iNum > (int)TRC_BURST) || (ulPos + TRC_HDR_LEN + iNum*12UL > ulLine))
+				return ulErr + 1;
+			ulDrop = Le(p + 6, 2);
+			if (ulDrop != (uiFlushDrop[*pulBursts & (EVENTS-1)] & 0xFFFF))
+				ulErr++;
+			for (i = 0; i < iNum; i++, ulEv++)
+				if (memcmp(p + TRC_HDR_LEN + 12*i, &Ev[ulEv & (EVENTS-1)], 12))
+					ulErr++;
+			ulPos += TRC_HDR_LEN + iNum*12UL;
+			(*pulBursts)++;
+			continue;
+		}
+		sprintf(szExp, "text %lu\r\n", ulText);
+		if ((ulPos + strlen(szExp) > ulLine) || memcmp(p, szExp, strlen(szExp)))
+			return ulErr + 1;
+		ulPos += strlen(szExp);
+		*pulText = ++ulText;
+	}
+	if (ulDrop != (ulDrops & 0xFFFF))
+		ulErr++;
+	*pulEvents = ulEv;
+	return ulErr;
+}
+
+int main(int argc, char *argv[])
+{
+	unsigned long ulSlots = 2000000, ulEvents, ulText, ulBurstsRead, ulErr, k;
+	const char *szOut = 0;
+	int i, iRate;
+
+	for (i = 1; i + 1 < argc; i += 2)
+	{
+		if (!strcmp(argv[i], "-n"))
+			ulSlots = strtoul(argv[i+1], 0, 0);
+		else if (!strcmp(argv[i], "-s"))
+			srand(atoi(argv[i+1]));
+		else if (!strcmp(argv[i], "-o"))
+			szOut = argv[i+1];
+	}
+	pucLine = malloc(STREAM);
+	if (ulSlots > STREAM/2)
+		ulSlots = STREAM/2;
+	Uart.COMTX = EMPTY;
+	Uart.COMLSR = COMLSR_THRE|COMLSR_TEMT;
+	UrtCfg(pADI_UART, B115200, COMLCR_WLS_8BITS, 0);
+	DmaBase();
+	TrcCfg(pADI_UART, pADI_TM0);
+	// Event rate per slot in percent: mostly below the line rate of 1/12, with bursts above it
+	for (k = 0; k < ulSlots; k++)
+	{
+		iRate = ((k / 20000) % 4 == 3) ? 20 : 4;
+		Slot(iRate);
+	}
+	// No more events, the rest of the ring is sent
+	for (k = 0; k < 200000; k++)
+		Slot(0);
+	if (szOut)
+	{
+		FILE *pF = fopen(szOut, "wb");
+
+		if (pF)
+		{
+			fwrite(pucLine, 1, ulLine, pF);
+			fclose(pF);
+		}
+	}
+	ulErr = Check(&ulEvents, &ulText, &ulBurstsRead);
+	printf("%lu slots, %lu line bytes: %lu bursts, %lu of %lu events, %lu of %lu text lines, "
+		   "%lu dropped (TrcDropped %d), %lu errors\n", ulSlots, ulLine, ulBurstsRead, ulEvents, ulEvIn,
+		   ulText, ulTextLines, ulDrops, TrcDropped(), ulErr);
+	if (ulErr || (ulEvents != ulEvIn) || (ulText != ulTextLines) || (ulBurstsRead != ulBursts) || (ulFlushes != ulBursts) ||
+		((unsigned long)TrcDropped() != ulDrops) || (ulDrops == 0))
+	{
+		printf("FAILED\n");
+		return 1;
+	}
+	printf("ok\n");
+	return 0;
+}
@@ -0,0 +1,385 @@
+/**
+ *****************************************************************************
+   @file     UrtBench.c
+   @brief    Host benchmark of the UART telemetry paths over the simulated UART of UrtSim.c.
+   - Runs common/UrtLib.c, common/TlmLib.c and common/FmtLib.c unchanged against the
+     simulated UART, paced at the baud rate set with UrtBaud(), and reads the pty
+     like a PC on the serial port.
+   - A producer makes -r measurement cycles per second of -c channels, slowly changing
+     values in mC like the CN0221 temperatures, and sends them for -t seconds with:
+       ascii   one text line per value, "C<chan> <cycle> <value>\r\n", with FmtFix()
+               and UrtWrite(). A line that does not fit in the queue is dropped.
+       binary  UrtTlmSend() packets of -n values of one channel, 24 bit values.
+       batch   TlmLib batches of -n values per channel or -w cycles, sent by DMA.
+   - The reader decodes the lines or packets (tools/TlmDec.c) and checks each value.
+   - Reports per mode: values offered and delivered per second, line bytes per
+     second and use of the line, bytes per value, values dropped by the producer
+     because the queue was full and values lost on the way, the depth of the transmit
+     queue (UrtWrite() queue plus the DMA packet) sampled each cycle, and the latency
+     from the production of each value to the read of the bytes that carry it.
+
+   Build:  gcc -O2 -Ihost -o UrtBench UrtBench.c UrtSim.c TlmDec.c ../common/UrtLib.c
+                ../common/TlmLib.c ../common/FmtLib.c -lpthread -lm
+
+   Usage:  UrtBench [-m mode] [-b baud] [-r rate] [-c channels] [-n values] [-w window] [-t seconds]
+   - -m : ascii, binary, batch or all. Default all, one after the other.
+   - -b : baud rate, default 115200.
+   - -r : measurement cycles per second, default 1000.
+   - -c : channels, 1 to TLM_CHANS. Default 2.
+   - -n : values per packet for binary, per channel and batch for batch. Default 8.
+   - -w : batch window in cycles, default the -n value.
+   - -t : seconds of production, default 2.
+
+   @version  V0.1
+   @date     October 2026
+
+**/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <time.h>
+#include "UrtSim.h"
+#include "TlmDec.h"
+#include "../common/UrtLib.h"
+#include "../common/TlmLib.h"
+#include "../common/FmtLib.h"
+
+#define MODE_ASCII		0
+#define MODE_BINARY		1
+#define MODE_BATCH		2
+
+static const char *szMode[3] = {"ascii", "binary", "batch"};
+
+static long lBaud = 115200;
+static int iRate = 1000;
+static int iChans = 2;
+static int iPerPkt = 8;
+static int iWindow = 0;
+static double dSeconds = 2;
+
+// Per cycle production time, per value its code and the time its bytes were read
+static int iCycles;
+static double *pdProd;
+static long *plVal;
+static double *pdRecv;
+static int iMode;
+static volatile int iReaderRun;
+static unsigned long ulBadVal;
+static unsigned long ulDupVal;
+static double dLastRecv;
+
+static void UartIsr(void)
+{
+	int iIir = UrtIntSta(pADI_UART);
+
+	if ((iIir & 0x2) == 0x2)
+		UrtWriteIsr(pADI_UART);
+	if ((iIir & 0x4) == 0x4)
+		UrtRx(pADI_UART);
+}
+
+static void DmaTxIsr(void)
+{
+	TlmTxIsr();
+}
+
+static void SleepUntil(double dTime)
+{
+	struct timespec Ts;
+
+	Ts.tv_sec = (time_t)dTime;
+	Ts.tv_nsec = (long)((dTime - Ts.tv_sec)*1e9);
+	clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &Ts, 0);
+}
+
+static void Received(int iCycle, int iChan, long lVal, double dNow)
+{
+	int i = iCycle*iChans + iChan;
+
+	if ((iCycle < 0) || (iCycle >= iCycles) || (iChan < 0) || (iChan >= iChans) || (plVal[i] != lVal))
+	{
+		ulBadVal++;
+		return;
+	}
+	if (pdRecv[i] != 0)
+	{
+		ulDupVal++;
+		return;
+	}
+	pdRecv[i] = dNow;
+	dLastRecv = dNow;
+}
+
+static void *Reader(void *pArg)
+{
+	unsigned char ucBuf[4096];
+	char szLine[64];
+	int iLine = 0;
+	TlmDec Dec;
+	TlmPkt Pkt;
+	int iFd = open(UrtSimPty(), O_RDONLY|O_NOCTTY);
+	int iIdle = 0;
+
+	(void)pArg;
+	TlmDecInit(&Dec);
+	// Stop 100ms after the producer, once nothing more arrives
+	while (iReaderRun || (iIdle < 10))
+	{
+		struct pollfd Pfd = {iFd, POLLIN, 0};
+		double dNow;
+		int iLen, i, j;
+
+		if (poll(&Pfd, 1, 10) <= 0)
+		{
+			iIdle++;
+			continue;
+		}
+		iIdle = 0;
+		iLen = (int)read(iFd, ucBuf, sizeof(ucBuf));
+		dNow = UrtSimNow();
+		for (i = 0; i < iLen; i++)
+		{
+			if (iMode != MODE_ASCII)
+			{
+				if (TlmDecByte(&Dec, ucBuf[i], &Pkt) != 1)
+					continue;
+				do
+					for (j = 0; j < Pkt.iNum; j++)
+						Received((int)(Pkt.iTimed ? Pkt.ulValTime[j] : Pkt.ulTime + j), Pkt.iChan, Pkt.lVal[j], dNow);
+				while (TlmDecNext(&Dec, &Pkt));
+				continue;
+			}
+			if (ucBuf[i] != '\n')
+			{
+				if (iLine < (int)sizeof(szLine)-1)
+					szLine[iLine++] = (char)ucBuf[i];
+				continue;
+			}
+			szLine[iLine] = 0;
+			iLine = 0;
+			{
+				int iChan, iCycle;
+				double dVal;
+
+				if (sscanf(szLine, "C%d %d %lf", &iChan, &iCycle, &dVal) == 3)
+					Received(iCycle, iChan, lround(dVal*1000), dNow);
+				else
+					ulBadVal++;
+			}
+		}
+	}
+	close(iFd);
+	return 0;
+}
+
+static int Cmp(const void *p1, const void *p2)
+{
+	double d1 = *(const double *)p1, d2 = *(const double *)p2;
+
+	return (d1 > d2) - (d1 < d2);
+}
+
+// Bytes waiting to be sent: UrtWrite() queue and what the DMA still has to send
+static int Depth(void)
+{
+	return URT_TX_SIZE-1 - UrtWriteFree(pADI_UART) + (int)UrtSimSta(URT_SIM_DMA_LEFT);
+}
+
+static void Run(int iRunMode)
+{
+	pthread_t Thread;
+	long lPkt[TLM_CHANS][URT_TLM_MAX];
+	int iHeld = 0;
+	unsigned long ulDrop = 0, ulRecv = 0, ulTx0;
+	double dDepth = 0, dStart, *pdLat;
+	int iDepthMax = 0;
+	int k, c, i;
+
+	iMode = iRunMode;
+	ulBadVal = ulDupVal = 0;
+	memset(pdRecv, 0, sizeof(double)*iCycles*iChans);
+	iReaderRun = 1;
+	pthread_create(&Thread, 0, Reader, 0);
+	usleep(20000);
+
+	UrtSimLock();
+	if (iMode == MODE_BATCH)
+		TlmCfg(pADI_UART, iPerPkt, iWindow, 3);
+	ulTx0 = UrtSimSta(URT_SIM_TX);
+	UrtSimUnlock();
+
+	dStart = UrtSimNow();
+	for (k = 0; k < iCycles; k++)
+	{
+		SleepUntil(dStart + (double)k/iRate);
+		pdProd[k] = UrtSimNow();
+		UrtSimLock();
+		for (c = 0; c < iChans; c++)
+		{
+			long lVal = plVal[k*iChans + c];
+
+			if (iMode == MODE_ASCII)
+			{
+				char szOut[40];
+				int iLen;
+
+				iLen = FmtStr(szOut, "C");
+				iLen += FmtFix(szOut+iLen, c, 0);
+				iLen += FmtStr(szOut+iLen, " ");
+				iLen += FmtFix(szOut+iLen, k, 0);
+				iLen += FmtStr(szOut+iLen, " ");
+				iLen += FmtFix(szOut+iLen, lVal, 3);
+				iLen += FmtStr(szOut+iLen, "\r\n");
+				if (UrtWriteFree(pADI_UART) >= iLen)
+					UrtWrite(pADI_UART, (unsigned char *)szOut, iLen);
+				else
+					ulDrop++;
+			}
+			else if (iMode == MODE_BINARY)
+			{
+				lPkt[c][iHeld] = lVal;
+				if ((iHeld + 1 == iPerPkt) && (UrtTlmSend(pADI_UART, c, k + 1 - iPerPkt, lPkt[c], iPerPkt, URT_TLM_I24|3) <= 0))
+					ulDrop += iPerPkt;
+			}
+			else if (TlmAdd(c, k, lVal) != 1)
+				ulDrop++;
+		}
+		if (iMode == MODE_BINARY)
+			iHeld = (iHeld + 1) % iPerPkt;
+		if (iMode == MODE_BATCH)
+			TlmPoll(k);
+		i = Depth();
+		dDepth += i;
+		if (i > iDepthMax)
+			iDepthMax = i;
+		UrtSimUnlock();
+	}
+	// Let the last batch close, then wait for the queue and the line to empty
+	for (;;)
+	{
+		int iBusy;
+
+		UrtSimLock();
+		if (iMode == MODE_BATCH)
+			TlmPoll(iCycles + iWindow);
+		iBusy = (Depth() > 0) || UrtSimSta(URT_SIM_BUSY) || ((iMode == MODE_BATCH) && TlmBusy());
+		UrtSimUnlock();
+		if (!iBusy)
+			break;
+		usleep(1000);
+	}
+	iReaderRun = 0;
+	pthread_join(Thread, 0);
+
+	pdLat = malloc(sizeof(double)*iCycles*iChans);
+	for (i = 0; i < iCycles*iChans; i++)
+		if (pdRecv[i] != 0)
+			pdLat[ulRecv++] = (pdRecv[i] - pdProd[i/iChans])*1e3;
+	qsort(pdLat, ulRecv, sizeof(double), Cmp);
+	{
+		double dRun = dLastRecv - dStart;
+		double dLatSum = 0;
+		unsigned long ulTx = UrtSimSta(URT_SIM_TX) - ulTx0;
+		unsigned long ulOffer = (unsigned long)iCycles*iChans;
+
+		for (i = 0; i < (int)ulRecv; i++)
+			dLatSum += pdLat[i];
+		printf("%-7s %9.0f %9.0f %8.0f %5.1f%% %6.2f %8lu %6lu %7.1f %5d",
+				szMode[iMode], ulOffer/dSeconds, ulRecv/dRun, ulTx/dRun,
+				100.0*ulTx*10/(UrtSimBaud()*dRun), ulRecv ? (double)ulTx/ulRecv : 0,
+				ulDrop, ulOffer - ulDrop - ulRecv, dDepth/iCycles, iDepthMax);
+		if (ulRecv)
+			printf(" %7.2f %7.2f %7.2f %7.2f", dLatSum/ulRecv, pdLat[ulRecv/2],
+					pdLat[(unsigned long)(ulRecv*0.99)], pdLat[ulRecv-1]);
+		if (ulBadVal || ulDupVal)
+			printf("  %lu wrong, %lu repeated", ulBadVal, ulDupVal);
+		printf("\n");
+	}
+	free(pdLat);
+}
+
+int main(int argc, char *argv[])
+{
+	int iFirst = MODE_ASCII, iLast = MODE_BATCH;
+	int i;
+
+	for (i = 1; i < argc; i++)
+	{
+		const char *szArg = (i + 1 < argc) ? argv[i+1] : 0;
+
+		if (!strcmp(argv[i], "-m") && szArg)
+		{
+			for (iFirst = MODE_BATCH; iFirst >= 0; iFirst--)
+				if (!strcmp(szArg, szMode[iFirst]))
+					break;
+			iLast = iFirst;
+			if (!strcmp(szArg, "all"))
+			{
+				iFirst = MODE_ASCII;
+				iLast = MODE_BATCH;
+			}
+			if (iFirst < 0)
+				break;
+		}
+		else if (!strcmp(argv[i], "-b") && szArg)
+			lBaud = atol(szArg);
+		else if (!strcmp(argv[i], "-r") && szArg)
+			iRate = atoi(szArg);
+		else if (!strcmp(argv[i], "-c") && szArg)
+			iChans = atoi(szArg);
+		else if (!strcmp(argv[i], "-n") && szArg)
+			iPerPkt = atoi(szArg);
+		else if (!strcmp(argv[i], "-w") && szArg)
+			iWindow = atoi(szArg);
+		else if (!strcmp(argv[i], "-t") && szArg)
+			dSeconds = atof(szArg);
+		else
+			break;
+		i++;
+	}
+	if ((i < argc) || (lBaud < 1) || (iRate < 1) || (iChans < 1) || (iChans > TLM_CHANS) ||
+		(iPerPkt < 1) || (iPerPkt > URT_TLM_MAX) || (iPerPkt > TLM_BATCH) || (dSeconds <= 0))
+	{
+		fprintf(stderr, "usage: UrtBench [-m ascii|binary|batch|all] [-b baud] [-r rate] [-c 1-%d] [-n 1-%d] [-w window] [-t seconds]\n",
+				TLM_CHANS, (URT_TLM_MAX < TLM_BATCH) ? URT_TLM_MAX : TLM_BATCH);
+		return 2;
+	}
+	if (iWindow == 0)
+		iWindow = iPerPkt;
+	// Whole packets only, so every value produced is sent in binary mode
+	iCycles = (int)(dSeconds*iRate)/iPerPkt*iPerPkt;
+	if (iCycles < iPerPkt)
+		iCycles = iPerPkt;
+	pdProd = malloc(sizeof(double)*iCycles);
+	plVal = malloc(sizeof(long)*iCycles*iChans);
+	pdRecv = malloc(sizeof(double)*iCycles*iChans);
+	srand(1);
+	for (i = 0; i < iCycles*iChans; i++)
+		plVal[i] = 25000 + (i % iChans)*1000 + lround(2000*sin(2*M_PI*(i/iChans)/(5.0*iRate))) + rand() % 11 - 5;
+
+	if (!UrtSimStart(UartIsr, DmaTxIsr))
+	{
+		perror("pty");
+		return 1;
+	}
+	UrtSimLock();
+	UrtCfg(pADI_UART, B9600, COMLCR_WLS_8BITS, 0);
+	UrtBaud(pADI_UART, lBaud);
+	UrtIntCfg(pADI_UART, COMIEN_ERBFI);
+	UrtSimUnlock();
+	printf("%s, %.0f baud (%ld asked), %d cycles/s, %d channels, %d values per packet, %d cycles batch window, %.1fs\n"
+			"depth in bytes, latency in ms\n",
+			UrtSimPty(), UrtSimBaud(), lBaud, iRate, iChans, iPerPkt, iWindow, dSeconds);
+	printf("mode    offered/s deliver/s  bytes/s   line  B/val  dropped   lost   depth   max"
+			"    mean     p50     p99     max\n");
+	for (i = iFirst; i <= iLast; i++)
+		Run(i);
+	UrtSimStop();
+	return 0;
+}
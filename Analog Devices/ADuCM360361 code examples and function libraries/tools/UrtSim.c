@@ -0,0 +1,398 @@
+/**
+ *****************************************************************************
+   @file     UrtSim.c
+   @brief    Simulated ADuCM360 UART on a Linux pseudo terminal.
+   - pADI_UART points to a register block polled by a simulator thread:
+       - A value written to COMTX is taken into the transmit shift register at once if
+         it is idle, otherwise when the byte being shifted out ends. Each byte takes
+         its frame time, start, data, parity and stop bits, at the baud rate set in
+         COMDIV/COMFBR with a 16MHz UART clock. It is written to the pty when its
+         frame ends.
+       - Bytes written to the pty are received in COMRX, one per frame time. A byte
+         arriving while COMLSR_DR is still set is lost and counted.
+       - COMLSR THRE, TEMT and DR and COMIIR follow, and the UART interrupt handler
+         is called while COMIIR reports an interrupt enabled in COMIEN. Receive
+         data is assumed read by the handler.
+   - Also stands in for ClkFreq() of common/ClkLib.c and for the DMA functions of
+     common/DmaLib.c used by TlmLib.c: basic cycles on the UART transmit channel
+     only, which feed COMTX while COMIEN_EDMAT is set. The DMA handler is called
+     at the end of each cycle.
+   Timing follows the host clock, so a loaded PC delays bytes but the long term
+   rate stays the baud rate.
+
+   Build:  gcc -O2 -Ihost -c UrtSim.c
+
+   @version  V0.1
+   @date     October 2026
+
+**/
+
+#define _GNU_SOURCE
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <termios.h>
+#include <pthread.h>
+#include <time.h>
+#include <errno.h>
+#include "UrtSim.h"
+#include "../common/DmaLib.h"
+#include "../common/ClkLib.h"
+
+#define URT_SIM_EMPTY	0xFFFF			// COMTX value while the transmit buffer is empty
+#define URT_SIM_LOOPS	8				// interrupts taken in a row before the thread runs again
+
+static ADI_UART_TypeDef SimUart;
+ADI_UART_TypeDef *pADI_UART = &SimUart;
+
+static pthread_mutex_t SimLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t SimWake;
+static pthread_t SimThread;
+static volatile int iSimRun = 0;
+static int iSimMaster = -1;
+static int iSimSlave = -1;
+static char szSimPty[64];
+static void (*pSimUartIsr)(void) = 0;
+static void (*pSimDmaIsr)(void) = 0;
+
+static int iSimShift = 0;				// 1 while a byte is shifted out
+static unsigned char ucSimShift;
+static double dSimShiftEnd;				// end of the frame of the byte shifted out
+static double dSimRxNext = 0;
+static unsigned long ulSimSta[URT_SIM_DMA_INT+1];
+
+static const unsigned char *pucSimDma = 0;	// UART transmit DMA channel
+static int iSimDmaLeft = 0;
+static int iSimDmaOn = 0;
+static int iSimDmaMask = 1;
+static int iSimDmaDone = 0;
+
+double UrtSimNow(void)
+{
+	struct timespec Ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &Ts);
+	return Ts.tv_sec + Ts.tv_nsec*1e-9;
+}
+
+long ClkFreq(int iClk)
+{
+	(void)iClk;
+	return 16000000;
+}
+
+// Baud rate from COMDIV and COMFBR, 0 if not set up
+double UrtSimBaud(void)
+{
+	double dDiv = SimUart.COMDIV;
+	unsigned int uiFbr = SimUart.COMFBR;
+
+	if (dDiv == 0)
+		return 0;
+	if (uiFbr & 0x8000)
+		dDiv *= ((uiFbr >> 11) & 3) + (uiFbr & 0x7FF)/2048.0;
+	if (dDiv == 0)
+		return 0;
+	return ClkFreq(CLK_FREQ_UART)/(32*dDiv);
+}
+
+// Frame time of one byte with the COMLCR format
+static double SimFrame(void)
+{
+	unsigned int uiLcr = SimUart.COMLCR;
+	double dBaud = UrtSimBaud();
+	double dBits = 1 + 5 + (uiLcr & 3);
+
+	if (uiLcr & COMLCR_PEN_EN)
+		dBits += 1;
+	if (uiLcr & COMLCR_STOP_EN)
+		dBits += ((uiLcr & 3) == 0) ? 1.5 : 2;
+	else
+		dBits += 1;
+	return (dBaud > 0) ? dBits/dBaud : 0;
+}
+
+// Update the transmitter, the DMA and the status registers and take the pending
+// interrupts. dStart is the time a byte taken by the idle shift register starts.
+static void SimStep(double dStart)
+{
+	int iLoop;
+
+	for (iLoop = 0; iLoop < URT_SIM_LOOPS; iLoop++)
+	{
+		unsigned int uiLsr, uiIir, uiIen;
+
+		if (!iSimShift && (SimUart.COMTX != URT_SIM_EMPTY) && (SimFrame() > 0))
+		{
+			ucSimShift = (unsigned char)SimUart.COMTX;
+			SimUart.COMTX = URT_SIM_EMPTY;
+			iSimShift = 1;
+			dSimShiftEnd = dStart + SimFrame();
+			pthread_cond_signal(&SimWake);
+		}
+		uiIen = SimUart.COMIEN;
+		if (iSimDmaOn && !iSimDmaMask && (uiIen & COMIEN_EDMAT) && (SimUart.COMTX == URT_SIM_EMPTY) && (iSimDmaLeft > 0))
+		{
+			SimUart.COMTX = *pucSimDma++;
+			if (--iSimDmaLeft == 0)
+			{
+				iSimDmaOn = 0;
+				iSimDmaDone = 1;
+			}
+			continue;
+		}
+		uiLsr = SimUart.COMLSR & (COMLSR_DR|COMLSR_OE);
+		if (SimUart.COMTX == URT_SIM_EMPTY)
+		{
+			uiLsr |= COMLSR_THRE;
+			if (!iSimShift)
+				uiLsr |= COMLSR_TEMT;
+		}
+		SimUart.COMLSR = uiLsr;
+		if ((uiIen & COMIEN_ERBFI) && (uiLsr & COMLSR_DR))
+			uiIir = 0x4;
+		else if ((uiIen & COMIEN_ETBEI) && (uiLsr & COMLSR_THRE))
+			uiIir = 0x2;
+		else
+			uiIir = 0x1;
+		SimUart.COMIIR = uiIir;
+		if (iSimDmaDone)
+		{
+			iSimDmaDone = 0;
+			ulSimSta[URT_SIM_DMA_INT]++;
+			if (pSimDmaIsr)
+				pSimDmaIsr();
+			continue;
+		}
+		if ((uiIir == 0x1) || !pSimUartIsr)
+			return;
+		ulSimSta[URT_SIM_UART_INT]++;
+		pSimUartIsr();
+		if (uiIir == 0x4)
+			SimUart.COMLSR &= ~(COMLSR_DR|COMLSR_OE);
+	}
+}
+
+static void *SimRun(void *pArg)
+{
+	(void)pArg;
+	pthread_mutex_lock(&SimLock);
+	while (iSimRun)
+	{
+		double dNow = UrtSimNow();
+		double dFrame = SimFrame();
+		double dWait;
+		struct timespec Ts;
+
+		if (iSimShift && (dNow >= dSimShiftEnd))
+		{
+			// A full pty is a receiver that does not keep up: the byte is lost on the line
+			if (write(iSimMaster, &ucSimShift, 1) == 1)
+				ulSimSta[URT_SIM_TX]++;
+			iSimShift = 0;
+			SimStep(dSimShiftEnd);				// the next byte follows without a gap
+		}
+		if ((dFrame > 0) && (dNow >= dSimRxNext))
+		{
+			unsigned char ucRx;
+
+			if (read(iSimMaster, &ucRx, 1) == 1)
+			{
+				ulSimSta[URT_SIM_RX]++;
+				if (SimUart.COMLSR & COMLSR_DR)
+				{
+					ulSimSta[URT_SIM_OVR]++;
+					SimUart.COMLSR |= COMLSR_OE;
+				}
+				else
+				{
+					SimUart.COMRX = ucRx;
+					SimUart.COMLSR |= COMLSR_DR;
+				}
+				dSimRxNext = dNow + dFrame;
+			}
+		}
+		SimStep(dNow);
+		// Wake at the end of the byte shifted out, else poll the pty for received bytes
+		dWait = (dFrame > 0 && dFrame < 1e-3) ? dFrame : 1e-3;
+		dWait = iSimShift ? dSimShiftEnd : dNow + dWait;
+		Ts.tv_sec = (time_t)dWait;
+		Ts.tv_nsec = (long)((dWait - Ts.tv_sec)*1e9);
+		pthread_cond_timedwait(&SimWake, &SimLock, &Ts);
+	}
+	pthread_mutex_unlock(&SimLock);
+	return 0;
+}
+
+/**
+	@brief int UrtSimStart(void (*pUartIsr)(void), void (*pDmaTxIsr)(void))
+			==========Create the pty and start the simulated UART.
+	@param pUartIsr :{0,}	\n
+		UART_Int_Handler of the application, 0 for none.
+	@param pDmaTxIsr :{0,}	\n
+		DMA_UART_TX_Int_Handler of the application, 0 for none.
+	@return 1, or 0 if the pty or the thread could not be created.
+	@note
+		- The pty is raw, 8 bits, no echo. Its name is given by UrtSimPty().
+		- Nothing is sent until UrtCfg() or UrtBaud() has set the baud rate.
+**/
+
+int UrtSimStart(void (*pUartIsr)(void), void (*pDmaTxIsr)(void))
+{
+	pthread_condattr_t Attr;
+	struct termios Tio;
+	const char *szName;
+
+	memset(&SimUart, 0, sizeof(SimUart));
+	SimUart.COMTX = URT_SIM_EMPTY;
+	SimUart.COMLSR = COMLSR_THRE|COMLSR_TEMT;
+	SimUart.COMIIR = 0x1;
+	pSimUartIsr = pUartIsr;
+	pSimDmaIsr = pDmaTxIsr;
+	iSimMaster = posix_openpt(O_RDWR|O_NOCTTY);
+	if ((iSimMaster < 0) || grantpt(iSimMaster) || unlockpt(iSimMaster) || !(szName = ptsname(iSimMaster)))
+		return 0;
+	strncpy(szSimPty, szName, sizeof(szSimPty)-1);
+	// Keep the slave open so bytes sent before a reader opens it wait in the pty
+	iSimSlave = open(szSimPty, O_RDWR|O_NOCTTY);
+	if (iSimSlave < 0)
+		return 0;
+	tcgetattr(iSimSlave, &Tio);
+	cfmakeraw(&Tio);
+	tcsetattr(iSimSlave, TCSANOW, &Tio);
+	fcntl(iSimMaster, F_SETFL, fcntl(iSimMaster, F_GETFL) | O_NONBLOCK);
+	pthread_condattr_init(&Attr);
+	pthread_condattr_setclock(&Attr, CLOCK_MONOTONIC);
+	pthread_cond_init(&SimWake, &Attr);
+	iSimRun = 1;
+	if (pthread_create(&SimThread, 0, SimRun, 0))
+	{
+		iSimRun = 0;
+		return 0;
+	}
+	return 1;
+}
+
+/**
+	@brief void UrtSimStop(void)
+			==========Stop the simulated UART and close the pty.
+**/
+
+void UrtSimStop(void)
+{
+	if (!iSimRun)
+		return;
+	pthread_mutex_lock(&SimLock);
+	iSimRun = 0;
+	pthread_cond_signal(&SimWake);
+	pthread_mutex_unlock(&SimLock);
+	pthread_join(SimThread, 0);
+	close(iSimSlave);
+	close(iSimMaster);
+	iSimSlave = iSimMaster = -1;
+}
+
+/**
+	@brief const char *UrtSimPty(void)
+			==========Name of the pty, "/dev/pts/N".
+**/
+
+const char *UrtSimPty(void)
+{
+	return szSimPty;
+}
+
+/**
+	@brief void UrtSimLock(void)
+			==========Keep the interrupt handlers out, like disabling interrupts.
+**/
+
+void UrtSimLock(void)
+{
+	pthread_mutex_lock(&SimLock);
+}
+
+/**
+	@brief void UrtSimUnlock(void)
+			==========Take the interrupts made pending by the main code and let the handlers run again.
+**/
+
+void UrtSimUnlock(void)
+{
+	SimStep(UrtSimNow());
+	pthread_mutex_unlock(&SimLock);
+}
+
+/**
+	@brief unsigned long UrtSimSta(int iSta)
+			==========Read a counter or a state of the simulation.
+	@param iSta :{URT_SIM_TX,URT_SIM_RX,URT_SIM_OVR,URT_SIM_UART_INT,URT_SIM_DMA_INT,URT_SIM_DMA_LEFT,URT_SIM_BUSY}	\n
+		Value to read.
+	@return The value, 0 for an invalid iSta.
+	@note
+		- Call between UrtSimLock() and UrtSimUnlock() for a consistent value.
+**/
+
+unsigned long UrtSimSta(int iSta)
+{
+	if (iSta == URT_SIM_DMA_LEFT)
+		return iSimDmaOn ? iSimDmaLeft : 0;
+	if (iSta == URT_SIM_BUSY)
+		return iSimShift || (SimUart.COMTX != URT_SIM_EMPTY);
+	if ((iSta < 0) || (iSta > URT_SIM_DMA_INT))
+		return 0;
+	return ulSimSta[iSta];
+}
+
+// DMA functions of common/DmaLib.c used on the UART transmit channel. Other
+// channels and cycle types are ignored.
+
+int DmaBase(void)
+{
+	return 1;
+}
+
+int DmaPeripheralStructSetup(int iChan, int iCfg)
+{
+	(void)iChan;
+	(void)iCfg;
+	return 1;
+}
+
+int DmaStructPtrOutSetup(int iChan, int iNumVals, unsigned char *pucTX_DMA)
+{
+	if (iChan == UARTTX_C)
+		pucSimDma = pucTX_DMA;
+	(void)iNumVals;
+	return 1;
+}
+
+int DmaCycleCntCtrl(unsigned int iChan, int iNumx, int iCfg)
+{
+	if ((iChan == UARTTX_C) && (iCfg == DMA_BASIC))
+		iSimDmaLeft = iNumx;
+	return 1;
+}
+
+int DmaSet(int iMask, int iEnable, int iAlt, int iPriority)
+{
+	(void)iAlt;
+	(void)iPriority;
+	if (iMask & DMARMSKSET_UARTTX)
+		iSimDmaMask = 1;
+	if ((iEnable & DMAENSET_UARTTX) && (iSimDmaLeft > 0))
+		iSimDmaOn = 1;
+	return 1;
+}
+
+int DmaClr(int iMask, int iEnable, int iAlt, int iPriority)
+{
+	(void)iAlt;
+	(void)iPriority;
+	if (iMask & DMARMSKCLR_UARTTX)
+		iSimDmaMask = 0;
+	if (iEnable & DMAENCLR_UARTTX)
+		iSimDmaOn = 0;
+	return 1;
+}
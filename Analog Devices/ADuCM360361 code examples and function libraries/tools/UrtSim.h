@@ -0,0 +1,42 @@
+/**
+ *****************************************************************************
+   @file     UrtSim.h
+   @brief    Simulated ADuCM360 UART on a Linux pseudo terminal, to run common/UrtLib.c
+             and the libraries built on it on a PC.
+   - Build the device code with tools/host first on the include path and link UrtSim.c.
+   - Start the simulation with UrtSimStart(). The UART sends its bytes to the pty at
+     the baud rate set in COMDIV/COMFBR, and the bytes written to the pty are received
+     in COMRX. Open UrtSimPty() like a serial port: TlmDump, a terminal or a test.
+   - Interrupt handlers run in the simulator thread. Main code that uses the UART or
+     its libraries calls UrtSimLock() and UrtSimUnlock() around them, like it would
+     disable interrupts. Pending interrupts are taken in UrtSimUnlock().
+
+   @version  V0.1
+   @date     October 2026
+
+**/
+
+#ifndef URTSIM_H
+#define URTSIM_H
+
+#include <ADuCM360.h>
+
+extern int UrtSimStart(void (*pUartIsr)(void), void (*pDmaTxIsr)(void));
+extern void UrtSimStop(void);
+extern const char *UrtSimPty(void);
+extern void UrtSimLock(void);
+extern void UrtSimUnlock(void);
+extern double UrtSimBaud(void);
+extern double UrtSimNow(void);
+extern unsigned long UrtSimSta(int iSta);
+
+// UrtSimSta() counters
+#define URT_SIM_TX			0			// bytes sent to the pty
+#define URT_SIM_RX			1			// bytes received from the pty
+#define URT_SIM_OVR			2			// received bytes lost, COMRX not read in time
+#define URT_SIM_UART_INT	3			// UART interrupts taken
+#define URT_SIM_DMA_INT		4			// DMA UART transmit interrupts taken
+#define URT_SIM_DMA_LEFT	5			// bytes the DMA still has to send, not a counter
+#define URT_SIM_BUSY		6			// 1 while a byte is held or shifted out, not a counter
+
+#endif
@@ -0,0 +1,322 @@
+/**
+ *****************************************************************************
+   @file     ADuCM360.h
+   @brief    Host stand-in for the ADuCM360 device header, for tools/UrtSim.
+   - Only declares what common/UrtLib.c, common/TlmLib.c, common/CmdLib.c,
+     common/MbsLib.c, common/GptLib.c, common/DmaLib.c, common/SpiLib.c,
+     examples/SPI/AD5421.c and the headers they include need to compile on a PC.
+   - The timers, the DMA controller, the SPI, I2C, DAC and ADC blocks and the GPIO
+     ports are plain registers. A host tool that uses them defines their pADI_
+     pointers and models them itself, and defines NVIC_EnableIRQ() and
+     NVIC_DisableIRQ() if it needs them. DmaLib.c keeps addresses in 32 bit descriptor fields, so link it
+     with -no-pie to keep static data below 4GB.
+   - SPITX and SPIRX are plain registers too. tools/SpiTest.c shows how a sed copy of
+     SpiLib.c sends them to SpiHostTx(), SpiHostRx() and SpiHostFlush().
+   - pADI_UART points to the UART simulated by UrtSim.c. COMTX and COMRX, one
+     register on the device, are two fields here so the simulator can tell a write
+     to COMTX from a received byte.
+   Put this directory first on the include path: gcc -Ihost ...
+
+   @version  V0.1
+   @date     October 2026
+
+**/
+
+#ifndef ADUCM360_HOST_H
+#define ADUCM360_HOST_H
+
+#include <stdint.h>
+
+#define __IO	volatile
+
+typedef struct
+{
+	__IO uint16_t COMTX;				// 0xFFFF while empty, see UrtSim.c
+	__IO uint16_t COMRX;
+	__IO uint16_t COMIEN;
+	__IO uint16_t COMIIR;
+	__IO uint16_t COMLCR;
+	__IO uint16_t COMMCR;
+	__IO uint16_t COMLSR;
+	__IO uint16_t COMMSR;
+	__IO uint16_t COMSCR;
+	__IO uint16_t COMFBR;
+	__IO uint16_t COMDIV;
+} ADI_UART_TypeDef;
+
+typedef struct
+{
+	__IO uint16_t LD;
+	__IO uint16_t VAL;
+	__IO uint16_t CON;
+	__IO uint16_t CLRI;
+	__IO uint16_t CAP;
+	__IO uint16_t STA;
+} ADI_TIMER_TypeDef;
+
+typedef struct
+{
+	__IO uint16_t SPISTA;
+	__IO uint16_t SPIRX;
+	__IO uint16_t SPITX;
+	__IO uint16_t SPIDIV;
+	__IO uint16_t SPICON;
+	__IO uint16_t SPIDMA;
+	__IO uint16_t SPICNT;
+} ADI_SPI_TypeDef;
+
+typedef struct
+{
+	__IO uint32_t DMASTA;
+	__IO uint32_t DMACFG;
+	__IO uint32_t DMAPDBPTR;
+	__IO uint32_t DMAADBPTR;
+	__IO uint32_t DMASWREQ;
+	__IO uint32_t DMARMSKSET;
+	__IO uint32_t DMARMSKCLR;
+	__IO uint32_t DMAENSET;
+	__IO uint32_t DMAENCLR;
+	__IO uint32_t DMAALTSET;
+	__IO uint32_t DMAALTCLR;
+	__IO uint32_t DMAPRISET;
+	__IO uint32_t DMAPRICLR;
+	__IO uint32_t DMAERRCLR;
+} ADI_DMA_TypeDef;
+
+typedef struct
+{
+	__IO uint16_t GPCON;
+	__IO uint8_t GPOEN;
+	__IO uint8_t GPPUL;
+	__IO uint8_t GPOCE;
+	__IO uint8_t GPIN;
+	__IO uint8_t GPOUT;
+	__IO uint8_t GPSET;
+	__IO uint8_t GPCLR;
+	__IO uint8_t GPTGL;
+} ADI_GPIO_TypeDef;
+
+typedef struct
+{
+	__IO uint16_t I2CMTX;
+	__IO uint16_t I2CMRX;
+	__IO uint16_t I2CSTX;
+	__IO uint16_t I2CSRX;
+} ADI_I2C_TypeDef;
+
+typedef struct
+{
+	__IO uint32_t DACDAT;
+} ADI_DAC_TypeDef;
+
+typedef struct
+{
+	__IO uint32_t MSKI;
+	__IO uint32_t DAT;
+} ADI_ADC_TypeDef;
+
+typedef struct
+{
+	__IO uint32_t STEPDAT;
+} ADI_ADCSTEP_TypeDef;
+
+extern ADI_UART_TypeDef *pADI_UART;
+extern ADI_TIMER_TypeDef *pADI_TM0;
+extern ADI_TIMER_TypeDef *pADI_TM1;
+extern ADI_SPI_TypeDef *pADI_SPI0;
+extern ADI_SPI_TypeDef *pADI_SPI1;
+extern ADI_DMA_TypeDef *pADI_DMA;
+extern ADI_I2C_TypeDef *pADI_I2C;
+extern ADI_DAC_TypeDef *pADI_DAC;
+extern ADI_ADC_TypeDef *pADI_ADC0;
+extern ADI_ADC_TypeDef *pADI_ADC1;
+extern ADI_ADCSTEP_TypeDef *pADI_ADCSTEP;
+extern ADI_GPIO_TypeDef *pADI_GP0;
+extern ADI_GPIO_TypeDef *pADI_GP1;
+extern ADI_GPIO_TypeDef *pADI_GP2;
+
+// Interrupts, only the names are used
+typedef enum
+{
+	UART_IRQn,
+	SPI0_IRQn,
+	SPI1_IRQn,
+} IRQn_Type;
+
+extern void NVIC_EnableIRQ(IRQn_Type IRQn);
+extern void NVIC_DisableIRQ(IRQn_Type IRQn);
+
+// Interrupt mask, defined by the tools that run common/SpiLib.c
+extern unsigned long __get_PRIMASK(void);
+extern void __disable_irq(void);
+extern void __set_PRIMASK(unsigned long ulPriMask);
+
+// SPI FIFO accesses. SPITX and SPIRX above are plain memory, so the tools that
+// model the FIFOs run a sed copy of common/SpiLib.c that calls these instead.
+extern void SpiHostTx(ADI_SPI_TypeDef *pSPI, int iTx);
+extern int SpiHostRx(ADI_SPI_TypeDef *pSPI);
+extern void SpiHostFlush(ADI_SPI_TypeDef *pSPI, int iFlush);
+
+// COMLCR
+#define COMLCR_BRK_EN		0x40
+#define COMLCR_BRK_DIS		0x00
+#define COMLCR_SP_EN		0x20
+#define COMLCR_EPS_EN		0x10
+#define COMLCR_PEN_EN		0x08
+#define COMLCR_STOP_EN		0x04
+#define COMLCR_WLS_5BITS	0x00
+#define COMLCR_WLS_6BITS	0x01
+#define COMLCR_WLS_7BITS	0x02
+#define COMLCR_WLS_8BITS	0x03
+
+// COMLSR
+#define COMLSR_DR			0x01
+#define COMLSR_OE			0x02
+#define COMLSR_PE			0x04
+#define COMLSR_FE			0x08
+#define COMLSR_BI			0x10
+#define COMLSR_THRE			0x20
+#define COMLSR_TEMT			0x40
+
+// COMIEN
+#define COMIEN_ERBFI		0x01
+#define COMIEN_ETBEI		0x02
+#define COMIEN_ELSI			0x04
+#define COMIEN_EDSSI		0x08
+#define COMIEN_EDMAT		0x10
+#define COMIEN_EDMAR		0x20
+
+// COMMCR
+#define COMMCR_DTR			0x01
+#define COMMCR_RTS			0x02
+#define COMMCR_LOOPBACK		0x10
+
+// COMMSR
+#define COMMSR_DCTS			0x01
+#define COMMSR_DDSR			0x02
+#define COMMSR_TERI			0x04
+#define COMMSR_DDCD			0x08
+#define COMMSR_CTS			0x10
+#define COMMSR_DSR			0x20
+#define COMMSR_RI			0x40
+#define COMMSR_DCD			0x80
+
+// TCON
+#define TCON_EVENT_MSK		0x0F00
+#define TCON_EVENTEN		0x1000
+#define TCON_RLD			0x0080
+#define TCON_CLK_UCLK		0x0000
+#define TCON_CLK_PCLK		0x0020
+#define TCON_CLK_LFOSC		0x0040
+#define TCON_CLK_LFXTAL		0x0060
+#define TCON_ENABLE			0x0010
+#define TCON_MOD_FREERUN	0x0000
+#define TCON_MOD_PERIODIC	0x0008
+#define TCON_UP				0x0004
+#define TCON_PRE_DIV1		0x0000
+#define TCON_PRE_DIV16		0x0001
+#define TCON_PRE_DIV256		0x0002
+#define TCON_PRE_DIV32768	0x0003
+
+// TSTA
+#define TSTA_TMOUT			0x0001
+#define TSTA_CAP			0x0002
+#define TSTA_BUSY			0x0040
+#define TSTA_PDOK			0x0080
+#define TSTA_CON			0x0100
+
+// TSTA_CON bit band aliases, read by GptBsy()
+#define T0STA_CON_BBA		((pADI_TM0->STA & TSTA_CON) != 0)
+#define T1STA_CON_BBA		((pADI_TM1->STA & TSTA_CON) != 0)
+
+// DMA channel bits of the UART transmit channel, UARTTX_C in common/DmaLib.h
+#define DMARMSKSET_UARTTX	0x04
+#define DMARMSKCLR_UARTTX	0x04
+#define DMAENSET_UARTTX		0x04
+#define DMAENCLR_UARTTX		0x04
+#define DMAALTSET_UARTTX	0x04
+#define DMAALTCLR_UARTTX	0x04
+
+// UART and SPI1 receive channels, UARTRX_C and SPI1RX_C
+#define DMARMSKCLR_UARTRX	0x08
+#define DMAENSET_UARTRX		0x08
+#define DMAALTSET_UARTRX	0x08
+#define DMAALTCLR_UARTRX	0x08
+#define DMARMSKCLR_SPI1RX	0x02
+#define DMAENSET_SPI1RX		0x02
+#define DMAALTSET_SPI1RX	0x02
+#define DMAALTCLR_SPI1RX	0x02
+
+// DMA interrupt numbers, only their span is used
+#define INT_NUM_DMA_FIRST	11
+#define INT_NUM_DMA_LAST	22
+
+// SPISTA
+#define SPISTA_CSERR		0x1000
+#define SPISTA_RXS			0x0800
+#define SPISTA_RXFSTA_MSK	0x0700
+#define SPISTA_RXFSTA_EMPTY	0x0000
+#define SPISTA_RXFSTA_ONEBYTE	0x0100
+#define SPISTA_RXFSTA_TWOBYTES	0x0200
+#define SPISTA_RXFSTA_THREEBYTES	0x0300
+#define SPISTA_RXFSTA_FOURBYTES	0x0400
+#define SPISTA_RXOF			0x0080
+#define SPISTA_RX			0x0040
+#define SPISTA_TX			0x0020
+#define SPISTA_TXUR			0x0010
+#define SPISTA_TXFSTA_MSK	0x000E
+#define SPISTA_TXFSTA_EMPTY	0x0000
+#define SPISTA_TXFSTA_ONEBYTE	0x0002
+#define SPISTA_TXFSTA_TWOBYTES	0x0004
+#define SPISTA_TXFSTA_THREEBYTES	0x0006
+#define SPISTA_TXFSTA_FOURBYTES	0x0008
+#define SPISTA_IRQ			0x0001
+
+// SPIDIV
+#define SPIDIV_BCRST_DIS	0x0000
+#define SPIDIV_BCRST_EN		0x0080
+
+// SPICON
+#define SPICON_MOD_MSK		0xC000
+#define SPICON_MOD_TX1RX1	0x0000
+#define SPICON_MOD_TX2RX2	0x4000
+#define SPICON_MOD_TX3RX3	0x8000
+#define SPICON_MOD_TX4RX4	0xC000
+#define SPICON_TFLUSH_DIS	0x0000
+#define SPICON_TFLUSH_EN	0x2000
+#define SPICON_RFLUSH_DIS	0x0000
+#define SPICON_RFLUSH_EN	0x1000
+#define SPICON_CON_DIS		0x0000
+#define SPICON_CON_EN		0x0800
+#define SPICON_LOOPBACK_DIS	0x0000
+#define SPICON_LOOPBACK_EN	0x0400
+#define SPICON_SOEN_DIS		0x0000
+#define SPICON_SOEN_EN		0x0200
+#define SPICON_RXOF_DIS		0x0000
+#define SPICON_RXOF_EN		0x0100
+#define SPICON_ZEN_DIS		0x0000
+#define SPICON_ZEN_EN		0x0080
+#define SPICON_TIM_RXRD		0x0000
+#define SPICON_TIM_TXWR		0x0040
+#define SPICON_LSB_DIS		0x0000
+#define SPICON_LSB_EN		0x0020
+#define SPICON_WOM_DIS		0x0000
+#define SPICON_WOM_EN		0x0010
+#define SPICON_CPOL_LOW		0x0000
+#define SPICON_CPOL_HIGH	0x0008
+#define SPICON_CPHA_SAMPLELEADING	0x0000
+#define SPICON_CPHA_SAMPLETRAILING	0x0004
+#define SPICON_MASEN_DIS	0x0000
+#define SPICON_MASEN_EN		0x0002
+#define SPICON_ENABLE_DIS	0x0000
+#define SPICON_ENABLE_EN	0x0001
+
+// SPIDMA
+#define SPIDMA_IENRXDMA_DIS	0x0000
+#define SPIDMA_IENRXDMA_EN	0x0004
+#define SPIDMA_IENTXDMA_DIS	0x0000
+#define SPIDMA_IENTXDMA_EN	0x0002
+#define SPIDMA_ENABLE_DIS	0x0000
+#define SPIDMA_ENABLE_EN	0x0001
+
+#endif
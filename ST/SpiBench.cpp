@@ -0,0 +1,660 @@
+//SpiBench - проверка и сравнение скорости обмена Spi<> на ПК, на модели регистров.
+//
+//Сборка:  g++ -O2 -no-pie -DSPI_PROF -Ihost -o SpiBench SpiBench.cpp spi_f10x_cpp.cpp
+//Запуск:  SpiBench [-a такты] [-f Гц] [-l такты] [-s low|med|max] [-w такты]
+//  -a : тактов ядра на одно обращение к регистру DMA и SPI1, по умолчанию 4,
+//       к SPI2 на APB1 - вдвое больше
+//  -f : частота SCK в Гц через frequency(), вместо -s
+//  -l : задержка DMA от запроса до пересылки, тактов, по умолчанию 6
+//  -s : скорость SPI, по умолчанию max
+//  -w : тактов обработки на кадр в сравнении sync/async, по умолчанию 2000
+//
+//Модель (host/stm32f10x.h): ядро 72 МГц, APB2 72 МГц (SPI1), APB1 36 МГц (SPI2).
+//Время идёт только при обращениях к регистрам SPI и DMA, остальные команды не
+//считаются - скорость опроса получается оценкой сверху. SPI: буфер передатчика,
+//сдвиговый регистр, буфер приёмника с OVR; ведомый отвечает инверсией каждого
+//байта, так проверяется выравнивание принятого. DMA: каналы SPI по флагам TXE/RXNE.
+//
+//Для каждого SPI и длины кадра печатает такты на кадр, МБ/с и занятость шины:
+//  byte - n вызовов transfer(uint8_t), как раньше: CS и ожидание BSY на каждый байт
+//  poll - transfer(tx, rx, n) без DMA
+//  dma  - transfer(tx, rx, n) через DMA
+//Затем K кадров с обработкой W тактов на кадр: sync - transfer() и обработка по
+//очереди, async - transferAsync(), обработка идёт, пока DMA передаёт следующий кадр.
+//Прерывания DMA моделируются: NVIC, PRIMASK, вход и выход - по 12 тактов.
+//frequency() проверяется и при HCLK ниже частоты ядра (делители HPRE, PPRE1, PPRE2).
+//Проверка очереди: кадры двух Spi<> с разными CS на SPI1 идут по очереди, кадр SPI1
+//ставится в очередь из прерывания SPI2, пока идёт
+//transfer() на SPI1, и должен начаться только после него.
+//Последняя таблица - SpiBus на SPI1 с тремя устройствами в разных режимах (ЦАП, АЦП,
+//flash: команда и страница одним кадром через hold): по очереди с ожиданием, в очередь
+//вперемешку и в очередь группами по устройству; такты, занятость шины и перенастройки CR1.
+//С -DSPI_PROF под каждым режимом - статистика Prof устройств: кадры, байты, такты
+//на линии (от CS до CS) и такты ожидания ядром. Время - DWT->CYCCNT, такты модели.
+//Возвращает 1, если хоть одна проверка не прошла.
+//Буферы выделяются в первых 4 ГБ (MAP_32BIT, -no-pie), чтобы адреса для CMAR
+//помещались в 32 бита.
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include "stm32f10x.h"
+#include "spi_f10x_cpp.h"
+
+GPIO_TypeDef host_gpio[5];
+SPI_TypeDef host_spi[3];
+DMA_TypeDef host_dma[2];
+DMA_Channel_TypeDef host_dma_ch[2][7];
+RCC_TypeDef host_rcc;
+AFIO_TypeDef host_afio;
+DWT_Type host_dwt;
+CoreDebug_Type host_coredebug;
+uint32_t SystemCoreClock = 72000000;
+
+static uint64_t now;                  //такты ядра
+static unsigned access = 4;
+static unsigned dma_lat = 6;
+static unsigned work = 2000;
+static unsigned errors;               //проверок, которые не прошли
+
+//прерывания: линия NVIC у каждого SPI - канал RX его DMA
+static const IRQn_Type irq_line[3] = {DMA1_Channel2_IRQn, DMA1_Channel4_IRQn, DMA2_Channel1_IRQn};
+static void (*irq_handler[3]) ();
+
+//печатает " ОШИБКА" и пояснение, считает ошибку
+static void error (const char * fmt, ...)
+{
+  va_list ap;
+
+  printf (" ОШИБКА");
+  if (*fmt) printf (" ");
+  va_start (ap, fmt);
+  vprintf (fmt, ap);
+  va_end (ap);
+  errors++;
+}
+static uint64_t nvic_en;
+static uint32_t primask;
+static bool in_irq;
+static unsigned long irq_count;
+
+struct Model
+{
+  unsigned apb;                       //тактов ядра на такт шины
+  DMA_TypeDef * dma;
+  DMA_Channel_TypeDef * rx_ch, * tx_ch;
+  uint8_t rx_shift, tx_shift;
+  bool txfull, shifting, rxne, ovr, ovr_dr;
+  uint8_t txbuf, shift, rxbuf;
+  uint64_t tx_at, txe_at, end, free_at, rxne_at;
+  bool txdma, rxdma;
+  uint64_t txdma_at, rxdma_at;
+  uint64_t busy;                      //тактов передачи на линии
+  unsigned long ovr_count;
+};
+
+static Model model[3];
+
+static void model_init (int k, unsigned apb, DMA_TypeDef * d, DMA_Channel_TypeDef * rx_ch, DMA_Channel_TypeDef * tx_ch, uint8_t rx_shift, uint8_t tx_shift)
+{
+  Model & m = model[k];
+
+  memset (&m, 0, sizeof (m));
+  m.apb = apb;
+  m.dma = d;
+  m.rx_ch = rx_ch;
+  m.tx_ch = tx_ch;
+  m.rx_shift = rx_shift;
+  m.tx_shift = tx_shift;
+}
+
+//события SPI и DMA до текущего момента
+static void advance (int k)
+{
+  Model & m = model[k];
+  SPI_TypeDef & r = host_spi[k];
+  unsigned bit = m.apb << (((r.CR1.v >> 3) & 7) + 1);
+
+  for (;;)
+  {
+    bool txon = (r.CR2.v & SPI_CR2_TXDMAEN) && (m.tx_ch->CCR.v & DMA_CCR1_EN) && m.tx_ch->CNDTR.v;
+    bool rxon = (r.CR2.v & SPI_CR2_RXDMAEN) && (m.rx_ch->CCR.v & DMA_CCR1_EN) && m.rx_ch->CNDTR.v;
+
+    if (txon && !m.txdma) m.txdma_at = now;
+    if (rxon && !m.rxdma) m.rxdma_at = now;
+    m.txdma = txon;
+    m.rxdma = rxon;
+    if (txon && !m.txfull)
+    {
+      uint64_t t = (m.txe_at > m.txdma_at ? m.txe_at : m.txdma_at) + dma_lat;
+      if (t <= now)
+      {
+        uint8_t * p = (uint8_t *)(size_t)m.tx_ch->CMAR.v;
+        m.txbuf = *p;
+        if (m.tx_ch->CCR.v & DMA_CCR1_MINC) m.tx_ch->CMAR.v++;
+        if (--m.tx_ch->CNDTR.v == 0) m.dma->ISR.v |= (DMA_ISR_GIF1|DMA_ISR_TCIF1) << m.tx_shift;
+        m.txfull = true;
+        m.tx_at = t;
+        continue;
+      }
+    }
+    if (rxon && m.rxne)
+    {
+      uint64_t t = (m.rxne_at > m.rxdma_at ? m.rxne_at : m.rxdma_at) + dma_lat;
+      if (t <= now)
+      {
+        uint8_t * p = (uint8_t *)(size_t)m.rx_ch->CMAR.v;
+        *p = m.rxbuf;
+        if (m.rx_ch->CCR.v & DMA_CCR1_MINC) m.rx_ch->CMAR.v++;
+        if (--m.rx_ch->CNDTR.v == 0) m.dma->ISR.v |= (DMA_ISR_GIF1|DMA_ISR_TCIF1) << m.rx_shift;
+        m.rxne = false;
+        continue;
+      }
+    }
+    if (!m.shifting && m.txfull && (r.CR1.v & SPI_CR1_SPE))
+    {
+      uint64_t start = m.tx_at > m.free_at ? m.tx_at : m.free_at;
+      m.shift = m.txbuf;
+      m.txfull = false;
+      m.txe_at = start;
+      m.shifting = true;
+      m.end = start + 8*bit;
+      m.busy += 8*bit;
+      continue;
+    }
+    if (m.shifting && m.end <= now)
+    {
+      if (m.rxne)
+      {
+        m.ovr = true;
+        m.ovr_count++;
+      }
+      else
+      {
+        m.rxbuf = (uint8_t)~m.shift;
+        m.rxne = true;
+        m.rxne_at = m.end;
+      }
+      m.shifting = false;
+      m.free_at = m.end;
+      continue;
+    }
+    break;
+  }
+}
+
+static void advance_all ()
+{
+  for (int k = 0; k < 3; k++) advance (k);
+}
+
+//вызов обработчиков, если флаг, TCIE/TEIE, NVIC и PRIMASK позволяют
+static void irq_check ()
+{
+  if (in_irq || primask) return;
+  for (int k = 0; k < 3; k++)
+  {
+    Model & m = model[k];
+    uint32_t ccr = m.rx_ch->CCR.v, isr = m.dma->ISR.v >> m.rx_shift;
+    bool pend = ((ccr & DMA_CCR1_TCIE) && (isr & DMA_ISR_TCIF1)) || ((ccr & DMA_CCR1_TEIE) && (isr & DMA_ISR_TEIF1));
+
+    if (!pend || !(nvic_en & (1ULL << irq_line[k])) || !irq_handler[k]) continue;
+    in_irq = true;
+    now += 12;
+    irq_handler[k] ();
+    now += 12;
+    irq_count++;
+    in_irq = false;
+  }
+}
+
+void NVIC_EnableIRQ (IRQn_Type irq) {nvic_en |= 1ULL << irq; irq_check ();}
+void NVIC_DisableIRQ (IRQn_Type irq) {nvic_en &= ~(1ULL << irq);}
+uint32_t __get_PRIMASK (void) {return primask;}
+void __set_PRIMASK (uint32_t pm) {primask = pm; irq_check ();}
+
+//вычисления без обращений к периферии; события и прерывания идут своим чередом
+static void cpu_work (uint64_t cycles)
+{
+  uint64_t end = now + cycles;
+
+  while (now < end)
+  {
+    now += end - now < 16 ? end - now : 16;
+    advance_all ();
+    irq_check ();
+  }
+}
+
+//номер SPI и регистра по адресу, -1 - не SPI
+static int spi_reg (const void * reg, int & field)
+{
+  size_t off = (const char *)reg - (const char *)host_spi;
+
+  if (off >= sizeof (host_spi)) return -1;
+  field = (off % sizeof (SPI_TypeDef))/sizeof (HostReg<uint16_t>);
+  return off/sizeof (SPI_TypeDef);
+}
+
+enum {CR1, CR2, SR, DR};
+
+uint32_t host_read (const void * reg, uint32_t v)
+{
+  int field, k = spi_reg (reg, field);
+
+  //APB1 вдвое медленнее ядра, обращение к нему вдвое дольше
+  now += k < 0 ? access : access*model[k].apb;
+  if (k < 0)
+  {
+    uint32_t x;
+    advance_all ();
+    x = reg == &host_dwt.CYCCNT ? (uint32_t)now : *(const uint32_t *)reg;
+    irq_check ();
+    return x;
+  }
+  Model & m = model[k];
+  advance (k);
+  if (field == SR)
+  {
+    uint16_t sr = 0;
+    if (m.ovr_dr)
+    {
+      m.ovr = m.ovr_dr = false;
+    }
+    if (!m.txfull) sr |= SPI_SR_TXE;
+    if (m.rxne) sr |= SPI_SR_RXNE;
+    if (m.txfull || m.shifting) sr |= SPI_SR_BSY;
+    if (m.ovr) sr |= SPI_SR_OVR;
+    irq_check ();
+    return sr;
+  }
+  if (field == DR)
+  {
+    m.rxne = false;
+    m.ovr_dr = m.ovr;
+    irq_check ();
+    return m.rxbuf;
+  }
+  irq_check ();
+  return v;
+}
+
+void host_write (void * reg, uint32_t v)
+{
+  int field, k = spi_reg (reg, field);
+
+  now += k < 0 ? access : access*model[k].apb;
+  if (k < 0)
+  {
+    advance_all ();
+    if (reg == &host_dma[0].IFCR || reg == &host_dma[1].IFCR)
+    {
+      DMA_TypeDef * d = reg == &host_dma[0].IFCR ? &host_dma[0] : &host_dma[1];
+      d->ISR.v &= ~v;
+    }
+    else *(uint32_t *)reg = v;
+    advance_all ();
+    irq_check ();
+    return;
+  }
+  Model & m = model[k];
+  advance (k);
+  if (field == DR)
+  {
+    m.txbuf = v;
+    m.txfull = true;
+    m.tx_at = now;
+  }
+  else if (field != SR) ((HostReg<uint16_t> *)reg)->v = v;
+  advance (k);
+  irq_check ();
+}
+
+static uint8_t * tx, * rx;
+
+static bool check (size_t n, size_t got)
+{
+  if (got != n) return false;
+  for (size_t i = 0; i < n; i++)
+    if (rx[i] != (uint8_t)~tx[i]) return false;
+  return true;
+}
+
+//такты и занятость шины на кадр; mode: 0 - byte, 1 - poll, 2 - dma
+template <class S> static bool run (int k, int mode, size_t n, uint64_t & cycles, double & use)
+{
+  Model & m = model[k];
+  uint64_t t0, b0;
+  size_t got = n;
+
+  memset (rx, 0, n);
+  S::dma_min = mode == 2 ? 1 : 0xFFFF;
+  t0 = now;
+  b0 = m.busy;
+  if (mode == 0)
+    for (size_t i = 0; i < n; i++) rx[i] = S::transfer (tx[i]);
+  else got = S::transfer (tx, rx, n);
+  //кадр закончен, когда CS снят; DMA ждёт последний принятый байт
+  cycles = now - t0;
+  use = 100.0*(m.busy - b0)/cycles;
+  return check (n, got);
+}
+
+template <class S> static void bench (int k, const char * name)
+{
+  static const size_t len[] = {1, 2, 4, 8, 16, 32, 64, 256, 1024, 4096};
+  static const char * mode[] = {"byte", "poll", "dma"};
+  unsigned bit = model[k].apb << (((host_spi[k].CR1.v >> 3) & 7) + 1);
+
+  printf ("\n%s, SCK %.2f МГц\n", name, SystemCoreClock/1e6/bit);
+  //frequency() считает по RCC->CFGR, модель - по своему делителю шины
+  if (S::frequency () != SystemCoreClock/bit) error ("frequency() %lu Гц\n", (unsigned long)S::frequency ());
+  printf ("     n |   byte: такты   МБ/с  шина |   poll: такты   МБ/с  шина |    dma: такты   МБ/с  шина\n");
+  for (size_t l = 0; l < sizeof (len)/sizeof (len[0]); l++)
+  {
+    printf ("%6u", (unsigned)len[l]);
+    for (int i = 0; i < 3; i++)
+    {
+      uint64_t cycles;
+      double use;
+      bool ok = run<S> (k, i, len[l], cycles, use);
+
+      printf (" | %13llu %6.2f %4.0f%%", (unsigned long long)cycles, len[l]*SystemCoreClock/1e6/cycles, use);
+      if (!ok) error ("%s", mode[i]);
+    }
+    printf ("\n");
+  }
+  printf ("OVR: %lu\n", model[k].ovr_count);
+}
+
+static unsigned frames_done;
+static bool frames_ok;
+
+static void frame_done (void * ctx, size_t n)
+{
+  size_t len = (size_t)ctx;
+
+  frames_ok = frames_ok && n == len;
+  frames_done++;
+}
+
+//K кадров по n байт, после каждого - обработка work тактов
+template <class S> static void overlap (const char * name)
+{
+  static const size_t len[] = {16, 64, 256, 1024};
+
+  printf ("\n%s, %u тактов обработки на кадр\n", name, work);
+  printf ("     n  кадров |  sync: такты |  async: такты  выигрыш\n");
+  S::dma_min = SPI_DMA_MIN;
+  for (size_t l = 0; l < sizeof (len)/sizeof (len[0]); l++)
+  {
+    size_t n = len[l], K = 4096/n > 16 ? 16 : 4096/n;
+    uint64_t t0, sync, async;
+    bool ok = true;
+
+    memset (rx, 0, 4096);
+    t0 = now;
+    for (size_t i = 0; i < K; i++)
+    {
+      ok = ok && S::transfer (tx + i*n, rx + i*n, n) == n;
+      cpu_work (work);
+    }
+    sync = now - t0;
+    ok = ok && check (K*n, K*n);
+
+    memset (rx, 0, 4096);
+    frames_done = 0;
+    frames_ok = true;
+    t0 = now;
+    for (size_t i = 0; i < K; i++)
+    {
+      //очередь полна - обработка ждёт
+      while (!S::transferAsync (tx + i*n, rx + i*n, n, frame_done, (void *)n)) cpu_work (16);
+      cpu_work (work);
+    }
+    while (S::busy ()) cpu_work (16);
+    async = now - t0;
+    ok = ok && frames_ok && frames_done == K && check (K*n, K*n);
+
+    printf ("%6u %7u | %12llu | %13llu  %6.2f", (unsigned)n, (unsigned)K, (unsigned long long)sync, (unsigned long long)async, (double)sync/async);
+    if (!ok) error ("");
+    printf ("\n");
+  }
+}
+
+static bool check_at (size_t off, size_t n)
+{
+  for (size_t i = off; i < off + n; i++)
+    if (rx[i] != (uint8_t)~tx[i]) return false;
+  return true;
+}
+
+static void cross_done (void *, size_t n)
+{
+  frames_ok = frames_ok && n == 16;
+  frames_ok = frames_ok && Spi<SpiBase::spi1>::transferAsync (tx + 3072, rx + 3072, 64, frame_done, (void *)64);
+}
+
+//Spi<> с разными CS на одном SPI: transferAsync() обоих в одну очередь
+static void shared ()
+{
+  typedef Spi<SpiBase::spi1> A;
+  typedef Spi<SpiBase::spi1, SpiBase::B, 0> B;
+  bool ok = true;
+  uint32_t a0 = 0, b0 = 0;
+
+#ifdef SPI_PROF
+  a0 = A::prof.frames;
+  b0 = B::prof.frames;
+#endif
+  memset (rx, 0, 4096);
+  frames_done = 0;
+  frames_ok = true;
+  for (int i = 0; i < 8; i++)
+  {
+    if (i & 1) while (!B::transferAsync (tx + i*256, rx + i*256, 256, frame_done, (void *)256)) cpu_work (16);
+    else while (!A::transferAsync (tx + i*256, rx + i*256, 256, frame_done, (void *)256)) cpu_work (16);
+  }
+  //с ограничением: кадр, поставленный не в ту очередь, не закончится
+  for (int t = 0; (A::busy () || B::busy ()) && t < 100000; t++) cpu_work (16);
+  ok = frames_ok && frames_done == 8 && check_at (0, 8*256);
+#ifdef SPI_PROF
+  //кадры считаются устройству, поставившему их в очередь
+  ok = ok && A::prof.frames == a0 + 4 && B::prof.frames == b0 + 4;
+#endif
+  (void)a0;
+  (void)b0;
+  printf ("\nSPI1, два CS, transferAsync() вперемешку: %s\n", ok ? "да" : "ОШИБКА");
+  if (!ok) errors++;
+}
+
+//transferAsync() из прерывания во время transfer() того же SPI
+static void cross ()
+{
+  typedef Spi<SpiBase::spi1> S1;
+  typedef Spi<SpiBase::spi2> S2;
+  unsigned long irq0 = irq_count;
+  bool ok;
+
+  memset (rx, 0, 4096);
+  frames_done = 0;
+  frames_ok = true;
+  S1::dma_min = 1;
+  ok = S2::transferAsync (tx + 2048, rx + 2048, 16, cross_done);
+  ok = ok && S1::transfer (tx, rx, 1024) == 1024 && check_at (0, 1024);
+  //кадр SPI2 закончился во время transfer(), SPI1 ещё не начат
+  ok = ok && irq_count == irq0 + 1 && S1::busy ();
+  while (S1::busy () || S2::busy ()) cpu_work (16);
+  ok = ok && frames_ok && frames_done == 1 && check_at (2048, 16) && check_at (3072, 64);
+  S1::dma_min = SPI_DMA_MIN;
+  printf ("\ntransferAsync() SPI1 из прерывания SPI2 во время transfer() SPI1: %s\n", ok ? "да" : "ОШИБКА");
+  if (!ok) errors++;
+}
+
+//frequency() при HCLK ниже частоты ядра: HPRE /8, SystemCoreClock 9 МГц, как его
+//пересчитывает CMSIS, APB1 /2, APB2 /4. Делитель HPRE уже в SystemCoreClock и
+//второй раз не применяется. Частоты и CR1 восстанавливаются.
+static void clocks ()
+{
+  typedef Spi<SpiBase::spi1> S1;
+  typedef Spi<SpiBase::spi2> S2;
+  static const uint32_t hz[] = {4500000, 2250000, 1000000, 100000, 1};
+  uint32_t cfgr = RCC->CFGR, core = SystemCoreClock;
+  uint16_t cr1[2] = {host_spi[0].CR1.v, host_spi[1].CR1.v};
+  bool ok = true;
+
+  RCC->CFGR = RCC_CFGR_HPRE_DIV8|RCC_CFGR_PPRE1_DIV2|RCC_CFGR_PPRE2_DIV4;
+  SystemCoreClock = 9000000;
+  for (size_t i = 0; i < sizeof (hz)/sizeof (hz[0]); i++)
+  {
+    //ожидаемое: наибольшее Fpclk/2..Fpclk/256 не выше hz, иначе Fpclk/256
+    uint32_t pclk[2] = {9000000/4, 9000000/2}, f[2];
+
+    f[0] = S1::frequency (hz[i]);
+    f[1] = S2::frequency (hz[i]);
+    for (int k = 0; k < 2; k++)
+    {
+      uint32_t want = pclk[k] >> 8;
+
+      for (int b = 7; b >= 1; b--) if ((pclk[k] >> b) <= hz[i]) want = pclk[k] >> b;
+      if (f[k] != want) ok = false;
+    }
+    ok = ok && S1::frequency () == f[0] && S2::frequency () == f[1];
+    printf ("%s%lu Гц: SPI1 %lu, SPI2 %lu", i ? "; " : "\nHCLK 9 МГц, APB2 /4, APB1 /2, frequency() ", (unsigned long)hz[i], (unsigned long)f[0], (unsigned long)f[1]);
+  }
+  printf (": %s\n", ok ? "да" : "ОШИБКА");
+  if (!ok) errors++;
+  RCC->CFGR = cfgr;
+  SystemCoreClock = core;
+  host_spi[0].CR1.v = cr1[0];
+  host_spi[1].CR1.v = cr1[1];
+}
+
+//R циклов: ЦАП 3 байта, АЦП 4 байта, flash 4 + 256 байт
+static void bus (unsigned R)
+{
+  typedef SpiBus<SpiBase::spi1> Bus;
+  static const char * mode[] = {"transfer       ", "submit         ", "submit группами"};
+  Bus b;
+  SpiDev dac = Bus::device (SpiBase::B, 0, SpiBase::max, SpiBase::Neg, SpiBase::Rising);
+  SpiDev adc = Bus::device (SpiBase::B, 1, SpiBase::med, SpiBase::Pos, SpiBase::Rising);
+  SpiDev flash = Bus::device (SpiBase::A, 4, SpiBase::max, SpiBase::Neg, SpiBase::Faling);
+  //предельные частоты устройств вместо low/med/max
+  uint32_t f_dac = Bus::frequency (dac, 30000000);
+  uint32_t f_adc = Bus::frequency (adc, 2000000);
+  uint32_t f_flash = Bus::frequency (flash, 50000000);
+  const SpiDev * dev[3] = {&dac, &adc, &flash};
+  static const size_t len[3] = {3, 4, 4};
+  size_t total = R*(3 + 4 + 4 + 256);
+
+  (void)b;
+  irq_handler[0] = Bus::isr;
+  printf ("\nSpiBus, SPI1, %u циклов ЦАП + АЦП + flash, %u байт\n", R, (unsigned)total);
+  printf ("SCK: ЦАП %.3f МГц (до 30), АЦП %.3f МГц (до 2), flash %.3f МГц (до 50)\n", f_dac/1e6, f_adc/1e6, f_flash/1e6);
+  printf ("                |    такты  шина  CR1\n");
+  for (int m = 0; m < 3; m++)
+  {
+    uint64_t t0 = now, b0 = model[0].busy;
+    uint32_t r0 = Bus::reconfig;
+    size_t off = 0;
+    bool ok = true;
+
+    memset (rx, 0, 4096);
+    frames_done = 0;
+    frames_ok = true;
+    for (int d = 0; d < 3; d++) dev[d]->prof = SpiBase::Prof ();
+    for (unsigned c = 0; c < R; c++)
+    {
+      for (int k = 0; k < 3; k++)
+      {
+        //группами: сначала все кадры ЦАП, потом АЦП, потом flash
+        int d = m == 2 ? (c*3 + k)/R : k;
+        size_t at = m == 2 ? ((c*3 + k) % R)*(len[d] + (d == 2 ? 256 : 0)) + (d == 0 ? 0 : d == 1 ? R*3 : R*7) : off;
+        size_t n = len[d];
+
+        if (m == 0)
+        {
+          ok = ok && Bus::transfer (*dev[d], tx + at, rx + at, n + (d == 2 ? 256 : 0)) == n + (d == 2 ? 256 : 0);
+          off += n + (d == 2 ? 256 : 0);
+          continue;
+        }
+        while (!Bus::submit (*dev[d], tx + at, rx + at, n, frame_done, (void *)n, d == 2)) cpu_work (16);
+        if (d == 2)
+          while (!Bus::submit (*dev[d], tx + at + n, rx + at + n, 256, frame_done, (void *)256)) cpu_work (16);
+        off += n + (d == 2 ? 256 : 0);
+      }
+    }
+    while (Bus::busy ()) cpu_work (16);
+    ok = ok && frames_ok && check (total, total);
+    if (m) ok = ok && frames_done == R*4;
+    printf ("%s | %8llu %4.0f%% %4u", mode[m], (unsigned long long)(now - t0), 100.0*(model[0].busy - b0)/(now - t0), (unsigned)(Bus::reconfig - r0));
+    if (!ok) error ("");
+    printf ("\n");
+#ifdef SPI_PROF
+    static const char * name[3] = {"ЦАП  ", "АЦП  ", "flash"};
+    uint32_t bytes = 0;
+
+    for (int d = 0; d < 3; d++)
+    {
+      const SpiBase::Prof & p = dev[d]->prof;
+
+      //transfer() передаёт команду и страницу flash одним кадром
+      if (p.frames != (d == 2 && m ? 2*R : R)) error ("кадров %u\n", (unsigned)p.frames);
+      bytes += p.bytes;
+      printf ("    %s      | кадров %4u, байт %5u, на линии %7u, ожидание %7u, макс. кадр %5u\n",
+        name[d], (unsigned)p.frames, (unsigned)p.bytes, (unsigned)p.busy, (unsigned)p.wait, (unsigned)p.max);
+    }
+    if (bytes != total) error ("байт %u\n", (unsigned)bytes);
+#endif
+  }
+  irq_handler[0] = Spi<SpiBase::spi1>::isr;
+}
+
+int main (int argc, char * argv[])
+{
+  uint8_t speed = SpiBase::max;
+  uint32_t hz = 0;
+
+  for (int i = 1; i + 1 < argc; i += 2)
+  {
+    if (!strcmp (argv[i], "-a")) access = atoi (argv[i + 1]);
+    else if (!strcmp (argv[i], "-l")) dma_lat = atoi (argv[i + 1]);
+    else if (!strcmp (argv[i], "-w")) work = atoi (argv[i + 1]);
+    else if (!strcmp (argv[i], "-f")) hz = atoi (argv[i + 1]);
+    else if (!strcmp (argv[i], "-s")) speed = !strcmp (argv[i + 1], "low") ? SpiBase::low : !strcmp (argv[i + 1], "med") ? SpiBase::med : SpiBase::max;
+  }
+  model_init (0, 1, DMA1, DMA1_Channel2, DMA1_Channel3, 4, 8);
+  model_init (1, 2, DMA1, DMA1_Channel4, DMA1_Channel5, 12, 16);
+  model_init (2, 2, DMA2, DMA2_Channel1, DMA2_Channel2, 0, 4);
+  tx = (uint8_t *)mmap (0, 2*4096, PROT_READ|PROT_WRITE, MAP_PRIVATE|MAP_ANONYMOUS|MAP_32BIT, -1, 0);
+  if (tx == MAP_FAILED) return 1;
+  rx = tx + 4096;
+  for (int i = 0; i < 4096; i++) tx[i] = rand ();
+
+  //APB1 - половина частоты ядра, как в модели
+  RCC->CFGR = RCC_CFGR_PPRE1_DIV2;
+  irq_handler[0] = Spi<SpiBase::spi1>::isr;
+  irq_handler[1] = Spi<SpiBase::spi2>::isr;
+  Spi<SpiBase::spi1> spi1 (speed);
+  //второе устройство на SPI1, CS на B0
+  Spi<SpiBase::spi1, SpiBase::B, 0> spi1b (speed);
+  Spi<SpiBase::spi2> spi2 (speed);
+  if (hz)
+  {
+    spi1.frequency (hz);
+    spi2.frequency (hz);
+  }
+  printf ("обращение к регистру %u тактов, задержка DMA %u тактов, ядро %.0f МГц\n", access, dma_lat, SystemCoreClock/1e6);
+  clocks ();
+  bench< Spi<SpiBase::spi1> > (0, "SPI1");
+  bench< Spi<SpiBase::spi2> > (1, "SPI2");
+  overlap< Spi<SpiBase::spi1> > ("SPI1");
+  overlap< Spi<SpiBase::spi2> > ("SPI2");
+  shared ();
+  cross ();
+  bus (8);
+  printf ("прерываний: %lu, ошибок: %u\n", irq_count, errors);
+  return errors ? 1 : 0;
+}
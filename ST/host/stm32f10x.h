@@ -0,0 +1,182 @@
+//Заменитель stm32f10x.h для сборки spi_f10x_cpp на ПК (SpiBench.cpp).
+//Регистры SPI и DMA - объекты HostReg: каждое чтение и запись вызывает модель
+//host_read()/host_write(), которая считает такты и ведёт себя как периферия.
+//GPIO, RCC и AFIO - просто память.
+
+#ifndef STM32F10X_HOST_H
+#define STM32F10X_HOST_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+extern uint32_t host_read (const void * reg, uint32_t v);
+extern void host_write (void * reg, uint32_t v);
+
+template <class T> struct HostReg
+{
+  T v;
+  operator T () const {return (T)host_read (this, v);}
+  HostReg & operator = (T x) {host_write (this, x); return *this;}
+  HostReg & operator |= (T x) {return *this = (T)(*this | x);}
+  HostReg & operator &= (T x) {return *this = (T)(*this & x);}
+};
+
+typedef struct
+{
+  volatile uint32_t CRL, CRH, IDR, ODR, BSRR, BRR, LCKR;
+} GPIO_TypeDef;
+
+typedef struct
+{
+  HostReg<uint16_t> CR1, CR2, SR, DR, CRCPR, RXCRCR, TXCRCR, I2SCFGR, I2SPR;
+} SPI_TypeDef;
+
+typedef struct
+{
+  HostReg<uint32_t> CCR, CNDTR, CPAR, CMAR;
+} DMA_Channel_TypeDef;
+
+typedef struct
+{
+  HostReg<uint32_t> ISR, IFCR;
+} DMA_TypeDef;
+
+typedef struct
+{
+  volatile uint32_t CR, CFGR, CIR, APB2RSTR, APB1RSTR, AHBENR, APB2ENR, APB1ENR, BDCR, CSR;
+} RCC_TypeDef;
+
+typedef struct
+{
+  volatile uint32_t EVCR, MAPR, EXTICR[4], MAPR2;
+} AFIO_TypeDef;
+
+//DWT->CYCCNT при чтении - такты модели
+typedef struct
+{
+  HostReg<uint32_t> CTRL, CYCCNT;
+} DWT_Type;
+
+typedef struct
+{
+  volatile uint32_t DHCSR, DCRSR, DCRDR, DEMCR;
+} CoreDebug_Type;
+
+typedef enum
+{
+  DMA1_Channel1_IRQn = 11, DMA1_Channel2_IRQn, DMA1_Channel3_IRQn, DMA1_Channel4_IRQn,
+  DMA1_Channel5_IRQn, DMA1_Channel6_IRQn, DMA1_Channel7_IRQn,
+  SPI1_IRQn = 35, SPI2_IRQn = 36, SPI3_IRQn = 51,
+  DMA2_Channel1_IRQn = 56, DMA2_Channel2_IRQn, DMA2_Channel3_IRQn, DMA2_Channel4_5_IRQn
+} IRQn_Type;
+
+//NVIC и PRIMASK - тоже модель: прерывание вызывается, когда разрешено и не замаскировано
+extern void NVIC_EnableIRQ (IRQn_Type irq);
+extern void NVIC_DisableIRQ (IRQn_Type irq);
+extern uint32_t __get_PRIMASK (void);
+extern void __set_PRIMASK (uint32_t pm);
+static inline void __disable_irq (void) {__set_PRIMASK (1);}
+static inline void __enable_irq (void) {__set_PRIMASK (0);}
+
+extern GPIO_TypeDef host_gpio[5];
+extern SPI_TypeDef host_spi[3];
+extern DMA_TypeDef host_dma[2];
+extern DMA_Channel_TypeDef host_dma_ch[2][7];
+extern RCC_TypeDef host_rcc;
+extern AFIO_TypeDef host_afio;
+extern DWT_Type host_dwt;
+extern CoreDebug_Type host_coredebug;
+extern uint32_t SystemCoreClock;
+
+#define GPIOA (&host_gpio[0])
+#define GPIOB (&host_gpio[1])
+#define GPIOC (&host_gpio[2])
+#define GPIOD (&host_gpio[3])
+#define GPIOE (&host_gpio[4])
+#define SPI1 (&host_spi[0])
+#define SPI2 (&host_spi[1])
+#define SPI3 (&host_spi[2])
+#define DMA1 (&host_dma[0])
+#define DMA2 (&host_dma[1])
+#define DMA1_Channel1 (&host_dma_ch[0][0])
+#define DMA1_Channel2 (&host_dma_ch[0][1])
+#define DMA1_Channel3 (&host_dma_ch[0][2])
+#define DMA1_Channel4 (&host_dma_ch[0][3])
+#define DMA1_Channel5 (&host_dma_ch[0][4])
+#define DMA1_Channel6 (&host_dma_ch[0][5])
+#define DMA1_Channel7 (&host_dma_ch[0][6])
+#define DMA2_Channel1 (&host_dma_ch[1][0])
+#define DMA2_Channel2 (&host_dma_ch[1][1])
+#define DMA2_Channel3 (&host_dma_ch[1][2])
+#define DMA2_Channel4 (&host_dma_ch[1][3])
+#define DMA2_Channel5 (&host_dma_ch[1][4])
+#define RCC (&host_rcc)
+#define AFIO (&host_afio)
+#define DWT (&host_dwt)
+#define CoreDebug (&host_coredebug)
+
+#define SPI_CR1_CPHA ((uint16_t)0x0001)
+#define SPI_CR1_CPOL ((uint16_t)0x0002)
+#define SPI_CR1_MSTR ((uint16_t)0x0004)
+#define SPI_CR1_BR ((uint16_t)0x0038)
+#define SPI_CR1_BR_0 ((uint16_t)0x0008)
+#define SPI_CR1_BR_1 ((uint16_t)0x0010)
+#define SPI_CR1_BR_2 ((uint16_t)0x0020)
+#define SPI_CR1_SPE ((uint16_t)0x0040)
+#define SPI_CR1_LSBFIRST ((uint16_t)0x0080)
+#define SPI_CR1_SSI ((uint16_t)0x0100)
+#define SPI_CR1_SSM ((uint16_t)0x0200)
+#define SPI_CR1_DFF ((uint16_t)0x0800)
+
+#define SPI_CR2_RXDMAEN ((uint8_t)0x01)
+#define SPI_CR2_TXDMAEN ((uint8_t)0x02)
+#define SPI_CR2_SSOE ((uint8_t)0x04)
+#define SPI_CR2_ERRIE ((uint8_t)0x20)
+#define SPI_CR2_RXNEIE ((uint8_t)0x40)
+#define SPI_CR2_TXEIE ((uint8_t)0x80)
+
+#define SPI_SR_RXNE ((uint8_t)0x01)
+#define SPI_SR_TXE ((uint8_t)0x02)
+#define SPI_SR_MODF ((uint8_t)0x20)
+#define SPI_SR_OVR ((uint8_t)0x40)
+#define SPI_SR_BSY ((uint8_t)0x80)
+
+#define DMA_CCR1_EN ((uint16_t)0x0001)
+#define DMA_CCR1_TCIE ((uint16_t)0x0002)
+#define DMA_CCR1_HTIE ((uint16_t)0x0004)
+#define DMA_CCR1_TEIE ((uint16_t)0x0008)
+#define DMA_CCR1_DIR ((uint16_t)0x0010)
+#define DMA_CCR1_CIRC ((uint16_t)0x0020)
+#define DMA_CCR1_PINC ((uint16_t)0x0040)
+#define DMA_CCR1_MINC ((uint16_t)0x0080)
+#define DMA_CCR1_PL ((uint16_t)0x3000)
+
+#define DMA_ISR_GIF1 ((uint32_t)0x00000001)
+#define DMA_ISR_TCIF1 ((uint32_t)0x00000002)
+#define DMA_ISR_HTIF1 ((uint32_t)0x00000004)
+#define DMA_ISR_TEIF1 ((uint32_t)0x00000008)
+#define DMA_IFCR_CGIF1 ((uint32_t)0x00000001)
+
+#define RCC_CFGR_HPRE ((uint32_t)0x000000F0)
+#define RCC_CFGR_HPRE_DIV8 ((uint32_t)0x000000A0)
+#define RCC_CFGR_PPRE1 ((uint32_t)0x00000700)
+#define RCC_CFGR_PPRE1_DIV2 ((uint32_t)0x00000400)
+#define RCC_CFGR_PPRE2 ((uint32_t)0x00003800)
+#define RCC_CFGR_PPRE2_DIV4 ((uint32_t)0x00002800)
+
+#define RCC_AHBENR_DMA1EN ((uint32_t)0x00000001)
+#define RCC_AHBENR_DMA2EN ((uint32_t)0x00000002)
+#define RCC_APB2ENR_AFIOEN ((uint32_t)0x00000001)
+#define RCC_APB2ENR_IOPAEN ((uint32_t)0x00000004)
+#define RCC_APB2ENR_IOPBEN ((uint32_t)0x00000008)
+#define RCC_APB2ENR_SPI1EN ((uint32_t)0x00001000)
+#define RCC_APB1ENR_SPI2EN ((uint32_t)0x00004000)
+#define RCC_APB1ENR_SPI3EN ((uint32_t)0x00008000)
+
+#define DWT_CTRL_CYCCNTENA_Msk (1UL << 0)
+#define CoreDebug_DEMCR_TRCENA_Msk (1UL << 24)
+
+#define AFIO_MAPR_SWJ_CFG ((uint32_t)0x07000000)
+#define AFIO_MAPR_SWJ_CFG_JTAGDISABLE ((uint32_t)0x02000000)
+
+#endif
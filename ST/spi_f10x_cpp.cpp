@@ -2,77 +2,140 @@
 #include "spi_f10x_cpp.h"
 
 
-uint8_t Spi::transfer (uint8_t data)
+void SpiBase::pin_mode (GPIO_TypeDef * port, uint8_t pin, uint8_t mode)
 {
-  GPIOB->ODR &= ~GPIO_ODR_ODR12;
-  SPI2->DR = data; //Пишем в буфер передатчика SPI1. После этого стартует обмен данными
-  while(SPI2->SR & SPI_SR_BSY); 
-	GPIOB->ODR |= GPIO_ODR_ODR12;
-  return SPI2->DR;
+  volatile uint32_t * cr = pin < 8 ? &port->CRL : &port->CRH;
+  uint8_t shift = (pin & 7)*4;
 
+  *cr = (*cr & ~(0xFUL << shift)) | ((uint32_t)mode << shift);
 }
 
 
-  Spi::Spi(uint8_t num, uint8_t sp, int8_t role, int8_t cpol, int8_t cpha)
+void SpiBase::config (SPI_TypeDef * s, uint16_t br, int8_t role, int8_t cpol, int8_t cpha)
 {
-  if (num == spi1) 
+  uint16_t cr1 = br;
+
+  s->CR2 = 0;
+  s->CR1 = 0;
+
+  if (cpol == Pos) cr1 |= SPI_CR1_CPOL;
+  if (cpha == Rising) cr1 |= SPI_CR1_CPHA;
+  if (role == master)
+  {
+    s->CR2 |= SPI_CR2_SSOE;
+    cr1 |= SPI_CR1_MSTR; //Режим Master
+  }
+  else cr1 |= SPI_CR1_SSM; //Slave: NSS программно, SSI = 0 - всегда выбран
+  s->CR1 = cr1;
+  s->CR1 |= SPI_CR1_SPE; //Включаем SPI
+}
+
+
+//частота шины SPI: SPI1 - APB2, SPI2 и SPI3 - APB1, по делителю PPRE из RCC->CFGR;
+//SystemCoreClock - это уже HCLK, делитель HPRE в нём учтён
+uint32_t SpiBase::pclk (bool apb2)
+{
+  uint32_t cfgr = RCC->CFGR;
+  uint32_t ppre = apb2 ? (cfgr & RCC_CFGR_PPRE2) >> 11 : (cfgr & RCC_CFGR_PPRE1) >> 8;
+
+  return ppre & 4 ? SystemCoreClock >> ((ppre & 3) + 1) : SystemCoreClock;
+}
+
+
+//BR для наибольшей частоты SCK не выше hz; медленнее Fpclk/256 не бывает
+uint16_t SpiBase::br_hz (uint32_t pclk, uint32_t hz)
 {
-  spi1_init (sp, role, cpol, cpha);
- // n = num;
+  uint16_t br = 0;
+
+  while (br < 7 && (pclk >> (br + 1)) > hz) br++;
+  return br << 3;
 }
-  if (num == spi2) spi2_init (sp, role, cpol, cpha);
-  
+
+
+size_t SpiBase::exchange_poll (SPI_TypeDef * s, const uint8_t * tx, uint8_t * rx, size_t n)
+{
+  size_t i = 0, j = 0;
+
+  if (s->SR & SPI_SR_RXNE) (void)s->DR;
+  //не больше двух байт в пути: буфер передатчика и сдвиговый регистр
+  while (j < n)
+  {
+    uint16_t sr = s->SR;
+
+    if ((sr & SPI_SR_TXE) && i < n && i - j < 2)
+    {
+      s->DR = tx ? tx[i] : 0xFF;
+      i++;
+    }
+    if (sr & SPI_SR_RXNE)
+    {
+      uint8_t b = s->DR;
+      if (rx) rx[j] = b;
+      j++;
+    }
+    //всё передано, а принятого нет - байт потерян (OVR)
+    else if (i == n && (s->SR & (SPI_SR_TXE|SPI_SR_BSY|SPI_SR_RXNE)) == SPI_SR_TXE) break;
+  }
+  while (s->SR & SPI_SR_BSY);
+  if (s->SR & SPI_SR_OVR)
+  {
+    (void)s->DR;
+    (void)s->SR;
+  }
+  return j;
 }
 
-void Spi::spi2_init (uint8_t sp, int8_t role, int8_t cpol, int8_t cpha)
+
+void SpiBase::dma_start (SPI_TypeDef * s, const Dma & d, const uint8_t * tx, uint8_t * rx, uint16_t n, bool irq)
 {
-    RCC->APB1ENR |=RCC_APB1ENR_SPI2EN;
-	RCC->APB2ENR |=RCC_APB2ENR_IOPBEN|RCC_APB2ENR_AFIOEN;
-	//B12 - CS; B13 - SCK; B14 - MISO; B15 - MOSI
-	GPIOB->CRH &= ~(GPIO_CRH_MODE13|GPIO_CRH_MODE14|GPIO_CRH_MODE15|GPIO_CRH_CNF13|GPIO_CRH_CNF14|GPIO_CRH_CNF15);
-	GPIOB->CRH |=	GPIO_CRH_MODE13|GPIO_CRH_MODE15|GPIO_CRH_CNF13_1 |GPIO_CRH_CNF14_1|GPIO_CRH_CNF15_1;
-	
-	//настройка CS
-	GPIOB->CRH &= ~(GPIO_CRH_MODE12|GPIO_CRH_CNF12);
-	GPIOB->CRH |= GPIO_CRH_MODE12;	
-  GPIOB->ODR |= GPIO_ODR_ODR12;
-
-	SPI2->CR2 =0;
-	SPI2->CR1 =0;
-
-	SPI2->CR2 |= SPI_CR2_SSOE;
-
-  if (cpol == Pos) SPI2->CR1 = SPI_CR1_CPOL;
-  if (cpha == Rising) SPI2->CR1 = SPI_CR1_CPHA;
-  if (sp == low)SPI2->CR1 |= SPI_CR1_BR_2; //Baud rate = Fpclk/32  = 1.125Mhz
-  if (sp == med) SPI2->CR1 |= SPI_CR1_BR_1; // Baud rate = Fpclk/8 = 4.5Mhz
-
-	SPI2->CR1 |= SPI_CR1_BR_1; //Baud rate = Fpclk/8
-  SPI2->CR1 |= SPI_CR1_MSTR; //Режим Master
-  SPI2->CR1 |= SPI_CR1_SPE; //Включаем SPI1
+  static const uint8_t ff = 0xFF;
+  static uint8_t sink;
+
+  if (s->SR & SPI_SR_RXNE) (void)s->DR;
+  d.rx->CCR = 0;
+  d.tx->CCR = 0;
+  d.dma->IFCR = (0xFUL << d.rx_shift)|(0xFUL << d.tx_shift);
+  d.rx->CPAR = (uint32_t)(size_t)&s->DR;
+  d.rx->CMAR = (uint32_t)(size_t)(rx ? rx : &sink);
+  d.rx->CNDTR = n;
+  //конец кадра - по окончании приёма, прерывание только у канала RX
+  d.rx->CCR = (rx ? DMA_CCR1_MINC : 0)|(irq ? DMA_CCR1_TCIE|DMA_CCR1_TEIE : 0)|DMA_CCR1_EN;
+  d.tx->CPAR = (uint32_t)(size_t)&s->DR;
+  d.tx->CMAR = (uint32_t)(size_t)(tx ? tx : &ff);
+  d.tx->CNDTR = n;
+  d.tx->CCR = (tx ? DMA_CCR1_MINC : 0)|DMA_CCR1_DIR|DMA_CCR1_EN;
+  //сначала RX, чтобы первый принятый байт не потерялся
+  s->CR2 |= SPI_CR2_RXDMAEN;
+  s->CR2 |= SPI_CR2_TXDMAEN;
 }
 
 
-void Spi::spi1_init (uint8_t sp, int8_t role, int8_t cpol, int8_t cpha)
+bool SpiBase::dma_stop (SPI_TypeDef * s, const Dma & d)
 {
-  RCC->APB2ENR |=RCC_APB2ENR_SPI1EN|RCC_APB2ENR_IOPAEN|RCC_APB2ENR_AFIOEN;
-	//A4 - CS; A5 - SCK; A6 - MISO; A7 - MOSI
-	GPIOA->CRL &= ~(GPIO_CRL_MODE5|GPIO_CRL_MODE7|GPIO_CRL_MODE6|GPIO_CRL_CNF5|GPIO_CRL_CNF6|GPIO_CRL_CNF7);
-	GPIOA->CRL |=	GPIO_CRL_MODE5|GPIO_CRL_MODE7|GPIO_CRL_CNF5_1 |GPIO_CRL_CNF7_1|GPIO_CRL_CNF6_1;
-	
-	//настройка CS
-	GPIOA->CRL &= ~(GPIO_CRL_MODE4|GPIO_CRL_CNF4);
-	GPIOA->CRL |= GPIO_CRL_MODE4;
-	GPIOA->ODR |= GPIO_ODR_ODR4;
-	SPI1->CR2 =0;
-	SPI1->CR1 =0;
-	SPI1->CR2 |= SPI_CR2_SSOE;
-  if (cpol == Pos) SPI1->CR1 = SPI_CR1_CPOL;
-  if (cpha == Rising) SPI1->CR1 = SPI_CR1_CPHA;
-  if (sp == low)SPI1->CR1 |= SPI_CR1_BR_0|SPI_CR1_BR_2; //Baud rate = Fpclk/64
-  if (sp == med) SPI1->CR1 |= SPI_CR1_BR_0|SPI_CR1_BR_1; // Baud rate = Fpclk/16
-  if (sp == max) SPI1->CR1 |= SPI_CR1_BR_0; // Baud rate = Fpclk/4
-  SPI1->CR1 |= SPI_CR1_MSTR; //Режим Master
-  SPI1->CR1 |= SPI_CR1_SPE; //Включаем SPI1
+  bool ok = !(d.dma->ISR & (DMA_ISR_TEIF1 << d.rx_shift));
+
+  s->CR2 &= ~(SPI_CR2_RXDMAEN|SPI_CR2_TXDMAEN);
+  d.rx->CCR = 0;
+  d.tx->CCR = 0;
+  d.dma->IFCR = (0xFUL << d.rx_shift)|(0xFUL << d.tx_shift);
+  return ok;
 }
 
+
+size_t SpiBase::exchange_dma (SPI_TypeDef * s, const Dma & d, const uint8_t * tx, uint8_t * rx, size_t n)
+{
+  size_t done = 0;
+
+  //CNDTR 16 бит, длинный кадр - несколькими циклами DMA
+  while (done < n)
+  {
+    uint16_t k = n - done > 0xFFFF ? 0xFFFF : n - done;
+
+    dma_start (s, d, tx ? tx + done : 0, rx ? rx + done : 0, k, false);
+    //RX закончен - последний байт принят, SPI свободен
+    while (!(d.dma->ISR & ((DMA_ISR_TCIF1|DMA_ISR_TEIF1) << d.rx_shift)));
+    if (!dma_stop (s, d)) break;
+    done += k;
+  }
+  return done;
+}
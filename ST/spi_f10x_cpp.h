@@ -1,31 +1,671 @@
-#include "stm32f10x.h"  
+#include "stm32f10x.h"
+#include <stddef.h>
 
 #ifndef SPI_F10X_CPP_H
 #define SPI_F10X_CPP_H
 
+//SPI_PROF - статистика обменов по устройствам, см. SpiBase::Prof;
+//время - SPI_PROF_TIME(), по умолчанию такты ядра из DWT->CYCCNT
+#if defined(SPI_PROF) && !defined(SPI_PROF_TIME)
+#define SPI_PROF_TIME() (DWT->CYCCNT)
+#define SPI_PROF_DWT
+#endif
+
 
-class Spi
+//общее для всех SPI, не зависит от номера
+class SpiBase
 {
 public:
-  Spi (uint8_t num = spi2, uint8_t speed=med, int8_t role=master, int8_t cpol=Neg, int8_t cpha=Faling);
   enum Num_spi {spi1,spi2,spi3};
-enum Speed {low,med,max};
-  uint8_t transfer (uint8_t);
+  enum Speed {low,med,max};
+  enum Role {master,slave};
+  enum Cpol {Neg, Pos};
+  enum Cpha {Faling, Rising};
+  enum Port {A,B,C,D,E};
+
+  //каналы DMA одного SPI, сдвиг - позиция флагов канала в ISR/IFCR
+  struct Dma
+  {
+    DMA_TypeDef * dma;
+    DMA_Channel_TypeDef * rx;
+    DMA_Channel_TypeDef * tx;
+    uint8_t rx_shift, tx_shift;
+  };
+
+  //вызывается по окончании transferAsync(), n - принято байт, 0 - ошибка DMA
+  typedef void (*Callback) (void * ctx, size_t n);
+
+  struct Job
+  {
+    const uint8_t * tx;
+    uint8_t * rx;
+    uint16_t n;
+    Callback cb;
+    void * ctx;
+  };
+
+#ifdef SPI_PROF
+  //статистика устройства, время в тиках SPI_PROF_TIME(); без SPI_PROF - пустая
+  struct Prof
+  {
+    uint32_t frames;                  //кадров
+    uint32_t bytes;                   //байт
+    uint32_t busy;                    //сумма длительностей кадров, от CS до CS
+    uint32_t max;                     //самый длинный кадр
+    uint32_t wait;                    //ядро ждало: RXNE/BSY, конец DMA, конец очереди
+    uint32_t start, end;              //начало и конец последнего кадра
+
+    void frame (uint32_t t0, uint32_t t1, size_t n)
+    {
+      uint32_t t = t1 - t0;
+
+      frames++;
+      bytes += n;
+      busy += t;
+      if (t > max) max = t;
+      start = t0;
+      end = t1;
+    }
+    void waited (uint32_t t0) {wait += SPI_PROF_TIME () - t0;}
+  };
+
+  static uint32_t prof_time () {return SPI_PROF_TIME ();}
+#else
+  struct Prof
+  {
+    void frame (uint32_t, uint32_t, size_t) {}
+    void waited (uint32_t) {}
+  };
+
+  static uint32_t prof_time () {return 0;}
+#endif
+
+protected:
+  //режимы вывода для CRL/CRH
+  enum Mode {out = 0x3, in = 0x4, in_pull = 0x8, alt = 0xB};
+
+  static GPIO_TypeDef * gpio (uint8_t port)
+  {
+    return port == A ? GPIOA : port == B ? GPIOB : port == C ? GPIOC : port == D ? GPIOD : GPIOE;
+  }
+  static void pin_mode (GPIO_TypeDef * port, uint8_t pin, uint8_t mode);
+  static void config (SPI_TypeDef * s, uint16_t br, int8_t role, int8_t cpol, int8_t cpha);
+  static uint32_t pclk (bool apb2);
+  static uint16_t br_hz (uint32_t pclk, uint32_t hz);
+  static uint32_t sck_hz (uint32_t pclk, uint16_t cr1) {return pclk >> (((cr1 & SPI_CR1_BR) >> 3) + 1);}
+  static size_t exchange_poll (SPI_TypeDef * s, const uint8_t * tx, uint8_t * rx, size_t n);
+  static size_t exchange_dma (SPI_TypeDef * s, const Dma & d, const uint8_t * tx, uint8_t * rx, size_t n);
+  static void dma_start (SPI_TypeDef * s, const Dma & d, const uint8_t * tx, uint8_t * rx, uint16_t n, bool irq);
+  static bool dma_stop (SPI_TypeDef * s, const Dma & d);
+
+  //счётчик тактов DWT для SPI_PROF_TIME() по умолчанию
+  static void prof_init ()
+  {
+#ifdef SPI_PROF_DWT
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+  }
+};
+
+//с какой длины кадра transfer()/exchange() передают через DMA
+#ifndef SPI_DMA_MIN
+#define SPI_DMA_MIN 16
+#endif
+
+//очередь transferAsync() на каждый SPI, общая для его CS
+#ifndef SPI_QUEUE
+#define SPI_QUEUE 4
+#endif
+
+//очередь SpiBus, кадры всех устройств шины
+#ifndef SPI_BUS_QUEUE
+#define SPI_BUS_QUEUE 8
+#endif
+
+//выводы, тактирование и делители каждого SPI
+template <SpiBase::Num_spi N> struct SpiHw;
+
+template <> struct SpiHw<SpiBase::spi1>
+{
+  static SPI_TypeDef * spi () {return SPI1;}
+  static void clock ()
+  {
+    RCC->APB2ENR |= RCC_APB2ENR_SPI1EN|RCC_APB2ENR_IOPAEN|RCC_APB2ENR_AFIOEN;
+    RCC->AHBENR |= RCC_AHBENR_DMA1EN;
+  }
+  //DMA1: канал 2 - RX, канал 3 - TX
+  static SpiBase::Dma dma () {SpiBase::Dma d = {DMA1, DMA1_Channel2, DMA1_Channel3, 4, 8}; return d;}
+  enum {dma_irq = DMA1_Channel2_IRQn, apb2 = 1};
+  //A4 - CS; A5 - SCK; A6 - MISO; A7 - MOSI
+  enum {port = SpiBase::A, sck = 5, miso = 6, mosi = 7, cs_port = SpiBase::A, cs_pin = 4};
+  //APB2: Fpclk/64, Fpclk/16, Fpclk/4
+  enum {br_low = SPI_CR1_BR_0|SPI_CR1_BR_2, br_med = SPI_CR1_BR_0|SPI_CR1_BR_1, br_max = SPI_CR1_BR_0};
+};
 
+template <> struct SpiHw<SpiBase::spi2>
+{
+  static SPI_TypeDef * spi () {return SPI2;}
+  static void clock ()
+  {
+    RCC->APB1ENR |= RCC_APB1ENR_SPI2EN;
+    RCC->APB2ENR |= RCC_APB2ENR_IOPBEN|RCC_APB2ENR_AFIOEN;
+    RCC->AHBENR |= RCC_AHBENR_DMA1EN;
+  }
+  //DMA1: канал 4 - RX, канал 5 - TX
+  static SpiBase::Dma dma () {SpiBase::Dma d = {DMA1, DMA1_Channel4, DMA1_Channel5, 12, 16}; return d;}
+  enum {dma_irq = DMA1_Channel4_IRQn, apb2 = 0};
+  //B12 - CS; B13 - SCK; B14 - MISO; B15 - MOSI
+  enum {port = SpiBase::B, sck = 13, miso = 14, mosi = 15, cs_port = SpiBase::B, cs_pin = 12};
+  //APB1: Fpclk/32, Fpclk/8, Fpclk/2
+  enum {br_low = SPI_CR1_BR_2, br_med = SPI_CR1_BR_1, br_max = 0};
+};
+
+#ifdef RCC_APB1ENR_SPI3EN
+template <> struct SpiHw<SpiBase::spi3>
+{
+  static SPI_TypeDef * spi () {return SPI3;}
+  static void clock ()
+  {
+    RCC->APB1ENR |= RCC_APB1ENR_SPI3EN;
+    RCC->APB2ENR |= RCC_APB2ENR_IOPBEN|RCC_APB2ENR_AFIOEN;
+    RCC->AHBENR |= RCC_AHBENR_DMA2EN;
+    //B3, B4 и A15 заняты JTAG, оставляем только SWD
+    AFIO->MAPR = (AFIO->MAPR & ~AFIO_MAPR_SWJ_CFG) | AFIO_MAPR_SWJ_CFG_JTAGDISABLE;
+  }
+  //DMA2: канал 1 - RX, канал 2 - TX
+  static SpiBase::Dma dma () {SpiBase::Dma d = {DMA2, DMA2_Channel1, DMA2_Channel2, 0, 4}; return d;}
+  enum {dma_irq = DMA2_Channel1_IRQn, apb2 = 0};
+  //A15 - CS; B3 - SCK; B4 - MISO; B5 - MOSI
+  enum {port = SpiBase::B, sck = 3, miso = 4, mosi = 5, cs_port = SpiBase::A, cs_pin = 15};
+  //APB1: Fpclk/32, Fpclk/8, Fpclk/2
+  enum {br_low = SPI_CR1_BR_2, br_med = SPI_CR1_BR_1, br_max = 0};
+};
+#endif
+
+//очередь transferAsync() одного SPI, общая для всех Spi<N, csPort, csPin> с этим N:
+//кадр несёт свой CS, isr() любого из них обслуживает всю очередь
+template <SpiBase::Num_spi N>
+class SpiQueue : public SpiBase
+{
+public:
+  //кадр в очередь, CS - port/pin (маска), prof - статистика устройства
+  static bool submit (GPIO_TypeDef * port, uint16_t pin, Prof * prof, const uint8_t * tx, uint8_t * rx, size_t n, Callback cb, void * ctx)
+  {
+    uint32_t pm;
+
+    if (n == 0 || n > 0xFFFF) return false;
+    pm = __get_PRIMASK ();
+    __disable_irq ();
+    if (count == SPI_QUEUE)
+    {
+      __set_PRIMASK (pm);
+      return false;
+    }
+    Item & i = queue[(tail + count) % SPI_QUEUE];
+    i.port = port;
+    i.pin = pin;
+    i.prof = prof;
+    i.job.tx = tx;
+    i.job.rx = rx;
+    i.job.n = n;
+    i.job.cb = cb;
+    i.job.ctx = ctx;
+    //во время кадра с ожиданием только в очередь, его начнёт unlock()
+    if (count++ == 0 && !locked) start ();
+    __set_PRIMASK (pm);
+    return true;
+  }
+
+  static bool busy () {return count != 0;}
+
+  static void isr ()
+  {
+    SpiBase::Dma d = SpiHw<N>::dma ();
+
+    if (!count || !(d.dma->ISR & ((DMA_ISR_TCIF1|DMA_ISR_TEIF1) << d.rx_shift))) return;
+    Item i = queue[tail];
+    bool ok = dma_stop (SpiHw<N>::spi (), d);
+    i.port->BSRR = i.pin;
+    i.prof->frame (started, prof_time (), ok ? i.job.n : 0);
+    tail = (tail + 1) % SPI_QUEUE;
+    //следующий кадр идёт, пока выполняется callback
+    if (--count) start ();
+    if (i.job.cb) i.job.cb (i.job.ctx, ok ? i.job.n : 0);
+  }
+
+  //ждёт конца очереди и занимает SPI для обмена с ожиданием:
+  //transferAsync() из прерывания до unlock() только ставит кадр в очередь
+  static void lock ()
+  {
+    uint32_t pm;
+
+    for (;;)
+    {
+      while (busy ());
+      pm = __get_PRIMASK ();
+      __disable_irq ();
+      if (!count) break;
+      __set_PRIMASK (pm);
+    }
+    locked = true;
+    __set_PRIMASK (pm);
+  }
+
+  static void unlock ()
+  {
+    uint32_t pm = __get_PRIMASK ();
+
+    __disable_irq ();
+    locked = false;
+    if (count) start ();
+    __set_PRIMASK (pm);
+  }
 
 private:
-void spi1_init (uint8_t speed, int8_t role, int8_t cpol, int8_t cpha);
-void spi2_init (uint8_t speed, int8_t role, int8_t cpol, int8_t cpha);
+  struct Item
+  {
+    GPIO_TypeDef * port;
+    uint16_t pin;
+    Prof * prof;
+    Job job;
+  };
 
- Num_spi n;
-enum Role {master,slave};
-enum Cpol {Neg, Pos};
-enum Cpha {Faling, Rising};
+  static void start ()
+  {
+    const Item & i = queue[tail];
+
+    started = prof_time ();
+    i.port->BRR = i.pin;
+    dma_start (SpiHw<N>::spi (), SpiHw<N>::dma (), i.job.tx, i.job.rx, i.job.n, true);
+  }
+
+  static Item queue[SPI_QUEUE];
+  static volatile uint8_t tail, count;
+  static volatile bool locked;        //идёт обмен с ожиданием
+  static uint32_t started;            //начало текущего кадра
 };
 
+template <SpiBase::Num_spi N>
+typename SpiQueue<N>::Item SpiQueue<N>::queue[SPI_QUEUE];
+template <SpiBase::Num_spi N>
+volatile uint8_t SpiQueue<N>::tail;
+template <SpiBase::Num_spi N>
+volatile uint8_t SpiQueue<N>::count;
+template <SpiBase::Num_spi N>
+volatile bool SpiQueue<N>::locked;
+template <SpiBase::Num_spi N>
+uint32_t SpiQueue<N>::started;
+
+//N - номер SPI, csPort/csPin - вывод CS (по умолчанию аппаратный NSS)
+template <SpiBase::Num_spi N, uint8_t csPort = SpiHw<N>::cs_port, uint8_t csPin = SpiHw<N>::cs_pin>
+class Spi : public SpiBase
+{
+public:
+  Spi (uint8_t speed=med, int8_t role=master, int8_t cpol=Neg, int8_t cpha=Faling)
+  {
+    GPIO_TypeDef * p = gpio (SpiHw<N>::port);
+
+    SpiHw<N>::clock ();
+    if (role == master)
+    {
+      pin_mode (p, SpiHw<N>::sck, alt);
+      pin_mode (p, SpiHw<N>::miso, in_pull);
+      pin_mode (p, SpiHw<N>::mosi, alt);
+      //настройка CS
+      RCC->APB2ENR |= RCC_APB2ENR_IOPAEN << csPort;
+      deselect ();
+      pin_mode (gpio (csPort), csPin, out);
+    }
+    else
+    {
+      pin_mode (p, SpiHw<N>::sck, in);
+      pin_mode (p, SpiHw<N>::miso, alt);
+      pin_mode (p, SpiHw<N>::mosi, in);
+    }
+    config (SpiHw<N>::spi (), speed == low ? SpiHw<N>::br_low : speed == max ? SpiHw<N>::br_max : SpiHw<N>::br_med,
+      role, cpol, cpha);
+    prof_init ();
+    NVIC_EnableIRQ ((IRQn_Type)SpiHw<N>::dma_irq);
+  }
+
+  static void select () {gpio (csPort)->BRR = 1 << csPin;}
+  static void deselect () {gpio (csPort)->BSRR = 1 << csPin;}
+
+  //не вызывать из callback, как и остальные обмены с ожиданием: ждут конца очереди transferAsync()
+  static uint8_t transfer (uint8_t data)
+  {
+    SPI_TypeDef * s = SpiHw<N>::spi ();
+    uint32_t t0;
+    uint8_t b;
+
+    lock ();
+    t0 = prof_time ();
+    select ();
+    s->DR = data; //Пишем в буфер передатчика. После этого стартует обмен данными
+    while (!(s->SR & SPI_SR_RXNE));
+    while (s->SR & SPI_SR_BSY);
+    deselect ();
+    b = s->DR;
+    prof.waited (t0);
+    prof.frame (t0, prof_time (), 1);
+    unlock ();
+    return b;
+  }
+
+  //обмен кадром без CS, tx = 0 - передаются 0xFF, rx = 0 - принятое не нужно
+  //возвращает число принятых байт, меньше n при переполнении (OVR)
+  static size_t exchange (const uint8_t * tx, uint8_t * rx, size_t n)
+  {
+    lock ();
+    n = blocking (tx, rx, n);
+    unlock ();
+    return n;
+  }
+
+  //кадр из n байт, CS держится на весь кадр
+  static size_t transfer (const uint8_t * tx, uint8_t * rx, size_t n)
+  {
+    lock ();
+    select ();
+    n = blocking (tx, rx, n);
+    deselect ();
+    unlock ();
+    return n;
+  }
+
+  //кадр через DMA в фоне, CS держится на весь кадр; buf передаётся и заменяется принятым
+  //false - очередь полна или n больше 65535; cb вызывается из прерывания DMA
+  static bool transferAsync (uint8_t * buf, size_t n, Callback cb, void * ctx = 0)
+  {
+    return transferAsync (buf, buf, n, cb, ctx);
+  }
+
+  static bool transferAsync (const uint8_t * tx, uint8_t * rx, size_t n, Callback cb, void * ctx = 0)
+  {
+    return SpiQueue<N>::submit (gpio (csPort), 1 << csPin, &prof, tx, rx, n, cb, ctx);
+  }
+
+  //в очереди SPI, от любого CS, или передаётся хотя бы один кадр
+  static bool busy () {return SpiQueue<N>::busy ();}
+
+  //SCK не выше hz от текущей частоты шины, вместо low/med/max; возвращает полученную частоту
+  //не вызывать из callback: ждёт конца очереди transferAsync()
+  static uint32_t frequency (uint32_t hz)
+  {
+    SPI_TypeDef * s = SpiHw<N>::spi ();
+    uint16_t cr1;
+
+    lock ();
+    while (s->SR & SPI_SR_BSY);
+    cr1 = (s->CR1 & ~SPI_CR1_BR) | br_hz (pclk (SpiHw<N>::apb2), hz);
+    //BR меняется только при выключенном SPI
+    s->CR1 = cr1 & ~SPI_CR1_SPE;
+    s->CR1 = cr1;
+    unlock ();
+    return frequency ();
+  }
+
+  static uint32_t frequency () {return sck_hz (pclk (SpiHw<N>::apb2), SpiHw<N>::spi ()->CR1);}
+
+  //вызывать из DMAx_Channely_IRQHandler канала RX этого SPI (SpiHw<N>::dma_irq),
+  //одна на все CS этого SPI
+  static void isr () {SpiQueue<N>::isr ();}
+
+  static uint16_t dma_min;
+  static Prof prof;                   //обмены этого CS при SPI_PROF, обнулять можно в любой момент
+
+private:
+  static void lock ()
+  {
+    uint32_t t0 = prof_time ();
+
+    SpiQueue<N>::lock ();
+    prof.waited (t0);
+  }
+
+  static void unlock () {SpiQueue<N>::unlock ();}
+
+  //ядро ждёт весь кадр, и с DMA тоже
+  static size_t blocking (const uint8_t * tx, uint8_t * rx, size_t n)
+  {
+    uint32_t t0 = prof_time ();
+
+    if (n >= dma_min) n = exchange_dma (SpiHw<N>::spi (), SpiHw<N>::dma (), tx, rx, n);
+    else n = exchange_poll (SpiHw<N>::spi (), tx, rx, n);
+    prof.waited (t0);
+    prof.frame (t0, prof_time (), n);
+    return n;
+  }
+};
+
+template <SpiBase::Num_spi N, uint8_t csPort, uint8_t csPin>
+uint16_t Spi<N, csPort, csPin>::dma_min = SPI_DMA_MIN;
+template <SpiBase::Num_spi N, uint8_t csPort, uint8_t csPin>
+SpiBase::Prof Spi<N, csPort, csPin>::prof;
+
+//устройство на общей шине SpiBus: вывод CS и свой CR1 (делитель, CPOL, CPHA)
+struct SpiDev
+{
+  GPIO_TypeDef * port;
+  uint16_t pin;                       //маска вывода CS
+  uint16_t cr1;
+  mutable SpiBase::Prof prof;         //обмены устройства при SPI_PROF; кадр hold - отдельно
+};
+
+//один SPI на несколько устройств: кадры всех устройств в одной очереди,
+//CR1 переписывается, только когда следующий кадр для другого устройства.
+//Вместо Spi<N> для этого SPI, isr() - из прерывания канала RX DMA (SpiHw<N>::dma_irq)
+template <SpiBase::Num_spi N>
+class SpiBus : public SpiBase
+{
+public:
+  SpiBus ()
+  {
+    GPIO_TypeDef * p = gpio (SpiHw<N>::port);
+
+    SpiHw<N>::clock ();
+    pin_mode (p, SpiHw<N>::sck, alt);
+    pin_mode (p, SpiHw<N>::miso, in_pull);
+    pin_mode (p, SpiHw<N>::mosi, alt);
+    config (SpiHw<N>::spi (), SpiHw<N>::br_med, master, Neg, Faling);
+    cur = SpiHw<N>::spi ()->CR1;
+    prof_init ();
+    NVIC_EnableIRQ ((IRQn_Type)SpiHw<N>::dma_irq);
+  }
+
+  //устройство с CS на csPort/csPin; вывод настраивается здесь, CS снят
+  static SpiDev device (uint8_t csPort, uint8_t csPin, uint8_t speed=med, int8_t cpol=Neg, int8_t cpha=Faling)
+  {
+    SpiDev d;
+
+    RCC->APB2ENR |= RCC_APB2ENR_IOPAEN << csPort;
+    d.port = gpio (csPort);
+    d.pin = 1 << csPin;
+    d.port->BSRR = d.pin;
+    pin_mode (d.port, csPin, out);
+    d.prof = Prof ();
+    d.cr1 = SPI_CR1_MSTR|SPI_CR1_SPE|(speed == low ? SpiHw<N>::br_low : speed == max ? SpiHw<N>::br_max : SpiHw<N>::br_med);
+    if (cpol == Pos) d.cr1 |= SPI_CR1_CPOL;
+    if (cpha == Rising) d.cr1 |= SPI_CR1_CPHA;
+    return d;
+  }
+
+  //кадр в очередь, как Spi<N>::transferAsync(); false - очередь полна или n больше 65535
+  //hold - CS не снимается, следующий кадр того же устройства продолжает этот
+  //(команда и данные из разных буферов одним кадром)
+  static bool submit (const SpiDev & d, const uint8_t * tx, uint8_t * rx, size_t n, Callback cb = 0, void * ctx = 0, bool hold = false)
+  {
+    uint32_t pm;
+
+    if (n == 0 || n > 0xFFFF) return false;
+    pm = __get_PRIMASK ();
+    __disable_irq ();
+    if (count == SPI_BUS_QUEUE)
+    {
+      __set_PRIMASK (pm);
+      return false;
+    }
+    Item & i = queue[(tail + count) % SPI_BUS_QUEUE];
+    i.dev = &d;
+    i.hold = hold;
+    i.job.tx = tx;
+    i.job.rx = rx;
+    i.job.n = n;
+    i.job.cb = cb;
+    i.job.ctx = ctx;
+    //во время transfer() только в очередь, его начнёт unlock()
+    if (count++ == 0 && !locked) start ();
+    __set_PRIMASK (pm);
+    return true;
+  }
+
+  //кадр с ожиданием, после уже поставленных в очередь; не вызывать из callback
+  static size_t transfer (const SpiDev & d, const uint8_t * tx, uint8_t * rx, size_t n)
+  {
+    SPI_TypeDef * s = SpiHw<N>::spi ();
+    uint32_t t0 = prof_time ();
+
+    lock ();
+    d.prof.waited (t0);
+    t0 = prof_time ();
+    if (held && held != &d) held->port->BSRR = held->pin;
+    use (d);
+    d.port->BRR = d.pin;
+    n = n >= dma_min ? exchange_dma (s, SpiHw<N>::dma (), tx, rx, n) : exchange_poll (s, tx, rx, n);
+    d.port->BSRR = d.pin;
+    held = 0;
+    d.prof.waited (t0);
+    d.prof.frame (t0, prof_time (), n);
+    unlock ();
+    return n;
+  }
+
+  static bool busy () {return count != 0;}
+
+  //SCK устройства не выше hz от текущей частоты шины, с его следующего кадра;
+  //возвращает полученную частоту
+  static uint32_t frequency (SpiDev & d, uint32_t hz)
+  {
+    d.cr1 = (d.cr1 & ~SPI_CR1_BR) | br_hz (pclk (SpiHw<N>::apb2), hz);
+    return frequency (d);
+  }
+
+  static uint32_t frequency (const SpiDev & d) {return sck_hz (pclk (SpiHw<N>::apb2), d.cr1);}
+
+  static void isr ()
+  {
+    SpiBase::Dma d = SpiHw<N>::dma ();
+
+    if (!count || !(d.dma->ISR & ((DMA_ISR_TCIF1|DMA_ISR_TEIF1) << d.rx_shift))) return;
+    Item i = queue[tail];
+    bool ok = dma_stop (SpiHw<N>::spi (), d);
+    i.dev->prof.frame (started, prof_time (), ok ? i.job.n : 0);
+    if (i.hold && ok) held = i.dev;
+    else
+    {
+      i.dev->port->BSRR = i.dev->pin;
+      held = 0;
+    }
+    tail = (tail + 1) % SPI_BUS_QUEUE;
+    //подряд идущие кадры - сразу из прерывания, без перенастройки для того же устройства
+    if (--count) start ();
+    if (i.job.cb) i.job.cb (i.job.ctx, ok ? i.job.n : 0);
+  }
+
+  static uint16_t dma_min;
+  static uint32_t reconfig;           //сколько раз переписан CR1
+
+private:
+  struct Item
+  {
+    const SpiDev * dev;
+    bool hold;
+    Job job;
+  };
+
+  //режим и скорость устройства; BR, CPOL и CPHA меняются только при выключенном SPI
+  static void use (const SpiDev & d)
+  {
+    SPI_TypeDef * s = SpiHw<N>::spi ();
+
+    if (d.cr1 == cur) return;
+    s->CR1 = d.cr1 & ~SPI_CR1_SPE;
+    s->CR1 = d.cr1;
+    cur = d.cr1;
+    reconfig++;
+  }
+
+  static void start ()
+  {
+    const Item & i = queue[tail];
+
+    started = prof_time ();
+    //CS, оставленный hold, снимается, если дальше другое устройство
+    if (held && held != i.dev) held->port->BSRR = held->pin;
+    held = 0;
+    use (*i.dev);
+    i.dev->port->BRR = i.dev->pin;
+    dma_start (SpiHw<N>::spi (), SpiHw<N>::dma (), i.job.tx, i.job.rx, i.job.n, true);
+  }
+
+  //как SpiQueue<N>::lock(): submit() из прерывания во время transfer() только ставит в очередь
+  static void lock ()
+  {
+    uint32_t pm;
+
+    for (;;)
+    {
+      while (busy ());
+      pm = __get_PRIMASK ();
+      __disable_irq ();
+      if (!count) break;
+      __set_PRIMASK (pm);
+    }
+    locked = true;
+    __set_PRIMASK (pm);
+  }
+
+  static void unlock ()
+  {
+    uint32_t pm = __get_PRIMASK ();
+
+    __disable_irq ();
+    locked = false;
+    if (count) start ();
+    __set_PRIMASK (pm);
+  }
+
+  static Item queue[SPI_BUS_QUEUE];
+  static volatile uint8_t tail, count;
+  static volatile bool locked;
+  static uint16_t cur;
+  static const SpiDev * held;
+  static uint32_t started;
+};
+
+template <SpiBase::Num_spi N>
+uint16_t SpiBus<N>::dma_min = SPI_DMA_MIN;
+template <SpiBase::Num_spi N>
+uint32_t SpiBus<N>::reconfig;
+template <SpiBase::Num_spi N>
+typename SpiBus<N>::Item SpiBus<N>::queue[SPI_BUS_QUEUE];
+template <SpiBase::Num_spi N>
+volatile uint8_t SpiBus<N>::tail;
+template <SpiBase::Num_spi N>
+volatile uint8_t SpiBus<N>::count;
+template <SpiBase::Num_spi N>
+volatile bool SpiBus<N>::locked;
+template <SpiBase::Num_spi N>
+uint16_t SpiBus<N>::cur;
+template <SpiBase::Num_spi N>
+const SpiDev * SpiBus<N>::held;
+template <SpiBase::Num_spi N>
+uint32_t SpiBus<N>::started;
+
 uint8_t transfer (uint8_t data);
 
-//настройки линий CS
+//настройки линий CS; на общей шине CS ведёт SpiBus, см. SpiBus<N>::device()
 #define CS1_ON GPIOA->ODR|= 1<<4
 #define CS1_OFF GPIOA->ODR&= ~(1<<4)
 #define CS2_ON GPIOB->ODR|= 1<<12